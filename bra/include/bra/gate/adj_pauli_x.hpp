@@ -37,6 +37,9 @@ namespace bra
       std::string const& do_name() const override;
       std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const override;
+      qubits_type do_fusible_qubits() const override;
+      matrix_type do_matrix() const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
     }; // class adj_pauli_x
   } // namespace gate
 } // namespace bra
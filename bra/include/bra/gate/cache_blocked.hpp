@@ -0,0 +1,53 @@
+#ifndef BRA_GATE_CACHE_BLOCKED_HPP
+# define BRA_GATE_CACHE_BLOCKED_HPP
+
+# include <string>
+# include <vector>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    // run of gates on lower qubits made by ::bra::gates::block, which is applied to one block of amplitudes after another
+    class cache_blocked final
+      : public ::bra::gate::gate
+    {
+     public:
+      using bit_integer_type = ::bra::state::bit_integer_type;
+
+     private:
+      std::vector<matrix_type> matrices_;
+      std::vector<qubits_type> qubits_list_;
+      bit_integer_type num_block_qubits_;
+
+      static std::string const name_;
+
+     public:
+      cache_blocked(
+        std::vector<matrix_type>&& matrices, std::vector<qubits_type>&& qubits_list,
+        bit_integer_type const num_block_qubits);
+
+      ~cache_blocked() = default;
+      cache_blocked(cache_blocked const&) = delete;
+      cache_blocked& operator=(cache_blocked const&) = delete;
+      cache_blocked(cache_blocked&&) = delete;
+      cache_blocked& operator=(cache_blocked&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+      qubits_type do_local_qubits() const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
+    }; // class cache_blocked
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_CACHE_BLOCKED_HPP
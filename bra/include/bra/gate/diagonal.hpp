@@ -0,0 +1,46 @@
+#ifndef BRA_GATE_DIAGONAL_HPP
+# define BRA_GATE_DIAGONAL_HPP
+
+# include <string>
+# include <vector>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    // run of diagonal gates made by ::bra::gates::merge_diagonals. The run is the product of diagonals_[i] acting on
+    // qubits_list_[i], which is applied by one sweep over the state
+    class diagonal final
+      : public ::bra::gate::gate
+    {
+      std::vector<matrix_type> diagonals_;
+      std::vector<qubits_type> qubits_list_;
+
+      static std::string const name_;
+
+     public:
+      diagonal(std::vector<matrix_type>&& diagonals, std::vector<qubits_type>&& qubits_list);
+
+      ~diagonal() = default;
+      diagonal(diagonal const&) = delete;
+      diagonal& operator=(diagonal const&) = delete;
+      diagonal(diagonal&&) = delete;
+      diagonal& operator=(diagonal&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
+    }; // class diagonal
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_DIAGONAL_HPP
@@ -46,6 +46,7 @@ namespace bra
       ::bra::state& do_apply(::bra::state& state) const override;
       std::string const& do_name() const override;
       std::string do_representation(std::ostringstream& repr_stream, int const) const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
     }; // class exit
   } // namespace gate
 } // namespace bra
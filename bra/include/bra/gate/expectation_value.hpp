@@ -0,0 +1,46 @@
+#ifndef BRA_GATE_EXPECTATION_VALUE_HPP
+# define BRA_GATE_EXPECTATION_VALUE_HPP
+
+# include <vector>
+# include <string>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    class expectation_value final
+      : public ::bra::gate::gate
+    {
+     public:
+      using pauli_term_type = ::bra::state::pauli_term_type;
+
+     private:
+      std::vector<pauli_term_type> pauli_terms_;
+
+      static std::string const name_;
+
+     public:
+      explicit expectation_value(std::vector<pauli_term_type> const& pauli_terms);
+
+      ~expectation_value() = default;
+      expectation_value(expectation_value const&) = delete;
+      expectation_value& operator=(expectation_value const&) = delete;
+      expectation_value(expectation_value&&) = delete;
+      expectation_value& operator=(expectation_value&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(std::ostringstream& repr_stream, int const) const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
+    }; // class expectation_value
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_EXPECTATION_VALUE_HPP
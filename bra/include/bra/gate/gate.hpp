@@ -2,9 +2,11 @@
 # define BRA_GATE_GATE_HPP
 
 # include <string>
+# include <vector>
 # include <iosfwd>
 
 # include <bra/state.hpp>
+# include <bra/instruction.hpp>
 
 
 namespace bra
@@ -14,6 +16,11 @@ namespace bra
     class gate
     {
      public:
+      using qubit_type = ::bra::state::qubit_type;
+      using complex_type = ::bra::state::complex_type;
+      using qubits_type = std::vector<qubit_type>;
+      using matrix_type = std::vector<complex_type>;
+
       gate() = default;
       virtual ~gate() = default;
 
@@ -26,11 +33,29 @@ namespace bra
       std::string const& name() const { return do_name(); }
       std::string representation() const;
 
+      // fusible_qubits() is empty if the gate cannot be merged with other gates. Otherwise matrix() is its
+      // 2^n x 2^n matrix in row-major order, where the i-th bit of row/column indices corresponds to fusible_qubits()[i]
+      qubits_type fusible_qubits() const { return do_fusible_qubits(); }
+      matrix_type matrix() const { return do_matrix(); }
+
+      // local_qubits() are the qubits which must be local (not global) when the gate is applied to MPI states.
+      // It is the same as fusible_qubits() except for gates applied without interchanging qubits
+      qubits_type local_qubits() const { return do_local_qubits(); }
+
+      // instruction() is the record which bra::program applies without virtual calls. Operands of variable sizes are
+      // copied to the back of operands_list
+      ::bra::instruction instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+      { return do_instruction(operands_list); }
+
      protected:
       virtual ::bra::state& do_apply(::bra::state& state) const = 0;
       virtual std::string const& do_name() const = 0;
       virtual std::string do_representation(
         std::ostringstream& repr_stream, int const parameter_width) const = 0;
+      virtual qubits_type do_fusible_qubits() const { return {}; }
+      virtual matrix_type do_matrix() const { return {}; }
+      virtual qubits_type do_local_qubits() const { return do_fusible_qubits(); }
+      virtual ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const = 0;
     }; // class gate
 
     inline ::bra::state& operator<<(::bra::state& state, ::bra::gate::gate const& gate)
@@ -0,0 +1,46 @@
+#ifndef BRA_GATE_REMAP_QUBITS_HPP
+# define BRA_GATE_REMAP_QUBITS_HPP
+
+# include <string>
+# include <vector>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    // exchange of nonlocal_qubits_[i] with local evicted_qubits_[i] made by ::bra::gates::plan_qubit_remapping.
+    // All the pairs are exchanged by one interchange before the gates needing nonlocal_qubits_
+    class remap_qubits final
+      : public ::bra::gate::gate
+    {
+      qubits_type nonlocal_qubits_;
+      qubits_type evicted_qubits_;
+
+      static std::string const name_;
+
+     public:
+      remap_qubits(qubits_type&& nonlocal_qubits, qubits_type&& evicted_qubits);
+
+      ~remap_qubits() = default;
+      remap_qubits(remap_qubits const&) = delete;
+      remap_qubits& operator=(remap_qubits const&) = delete;
+      remap_qubits(remap_qubits&&) = delete;
+      remap_qubits& operator=(remap_qubits&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
+    }; // class remap_qubits
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_REMAP_QUBITS_HPP
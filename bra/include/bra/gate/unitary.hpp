@@ -0,0 +1,52 @@
+#ifndef BRA_GATE_UNITARY_HPP
+# define BRA_GATE_UNITARY_HPP
+
+# include <string>
+# include <vector>
+# include <iosfwd>
+
+# include <bra/gate/gate.hpp>
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    // dense matrix made by ::bra::gates::fuse
+    class unitary final
+      : public ::bra::gate::gate
+    {
+     public:
+      using qubit_type = ::bra::state::qubit_type;
+      using complex_type = ::bra::state::complex_type;
+
+     private:
+      matrix_type matrix_;
+      qubits_type qubits_;
+
+      static std::string const name_;
+
+     public:
+      unitary(matrix_type&& matrix, qubits_type&& qubits);
+
+      ~unitary() = default;
+      unitary(unitary const&) = delete;
+      unitary& operator=(unitary const&) = delete;
+      unitary(unitary&&) = delete;
+      unitary& operator=(unitary&&) = delete;
+
+     private:
+      ::bra::state& do_apply(::bra::state& state) const override;
+      std::string const& do_name() const override;
+      std::string do_representation(
+        std::ostringstream& repr_stream, int const parameter_width) const override;
+      qubits_type do_fusible_qubits() const override;
+      matrix_type do_matrix() const override;
+      ::bra::instruction do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const override;
+    }; // class unitary
+  } // namespace gate
+} // namespace bra
+
+
+#endif // BRA_GATE_UNITARY_HPP
@@ -2,6 +2,7 @@
 # define BRA_GATES_HPP
 
 # include <cassert>
+# include <cstddef>
 # include <iosfwd>
 # include <vector>
 # include <string>
@@ -27,6 +28,8 @@
 # endif // BRA_NO_MPI
 
 # include <bra/state.hpp>
+# include <bra/statement.hpp>
+# include <bra/mapped_file.hpp>
 # include <bra/gate/gate.hpp>
 
 # if __cplusplus >= 201703L
@@ -38,6 +41,8 @@
 
 namespace bra
 {
+  class program;
+
   class unsupported_mnemonic_error
     : public std::runtime_error
   {
@@ -56,6 +61,13 @@ namespace bra
     std::string generate_what_string(columns_type const& columns);
   }; // class wrong_mnemonic_error
 
+  class wrong_compiled_qcx_error
+    : public std::runtime_error
+  {
+   public:
+    wrong_compiled_qcx_error();
+  }; // class wrong_compiled_qcx_error
+
 # ifndef BRA_NO_MPI
   class wrong_mpi_communicator_size_error
     : public std::runtime_error
@@ -69,6 +81,7 @@ namespace bra
   enum class bit_statement : int { assignment };
   enum class generate_statement : int { events };
   enum class depolarizing_statement : int { channel };
+  enum class expectation_statement : int { value };
 
   class gates
   {
@@ -91,6 +104,7 @@ namespace bra
 # endif
 
     using real_type = ::bra::state::real_type;
+    using pauli_term_type = ::bra::state::pauli_term_type;
 
     using columns_type = wrong_mnemonics_error::columns_type;
 
@@ -104,6 +118,7 @@ namespace bra
     state_integer_type initial_state_value_;
 # ifndef BRA_NO_MPI
     std::vector<permutated_qubit_type> initial_permutation_;
+    state_integer_type mpi_buffer_size_; // MPISWAPBUFFER, or 0 if not given
 # endif
 
     using complex_type = ::bra::state::complex_type;
@@ -145,9 +160,25 @@ namespace bra
       yampi::rank const root = yampi::rank{},
       yampi::communicator const& communicator = yampi::communicator{::yampi::world_communicator_t()},
       size_type const num_reserved_gates = size_type{0u});
+    gates(
+      ::bra::mapped_file const& compiled_file,
+      bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+      yampi::environment const& environment,
+      yampi::rank const root = yampi::rank{},
+      yampi::communicator const& communicator = yampi::communicator{::yampi::world_communicator_t()},
+      size_type const num_reserved_gates = size_type{0u});
+    gates(
+      ::bra::mapped_file const& compiled_file, ::bra::program& program,
+      bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+      yampi::environment const& environment,
+      yampi::rank const root = yampi::rank{},
+      yampi::communicator const& communicator = yampi::communicator{::yampi::world_communicator_t()});
 # else // BRA_NO_MPI
     explicit gates(std::istream& input_stream);
     gates(std::istream& input_stream, size_type const num_reserved_gates);
+    explicit gates(::bra::mapped_file const& compiled_file);
+    gates(::bra::mapped_file const& compiled_file, size_type const num_reserved_gates);
+    gates(::bra::mapped_file const& compiled_file, ::bra::program& program);
 # endif // BRA_NO_MPI
 
     bool operator==(gates const& other) const;
@@ -161,6 +192,7 @@ namespace bra
     state_integer_type const& initial_state_value() const { return initial_state_value_; }
 # ifndef BRA_NO_MPI
     std::vector<permutated_qubit_type> const& initial_permutation() const { return initial_permutation_; }
+    state_integer_type const& mpi_buffer_size() const { return mpi_buffer_size_; }
 # endif
 
 # ifndef BRA_NO_MPI
@@ -189,11 +221,87 @@ namespace bra
       std::istream& input_stream, yampi::environment const& environment,
       yampi::communicator const& communicator = yampi::communicator{yampi::world_communicator_t()},
       size_type const num_reserved_gates = size_type{0u});
+    // compiled_file is a compiled .qcx file (see bra/statement.hpp), whose statements are read in place
+    void assign(
+      ::bra::mapped_file const& compiled_file, yampi::environment const& environment,
+      yampi::communicator const& communicator = yampi::communicator{yampi::world_communicator_t()},
+      size_type const num_reserved_gates = size_type{0u});
+    // appends the gates of compiled_file to program instead of this, without allocating gate objects.
+    // This has no gates after that, so that it is used only for the other statements, e.g. QUBITS
+    void assign(
+      ::bra::mapped_file const& compiled_file, ::bra::program& program, yampi::environment const& environment,
+      yampi::communicator const& communicator = yampi::communicator{yampi::world_communicator_t()});
 # else // BRA_NO_MPI
     void assign(
       std::istream& input_stream,
       size_type const num_reserved_gates = size_type{0u});
+    // compiled_file is a compiled .qcx file (see bra/statement.hpp), whose statements are read in place
+    void assign(
+      ::bra::mapped_file const& compiled_file,
+      size_type const num_reserved_gates = size_type{0u});
+    // appends the gates of compiled_file to program instead of this, without allocating gate objects.
+    // This has no gates after that, so that it is used only for the other statements, e.g. QUBITS
+    void assign(::bra::mapped_file const& compiled_file, ::bra::program& program);
 # endif // BRA_NO_MPI
+
+    // writes the statements of the .qcx file input_stream in the compiled form, which is loaded without parsing text
+    static void compile(std::istream& input_stream, std::ostream& output_stream);
+
+   private:
+    // calls handle(opcode, operands) for each statement of input_stream
+    template <typename Function>
+    void read_statements(std::istream& input_stream, Function&& handle) const;
+
+    // calls handle(opcode, operands, num_operands) for each statement of compiled_file
+    template <typename Function>
+    static void read_statements(::bra::mapped_file const& compiled_file, Function&& handle);
+
+    // Gates are appended to program if it is not null, or to this otherwise
+# ifndef BRA_NO_MPI
+    void push_statement(
+      ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands,
+      yampi::environment const& environment, yampi::communicator const& communicator,
+      ::bra::program* const program);
+# else // BRA_NO_MPI
+    void push_statement(
+      ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands,
+      ::bra::program* const program);
+# endif // BRA_NO_MPI
+
+    template <typename Gate, typename... Arguments>
+    void push_gate(::bra::program* const program, Arguments&&... arguments);
+
+   public:
+
+    // merges each run of consecutive unitary gates acting on at most max_num_fused_qubits qubits in total into one dense gate.
+    // states apply dense gates on up to five qubits
+    void fuse(bit_integer_type const max_num_fused_qubits = bit_integer_type{3u});
+
+    // groups each run of consecutive unitary gates whose qubits are all lower than num_block_qubits into one gate,
+    // which applies the whole run to one cache-resident block of 2^num_block_qubits amplitudes after another
+    void block(bit_integer_type const num_block_qubits);
+
+    // cancels pairs of unitary gates whose product is the identity, e.g. H H and T T+, and merges pairs of one-qubit gates
+    // whose product is a phase shift, e.g. U1 U1, into one U1 gate. Gates on disjoint qubits are looked through,
+    // but other gates than unitary ones are not. Pairs on at most max_num_gate_qubits qubits are tried, and the number
+    // of removed gates is returned
+    size_type simplify(bit_integer_type const max_num_gate_qubits = bit_integer_type{3u});
+
+    // merges each run of consecutive diagonal gates into one gate, which applies the product of their diagonals by
+    // one sweep over the state. The product is stored as lookup tables on at most max_num_table_qubits qubits each
+    void merge_diagonals(bit_integer_type const max_num_table_qubits = bit_integer_type{10u});
+
+    // removes the longest prefix of Clifford gates on at most three qubits each, which are applied to tableau instead.
+    // tableau should start from initial_state_value(), and the number of removed gates is returned
+    size_type extract_clifford_prefix(::bra::stabilizer_tableau& tableau);
+
+# ifndef BRA_NO_MPI
+    // inserts gates exchanging nonlocal qubits with local ones before the gates which need them, looking ahead at the
+    // circuit: the local qubits used farthest in the future are evicted, and nonlocal qubits needed soon are brought
+    // by the same exchange, up to max_num_remapped_qubits (at most five) qubits at once
+    void plan_qubit_remapping(bit_integer_type const max_num_remapped_qubits = bit_integer_type{5u});
+# endif // BRA_NO_MPI
+
     allocator_type get_allocator() const { return data_.get_allocator(); }
 
     // Element access
@@ -254,9 +362,7 @@ namespace bra
     state_integer_type read_initial_state_value(columns_type& columns) const;
     bit_integer_type read_num_mpi_processes(columns_type const& columns) const;
     state_integer_type read_mpi_buffer_size(columns_type const& columns) const;
-# ifndef BRA_NO_MPI
-    std::vector<permutated_qubit_type> read_initial_permutation(columns_type const& columns) const;
-# endif
+    std::vector<bit_integer_type> read_initial_permutation(columns_type const& columns) const;
 
     qubit_type read_target(columns_type const& columns) const;
     std::tuple<qubit_type, real_type> read_target_phase(columns_type const& columns) const;
@@ -296,6 +402,8 @@ namespace bra
     qubit_type read_clear(columns_type const& columns) const { return read_target(columns); }
     qubit_type read_set(columns_type const& columns) const { return read_target(columns); }
     std::tuple< ::bra::depolarizing_statement, real_type, real_type, real_type, int > read_depolarizing_statement(columns_type& columns) const;
+    std::tuple< ::bra::expectation_statement, std::string > read_expectation_statement(columns_type& columns) const;
+    std::vector<pauli_term_type> read_hamiltonian(std::string const& filename, columns_type const& columns) const;
   }; // class gates
 
   inline bool operator!=(::bra::gates const& lhs, ::bra::gates const& rhs)
@@ -0,0 +1,145 @@
+#ifndef BRA_INSTRUCTION_HPP
+# define BRA_INSTRUCTION_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <array>
+# include <vector>
+# include <utility>
+
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  // Each code is applied by calling one bra::state member function with the listed fields of bra::instruction.
+  // "operands" means the bra::instruction_operands at operands_index, and integers[0] of the codes taking a root rank
+  // is the rank only if BRA_NO_MPI is not defined
+  enum class instruction_code : std::uint8_t
+  {
+    hadamard, adj_hadamard, pauli_x, adj_pauli_x, pauli_y, adj_pauli_y, pauli_z, adj_pauli_z, // target_qubit
+    phase_shift, adj_phase_shift, // phase_coefficient, target_qubit
+    u1, adj_u1, u2, adj_u2, u3, adj_u3, // phases, target_qubit
+    x_rotation_half_pi, adj_x_rotation_half_pi, y_rotation_half_pi, adj_y_rotation_half_pi, // target_qubit
+    controlled_not, adj_controlled_not, // target_qubit, control_qubit1
+    controlled_phase_shift, adj_controlled_phase_shift, controlled_v, adj_controlled_v, // phase_coefficient, target_qubit, control_qubit1
+    toffoli, adj_toffoli, // target_qubit, control_qubit1, control_qubit2
+    clear, set, // target_qubit
+    unitary, // operands.matrices[0], operands.qubits_list[0]
+    cache_blocked_unitaries, // operands.matrices, operands.qubits_list, integers[0] (num_block_qubits)
+    diagonal, // operands.matrices, operands.qubits_list
+    remap_qubits, // operands.qubits_list[0] (nonlocal qubits), operands.qubits_list[1] (evicted qubits)
+    expectation_value, // operands.pauli_terms
+    shor_box, // integers (num_exponent_qubits, divisor, base)
+    depolarizing_channel, // phases (px, py, pz), integers[0] (seed)
+    projective_measurement, // target_qubit, integers[0] (root)
+    measurement, exit, // integers[0] (root)
+    generate_events // integers (root, num_events, seed)
+  }; // enum class instruction_code
+
+  // operands of variable sizes, which are owned by bra::program
+  struct instruction_operands
+  {
+    using qubit_type = ::bra::state::qubit_type;
+    using complex_type = ::bra::state::complex_type;
+    using pauli_term_type = ::bra::state::pauli_term_type;
+
+    std::vector<std::vector<complex_type>> matrices;
+    std::vector<std::vector<qubit_type>> qubits_list;
+    std::vector<pauli_term_type> pauli_terms;
+  }; // struct instruction_operands
+
+  // trivially copyable record of a gate, which is stored contiguously in bra::program. Operands of variable sizes are
+  // referred to by operands_index
+  struct instruction
+  {
+    using qubit_type = ::bra::state::qubit_type;
+    using control_qubit_type = ::bra::state::control_qubit_type;
+    using real_type = ::bra::state::real_type;
+    using complex_type = ::bra::state::complex_type;
+
+    ::bra::instruction_code code;
+    qubit_type target_qubit;
+    control_qubit_type control_qubit1;
+    control_qubit_type control_qubit2;
+    complex_type phase_coefficient;
+    std::array<real_type, 3u> phases;
+    std::array<std::uint64_t, 3u> integers;
+    std::size_t operands_index;
+  }; // struct instruction
+
+  inline ::bra::instruction make_instruction(::bra::instruction_code const code)
+  {
+    auto result = ::bra::instruction{};
+    result.code = code;
+    return result;
+  }
+
+  // moves operands to the back of operands_list
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction_operands&& operands,
+    std::vector< ::bra::instruction_operands >& operands_list)
+  {
+    auto result = ::bra::make_instruction(code);
+    result.operands_index = operands_list.size();
+    operands_list.push_back(std::move(operands));
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction::qubit_type const target_qubit)
+  {
+    auto result = ::bra::make_instruction(code);
+    result.target_qubit = target_qubit;
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction::qubit_type const target_qubit,
+    ::bra::instruction::control_qubit_type const control_qubit)
+  {
+    auto result = ::bra::make_instruction(code, target_qubit);
+    result.control_qubit1 = control_qubit;
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction::qubit_type const target_qubit,
+    ::bra::instruction::control_qubit_type const control_qubit1,
+    ::bra::instruction::control_qubit_type const control_qubit2)
+  {
+    auto result = ::bra::make_instruction(code, target_qubit, control_qubit1);
+    result.control_qubit2 = control_qubit2;
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction::complex_type const& phase_coefficient,
+    ::bra::instruction::qubit_type const target_qubit)
+  {
+    auto result = ::bra::make_instruction(code, target_qubit);
+    result.phase_coefficient = phase_coefficient;
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, ::bra::instruction::complex_type const& phase_coefficient,
+    ::bra::instruction::qubit_type const target_qubit, ::bra::instruction::control_qubit_type const control_qubit)
+  {
+    auto result = ::bra::make_instruction(code, target_qubit, control_qubit);
+    result.phase_coefficient = phase_coefficient;
+    return result;
+  }
+
+  inline ::bra::instruction make_instruction(
+    ::bra::instruction_code const code, std::array< ::bra::instruction::real_type, 3u > const& phases,
+    ::bra::instruction::qubit_type const target_qubit)
+  {
+    auto result = ::bra::make_instruction(code, target_qubit);
+    result.phases = phases;
+    return result;
+  }
+} // namespace bra
+
+
+#endif // BRA_INSTRUCTION_HPP
@@ -0,0 +1,38 @@
+#ifndef BRA_MAPPED_FILE_HPP
+# define BRA_MAPPED_FILE_HPP
+
+# include <cstddef>
+# include <string>
+# include <stdexcept>
+
+
+namespace bra
+{
+  class cannot_map_file_error
+    : public std::runtime_error
+  {
+   public:
+    cannot_map_file_error(std::string const& filename);
+  }; // class cannot_map_file_error
+
+  // read-only memory mapping of a whole file. Processes mapping the same file share its pages in the page cache
+  class mapped_file
+  {
+    void* data_;
+    std::size_t size_;
+
+   public:
+    explicit mapped_file(std::string const& filename);
+    ~mapped_file() noexcept;
+    mapped_file(mapped_file const&) = delete;
+    mapped_file& operator=(mapped_file const&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    mapped_file& operator=(mapped_file&&) = delete;
+
+    char const* data() const noexcept { return static_cast<char const*>(data_); }
+    std::size_t size() const noexcept { return size_; }
+  }; // class mapped_file
+} // namespace bra
+
+
+#endif // BRA_MAPPED_FILE_HPP
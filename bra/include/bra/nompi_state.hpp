@@ -3,10 +3,17 @@
 
 # ifdef BRA_NO_MPI
 #   include <vector>
+#   include <memory>
+#   include <iterator>
 
 #   include <ket/gate/projective_measurement.hpp>
 #   include <ket/utility/integer_exp2.hpp>
+#   include <ket/utility/numa.hpp>
+#   include <ket/utility/uninitialized_allocator.hpp>
 #   include <ket/utility/parallel/loop_n.hpp>
+#   ifdef BRA_USE_PLANAR_STATE
+#     include <ket/utility/planar_complex_vector.hpp>
+#   endif // BRA_USE_PLANAR_STATE
 
 #   include <bra/state.hpp>
 
@@ -18,7 +25,13 @@ namespace bra
   {
     ket::utility::policy::parallel<unsigned int> parallel_policy_;
 
-    using data_type = std::vector<complex_type>;
+#   ifndef BRA_USE_PLANAR_STATE
+    using data_type = std::vector<complex_type, ket::utility::uninitialized_allocator<std::allocator<complex_type>>>;
+#   else // BRA_USE_PLANAR_STATE
+    using data_type
+      = ket::utility::planar_complex_vector<
+          real_type, ket::utility::uninitialized_allocator<std::allocator<real_type>>>;
+#   endif // BRA_USE_PLANAR_STATE
     data_type data_;
 
    public:
@@ -32,10 +45,11 @@ namespace bra
       ::bra::state::state_integer_type const initial_integer,
       unsigned int const total_num_qubits)
     {
-      auto result
-        = data_type(
-            ket::utility::integer_exp2<state_integer_type>(total_num_qubits),
-            complex_type{real_type{0}});
+      // the amplitudes are first touched by the threads of parallel_policy_ (see ket::mpi::state)
+      auto result = data_type{};
+      result.resize(ket::utility::integer_exp2<state_integer_type>(total_num_qubits));
+      ket::utility::interleave_pages(result);
+      ket::utility::fill(parallel_policy_, std::begin(result), std::end(result), complex_type{real_type{0}});
       result[initial_integer] = complex_type{real_type{1}};
       return result;
     }
@@ -108,15 +122,29 @@ namespace bra
       qubit_type const target_qubit,
       control_qubit_type const control_qubit1,
       control_qubit_type const control_qubit2) override;
+    void do_unitary(
+      std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits) override;
+    void do_cache_blocked_unitaries(
+      std::vector<std::vector<complex_type>> const& matrices,
+      std::vector<std::vector<qubit_type>> const& qubits_list,
+      bit_integer_type const num_block_qubits) override;
+    void do_diagonal(
+      std::vector<std::vector<complex_type>> const& diagonals,
+      std::vector<std::vector<qubit_type>> const& qubits_list) override;
+    void do_remap_qubits(
+      std::vector<qubit_type> const& nonlocal_qubits, std::vector<qubit_type> const& evicted_qubits) override;
+    void do_pauli_string(state_integer_type const x_mask, state_integer_type const z_mask) override;
     ket::gate::outcome do_projective_measurement(qubit_type const qubit) override;
     void do_expectation_values() override;
     void do_measure() override;
     void do_generate_events(int const num_events, int const seed) override;
+    real_type do_expectation_value(std::vector<pauli_term_type> const& pauli_terms) override;
     void do_shor_box(
       bit_integer_type const num_exponent_qubits,
       state_integer_type const divisor, state_integer_type const base) override;
     void do_clear(qubit_type const qubit) override;
     void do_set(qubit_type const qubit) override;
+    void do_assign_stabilizer_state(::bra::stabilizer_tableau const& tableau) override;
     void do_depolarizing_channel(real_type const px, real_type const py, real_type const pz, int const seed) override;
   }; // class nompi_state
 
@@ -7,7 +7,11 @@
 #   include <ket/gate/projective_measurement.hpp>
 #   include <ket/utility/parallel/loop_n.hpp>
 #   include <ket/mpi/utility/unit_mpi.hpp>
+#   include <ket/utility/uninitialized_allocator.hpp>
 #   include <ket/mpi/state.hpp>
+#   ifdef BRA_USE_PLANAR_STATE
+#     include <ket/utility/planar_complex_vector.hpp>
+#   endif // BRA_USE_PLANAR_STATE
 
 #   include <yampi/allocator.hpp>
 #   include <yampi/rank.hpp>
@@ -27,7 +31,15 @@ namespace bra
       = ket::mpi::utility::policy::unit_mpi< ::bra::state::state_integer_type, ::bra::state::bit_integer_type, unsigned int >;
     unit_mpi_policy_type mpi_policy_;
 
-    using data_type = ket::mpi::state<complex_type, true, yampi::allocator<complex_type>>;
+#   ifndef BRA_USE_PLANAR_STATE
+    using data_type
+      = ket::mpi::state<complex_type, true, ket::utility::uninitialized_allocator<yampi::allocator<complex_type>>>;
+#   else // BRA_USE_PLANAR_STATE
+    using data_type
+      = ket::mpi::state<
+          complex_type, true,
+          ket::utility::planar_allocator<complex_type, ket::utility::uninitialized_allocator<yampi::allocator<real_type>>>>;
+#   endif // BRA_USE_PLANAR_STATE
     data_type data_;
 
    public:
@@ -125,17 +137,31 @@ namespace bra
       qubit_type const target_qubit,
       control_qubit_type const control_qubit1,
       control_qubit_type const control_qubit2) override;
+    void do_unitary(
+      std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits) override;
+    void do_cache_blocked_unitaries(
+      std::vector<std::vector<complex_type>> const& matrices,
+      std::vector<std::vector<qubit_type>> const& qubits_list,
+      bit_integer_type const num_block_qubits) override;
+    void do_diagonal(
+      std::vector<std::vector<complex_type>> const& diagonals,
+      std::vector<std::vector<qubit_type>> const& qubits_list) override;
+    void do_remap_qubits(
+      std::vector<qubit_type> const& nonlocal_qubits, std::vector<qubit_type> const& evicted_qubits) override;
+    void do_pauli_string(state_integer_type const x_mask, state_integer_type const z_mask) override;
     ket::gate::outcome do_projective_measurement(
       qubit_type const qubit, yampi::rank const root) override;
     void do_expectation_values(yampi::rank const root) override;
     void do_measure(yampi::rank const root) override;
     void do_generate_events(yampi::rank const root, int const num_events, int const seed) override;
+    real_type do_expectation_value(std::vector<pauli_term_type> const& pauli_terms) override;
     void do_shor_box(
       state_integer_type const divisor, state_integer_type const base,
       std::vector<qubit_type> const& exponent_qubits,
       std::vector<qubit_type> const& modular_exponentiation_qubits) override;
     void do_clear(qubit_type const qubit) override;
     void do_set(qubit_type const qubit) override;
+    void do_assign_stabilizer_state(::bra::stabilizer_tableau const& tableau) override;
   }; // class paged_unit_mpi_state
 } // namespace bra
 
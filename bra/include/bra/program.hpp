@@ -0,0 +1,57 @@
+#ifndef BRA_PROGRAM_HPP
+# define BRA_PROGRAM_HPP
+
+# include <vector>
+
+# include <bra/state.hpp>
+# include <bra/instruction.hpp>
+
+
+namespace bra
+{
+  class gates;
+  class tracer;
+
+  namespace gate
+  {
+    class gate;
+  }
+
+  // contiguous array of the instructions of gates, which is applied to states by one switch-dispatched loop.
+  // The program owns the operands of the instructions, so it does not refer to gates after its construction
+  class program
+  {
+    using data_type = std::vector< ::bra::instruction >;
+    data_type data_;
+    std::vector< ::bra::instruction_operands > operands_list_;
+
+   public:
+    using value_type = data_type::value_type;
+    using size_type = data_type::size_type;
+    using const_iterator = data_type::const_iterator;
+
+    program();
+    explicit program(::bra::gates const& gates);
+
+    // appends the instruction of gate, whose operands are copied into this
+    void push_back(::bra::gate::gate const& gate);
+
+    ::bra::state& apply(::bra::state& state) const;
+    // records the time and the communication of each instruction in tracer, whose gate indices are those in gates
+    ::bra::state& apply(::bra::state& state, ::bra::tracer& tracer) const;
+
+    const_iterator begin() const noexcept { return data_.begin(); }
+    const_iterator end() const noexcept { return data_.end(); }
+    bool empty() const noexcept { return data_.empty(); }
+    size_type size() const noexcept { return data_.size(); }
+
+   private:
+    void apply_instruction(::bra::state& state, ::bra::instruction const& instruction) const;
+  }; // class program
+
+  inline ::bra::state& operator<<(::bra::state& state, ::bra::program const& program)
+  { return program.apply(state); }
+} // namespace bra
+
+
+#endif // BRA_PROGRAM_HPP
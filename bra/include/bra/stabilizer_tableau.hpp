@@ -0,0 +1,93 @@
+#ifndef BRA_STABILIZER_TABLEAU_HPP
+# define BRA_STABILIZER_TABLEAU_HPP
+
+# include <vector>
+# include <utility>
+
+# include <bra/state.hpp>
+
+
+namespace bra
+{
+  // i^phase X^x_mask Z^z_mask, where X^x_mask is the product of X's on the qubits of x_mask
+  struct pauli_operator
+  {
+    using state_integer_type = ::bra::state::state_integer_type;
+
+    unsigned int phase; // modulo 4
+    state_integer_type x_mask;
+    state_integer_type z_mask;
+  }; // struct pauli_operator
+
+  // (i^p X^x Z^z)(i^q X^y Z^w) = i^(p+q) (-1)^|z&y| X^(x^y) Z^(z^w)
+  ::bra::pauli_operator operator*(::bra::pauli_operator const& lhs, ::bra::pauli_operator const& rhs);
+
+  // stabilizer_amplitudes(value) is the amplitude of the computational basis state |value> in a stabilizer state,
+  // whose global phase is chosen such that the amplitude of one value in the support is positive.
+  // The stabilizers are brought into reduced row echelon form, so that each amplitude costs O(n) Pauli products
+  class stabilizer_amplitudes
+  {
+   public:
+    using state_integer_type = ::bra::state::state_integer_type;
+    using bit_integer_type = ::bra::state::bit_integer_type;
+    using real_type = ::bra::state::real_type;
+    using complex_type = ::bra::state::complex_type;
+
+   private:
+    // Each of x_stabilizers_ has the highest bit of its x_mask which no other x_mask has. The support of the state
+    // is the set of support_value_ xor any combination of their x_masks
+    std::vector< ::bra::pauli_operator > x_stabilizers_;
+    std::vector<state_integer_type> pivot_masks_;
+    state_integer_type support_value_;
+    real_type magnitude_;
+
+   public:
+    stabilizer_amplitudes(std::vector< ::bra::pauli_operator > stabilizers, bit_integer_type const num_qubits);
+
+    complex_type operator()(state_integer_type const value) const;
+  }; // class stabilizer_amplitudes
+
+  // Aaronson-Gottesman tableau of a state generated by Clifford gates from a computational basis state.
+  // Only the n stabilizers are kept because measurements are not simulated by the tableau
+  class stabilizer_tableau
+  {
+   public:
+    using state_integer_type = ::bra::state::state_integer_type;
+    using bit_integer_type = ::bra::state::bit_integer_type;
+    using qubit_type = ::bra::state::qubit_type;
+    using complex_type = ::bra::state::complex_type;
+
+   private:
+    std::vector< ::bra::pauli_operator > stabilizers_;
+    bit_integer_type num_qubits_;
+
+   public:
+    stabilizer_tableau(state_integer_type const initial_state_value, bit_integer_type const num_qubits);
+
+    bit_integer_type const& num_qubits() const { return num_qubits_; }
+
+    // applies the unitary gate matrix on qubits (see bra::gate::gate::matrix) if it is a Clifford gate on at most
+    // max_num_gate_qubits qubits. Otherwise the tableau is unchanged and false is returned
+    static constexpr bit_integer_type max_num_gate_qubits = bit_integer_type{3u};
+    bool apply(std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits);
+
+    stabilizer_amplitudes amplitudes() const { return stabilizer_amplitudes{stabilizers_, num_qubits_}; }
+
+    // the amplitudes in terms of the values whose bits are moved by map_bits, e.g. permutated values of MPI states
+    template <typename MapBits>
+    stabilizer_amplitudes amplitudes(MapBits map_bits) const
+    {
+      auto stabilizers = stabilizers_;
+      for (auto& stabilizer: stabilizers)
+      {
+        stabilizer.x_mask = map_bits(stabilizer.x_mask);
+        stabilizer.z_mask = map_bits(stabilizer.z_mask);
+      }
+
+      return stabilizer_amplitudes{std::move(stabilizers), num_qubits_};
+    }
+  }; // class stabilizer_tableau
+} // namespace bra
+
+
+#endif // BRA_STABILIZER_TABLEAU_HPP
@@ -16,10 +16,13 @@
 
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
+# include <ket/pauli_term.hpp>
 # include <ket/gate/projective_measurement.hpp>
+# include <ket/utility/integer_exp2.hpp>
 # ifndef BRA_NO_MPI
 #   include <ket/mpi/permutated.hpp>
 #   include <ket/mpi/qubit_permutation.hpp>
+#   include <ket/mpi/utility/buffer_size_limit.hpp>
 
 #   include <yampi/allocator.hpp>
 #   include <yampi/datatype.hpp>
@@ -38,7 +41,9 @@
 
 namespace bra
 {
-  enum class finished_process : int { operations, begin_measurement, generate_events, ket_measure };
+  class stabilizer_tableau;
+
+  enum class finished_process : int { operations, begin_measurement, generate_events, ket_measure, expectation_value };
 
   class state
   {
@@ -74,6 +79,7 @@ namespace bra
     using spins_allocator_type = std::allocator<spin_type>;
 # endif // BRA_NO_MPI
     using spins_type = std::vector<spin_type, spins_allocator_type>;
+    using pauli_term_type = ket::pauli_term<real_type, state_integer_type>;
     using random_number_generator_type = std::mt19937_64;
     using seed_type = random_number_generator_type::result_type;
 
@@ -92,6 +98,10 @@ namespace bra
     boost::optional<spins_type> maybe_expectation_values_; // return value of ket(::mpi)::all_spin_expectation_values
     state_integer_type measured_value_; // return value of ket(::mpi)::measure
     std::vector<state_integer_type> generated_events_; // results of ket(::mpi)::generate_events
+    std::vector<real_type> observable_expectation_values_; // return values of ket(::mpi)::expectation_value
+    // Pauli errors not yet applied to the state, X^pauli_frame_x_mask_ Z^pauli_frame_z_mask_ up to a global phase
+    state_integer_type pauli_frame_x_mask_;
+    state_integer_type pauli_frame_z_mask_;
     random_number_generator_type random_number_generator_;
 # ifndef BRA_NO_MPI
 
@@ -138,6 +148,7 @@ namespace bra
     { return maybe_expectation_values_; }
     state_integer_type const& measured_value() const { return measured_value_; }
     std::vector<state_integer_type> const& generated_events() const { return generated_events_; }
+    std::vector<real_type> const& observable_expectation_values() const { return observable_expectation_values_; }
     random_number_generator_type& random_number_generator() { return random_number_generator_; }
 
 # ifndef BRA_NO_MPI
@@ -145,6 +156,15 @@ namespace bra
 
     yampi::communicator const& communicator() const { return communicator_; }
     yampi::environment const& environment() const { return environment_; }
+
+    // interchanges of qubits use at most new_mpi_buffer_size elements of extra memory. 0 means no limit.
+    // The limit is given to ket apart from buffer_, whose size other operations may change
+    void mpi_buffer_size(state_integer_type const new_mpi_buffer_size)
+    {
+      ket::mpi::utility::buffer_size_limit() = static_cast<std::size_t>(new_mpi_buffer_size);
+      buffer_.assign(new_mpi_buffer_size, complex_type{});
+      buffer_.shrink_to_fit();
+    }
 # endif // BRA_NO_MPI
 
     std::size_t num_finish_processes() const { return finish_times_and_processes_.size(); }
@@ -158,10 +178,10 @@ namespace bra
 # endif // BRA_NO_MPI
 
     ::bra::state& hadamard(qubit_type const qubit)
-    { do_hadamard(qubit); return *this; }
+    { do_hadamard(qubit); swap_pauli_frame_bits(qubit); return *this; }
 
     ::bra::state& adj_hadamard(qubit_type const qubit)
-    { do_adj_hadamard(qubit); return *this; }
+    { do_adj_hadamard(qubit); swap_pauli_frame_bits(qubit); return *this; }
 
     ::bra::state& pauli_x(qubit_type const qubit)
     { do_pauli_x(qubit); return *this; }
@@ -182,61 +202,95 @@ namespace bra
     { do_adj_pauli_z(qubit); return *this; }
 
     ::bra::state& u1(real_type const phase, qubit_type const qubit)
-    { do_u1(phase, qubit); return *this; }
+    { apply_pauli_frame_if_noncommuting(qubit_mask(qubit), state_integer_type{0u}); do_u1(phase, qubit); return *this; }
 
     ::bra::state& adj_u1(real_type const phase, qubit_type const qubit)
-    { do_adj_u1(phase, qubit); return *this; }
+    { apply_pauli_frame_if_noncommuting(qubit_mask(qubit), state_integer_type{0u}); do_adj_u1(phase, qubit); return *this; }
 
     ::bra::state& u2(
       real_type const phase1, real_type const phase2, qubit_type const qubit)
-    { do_u2(phase1, phase2, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit));
+      do_u2(phase1, phase2, qubit);
+      return *this;
+    }
 
     ::bra::state& adj_u2(
       real_type const phase1, real_type const phase2, qubit_type const qubit)
-    { do_adj_u2(phase1, phase2, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit));
+      do_adj_u2(phase1, phase2, qubit);
+      return *this;
+    }
 
     ::bra::state& u3(
       real_type const phase1, real_type const phase2, real_type const phase3,
       qubit_type const qubit)
-    { do_u3(phase1, phase2, phase3, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit));
+      do_u3(phase1, phase2, phase3, qubit);
+      return *this;
+    }
 
     ::bra::state& adj_u3(
       real_type const phase1, real_type const phase2, real_type const phase3,
       qubit_type const qubit)
-    { do_adj_u3(phase1, phase2, phase3, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit));
+      do_adj_u3(phase1, phase2, phase3, qubit);
+      return *this;
+    }
 
     ::bra::state& phase_shift(
       complex_type const phase_coefficient, qubit_type const qubit)
-    { do_phase_shift(phase_coefficient, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), state_integer_type{0u});
+      do_phase_shift(phase_coefficient, qubit);
+      return *this;
+    }
 
     ::bra::state& adj_phase_shift(
       complex_type const phase_coefficient, qubit_type const qubit)
-    { do_adj_phase_shift(phase_coefficient, qubit); return *this; }
+    {
+      apply_pauli_frame_if_noncommuting(qubit_mask(qubit), state_integer_type{0u});
+      do_adj_phase_shift(phase_coefficient, qubit);
+      return *this;
+    }
 
+    // (1 +- iX)/sqrt(2) maps Z to -+Y and Y to +-Z
     ::bra::state& x_rotation_half_pi(qubit_type const qubit)
-    { do_x_rotation_half_pi(qubit); return *this; }
+    { do_x_rotation_half_pi(qubit); pauli_frame_x_mask_ ^= pauli_frame_z_mask_ bitand qubit_mask(qubit); return *this; }
 
     ::bra::state& adj_x_rotation_half_pi(qubit_type const qubit)
-    { do_adj_x_rotation_half_pi(qubit); return *this; }
+    { do_adj_x_rotation_half_pi(qubit); pauli_frame_x_mask_ ^= pauli_frame_z_mask_ bitand qubit_mask(qubit); return *this; }
 
     ::bra::state& y_rotation_half_pi(qubit_type const qubit)
-    { do_y_rotation_half_pi(qubit); return *this; }
+    { do_y_rotation_half_pi(qubit); swap_pauli_frame_bits(qubit); return *this; }
 
     ::bra::state& adj_y_rotation_half_pi(qubit_type const qubit)
-    { do_adj_y_rotation_half_pi(qubit); return *this; }
+    { do_adj_y_rotation_half_pi(qubit); swap_pauli_frame_bits(qubit); return *this; }
 
     ::bra::state& controlled_not(
       qubit_type const target_qubit, control_qubit_type const control_qubit)
-    { do_controlled_not(target_qubit, control_qubit); return *this; }
+    {
+      do_controlled_not(target_qubit, control_qubit);
+      propagate_pauli_frame_through_controlled_not(target_qubit, control_qubit);
+      return *this;
+    }
 
     ::bra::state& adj_controlled_not(
       qubit_type const target_qubit, control_qubit_type const control_qubit)
-    { do_adj_controlled_not(target_qubit, control_qubit); return *this; }
+    {
+      do_adj_controlled_not(target_qubit, control_qubit);
+      propagate_pauli_frame_through_controlled_not(target_qubit, control_qubit);
+      return *this;
+    }
 
     ::bra::state& controlled_phase_shift(
       complex_type const phase_coefficient,
       qubit_type const target_qubit, control_qubit_type const control_qubit)
     {
+      apply_pauli_frame_if_noncommuting(qubit_mask(target_qubit) bitor qubit_mask(control_qubit.qubit()), state_integer_type{0u});
       do_controlled_phase_shift(phase_coefficient, target_qubit, control_qubit);
       return *this;
     }
@@ -245,6 +299,7 @@ namespace bra
       complex_type const phase_coefficient,
       qubit_type const target_qubit, control_qubit_type const control_qubit)
     {
+      apply_pauli_frame_if_noncommuting(qubit_mask(target_qubit) bitor qubit_mask(control_qubit.qubit()), state_integer_type{0u});
       do_adj_controlled_phase_shift(phase_coefficient, target_qubit, control_qubit);
       return *this;
     }
@@ -253,6 +308,8 @@ namespace bra
       complex_type const phase_coefficient,
       qubit_type const target_qubit, control_qubit_type const control_qubit)
     {
+      apply_pauli_frame_if_noncommuting(
+        qubit_mask(target_qubit) bitor qubit_mask(control_qubit.qubit()), qubit_mask(target_qubit));
       do_controlled_v(phase_coefficient, target_qubit, control_qubit);
       return *this;
     }
@@ -261,15 +318,20 @@ namespace bra
       complex_type const phase_coefficient,
       qubit_type const target_qubit, control_qubit_type const control_qubit)
     {
+      apply_pauli_frame_if_noncommuting(
+        qubit_mask(target_qubit) bitor qubit_mask(control_qubit.qubit()), qubit_mask(target_qubit));
       do_adj_controlled_v(phase_coefficient, target_qubit, control_qubit);
       return *this;
     }
 
+    // X on the target qubit commutes with the Toffoli gate
     ::bra::state& toffoli(
       qubit_type const target_qubit,
       control_qubit_type const control_qubit1,
       control_qubit_type const control_qubit2)
     {
+      apply_pauli_frame_if_noncommuting(
+        qubit_mask(control_qubit1.qubit()) bitor qubit_mask(control_qubit2.qubit()), qubit_mask(target_qubit));
       do_toffoli(target_qubit, control_qubit1, control_qubit2);
       return *this;
     }
@@ -279,10 +341,36 @@ namespace bra
       control_qubit_type const control_qubit1,
       control_qubit_type const control_qubit2)
     {
+      apply_pauli_frame_if_noncommuting(
+        qubit_mask(control_qubit1.qubit()) bitor qubit_mask(control_qubit2.qubit()), qubit_mask(target_qubit));
       do_adj_toffoli(target_qubit, control_qubit1, control_qubit2);
       return *this;
     }
 
+    ::bra::state& unitary(
+      std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits)
+    {
+      auto const mask = qubits_mask(qubits);
+      apply_pauli_frame_if_noncommuting(mask, mask);
+      do_unitary(matrix, qubits);
+      return *this;
+    }
+
+    ::bra::state& cache_blocked_unitaries(
+      std::vector<std::vector<complex_type>> const& matrices,
+      std::vector<std::vector<qubit_type>> const& qubits_list,
+      bit_integer_type const num_block_qubits);
+
+    ::bra::state& diagonal(
+      std::vector<std::vector<complex_type>> const& diagonals,
+      std::vector<std::vector<qubit_type>> const& qubits_list);
+
+    // makes nonlocal_qubits[i] local by exchanging it with evicted_qubits[i]. Pairs whose qubits are not nonlocal and
+    // local respectively at that time are ignored. This does nothing for states without MPI
+    ::bra::state& remap_qubits(
+      std::vector<qubit_type> const& nonlocal_qubits, std::vector<qubit_type> const& evicted_qubits)
+    { do_remap_qubits(nonlocal_qubits, evicted_qubits); return *this; }
+
 # ifndef BRA_NO_MPI
     ::bra::state& projective_measurement(qubit_type const qubit, yampi::rank const root);
 
@@ -301,17 +389,36 @@ namespace bra
     ::bra::state& exit();
 # endif // BRA_NO_MPI
 
+    ::bra::state& expectation_value(std::vector<pauli_term_type> const& pauli_terms);
+
     ::bra::state& shor_box(bit_integer_type const num_exponent_qubits, state_integer_type const divisor, state_integer_type const base);
 
     ::bra::state& clear(qubit_type const qubit)
-    { do_clear(qubit); return *this; }
+    { apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit)); do_clear(qubit); return *this; }
 
     ::bra::state& set(qubit_type const qubit)
-    { do_set(qubit); return *this; }
+    { apply_pauli_frame_if_noncommuting(qubit_mask(qubit), qubit_mask(qubit)); do_set(qubit); return *this; }
 
+    // replaces the state with the stabilizer state of tableau, which is expanded into amplitudes by one sweep
+    ::bra::state& assign_stabilizer_state(::bra::stabilizer_tableau const& tableau);
+
+    // the Pauli errors are not applied to the state immediately, but recorded in the Pauli frame
     ::bra::state& depolarizing_channel(real_type const px, real_type const py, real_type const pz, int const seed);
 
    private:
+    static state_integer_type qubit_mask(qubit_type const qubit)
+    { return ket::utility::integer_exp2<state_integer_type>(qubit); }
+    static state_integer_type qubits_mask(std::vector<qubit_type> const& qubits);
+
+    // The Pauli frame P is kept behind Clifford gates G by replacing P with G P G^dagger, and is applied to the state
+    // by one sweep before an operation which may not commute with it
+    void apply_pauli_frame();
+    // applies the Pauli frame if it has X's on the qubits of x_mask or Z's on those of z_mask
+    void apply_pauli_frame_if_noncommuting(state_integer_type const x_mask, state_integer_type const z_mask);
+    // H and (1 +- iY)/sqrt(2) exchange X and Z up to signs
+    void swap_pauli_frame_bits(qubit_type const qubit);
+    void propagate_pauli_frame_through_controlled_not(qubit_type const target_qubit, control_qubit_type const control_qubit);
+
 # ifndef BRA_NO_MPI
     virtual unsigned int do_num_page_qubits() const = 0;
     virtual unsigned int do_num_pages() const = 0;
@@ -379,6 +486,19 @@ namespace bra
       control_qubit_type const control_qubit1,
       control_qubit_type const control_qubit2)
       = 0;
+    virtual void do_unitary(
+      std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits) = 0;
+    virtual void do_cache_blocked_unitaries(
+      std::vector<std::vector<complex_type>> const& matrices,
+      std::vector<std::vector<qubit_type>> const& qubits_list,
+      bit_integer_type const num_block_qubits) = 0;
+    virtual void do_diagonal(
+      std::vector<std::vector<complex_type>> const& diagonals,
+      std::vector<std::vector<qubit_type>> const& qubits_list) = 0;
+    virtual void do_remap_qubits(
+      std::vector<qubit_type> const& nonlocal_qubits, std::vector<qubit_type> const& evicted_qubits) = 0;
+    // applies X^x_mask Z^z_mask up to a global phase
+    virtual void do_pauli_string(state_integer_type const x_mask, state_integer_type const z_mask) = 0;
 # ifndef BRA_NO_MPI
     virtual ket::gate::outcome do_projective_measurement(
       qubit_type const qubit, yampi::rank const root) = 0;
@@ -391,12 +511,14 @@ namespace bra
     virtual void do_measure() = 0;
     virtual void do_generate_events(int const num_events, int const seed) = 0;
 # endif // BRA_NO_MPI
+    virtual real_type do_expectation_value(std::vector<pauli_term_type> const& pauli_terms) = 0;
     virtual void do_shor_box(
       state_integer_type const divisor, state_integer_type const base,
       std::vector<qubit_type> const& exponent_qubits,
       std::vector<qubit_type> const& modular_exponentiation_qubits) = 0;
     virtual void do_clear(qubit_type const qubit) = 0;
     virtual void do_set(qubit_type const qubit) = 0;
+    virtual void do_assign_stabilizer_state(::bra::stabilizer_tableau const& tableau) = 0;
   }; // class state
 } // namespace bra
 
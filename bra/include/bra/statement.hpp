@@ -0,0 +1,55 @@
+#ifndef BRA_STATEMENT_HPP
+# define BRA_STATEMENT_HPP
+
+# include <cstdint>
+
+
+namespace bra
+{
+  // Statements of .qcx files. Operands of each opcode are listed in order; qubits, exponents and other integers are
+  // integer operands, and phases and probabilities are real ones
+  enum class opcode : std::uint32_t
+  {
+    qubits, // num_qubits
+    initial_state, // initial_state_value
+    mpi_buffer_size, // mpi_buffer_size
+    bit_assignment, // permutated qubits of qubits 0, 1, ...
+    hadamard, pauli_x, pauli_y, pauli_z, s_gate, adj_s_gate, t_gate, adj_t_gate, // target
+    u1, // target, phase
+    u2, // target, phase1, phase2
+    u3, // target, phase1, phase2, phase3
+    phase_shift, adj_phase_shift, // target, phase_exponent
+    x_rotation_half_pi, adj_x_rotation_half_pi, y_rotation_half_pi, adj_y_rotation_half_pi, // target
+    controlled_not, // control, target
+    controlled_phase_shift, adj_controlled_phase_shift, controlled_v, adj_controlled_v, // control, target, phase_exponent
+    toffoli, // control1, control2, target
+    projective_measurement, // target
+    shor_box, // num_exponent_qubits, divisor, base
+    measurement, //
+    generate_events, // num_events, seed
+    clear, set, // target
+    depolarizing_channel, // px, py, pz, seed
+    expectation_value, // coefficient, x_mask, z_mask of each Pauli term
+    exit //
+  }; // enum class opcode
+
+  union operand
+  {
+    std::int64_t integer;
+    double real;
+  }; // union operand
+
+  // Compiled .qcx files are compiled_qcx_magic followed by statements, each of which is a statement_header followed by
+  // its num_operands operands. All of them are 8-byte aligned and native-endian, so that statements are read directly
+  // from the memory mapping of the file
+  constexpr std::uint64_t compiled_qcx_magic = UINT64_C(0x3158435141524200); // "\0BRAQCX1" in little endian
+
+  struct statement_header
+  {
+    ::bra::opcode opcode;
+    std::uint32_t num_operands;
+  }; // struct statement_header
+} // namespace bra
+
+
+#endif // BRA_STATEMENT_HPP
@@ -0,0 +1,69 @@
+#ifndef BRA_TRACER_HPP
+# define BRA_TRACER_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+# include <chrono>
+# include <iosfwd>
+
+# ifndef BRA_NO_MPI
+#   include <yampi/rank.hpp>
+#   include <yampi/communicator.hpp>
+#   include <yampi/environment.hpp>
+# endif // BRA_NO_MPI
+
+
+namespace bra
+{
+  class gates;
+
+  struct trace_event
+  {
+    std::size_t gate_index;
+    double start_time; // seconds since the tracer was constructed
+    double end_time;
+    std::uint64_t num_sent_bytes; // bytes of amplitudes sent to other processes (see ket::mpi::utility::num_sent_bytes)
+  }; // struct trace_event
+
+  // ring buffer of the events of the gates applied in this process, where the oldest events are overwritten if more
+  // than capacity events are recorded. Gates are applied by one thread in each process, so no lock is needed
+  class tracer
+  {
+    using clock_type = std::chrono::steady_clock;
+
+    std::vector< ::bra::trace_event > events_;
+    std::size_t num_recorded_events_;
+    clock_type::time_point initial_time_;
+
+   public:
+    explicit tracer(std::size_t const capacity);
+
+    double now() const
+    { return std::chrono::duration<double>(clock_type::now() - initial_time_).count(); }
+
+    void record(
+      std::size_t const gate_index, double const start_time, double const end_time, std::uint64_t const num_sent_bytes)
+    {
+      events_[num_recorded_events_ % events_.size()]
+        = ::bra::trace_event{gate_index, start_time, end_time, num_sent_bytes};
+      ++num_recorded_events_;
+    }
+
+    // the kept events, from the oldest one to the latest one
+    std::vector< ::bra::trace_event > events() const;
+
+    // writes the events of all processes in the Chrome trace event format (chrome://tracing, Perfetto), where pid is
+    // the rank of each process. gates must be the gates whose program was traced. Only root writes into output_stream
+# ifndef BRA_NO_MPI
+    void write(
+      std::ostream& output_stream, ::bra::gates const& gates,
+      yampi::rank const root, yampi::communicator const& communicator, yampi::environment const& environment) const;
+# else // BRA_NO_MPI
+    void write(std::ostream& output_stream, ::bra::gates const& gates) const;
+# endif // BRA_NO_MPI
+  }; // class tracer
+} // namespace bra
+
+
+#endif // BRA_TRACER_HPP
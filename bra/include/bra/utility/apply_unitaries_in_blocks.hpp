@@ -0,0 +1,91 @@
+#ifndef BRA_UTILITY_APPLY_UNITARIES_IN_BLOCKS_HPP
+# define BRA_UTILITY_APPLY_UNITARIES_IN_BLOCKS_HPP
+
+# include <cstddef>
+# include <vector>
+# include <algorithm>
+# include <iterator>
+
+# ifndef BRA_NO_MPI
+#   include <yampi/communicator.hpp>
+#   include <yampi/environment.hpp>
+# endif // BRA_NO_MPI
+
+# include <ket/gate/unitary.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/for_each_block.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# ifndef BRA_NO_MPI
+#   include <ket/mpi/utility/for_each_local_range.hpp>
+# endif // BRA_NO_MPI
+
+# include <bra/utility/call_with_qubit_array.hpp>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // applies all of matrices to one block of 2^num_block_qubits amplitudes after another.
+    // Every qubit in qubits_list should be lower than num_block_qubits
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator,
+      typename Complex, typename Qubit, typename BitInteger>
+    void apply_unitaries_in_blocks(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      std::vector<std::vector<Complex>> const& matrices,
+      std::vector<std::vector<Qubit>> const& qubits_list,
+      BitInteger const num_block_qubits)
+    {
+      ::ket::utility::for_each_block(
+        parallel_policy, first, last, num_block_qubits,
+        [&matrices, &qubits_list](RandomAccessIterator const block_first, RandomAccessIterator const block_last)
+        {
+          for (auto index = std::size_t{0u}; index < matrices.size(); ++index)
+            ::bra::utility::call_with_qubit_array(
+              qubits_list[index],
+              [block_first, block_last, &matrices, index](auto const& qubit_array)
+              {
+                ::ket::gate::unitary(
+                  ::ket::utility::policy::make_sequential(),
+                  block_first, block_last, matrices[index], qubit_array);
+              });
+        });
+    }
+
+# ifndef BRA_NO_MPI
+    // returns true if every (permutated) qubit in permutated_qubits_list is lower than num_block_qubits and
+    // lies within every local range, that is, the gates can be applied in blocks without any communication
+    template <typename MpiPolicy, typename LocalState, typename Qubit, typename BitInteger>
+    bool are_in_local_blocks(
+      MpiPolicy const& mpi_policy, LocalState const& local_state,
+      std::vector<std::vector<Qubit>> const& permutated_qubits_list,
+      BitInteger const num_block_qubits,
+      yampi::communicator const& communicator, yampi::environment const& environment)
+    {
+      auto min_range_size = std::size_t{0u};
+      auto is_first_range = true;
+      ::ket::mpi::utility::for_each_local_range(
+        mpi_policy, local_state, communicator, environment,
+        [&min_range_size, &is_first_range](auto const first, auto const last)
+        {
+          auto const range_size = static_cast<std::size_t>(last - first);
+          min_range_size = is_first_range ? range_size : std::min(min_range_size, range_size);
+          is_first_range = false;
+        });
+
+      for (auto const& permutated_qubits: permutated_qubits_list)
+        for (auto const permutated_qubit: permutated_qubits)
+          if (static_cast<BitInteger>(permutated_qubit) >= num_block_qubits
+              or ::ket::utility::integer_exp2<std::size_t>(permutated_qubit) >= min_range_size)
+            return false;
+
+      return true;
+    }
+# endif // BRA_NO_MPI
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_APPLY_UNITARIES_IN_BLOCKS_HPP
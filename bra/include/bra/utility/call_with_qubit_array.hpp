@@ -0,0 +1,48 @@
+#ifndef BRA_UTILITY_CALL_WITH_QUBIT_ARRAY_HPP
+# define BRA_UTILITY_CALL_WITH_QUBIT_ARRAY_HPP
+
+# include <vector>
+# include <array>
+# include <stdexcept>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // ket::gate::unitary takes qubits as std::array, whose size is known at compile time.
+    // function(qubit_array) is called with std::array having the same elements as qubits
+    template <typename Qubit, typename Allocator, typename Function>
+    void call_with_qubit_array(std::vector<Qubit, Allocator> const& qubits, Function&& function)
+    {
+      switch (qubits.size())
+      {
+       case 1u:
+        function(std::array<Qubit, 1u>{qubits[0u]});
+        break;
+
+       case 2u:
+        function(std::array<Qubit, 2u>{qubits[0u], qubits[1u]});
+        break;
+
+       case 3u:
+        function(std::array<Qubit, 3u>{qubits[0u], qubits[1u], qubits[2u]});
+        break;
+
+       case 4u:
+        function(std::array<Qubit, 4u>{qubits[0u], qubits[1u], qubits[2u], qubits[3u]});
+        break;
+
+       case 5u:
+        function(std::array<Qubit, 5u>{qubits[0u], qubits[1u], qubits[2u], qubits[3u], qubits[4u]});
+        break;
+
+       default:
+        throw std::runtime_error{"unitary gates on more than five qubits are not supported"};
+      }
+    }
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_CALL_WITH_QUBIT_ARRAY_HPP
@@ -0,0 +1,76 @@
+#ifndef BRA_UTILITY_DIAGONAL_COEFFICIENTS_HPP
+# define BRA_UTILITY_DIAGONAL_COEFFICIENTS_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <vector>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // diagonal_coefficients(index) is the product of diagonals[i][j] over all i, where the k-th bit of j is
+    // the (bit_positions_list[i][k])-th bit of index. Each of diagonals is a small lookup table, so that
+    // a run of diagonal gates on many qubits costs a few table lookups per amplitude
+    template <typename Complex, typename StateInteger>
+    class diagonal_coefficients
+    {
+      std::vector<Complex> tables_;
+      std::vector<std::size_t> table_offsets_;
+      std::vector<unsigned int> bit_positions_;
+      std::vector<std::size_t> bit_position_offsets_;
+
+     public:
+      template <typename Qubit>
+      diagonal_coefficients(
+        std::vector<std::vector<Complex>> const& diagonals,
+        std::vector<std::vector<Qubit>> const& bit_positions_list)
+      {
+        assert(diagonals.size() == bit_positions_list.size());
+
+        table_offsets_.reserve(diagonals.size() + 1u);
+        bit_position_offsets_.reserve(diagonals.size() + 1u);
+        table_offsets_.push_back(std::size_t{0u});
+        bit_position_offsets_.push_back(std::size_t{0u});
+
+        for (auto index = std::size_t{0u}; index < diagonals.size(); ++index)
+        {
+          assert(diagonals[index].size() == (std::size_t{1u} << bit_positions_list[index].size()));
+
+          tables_.insert(tables_.end(), diagonals[index].begin(), diagonals[index].end());
+          table_offsets_.push_back(tables_.size());
+
+          for (auto const bit_position: bit_positions_list[index])
+            bit_positions_.push_back(static_cast<unsigned int>(bit_position));
+          bit_position_offsets_.push_back(bit_positions_.size());
+        }
+      }
+
+      template <typename Index>
+      Complex operator()(Index const index) const
+      {
+        auto const state_integer = static_cast<StateInteger>(index);
+
+        auto result = Complex{1};
+        for (auto table_index = std::size_t{0u}; table_index + 1u < table_offsets_.size(); ++table_index)
+        {
+          auto table_element_index = std::size_t{0u};
+          auto const first = bit_position_offsets_[table_index];
+          auto const last = bit_position_offsets_[table_index + 1u];
+          for (auto position_index = first; position_index < last; ++position_index)
+            table_element_index
+              |= static_cast<std::size_t>((state_integer >> bit_positions_[position_index]) bitand StateInteger{1u})
+                 << (position_index - first);
+
+          result *= tables_[table_offsets_[table_index] + table_element_index];
+        }
+
+        return result;
+      }
+    }; // class diagonal_coefficients<Complex, StateInteger>
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_DIAGONAL_COEFFICIENTS_HPP
@@ -0,0 +1,40 @@
+#ifndef BRA_UTILITY_MAKE_GATE_MATRIX_HPP
+# define BRA_UTILITY_MAKE_GATE_MATRIX_HPP
+
+# include <cstddef>
+# include <vector>
+# include <algorithm>
+
+# include <ket/utility/integer_exp2.hpp>
+
+
+namespace bra
+{
+  namespace utility
+  {
+    // apply_gate(column) applies a gate on qubits 0, 1, ..., num_qubits-1 of column. The i-th column of
+    // the resulting (row-major) matrix is obtained by applying the gate to the i-th computational basis state
+    template <typename Complex, typename Function>
+    std::vector<Complex> make_gate_matrix(unsigned int const num_qubits, Function&& apply_gate)
+    {
+      auto const num_indices = ::ket::utility::integer_exp2<std::size_t>(num_qubits);
+      auto result = std::vector<Complex>(num_indices * num_indices);
+
+      auto column = std::vector<Complex>(num_indices);
+      for (auto column_index = std::size_t{0u}; column_index < num_indices; ++column_index)
+      {
+        std::fill(column.begin(), column.end(), Complex{});
+        column[column_index] = Complex{1};
+        apply_gate(column);
+
+        for (auto row_index = std::size_t{0u}; row_index < num_indices; ++row_index)
+          result[row_index * num_indices + column_index] = column[row_index];
+      }
+
+      return result;
+    }
+  } // namespace utility
+} // namespace bra
+
+
+#endif // BRA_UTILITY_MAKE_GATE_MATRIX_HPP
@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/pauli_y.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_pauli_y.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -32,5 +34,17 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    adj_pauli_y::qubits_type adj_pauli_y::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    adj_pauli_y::matrix_type adj_pauli_y::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::adj_pauli_y(column, qubit_type{0u}); });
+    }
+
+    ::bra::instruction adj_pauli_y::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::adj_pauli_y, qubit_); }
   } // namespace gate
 } // namespace bra
@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/phase_shift.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_phase_shift.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -35,5 +37,26 @@ namespace bra
         << std::setw(parameter_width) << phase_exponent_;
       return repr_stream.str();
     }
+
+    adj_phase_shift::qubits_type adj_phase_shift::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    adj_phase_shift::matrix_type adj_phase_shift::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::adj_phase_shift_coeff(column, phase_coefficient_, qubit_type{0u}); });
+    }
+
+    adj_phase_shift::qubits_type adj_phase_shift::do_local_qubits() const
+    {
+#ifdef KET_USE_DIAGONAL_LOOP
+      return {};
+#else // KET_USE_DIAGONAL_LOOP
+      return do_fusible_qubits();
+#endif // KET_USE_DIAGONAL_LOOP
+    }
+
+    ::bra::instruction adj_phase_shift::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::adj_phase_shift, phase_coefficient_, qubit_); }
   } // namespace gate
 } // namespace bra
@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/phase_shift.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_t_gate.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -33,5 +35,26 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    adj_t_gate::qubits_type adj_t_gate::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    adj_t_gate::matrix_type adj_t_gate::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::adj_phase_shift_coeff(column, phase_coefficient_, qubit_type{0u}); });
+    }
+
+    adj_t_gate::qubits_type adj_t_gate::do_local_qubits() const
+    {
+#ifdef KET_USE_DIAGONAL_LOOP
+      return {};
+#else // KET_USE_DIAGONAL_LOOP
+      return do_fusible_qubits();
+#endif // KET_USE_DIAGONAL_LOOP
+    }
+
+    ::bra::instruction adj_t_gate::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::adj_phase_shift, phase_coefficient_, qubit_); }
   } // namespace gate
 } // namespace bra
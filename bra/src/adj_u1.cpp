@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/phase_shift.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_u1.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -34,5 +36,26 @@ namespace bra
         << std::setw(parameter_width) << phase_;
       return repr_stream.str();
     }
+
+    adj_u1::qubits_type adj_u1::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    adj_u1::matrix_type adj_u1::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::adj_phase_shift(column, phase_, qubit_type{0u}); });
+    }
+
+    adj_u1::qubits_type adj_u1::do_local_qubits() const
+    {
+#ifdef KET_USE_DIAGONAL_LOOP
+      return {};
+#else // KET_USE_DIAGONAL_LOOP
+      return do_fusible_qubits();
+#endif // KET_USE_DIAGONAL_LOOP
+    }
+
+    ::bra::instruction adj_u1::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::adj_u1, {phase_, real_type{}, real_type{}}, qubit_); }
   } // namespace gate
 } // namespace bra
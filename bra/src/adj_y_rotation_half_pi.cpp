@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/y_rotation_half_pi.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/adj_y_rotation_half_pi.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -32,5 +34,17 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    adj_y_rotation_half_pi::qubits_type adj_y_rotation_half_pi::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    adj_y_rotation_half_pi::matrix_type adj_y_rotation_half_pi::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::adj_y_rotation_half_pi(column, qubit_type{0u}); });
+    }
+
+    ::bra::instruction adj_y_rotation_half_pi::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::adj_y_rotation_half_pi, qubit_); }
   } // namespace gate
 } // namespace bra
@@ -1,8 +1,10 @@
 #include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <utility>
+#include <memory>
 #include <random>
 #include <chrono>
 
@@ -22,6 +24,13 @@
 
 #include <bra/gates.hpp>
 #include <bra/state.hpp>
+#include <bra/stabilizer_tableau.hpp>
+#include <bra/statement.hpp>
+#include <bra/mapped_file.hpp>
+#include <bra/program.hpp>
+#ifdef BRA_TRACE_CAPACITY
+# include <bra/tracer.hpp>
+#endif // BRA_TRACE_CAPACITY
 #ifndef BRA_NO_MPI
 # include <bra/make_general_mpi_state.hpp>
 # include <bra/make_unit_mpi_state.hpp>
@@ -35,6 +44,14 @@
 # define BRA_clock std::chrono::system_clock
 #endif // BRA_NO_MPI
 
+// Gates of compiled .qcx files are lowered into bra::program while the files are read, without gate objects, unless
+// passes over gates or the tracer need them
+#if !defined(BRA_USE_GATE_SIMPLIFICATION) && !defined(BRA_USE_CLIFFORD_PREFIX) \
+  && !defined(BRA_MAX_NUM_DIAGONAL_TABLE_QUBITS) && !defined(BRA_MAX_NUM_FUSED_QUBITS) \
+  && !defined(BRA_NUM_CACHE_BLOCK_QUBITS) && !defined(BRA_MAX_NUM_REMAPPED_QUBITS) && !defined(BRA_TRACE_CAPACITY)
+# define BRA_LOWER_COMPILED_GATES
+#endif
+
 
 template <typename StateInteger, typename BitInteger>
 std::string integer_to_bits_string(StateInteger const integer, BitInteger const total_num_qubits)
@@ -68,10 +85,12 @@ std::string error_message(std::string const& error)
   return
     error + ": bra general <qcxfile> [<num_threads_per_process> [<num_page_qubits> [<seed>]]]\n"
     + tab_like_spaces + "bra unit <qcxfile> <num_unit_qubits> <num_processes_per_unit> [<num_threads_per_process> [<num_page_qubits> [<seed>]]]\n"
+    + tab_like_spaces + "bra compile <qcxfile> <compiled_qcxfile>\n"
     + "  default values are: num_threads_per_process=1, num_page_qubits=2, seed=1\n";
 #else // BRA_NO_MPI
   return
     error + ": bra qcxfile [num_threads_per_process [seed]]\n"
+    + std::string(error.size() + 2u, ' ') + "bra compile qcxfile compiled_qcxfile\n"
     + "  default values are: num_threads_per_process=1, seed=1\n";
 #endif // BRA_NO_MPI
 }
@@ -98,6 +117,37 @@ int main(int argc, char* argv[])
   }
 #endif // BRA_NO_MPI
 
+  // bra compile <qcxfile> <compiled_qcxfile>: compiled .qcx files are given to bra instead of .qcx files
+  if (argc >= 2 and std::string{argv[1]} == "compile")
+  {
+#ifndef BRA_NO_MPI
+    if (not is_io_root_rank)
+      return argc == 4 ? EXIT_SUCCESS : EXIT_FAILURE;
+#endif // BRA_NO_MPI
+    if (argc != 4)
+    {
+      std::cerr << error_message("wrong number of arguments") << std::flush;
+      return EXIT_FAILURE;
+    }
+
+    auto input_stream = std::ifstream{argv[2]};
+    if (!input_stream)
+    {
+      std::cerr << "cannot open an input file " << argv[2] << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    auto output_stream = std::ofstream{argv[3], std::ios::binary};
+    if (!output_stream)
+    {
+      std::cerr << "cannot open an output file " << argv[3] << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    bra::gates::compile(input_stream, output_stream);
+    return EXIT_SUCCESS;
+  }
+
 #ifndef BRA_NO_MPI
   if (argc < 3 or argc > 8)
   {
@@ -207,8 +257,31 @@ int main(int argc, char* argv[])
     return EXIT_FAILURE;
   }
 
+  // compiled .qcx files are mapped to memory instead of being parsed
+  auto magic = std::uint64_t{};
+  auto const is_compiled
+    = file_stream.read(reinterpret_cast<char*>(std::addressof(magic)), sizeof(magic))
+      and magic == bra::compiled_qcx_magic;
+  file_stream.clear();
+  file_stream.seekg(0);
+
+#ifdef BRA_LOWER_COMPILED_GATES
+  auto compiled_program = bra::program{};
+#endif // BRA_LOWER_COMPILED_GATES
 #ifndef BRA_NO_MPI
-  auto gates = bra::gates{file_stream, num_unit_qubits, num_processes_per_unit, environment, root_rank, communicator};
+# ifdef BRA_LOWER_COMPILED_GATES
+  auto gates
+    = is_compiled
+      ? bra::gates{
+          bra::mapped_file{filename}, compiled_program,
+          num_unit_qubits, num_processes_per_unit, environment, root_rank, communicator}
+      : bra::gates{file_stream, num_unit_qubits, num_processes_per_unit, environment, root_rank, communicator};
+# else // BRA_LOWER_COMPILED_GATES
+  auto gates
+    = is_compiled
+      ? bra::gates{bra::mapped_file{filename}, num_unit_qubits, num_processes_per_unit, environment, root_rank, communicator}
+      : bra::gates{file_stream, num_unit_qubits, num_processes_per_unit, environment, root_rank, communicator};
+# endif // BRA_LOWER_COMPILED_GATES
   auto state_ptr
     = mpi_policy_string == "unit"
       ? bra::make_unit_mpi_state(
@@ -217,12 +290,52 @@ int main(int argc, char* argv[])
       : bra::make_general_mpi_state(
           num_page_qubits, gates.initial_state_value(), gates.num_lqubits(), gates.initial_permutation(),
           num_threads_per_process, seed, communicator, environment);
+  state_ptr->mpi_buffer_size(gates.mpi_buffer_size());
 #else // BRA_NO_MPI
-  auto gates = bra::gates{file_stream};
+# ifdef BRA_LOWER_COMPILED_GATES
+  auto gates = is_compiled ? bra::gates{bra::mapped_file{filename}, compiled_program} : bra::gates{file_stream};
+# else // BRA_LOWER_COMPILED_GATES
+  auto gates = is_compiled ? bra::gates{bra::mapped_file{filename}} : bra::gates{file_stream};
+# endif // BRA_LOWER_COMPILED_GATES
   auto state_ptr
     = bra::make_nompi_state(gates.initial_state_value(), gates.num_qubits(), num_threads, seed);
 #endif // BRA_NO_MPI
 
+#ifdef BRA_USE_GATE_SIMPLIFICATION
+  auto const num_unsimplified_gates = gates.size();
+  auto const num_removed_gates = gates.simplify();
+# ifndef BRA_NO_MPI
+  if (is_io_root_rank)
+# endif // BRA_NO_MPI
+    std::cout
+      << "Gates simplified: " << num_unsimplified_gates << " -> " << gates.size()
+      << " (" << num_removed_gates << " removed)" << std::endl;
+#endif // BRA_USE_GATE_SIMPLIFICATION
+#ifdef BRA_USE_CLIFFORD_PREFIX
+  auto clifford_prefix_tableau = bra::stabilizer_tableau{gates.initial_state_value(), gates.num_qubits()};
+  auto const num_clifford_prefix_gates = gates.extract_clifford_prefix(clifford_prefix_tableau);
+#endif // BRA_USE_CLIFFORD_PREFIX
+#ifdef BRA_MAX_NUM_DIAGONAL_TABLE_QUBITS
+  gates.merge_diagonals(BRA_MAX_NUM_DIAGONAL_TABLE_QUBITS);
+#endif // BRA_MAX_NUM_DIAGONAL_TABLE_QUBITS
+#ifdef BRA_MAX_NUM_FUSED_QUBITS
+  gates.fuse(BRA_MAX_NUM_FUSED_QUBITS);
+#endif // BRA_MAX_NUM_FUSED_QUBITS
+#ifdef BRA_NUM_CACHE_BLOCK_QUBITS
+  gates.block(BRA_NUM_CACHE_BLOCK_QUBITS);
+#endif // BRA_NUM_CACHE_BLOCK_QUBITS
+#if !defined(BRA_NO_MPI) && defined(BRA_MAX_NUM_REMAPPED_QUBITS)
+  gates.plan_qubit_remapping(BRA_MAX_NUM_REMAPPED_QUBITS);
+#endif // !defined(BRA_NO_MPI) && defined(BRA_MAX_NUM_REMAPPED_QUBITS)
+#ifdef BRA_LOWER_COMPILED_GATES
+  auto const program = is_compiled ? std::move(compiled_program) : bra::program{gates};
+#else // BRA_LOWER_COMPILED_GATES
+  auto const program = bra::program{gates};
+#endif // BRA_LOWER_COMPILED_GATES
+#ifdef BRA_TRACE_CAPACITY
+  auto tracer = bra::tracer{BRA_TRACE_CAPACITY};
+#endif // BRA_TRACE_CAPACITY
+
 #ifndef BRA_NO_MPI
   auto const start_time = BRA_clock::now(environment);
 #else
@@ -230,7 +343,24 @@ int main(int argc, char* argv[])
 #endif
   auto last_processed_time = start_time;
 
-  *state_ptr << gates;
+#ifdef BRA_USE_CLIFFORD_PREFIX
+  if (num_clifford_prefix_gates > decltype(num_clifford_prefix_gates){0u})
+    state_ptr->assign_stabilizer_state(clifford_prefix_tableau);
+#endif // BRA_USE_CLIFFORD_PREFIX
+#ifdef BRA_TRACE_CAPACITY
+  program.apply(*state_ptr, tracer);
+
+  // the events of the last BRA_TRACE_CAPACITY gates in each process are written into <qcxfile>.trace.json
+# ifndef BRA_NO_MPI
+  auto trace_stream = is_io_root_rank ? std::ofstream{(filename + ".trace.json").c_str()} : std::ofstream{};
+  tracer.write(trace_stream, gates, root_rank, communicator, environment);
+# else // BRA_NO_MPI
+  auto trace_stream = std::ofstream{(filename + ".trace.json").c_str()};
+  tracer.write(trace_stream, gates);
+# endif // BRA_NO_MPI
+#else // BRA_TRACE_CAPACITY
+  *state_ptr << program;
+#endif // BRA_TRACE_CAPACITY
 
 #ifndef BRA_NO_MPI
   if (not is_io_root_rank)
@@ -238,6 +368,7 @@ int main(int argc, char* argv[])
 #endif
 
   auto const num_finish_processes = state_ptr->num_finish_processes();
+  auto observable_index = std::size_t{0u};
   for (auto index = decltype(num_finish_processes){0u}; index < num_finish_processes; ++index)
   {
     auto finish_time_and_process = state_ptr->finish_time_and_process(index);
@@ -273,6 +404,18 @@ int main(int argc, char* argv[])
         << std::endl;
       last_processed_time = finish_time_and_process.first;
     }
+    else if (finish_time_and_process.second == ::bra::finished_process::expectation_value)
+    {
+      std::cout
+        << "Expectation value: " << state_ptr->observable_expectation_values()[observable_index++]
+        << "\nExpectation value finished: "
+        << duration_to_second(start_time, finish_time_and_process.first)
+        << " ("
+        << duration_to_second(last_processed_time, finish_time_and_process.first)
+        << ')'
+        << std::endl;
+      last_processed_time = finish_time_and_process.first;
+    }
     else if (finish_time_and_process.second == ::bra::finished_process::ket_measure)
     {
       std::cout
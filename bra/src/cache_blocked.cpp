@@ -0,0 +1,64 @@
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/cache_blocked.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const cache_blocked::name_ = "BLOCK";
+
+    cache_blocked::cache_blocked(
+      std::vector<matrix_type>&& matrices, std::vector<qubits_type>&& qubits_list,
+      bit_integer_type const num_block_qubits)
+      : ::bra::gate::gate{},
+        matrices_{std::move(matrices)}, qubits_list_{std::move(qubits_list)},
+        num_block_qubits_{num_block_qubits}
+    { }
+
+    ::bra::state& cache_blocked::do_apply(::bra::state& state) const
+    { return state.cache_blocked_unitaries(matrices_, qubits_list_, num_block_qubits_); }
+
+    std::string const& cache_blocked::do_name() const { return name_; }
+    std::string cache_blocked::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream
+        << std::right
+        << std::setw(parameter_width) << num_block_qubits_
+        << std::setw(parameter_width) << matrices_.size();
+      return repr_stream.str();
+    }
+
+    cache_blocked::qubits_type cache_blocked::do_local_qubits() const
+    {
+      auto result = qubits_type{};
+      for (auto const& qubits: qubits_list_)
+        for (auto const qubit: qubits)
+          if (std::find(std::begin(result), std::end(result), qubit) == std::end(result))
+            result.push_back(qubit);
+
+      return result;
+    }
+
+    ::bra::instruction cache_blocked::do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+    {
+      auto operands = ::bra::instruction_operands{};
+      operands.matrices = matrices_;
+      operands.qubits_list = qubits_list_;
+      auto result
+        = ::bra::make_instruction(::bra::instruction_code::cache_blocked_unitaries, std::move(operands), operands_list);
+      result.integers[0u] = num_block_qubits_;
+      return result;
+    }
+  } // namespace gate
+} // namespace bra
@@ -5,10 +5,12 @@
 
 #include <ket/qubit_io.hpp>
 #include <ket/control_io.hpp>
+#include <ket/gate/controlled_not.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/controlled_not.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -36,5 +38,17 @@ namespace bra
         << std::setw(parameter_width) << target_qubit_;
       return repr_stream.str();
     }
+
+    controlled_not::qubits_type controlled_not::do_fusible_qubits() const
+    { return {target_qubit_, control_qubit_.qubit()}; }
+
+    controlled_not::matrix_type controlled_not::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        2u, [this](matrix_type& column) { ::ket::gate::ranges::controlled_not(column, qubit_type{0u}, control_qubit_type{qubit_type{1u}}); });
+    }
+
+    ::bra::instruction controlled_not::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::controlled_not, target_qubit_, control_qubit_); }
   } // namespace gate
 } // namespace bra
@@ -5,10 +5,12 @@
 
 #include <ket/qubit_io.hpp>
 #include <ket/control_io.hpp>
+#include <ket/gate/controlled_v.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/controlled_v.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -41,5 +43,17 @@ namespace bra
         << std::setw(parameter_width) << phase_exponent_;
       return repr_stream.str();
     }
+
+    controlled_v::qubits_type controlled_v::do_fusible_qubits() const
+    { return {target_qubit_, control_qubit_.qubit()}; }
+
+    controlled_v::matrix_type controlled_v::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        2u, [this](matrix_type& column) { ::ket::gate::ranges::controlled_v_coeff(column, phase_coefficient_, qubit_type{0u}, control_qubit_type{qubit_type{1u}}); });
+    }
+
+    ::bra::instruction controlled_v::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::controlled_v, phase_coefficient_, target_qubit_, control_qubit_); }
   } // namespace gate
 } // namespace bra
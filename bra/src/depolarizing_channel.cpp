@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 #include <ios>
 #include <iomanip>
@@ -25,5 +26,13 @@ namespace bra
     std::string depolarizing_channel::do_representation(
       std::ostringstream& repr_stream, int const) const
     { return repr_stream.str(); }
+
+    ::bra::instruction depolarizing_channel::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    {
+      auto result = ::bra::make_instruction(::bra::instruction_code::depolarizing_channel);
+      result.phases = {px_, py_, pz_};
+      result.integers[0u] = static_cast<std::uint64_t>(seed_);
+      return result;
+    }
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,46 @@
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include <ket/qubit_io.hpp>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/diagonal.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const diagonal::name_ = "DIAGONAL";
+
+    diagonal::diagonal(std::vector<matrix_type>&& diagonals, std::vector<qubits_type>&& qubits_list)
+      : ::bra::gate::gate{}, diagonals_{std::move(diagonals)}, qubits_list_{std::move(qubits_list)}
+    { }
+
+    ::bra::state& diagonal::do_apply(::bra::state& state) const
+    { return state.diagonal(diagonals_, qubits_list_); }
+
+    std::string const& diagonal::do_name() const { return name_; }
+    std::string diagonal::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream << std::right;
+      for (auto const& qubits: qubits_list_)
+        for (auto const qubit: qubits)
+          repr_stream << std::setw(parameter_width) << qubit;
+      return repr_stream.str();
+    }
+
+    ::bra::instruction diagonal::do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+    {
+      auto operands = ::bra::instruction_operands{};
+      operands.matrices = diagonals_;
+      operands.qubits_list = qubits_list_;
+      return ::bra::make_instruction(::bra::instruction_code::diagonal, std::move(operands), operands_list);
+    }
+  } // namespace gate
+} // namespace bra
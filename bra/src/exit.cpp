@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 #include <ios>
 #include <iomanip>
@@ -38,5 +39,14 @@ namespace bra
     std::string exit::do_representation(
       std::ostringstream& repr_stream, int const) const
     { return repr_stream.str(); }
+
+    ::bra::instruction exit::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    {
+      auto result = ::bra::make_instruction(::bra::instruction_code::exit);
+#ifndef BRA_NO_MPI
+      result.integers[0u] = static_cast<std::uint64_t>(root_.mpi_rank());
+#endif // BRA_NO_MPI
+      return result;
+    }
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,38 @@
+#include <vector>
+#include <utility>
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/expectation_value.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const expectation_value::name_ = "EXPECTATION VALUE";
+
+    expectation_value::expectation_value(std::vector<pauli_term_type> const& pauli_terms)
+      : ::bra::gate::gate{}, pauli_terms_{pauli_terms}
+    { }
+
+    ::bra::state& expectation_value::do_apply(::bra::state& state) const
+    { return state.expectation_value(pauli_terms_); }
+
+    std::string const& expectation_value::do_name() const { return name_; }
+    std::string expectation_value::do_representation(
+      std::ostringstream& repr_stream, int const) const
+    { return repr_stream.str(); }
+
+    ::bra::instruction expectation_value::do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+    {
+      auto operands = ::bra::instruction_operands{};
+      operands.pauli_terms = pauli_terms_;
+      return ::bra::make_instruction(::bra::instruction_code::expectation_value, std::move(operands), operands_list);
+    }
+  } // namespace gate
+} // namespace bra
@@ -1,10 +1,20 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <complex>
 #include <istream>
+#include <ostream>
+#include <fstream>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <algorithm>
 #include <iterator>
+#include <functional>
+#include <vector>
 #include <memory>
+#include <limits>
 #include <stdexcept>
 # if __cplusplus >= 201703L
 #   include <type_traits>
@@ -35,6 +45,10 @@
 
 #include <bra/gates.hpp>
 #include <bra/state.hpp>
+#include <bra/statement.hpp>
+#include <bra/mapped_file.hpp>
+#include <bra/program.hpp>
+#include <bra/stabilizer_tableau.hpp>
 #include <bra/gate/gate.hpp>
 #include <bra/gate/hadamard.hpp>
 #include <bra/gate/pauli_x.hpp>
@@ -59,9 +73,14 @@
 #include <bra/gate/controlled_v.hpp>
 #include <bra/gate/adj_controlled_v.hpp>
 #include <bra/gate/toffoli.hpp>
+#include <bra/gate/unitary.hpp>
+#include <bra/gate/cache_blocked.hpp>
+#include <bra/gate/diagonal.hpp>
+#include <bra/gate/remap_qubits.hpp>
 #include <bra/gate/projective_measurement.hpp>
 #include <bra/gate/measurement.hpp>
 #include <bra/gate/generate_events.hpp>
+#include <bra/gate/expectation_value.hpp>
 #include <bra/gate/shor_box.hpp>
 #include <bra/gate/clear.hpp>
 #include <bra/gate/set.hpp>
@@ -99,6 +118,10 @@ namespace bra
     return result;
   }
 
+  wrong_compiled_qcx_error::wrong_compiled_qcx_error()
+    : std::runtime_error{"compiled qcx file is broken"}
+  { }
+
 #ifndef BRA_NO_MPI
   wrong_mpi_communicator_size_error::wrong_mpi_communicator_size_error()
     : std::runtime_error{"communicator size is wrong"}
@@ -108,12 +131,12 @@ namespace bra
 #ifndef BRA_NO_MPI
   gates::gates()
     : data_{}, num_qubits_{}, num_lqubits_{}, num_uqubits_{}, num_processes_per_unit_{1u},
-      initial_state_value_{}, initial_permutation_{}, phase_coefficients_{}, root_{}
+      initial_state_value_{}, initial_permutation_{}, mpi_buffer_size_{}, phase_coefficients_{}, root_{}
   { }
 
   gates::gates(gates::allocator_type const& allocator)
     : data_{allocator}, num_qubits_{}, num_lqubits_{}, num_uqubits_{}, num_processes_per_unit_{1u},
-      initial_state_value_{}, initial_permutation_{}, phase_coefficients_{}, root_{}
+      initial_state_value_{}, initial_permutation_{}, mpi_buffer_size_{}, phase_coefficients_{}, root_{}
   { }
 
   gates::gates(gates&& other, gates::allocator_type const& allocator)
@@ -124,6 +147,7 @@ namespace bra
         num_processes_per_unit_{std::move(other.num_processes_per_unit_)},
         initial_state_value_{std::move(other.initial_state_value_)},
         initial_permutation_{std::move(other.initial_permutation_)},
+        mpi_buffer_size_{std::move(other.mpi_buffer_size_)},
         phase_coefficients_{std::move(other.phase_coefficients_)},
         root_{std::move(other.root_)}
   { }
@@ -155,11 +179,38 @@ namespace bra
     size_type const num_reserved_gates)
     : data_{}, num_qubits_{}, num_lqubits_{},
       num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
-      initial_state_value_{}, initial_permutation_{}, phase_coefficients_{}, root_{root}
+      initial_state_value_{}, initial_permutation_{}, mpi_buffer_size_{}, phase_coefficients_{}, root_{root}
   {
     assert(num_processes_per_unit >= 1u);
     assign(input_stream, environment, communicator, num_reserved_gates);
   }
+
+  gates::gates(
+    ::bra::mapped_file const& compiled_file,
+    bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+    yampi::environment const& environment,
+    yampi::rank const root, yampi::communicator const& communicator,
+    size_type const num_reserved_gates)
+    : data_{}, num_qubits_{}, num_lqubits_{},
+      num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
+      initial_state_value_{}, initial_permutation_{}, mpi_buffer_size_{}, phase_coefficients_{}, root_{root}
+  {
+    assert(num_processes_per_unit >= 1u);
+    assign(compiled_file, environment, communicator, num_reserved_gates);
+  }
+
+  gates::gates(
+    ::bra::mapped_file const& compiled_file, ::bra::program& program,
+    bit_integer_type num_uqubits, unsigned int num_processes_per_unit,
+    yampi::environment const& environment,
+    yampi::rank const root, yampi::communicator const& communicator)
+    : data_{}, num_qubits_{}, num_lqubits_{},
+      num_uqubits_{num_uqubits}, num_processes_per_unit_{num_processes_per_unit},
+      initial_state_value_{}, initial_permutation_{}, mpi_buffer_size_{}, phase_coefficients_{}, root_{root}
+  {
+    assert(num_processes_per_unit >= 1u);
+    assign(compiled_file, program, environment, communicator);
+  }
 #else // BRA_NO_MPI
   gates::gates(std::istream& input_stream)
     : data_{}, num_qubits_{},
@@ -170,6 +221,21 @@ namespace bra
     : data_{}, num_qubits_{},
       initial_state_value_{}, phase_coefficients_{}
   { assign(input_stream, num_reserved_gates); }
+
+  gates::gates(::bra::mapped_file const& compiled_file)
+    : data_{}, num_qubits_{},
+      initial_state_value_{}, phase_coefficients_{}
+  { assign(compiled_file, size_type{0u}); }
+
+  gates::gates(::bra::mapped_file const& compiled_file, size_type const num_reserved_gates)
+    : data_{}, num_qubits_{},
+      initial_state_value_{}, phase_coefficients_{}
+  { assign(compiled_file, num_reserved_gates); }
+
+  gates::gates(::bra::mapped_file const& compiled_file, ::bra::program& program)
+    : data_{}, num_qubits_{},
+      initial_state_value_{}, phase_coefficients_{}
+  { assign(compiled_file, program); }
 #endif // BRA_NO_MPI
 
   bool gates::operator==(gates const& other) const
@@ -182,6 +248,7 @@ namespace bra
       and num_processes_per_unit_ == other.num_processes_per_unit_
       and initial_state_value_ == other.initial_state_value_
       and initial_permutation_ == other.initial_permutation_
+      and mpi_buffer_size_ == other.mpi_buffer_size_
       and phase_coefficients_ == other.phase_coefficients_
       and root_ == other.root_;
 #else // BRA_NO_MPI
@@ -244,16 +311,45 @@ namespace bra
   }
 #endif // BRA_NO_MPI
 
-#ifndef BRA_NO_MPI
-  void gates::assign(
-    std::istream& input_stream, yampi::environment const& environment,
-    yampi::communicator const& communicator, size_type const num_reserved_gates)
-#else // BRA_NO_MPI
-  void gates::assign(std::istream& input_stream, size_type const num_reserved_gates)
-#endif // BRA_NO_MPI
+  namespace gates_detail
   {
-    data_.clear();
-    data_.reserve(num_reserved_gates);
+    inline ::bra::operand to_operand(::bra::gates::qubit_type const qubit)
+    {
+      auto result = ::bra::operand{};
+      result.integer = static_cast<std::int64_t>(static_cast< ::bra::gates::bit_integer_type >(qubit));
+      return result;
+    }
+
+    inline ::bra::operand to_operand(::bra::gates::control_qubit_type const control_qubit)
+    { return ::bra::gates_detail::to_operand(control_qubit.qubit()); }
+
+    template <typename Integer>
+    inline ::bra::operand to_operand(Integer const integer)
+    {
+      auto result = ::bra::operand{};
+      result.integer = static_cast<std::int64_t>(integer);
+      return result;
+    }
+
+    inline ::bra::operand to_operand(::bra::gates::real_type const real)
+    {
+      auto result = ::bra::operand{};
+      result.real = static_cast<double>(real);
+      return result;
+    }
+  } // namespace gates_detail
+
+  template <typename Function>
+  void gates::read_statements(std::istream& input_stream, Function&& handle) const
+  {
+    auto operands = std::vector< ::bra::operand >{};
+    operands.reserve(10u);
+    auto const emit
+      = [&handle, &operands](::bra::opcode const opcode, auto const... values)
+        {
+          operands.assign(std::initializer_list< ::bra::operand >{::bra::gates_detail::to_operand(values)...});
+          handle(opcode, static_cast<std::vector< ::bra::operand > const&>(operands));
+        };
 
     auto line = std::string{};
     auto columns = columns_type{};
@@ -279,38 +375,26 @@ namespace bra
       boost::algorithm::to_upper(columns.front());
       auto const& first_mnemonic = columns.front();
       if (first_mnemonic == "QUBITS")
-      {
-#ifndef BRA_NO_MPI
-        num_qubits(
-          static_cast< ::bra::state::bit_integer_type >(read_num_qubits(columns)),
-          communicator, environment);
-#else // BRA_NO_MPI
-        num_qubits(
-          static_cast< ::bra::state::bit_integer_type >(read_num_qubits(columns)));
-#endif // BRA_NO_MPI
-      }
+        emit(::bra::opcode::qubits, read_num_qubits(columns));
       else if (first_mnemonic == "INITIAL") // INITIAL STATE
-        initial_state_value_
-          = static_cast< ::bra::state::state_integer_type >(read_initial_state_value(columns));
+        emit(::bra::opcode::initial_state, read_initial_state_value(columns));
       else if (first_mnemonic == "MPIPROCESSES")
       {
         read_num_mpi_processes(columns);
         // ignore this statement
       }
       else if (first_mnemonic == "MPISWAPBUFFER")
-      {
-        read_mpi_buffer_size(columns);
-        // ignore this statement
-      }
+        emit(::bra::opcode::mpi_buffer_size, read_mpi_buffer_size(columns));
       else if (first_mnemonic == "BIT") // BIT ASSIGNMENT
       {
         auto const statement = read_bit_statement(columns);
 
         if (statement == ::bra::bit_statement::assignment)
         {
-#ifndef BRA_NO_MPI
-          initial_permutation_ = read_initial_permutation(columns);
-#endif
+          operands.clear();
+          for (auto const permutated_bit: read_initial_permutation(columns))
+            operands.push_back(::bra::gates_detail::to_operand(permutated_bit));
+          handle(::bra::opcode::bit_assignment, static_cast<std::vector< ::bra::operand > const&>(operands));
         }
       }
       else if (first_mnemonic == "PERMUTATION")
@@ -318,50 +402,28 @@ namespace bra
       else if (first_mnemonic == "RANDOM") // RANDOM PERMUTATION
         throw unsupported_mnemonic_error{first_mnemonic};
       else if (first_mnemonic == "H")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::hadamard{read_hadamard(columns)}});
+        emit(::bra::opcode::hadamard, read_hadamard(columns));
       else if (first_mnemonic == "X")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::pauli_x{read_pauli_x(columns)}});
+        emit(::bra::opcode::pauli_x, read_pauli_x(columns));
       else if (first_mnemonic == "Y")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::pauli_y{read_pauli_y(columns)}});
+        emit(::bra::opcode::pauli_y, read_pauli_y(columns));
       else if (first_mnemonic == "Z")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::pauli_z{read_pauli_z(columns)}});
+        emit(::bra::opcode::pauli_z, read_pauli_z(columns));
       else if (first_mnemonic == "S")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::s_gate{
-              phase_coefficients_[2u], read_s_gate(columns)}});
+        emit(::bra::opcode::s_gate, read_s_gate(columns));
       else if (first_mnemonic == "S+")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_s_gate{
-              phase_coefficients_[2u], read_adj_s_gate(columns)}});
+        emit(::bra::opcode::adj_s_gate, read_adj_s_gate(columns));
       else if (first_mnemonic == "T")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::t_gate{
-              phase_coefficients_[3u], read_t_gate(columns)}});
+        emit(::bra::opcode::t_gate, read_t_gate(columns));
       else if (first_mnemonic == "T+")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_t_gate{
-              phase_coefficients_[3u], read_adj_t_gate(columns)}});
+        emit(::bra::opcode::adj_t_gate, read_adj_t_gate(columns));
       else if (first_mnemonic == "U1")
       {
         auto target = qubit_type{};
         auto phase = real_type{};
         std::tie(target, phase) = read_u1(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::u1{phase, target}});
+        emit(::bra::opcode::u1, target, phase);
       }
       else if (first_mnemonic == "U2")
       {
@@ -370,9 +432,7 @@ namespace bra
         auto phase2 = real_type{};
         std::tie(target, phase1, phase2) = read_u2(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::u2{phase1, phase2, target}});
+        emit(::bra::opcode::u2, target, phase1, phase2);
       }
       else if (first_mnemonic == "U3")
       {
@@ -382,71 +442,34 @@ namespace bra
         auto phase3 = real_type{};
         std::tie(target, phase1, phase2, phase3) = read_u3(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::u3{phase1, phase2, phase3, target}});
-      }
-      else if (first_mnemonic == "R" or first_mnemonic == "+R")
-      {
-        auto target = qubit_type{};
-        auto phase_exponent = int{};
-        std::tie(target, phase_exponent) = read_phase_shift(columns);
-
-        if (phase_exponent >= 0)
-          data_.push_back(std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::phase_shift{
-              phase_exponent, phase_coefficients_[phase_exponent], target}});
-        else
-        {
-          phase_exponent *= -1;
-          data_.push_back(std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_phase_shift{
-              phase_exponent, phase_coefficients_[phase_exponent], target}});
-        }
+        emit(::bra::opcode::u3, target, phase1, phase2, phase3);
       }
-      else if (first_mnemonic == "-R")
+      else if (first_mnemonic == "R" or first_mnemonic == "+R" or first_mnemonic == "-R")
       {
         auto target = qubit_type{};
         auto phase_exponent = int{};
         std::tie(target, phase_exponent) = read_phase_shift(columns);
 
-        if (phase_exponent >= 0)
-          data_.push_back(std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_phase_shift{
-              phase_exponent, phase_coefficients_[phase_exponent], target}});
+        if ((phase_exponent >= 0) == (first_mnemonic != "-R"))
+          emit(::bra::opcode::phase_shift, target, phase_exponent >= 0 ? phase_exponent : -phase_exponent);
         else
-        {
-          phase_exponent *= -1;
-          data_.push_back(std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::phase_shift{
-              phase_exponent, phase_coefficients_[phase_exponent], target}});
-        }
+          emit(::bra::opcode::adj_phase_shift, target, phase_exponent >= 0 ? phase_exponent : -phase_exponent);
       }
       else if (first_mnemonic == "+X")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::x_rotation_half_pi{read_x_rotation_half_pi(columns)}});
+        emit(::bra::opcode::x_rotation_half_pi, read_x_rotation_half_pi(columns));
       else if (first_mnemonic == "-X")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_x_rotation_half_pi{read_adj_x_rotation_half_pi(columns)}});
+        emit(::bra::opcode::adj_x_rotation_half_pi, read_adj_x_rotation_half_pi(columns));
       else if (first_mnemonic == "+Y")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::y_rotation_half_pi{read_y_rotation_half_pi(columns)}});
+        emit(::bra::opcode::y_rotation_half_pi, read_y_rotation_half_pi(columns));
       else if (first_mnemonic == "-Y")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::adj_y_rotation_half_pi{read_adj_y_rotation_half_pi(columns)}});
+        emit(::bra::opcode::adj_y_rotation_half_pi, read_adj_y_rotation_half_pi(columns));
       else if (first_mnemonic == "CNOT")
       {
         auto control = control_qubit_type{};
         auto target = qubit_type{};
         std::tie(control, target) = read_controlled_not(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::controlled_not{target, control}});
+        emit(::bra::opcode::controlled_not, control, target);
       }
       else if (first_mnemonic == "U")
       {
@@ -456,18 +479,9 @@ namespace bra
         std::tie(control, target, phase_exponent) = read_controlled_phase_shift(columns);
 
         if (phase_exponent >= 0)
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::controlled_phase_shift{
-                phase_exponent, phase_coefficients_[phase_exponent], target, control}});
+          emit(::bra::opcode::controlled_phase_shift, control, target, phase_exponent);
         else
-        {
-          phase_exponent *= -1;
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::adj_controlled_phase_shift{
-                phase_exponent, phase_coefficients_[phase_exponent], target, control}});
-        }
+          emit(::bra::opcode::adj_controlled_phase_shift, control, target, -phase_exponent);
       }
       else if (first_mnemonic == "V")
       {
@@ -477,18 +491,9 @@ namespace bra
         std::tie(control, target, phase_exponent) = read_controlled_v(columns);
 
         if (phase_exponent >= 0)
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::controlled_v{
-                phase_exponent, phase_coefficients_[phase_exponent], target, control}});
+          emit(::bra::opcode::controlled_v, control, target, phase_exponent);
         else
-        {
-          phase_exponent *= -1;
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::adj_controlled_v{
-                phase_exponent, phase_coefficients_[phase_exponent], target, control}});
-        }
+          emit(::bra::opcode::adj_controlled_v, control, target, -phase_exponent);
       }
       else if (first_mnemonic == "TOFFOLI")
       {
@@ -497,22 +502,10 @@ namespace bra
         auto target = qubit_type{};
         std::tie(control1, control2, target) = read_toffoli(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::toffoli{target, control1, control2}});
+        emit(::bra::opcode::toffoli, control1, control2, target);
       }
       else if (first_mnemonic == "M")
-      {
-#ifndef BRA_NO_MPI
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::projective_measurement{read_projective_measurement(columns), root_}});
-#else // BRA_NO_MPI
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::projective_measurement{read_projective_measurement(columns)}});
-#endif // BRA_NO_MPI
-      }
+        emit(::bra::opcode::projective_measurement, read_projective_measurement(columns));
       else if (first_mnemonic == "SHORBOX")
       {
         auto num_exponent_qubits = bit_integer_type{};
@@ -520,24 +513,14 @@ namespace bra
         auto base = state_integer_type{};
         std::tie(num_exponent_qubits, divisor, base) = read_shor_box(columns);
 
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::shor_box{num_exponent_qubits, divisor, base}});
+        emit(::bra::opcode::shor_box, num_exponent_qubits, divisor, base);
       }
       else if (first_mnemonic == "BEGIN") // BEGIN MEASUREMENT/LEARNING MACHINE
       {
         auto const statement = read_begin_statement(columns);
 
         if (statement == ::bra::begin_statement::measurement)
-        {
-#ifndef BRA_NO_MPI
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{new ::bra::gate::measurement{root_}});
-#else // BRA_NO_MPI
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{new ::bra::gate::measurement{}});
-#endif // BRA_NO_MPI
-        }
+          emit(::bra::opcode::measurement);
         else if (statement == ::bra::begin_statement::learning_machine)
           throw unsupported_mnemonic_error{first_mnemonic};
       }
@@ -580,26 +563,14 @@ namespace bra
 
         if (statement == ::bra::generate_statement::events)
         {
-#ifndef BRA_NO_MPI
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::generate_events{root_, num_events, seed}});
-#else // BRA_NO_MPI
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::generate_events{num_events, seed}});
-#endif // BRA_NO_MPI
+          emit(::bra::opcode::generate_events, num_events, seed);
           break;
         }
       }
       else if (first_mnemonic == "CLEAR")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::clear{read_clear(columns)}});
+        emit(::bra::opcode::clear, read_clear(columns));
       else if (first_mnemonic == "SET")
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{
-            new ::bra::gate::set{read_set(columns)}});
+        emit(::bra::opcode::set, read_set(columns));
       else if (first_mnemonic == "DEPOLARIZING")
       {
         auto statement = ::bra::depolarizing_statement{};
@@ -610,9 +581,27 @@ namespace bra
         std::tie(statement, px, py, pz, seed) = read_depolarizing_statement(columns);
 
         if (statement == ::bra::depolarizing_statement::channel)
-          data_.push_back(
-            std::unique_ptr< ::bra::gate::gate >{
-              new ::bra::gate::depolarizing_channel{px, py, pz, seed}});
+          emit(::bra::opcode::depolarizing_channel, px, py, pz, seed);
+        else
+          throw unsupported_mnemonic_error{first_mnemonic};
+      }
+      else if (first_mnemonic == "EXPECTATION") // EXPECTATION VALUE
+      {
+        auto statement = ::bra::expectation_statement{};
+        auto filename = std::string{};
+        std::tie(statement, filename) = read_expectation_statement(columns);
+
+        if (statement == ::bra::expectation_statement::value)
+        {
+          operands.clear();
+          for (auto const& pauli_term: read_hamiltonian(filename, columns))
+          {
+            operands.push_back(::bra::gates_detail::to_operand(pauli_term.coefficient));
+            operands.push_back(::bra::gates_detail::to_operand(pauli_term.x_mask));
+            operands.push_back(::bra::gates_detail::to_operand(pauli_term.z_mask));
+          }
+          handle(::bra::opcode::expectation_value, static_cast<std::vector< ::bra::operand > const&>(operands));
+        }
         else
           throw unsupported_mnemonic_error{first_mnemonic};
       }
@@ -621,13 +610,7 @@ namespace bra
         if (boost::size(columns) != 1u)
           throw wrong_mnemonics_error{columns};
 
-#ifndef BRA_NO_MPI
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{new ::bra::gate::exit{root_}});
-#else // BRA_NO_MPI
-        data_.push_back(
-          std::unique_ptr< ::bra::gate::gate >{new ::bra::gate::exit{}});
-#endif // BRA_NO_MPI
+        emit(::bra::opcode::exit);
         break;
       }
       else
@@ -635,6 +618,901 @@ namespace bra
     }
   }
 
+  template <typename Function>
+  void gates::read_statements(::bra::mapped_file const& compiled_file, Function&& handle)
+  {
+    if (compiled_file.size() < sizeof(::bra::compiled_qcx_magic)
+        or *reinterpret_cast<std::uint64_t const*>(compiled_file.data()) != ::bra::compiled_qcx_magic)
+      throw ::bra::wrong_compiled_qcx_error{};
+
+    // Operands are used in place, without being copied from the mapping
+    auto iter = compiled_file.data() + sizeof(::bra::compiled_qcx_magic);
+    auto const last = compiled_file.data() + compiled_file.size();
+    while (iter != last)
+    {
+      if (static_cast<std::size_t>(last - iter) < sizeof(::bra::statement_header))
+        throw ::bra::wrong_compiled_qcx_error{};
+
+      auto const& header = *reinterpret_cast< ::bra::statement_header const* >(iter);
+      iter += sizeof(::bra::statement_header);
+      if (static_cast<std::size_t>(last - iter) / sizeof(::bra::operand) < header.num_operands)
+        throw ::bra::wrong_compiled_qcx_error{};
+
+      auto const operands = reinterpret_cast< ::bra::operand const* >(iter);
+      iter += header.num_operands * sizeof(::bra::operand);
+      handle(header.opcode, operands, static_cast<std::size_t>(header.num_operands));
+    }
+  }
+
+#ifndef BRA_NO_MPI
+  void gates::assign(
+    std::istream& input_stream, yampi::environment const& environment,
+    yampi::communicator const& communicator, size_type const num_reserved_gates)
+  {
+    data_.clear();
+    data_.reserve(num_reserved_gates);
+
+    read_statements(
+      input_stream,
+      [this, &environment, &communicator](::bra::opcode const opcode, std::vector< ::bra::operand > const& operands)
+      { push_statement(opcode, operands.data(), operands.size(), environment, communicator, nullptr); });
+  }
+
+  void gates::assign(
+    ::bra::mapped_file const& compiled_file, yampi::environment const& environment,
+    yampi::communicator const& communicator, size_type const num_reserved_gates)
+  {
+    data_.clear();
+    data_.reserve(num_reserved_gates);
+
+    read_statements(
+      compiled_file,
+      [this, &environment, &communicator](
+        ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands)
+      { push_statement(opcode, operands, num_operands, environment, communicator, nullptr); });
+  }
+
+  void gates::assign(
+    ::bra::mapped_file const& compiled_file, ::bra::program& program, yampi::environment const& environment,
+    yampi::communicator const& communicator)
+  {
+    data_.clear();
+
+    read_statements(
+      compiled_file,
+      [this, &program, &environment, &communicator](
+        ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands)
+      { push_statement(opcode, operands, num_operands, environment, communicator, std::addressof(program)); });
+  }
+#else // BRA_NO_MPI
+  void gates::assign(std::istream& input_stream, size_type const num_reserved_gates)
+  {
+    data_.clear();
+    data_.reserve(num_reserved_gates);
+
+    read_statements(
+      input_stream,
+      [this](::bra::opcode const opcode, std::vector< ::bra::operand > const& operands)
+      { push_statement(opcode, operands.data(), operands.size(), nullptr); });
+  }
+
+  void gates::assign(::bra::mapped_file const& compiled_file, size_type const num_reserved_gates)
+  {
+    data_.clear();
+    data_.reserve(num_reserved_gates);
+
+    read_statements(
+      compiled_file,
+      [this](::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands)
+      { push_statement(opcode, operands, num_operands, nullptr); });
+  }
+
+  void gates::assign(::bra::mapped_file const& compiled_file, ::bra::program& program)
+  {
+    data_.clear();
+
+    read_statements(
+      compiled_file,
+      [this, &program](::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands)
+      { push_statement(opcode, operands, num_operands, std::addressof(program)); });
+  }
+#endif // BRA_NO_MPI
+
+  void gates::compile(std::istream& input_stream, std::ostream& output_stream)
+  {
+    output_stream.write(
+      reinterpret_cast<char const*>(std::addressof(::bra::compiled_qcx_magic)), sizeof(::bra::compiled_qcx_magic));
+
+    // Only num_qubits_ is needed to check qubits in statements, e.g. EXPECTATION VALUE
+    auto compiled_gates = gates{};
+    compiled_gates.read_statements(
+      input_stream,
+      [&compiled_gates, &output_stream](::bra::opcode const opcode, std::vector< ::bra::operand > const& operands)
+      {
+        if (opcode == ::bra::opcode::qubits)
+          compiled_gates.num_qubits_ = static_cast<bit_integer_type>(operands.front().integer);
+
+        auto const header = ::bra::statement_header{opcode, static_cast<std::uint32_t>(operands.size())};
+        output_stream.write(reinterpret_cast<char const*>(std::addressof(header)), sizeof(::bra::statement_header));
+        output_stream.write(
+          reinterpret_cast<char const*>(operands.data()),
+          static_cast<std::streamsize>(operands.size() * sizeof(::bra::operand)));
+      });
+  }
+
+  template <typename Gate, typename... Arguments>
+  void gates::push_gate(::bra::program* const program, Arguments&&... arguments)
+  {
+    if (program == nullptr)
+    {
+      data_.push_back(
+        std::unique_ptr< ::bra::gate::gate >{new Gate{std::forward<Arguments>(arguments)...}});
+      return;
+    }
+
+    // the gate lives only until it is lowered into program
+    Gate const gate{std::forward<Arguments>(arguments)...};
+    program->push_back(gate);
+  }
+
+#ifndef BRA_NO_MPI
+  void gates::push_statement(
+    ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands,
+    yampi::environment const& environment, yampi::communicator const& communicator,
+    ::bra::program* const program)
+#else // BRA_NO_MPI
+  void gates::push_statement(
+    ::bra::opcode const opcode, ::bra::operand const* const operands, std::size_t const num_operands,
+    ::bra::program* const program)
+#endif // BRA_NO_MPI
+  {
+    auto const check_num_operands
+      = [num_operands](std::size_t const expected_num_operands)
+        {
+          if (num_operands != expected_num_operands)
+            throw ::bra::wrong_compiled_qcx_error{};
+        };
+    auto const qubit_at
+      = [operands](std::size_t const index)
+        { return ket::make_qubit<state_integer_type>(static_cast<bit_integer_type>(operands[index].integer)); };
+    auto const control_qubit_at
+      = [&qubit_at](std::size_t const index) { return ket::make_control(qubit_at(index)); };
+    auto const real_at
+      = [operands](std::size_t const index) { return static_cast<real_type>(operands[index].real); };
+    auto const int_at
+      = [operands](std::size_t const index) { return static_cast<int>(operands[index].integer); };
+
+    switch (opcode)
+    {
+     case ::bra::opcode::qubits:
+      check_num_operands(1u);
+#ifndef BRA_NO_MPI
+      num_qubits(static_cast<bit_integer_type>(operands[0u].integer), communicator, environment);
+#else // BRA_NO_MPI
+      num_qubits(static_cast<bit_integer_type>(operands[0u].integer));
+#endif // BRA_NO_MPI
+      break;
+
+     case ::bra::opcode::initial_state:
+      check_num_operands(1u);
+      initial_state_value_ = static_cast<state_integer_type>(operands[0u].integer);
+      break;
+
+     case ::bra::opcode::mpi_buffer_size:
+      check_num_operands(1u);
+#ifndef BRA_NO_MPI
+      mpi_buffer_size_ = static_cast<state_integer_type>(operands[0u].integer);
+#endif // BRA_NO_MPI
+      // ignore this statement without MPI
+      break;
+
+     case ::bra::opcode::bit_assignment:
+#ifndef BRA_NO_MPI
+      initial_permutation_.clear();
+      initial_permutation_.reserve(num_operands);
+      for (auto index = std::size_t{0u}; index < num_operands; ++index)
+        initial_permutation_.push_back(static_cast<permutated_qubit_type>(static_cast<bit_integer_type>(operands[index].integer)));
+#endif // BRA_NO_MPI
+      // ignore this statement without MPI
+      break;
+
+     case ::bra::opcode::hadamard:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::hadamard >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::pauli_x:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::pauli_x >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::pauli_y:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::pauli_y >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::pauli_z:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::pauli_z >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::s_gate:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::s_gate >(program, phase_coefficients_[2u], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_s_gate:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::adj_s_gate >(program, phase_coefficients_[2u], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::t_gate:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::t_gate >(program, phase_coefficients_[3u], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_t_gate:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::adj_t_gate >(program, phase_coefficients_[3u], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::u1:
+      check_num_operands(2u);
+      push_gate< ::bra::gate::u1 >(program, real_at(1u), qubit_at(0u));
+      break;
+
+     case ::bra::opcode::u2:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::u2 >(program, real_at(1u), real_at(2u), qubit_at(0u));
+      break;
+
+     case ::bra::opcode::u3:
+      check_num_operands(4u);
+      push_gate< ::bra::gate::u3 >(program, real_at(1u), real_at(2u), real_at(3u), qubit_at(0u));
+      break;
+
+     case ::bra::opcode::phase_shift:
+      check_num_operands(2u);
+      push_gate< ::bra::gate::phase_shift >(program, int_at(1u), phase_coefficients_[int_at(1u)], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_phase_shift:
+      check_num_operands(2u);
+      push_gate< ::bra::gate::adj_phase_shift >(program, int_at(1u), phase_coefficients_[int_at(1u)], qubit_at(0u));
+      break;
+
+     case ::bra::opcode::x_rotation_half_pi:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::x_rotation_half_pi >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_x_rotation_half_pi:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::adj_x_rotation_half_pi >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::y_rotation_half_pi:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::y_rotation_half_pi >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_y_rotation_half_pi:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::adj_y_rotation_half_pi >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::controlled_not:
+      check_num_operands(2u);
+      push_gate< ::bra::gate::controlled_not >(program, qubit_at(1u), control_qubit_at(0u));
+      break;
+
+     case ::bra::opcode::controlled_phase_shift:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::controlled_phase_shift >(
+        program, int_at(2u), phase_coefficients_[int_at(2u)], qubit_at(1u), control_qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_controlled_phase_shift:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::adj_controlled_phase_shift >(
+        program, int_at(2u), phase_coefficients_[int_at(2u)], qubit_at(1u), control_qubit_at(0u));
+      break;
+
+     case ::bra::opcode::controlled_v:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::controlled_v >(
+        program, int_at(2u), phase_coefficients_[int_at(2u)], qubit_at(1u), control_qubit_at(0u));
+      break;
+
+     case ::bra::opcode::adj_controlled_v:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::adj_controlled_v >(
+        program, int_at(2u), phase_coefficients_[int_at(2u)], qubit_at(1u), control_qubit_at(0u));
+      break;
+
+     case ::bra::opcode::toffoli:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::toffoli >(program, qubit_at(2u), control_qubit_at(0u), control_qubit_at(1u));
+      break;
+
+     case ::bra::opcode::projective_measurement:
+      check_num_operands(1u);
+#ifndef BRA_NO_MPI
+      push_gate< ::bra::gate::projective_measurement >(program, qubit_at(0u), root_);
+#else // BRA_NO_MPI
+      push_gate< ::bra::gate::projective_measurement >(program, qubit_at(0u));
+#endif // BRA_NO_MPI
+      break;
+
+     case ::bra::opcode::shor_box:
+      check_num_operands(3u);
+      push_gate< ::bra::gate::shor_box >(
+        program, static_cast<bit_integer_type>(operands[0u].integer),
+        static_cast<state_integer_type>(operands[1u].integer), static_cast<state_integer_type>(operands[2u].integer));
+      break;
+
+     case ::bra::opcode::measurement:
+      check_num_operands(0u);
+#ifndef BRA_NO_MPI
+      push_gate< ::bra::gate::measurement >(program, root_);
+#else // BRA_NO_MPI
+      push_gate< ::bra::gate::measurement >(program);
+#endif // BRA_NO_MPI
+      break;
+
+     case ::bra::opcode::generate_events:
+      check_num_operands(2u);
+#ifndef BRA_NO_MPI
+      push_gate< ::bra::gate::generate_events >(program, root_, int_at(0u), int_at(1u));
+#else // BRA_NO_MPI
+      push_gate< ::bra::gate::generate_events >(program, int_at(0u), int_at(1u));
+#endif // BRA_NO_MPI
+      break;
+
+     case ::bra::opcode::clear:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::clear >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::set:
+      check_num_operands(1u);
+      push_gate< ::bra::gate::set >(program, qubit_at(0u));
+      break;
+
+     case ::bra::opcode::depolarizing_channel:
+      check_num_operands(4u);
+      push_gate< ::bra::gate::depolarizing_channel >(program, real_at(0u), real_at(1u), real_at(2u), int_at(3u));
+      break;
+
+     case ::bra::opcode::expectation_value:
+     {
+      if (num_operands % 3u != 0u)
+        throw ::bra::wrong_compiled_qcx_error{};
+
+      auto pauli_terms = std::vector<pauli_term_type>{};
+      pauli_terms.reserve(num_operands / 3u);
+      for (auto index = std::size_t{0u}; index < num_operands; index += 3u)
+        pauli_terms.push_back(
+          pauli_term_type{
+            real_at(index),
+            static_cast<state_integer_type>(operands[index + 1u].integer),
+            static_cast<state_integer_type>(operands[index + 2u].integer)});
+
+      push_gate< ::bra::gate::expectation_value >(program, std::move(pauli_terms));
+      break;
+     }
+
+     case ::bra::opcode::exit:
+      check_num_operands(0u);
+#ifndef BRA_NO_MPI
+      push_gate< ::bra::gate::exit >(program, root_);
+#else // BRA_NO_MPI
+      push_gate< ::bra::gate::exit >(program);
+#endif // BRA_NO_MPI
+      break;
+
+     default:
+      throw ::bra::wrong_compiled_qcx_error{};
+    }
+  }
+
+  namespace gates_detail
+  {
+    // matrix acts on qubits, which must be a subset of all_qubits. The result acts on all_qubits
+    ::bra::gate::gate::matrix_type expand_matrix(
+      ::bra::gate::gate::matrix_type const& matrix,
+      ::bra::gate::gate::qubits_type const& qubits, ::bra::gate::gate::qubits_type const& all_qubits)
+    {
+      auto bit_positions = std::vector<std::size_t>{};
+      bit_positions.reserve(qubits.size());
+      auto operated_bits_mask = std::size_t{0u};
+      for (auto const qubit: qubits)
+      {
+        bit_positions.push_back(
+          static_cast<std::size_t>(std::find(all_qubits.begin(), all_qubits.end(), qubit) - all_qubits.begin()));
+        operated_bits_mask |= std::size_t{1u} << bit_positions.back();
+      }
+
+      auto const to_operated_index
+        = [&bit_positions](std::size_t const index)
+          {
+            auto result = std::size_t{0u};
+            for (auto position_index = std::size_t{0u}; position_index < bit_positions.size(); ++position_index)
+              result |= ((index >> bit_positions[position_index]) bitand std::size_t{1u}) << position_index;
+            return result;
+          };
+
+      auto const num_indices = std::size_t{1u} << qubits.size();
+      auto const num_all_indices = std::size_t{1u} << all_qubits.size();
+      auto result = ::bra::gate::gate::matrix_type(num_all_indices * num_all_indices);
+      for (auto row = std::size_t{0u}; row < num_all_indices; ++row)
+        for (auto column = std::size_t{0u}; column < num_all_indices; ++column)
+          if ((row bitand compl operated_bits_mask) == (column bitand compl operated_bits_mask))
+            result[row * num_all_indices + column]
+              = matrix[to_operated_index(row) * num_indices + to_operated_index(column)];
+
+      return result;
+    }
+
+    ::bra::gate::gate::matrix_type multiply_matrices(
+      ::bra::gate::gate::matrix_type const& lhs, ::bra::gate::gate::matrix_type const& rhs)
+    {
+      auto num_indices = std::size_t{1u};
+      while (num_indices * num_indices < lhs.size())
+        num_indices <<= 1u;
+      assert(num_indices * num_indices == lhs.size() and lhs.size() == rhs.size());
+
+      auto result = ::bra::gate::gate::matrix_type(lhs.size());
+      for (auto row = std::size_t{0u}; row < num_indices; ++row)
+        for (auto index = std::size_t{0u}; index < num_indices; ++index)
+          for (auto column = std::size_t{0u}; column < num_indices; ++column)
+            result[row * num_indices + column] += lhs[row * num_indices + index] * rhs[index * num_indices + column];
+
+      return result;
+    }
+
+    bool is_diagonal(::bra::gate::gate::matrix_type const& matrix)
+    {
+      auto num_indices = std::size_t{1u};
+      while (num_indices * num_indices < matrix.size())
+        num_indices <<= 1u;
+
+      for (auto row = std::size_t{0u}; row < num_indices; ++row)
+        for (auto column = std::size_t{0u}; column < num_indices; ++column)
+          if (row != column and matrix[row * num_indices + column] != ::bra::gate::gate::complex_type{})
+            return false;
+
+      return true;
+    }
+
+    // diagonal acts on qubits, which must be a subset of all_qubits. The result acts on all_qubits
+    ::bra::gate::gate::matrix_type expand_diagonal(
+      ::bra::gate::gate::matrix_type const& diagonal,
+      ::bra::gate::gate::qubits_type const& qubits, ::bra::gate::gate::qubits_type const& all_qubits)
+    {
+      auto bit_positions = std::vector<std::size_t>{};
+      bit_positions.reserve(qubits.size());
+      for (auto const qubit: qubits)
+        bit_positions.push_back(
+          static_cast<std::size_t>(std::find(all_qubits.begin(), all_qubits.end(), qubit) - all_qubits.begin()));
+
+      auto const num_all_indices = std::size_t{1u} << all_qubits.size();
+      auto result = ::bra::gate::gate::matrix_type(num_all_indices);
+      for (auto index = std::size_t{0u}; index < num_all_indices; ++index)
+      {
+        auto operated_index = std::size_t{0u};
+        for (auto position_index = std::size_t{0u}; position_index < bit_positions.size(); ++position_index)
+          operated_index |= ((index >> bit_positions[position_index]) bitand std::size_t{1u}) << position_index;
+        result[index] = diagonal[operated_index];
+      }
+
+      return result;
+    }
+  } // namespace gates_detail
+
+  void gates::fuse(bit_integer_type const max_num_fused_qubits)
+  {
+    auto result = data_type{data_.get_allocator()};
+    result.reserve(data_.size());
+
+    // [run_first, run_last) is the present run of gates, which acts on fused_qubits as fused_matrix
+    auto run_first = data_.begin();
+    auto fused_qubits = ::bra::gate::gate::qubits_type{};
+    auto fused_matrix = ::bra::gate::gate::matrix_type{};
+    auto const flush
+      = [&result, &run_first, &fused_qubits, &fused_matrix](iterator const run_last)
+        {
+          if (run_last - run_first == 1)
+            result.push_back(std::move(*run_first));
+          else if (run_last - run_first > 1)
+            result.push_back(
+              std::unique_ptr< ::bra::gate::gate >{
+                new ::bra::gate::unitary{std::move(fused_matrix), std::move(fused_qubits)}});
+
+          run_first = run_last;
+          fused_qubits.clear();
+          fused_matrix.clear();
+        };
+
+    for (auto iter = data_.begin(), last = data_.end(); iter != last; ++iter)
+    {
+      auto qubits = (*iter)->fusible_qubits();
+      if (qubits.empty() or qubits.size() > max_num_fused_qubits)
+      {
+        flush(iter);
+        result.push_back(std::move(*iter));
+        run_first = std::next(iter);
+        continue;
+      }
+
+      auto all_qubits = fused_qubits;
+      for (auto const qubit: qubits)
+        if (std::find(all_qubits.begin(), all_qubits.end(), qubit) == all_qubits.end())
+          all_qubits.push_back(qubit);
+
+      if (all_qubits.size() > max_num_fused_qubits)
+        flush(iter);
+
+      if (run_first == iter)
+      {
+        fused_matrix = (*iter)->matrix();
+        fused_qubits = std::move(qubits);
+        continue;
+      }
+
+      fused_matrix
+        = ::bra::gates_detail::multiply_matrices(
+            ::bra::gates_detail::expand_matrix((*iter)->matrix(), qubits, all_qubits),
+            ::bra::gates_detail::expand_matrix(fused_matrix, fused_qubits, all_qubits));
+      fused_qubits = std::move(all_qubits);
+    }
+    flush(data_.end());
+
+    data_.swap(result);
+  }
+
+  void gates::block(bit_integer_type const num_block_qubits)
+  {
+    auto result = data_type{data_.get_allocator()};
+    result.reserve(data_.size());
+
+    // [run_first, run_last) is the present run of gates, all of whose qubits are lower than num_block_qubits
+    auto run_first = data_.begin();
+    auto const flush
+      = [&result, &run_first, num_block_qubits](iterator const run_last)
+        {
+          if (run_last - run_first == 1)
+            result.push_back(std::move(*run_first));
+          else if (run_last - run_first > 1)
+          {
+            auto matrices = std::vector< ::bra::gate::gate::matrix_type >{};
+            auto qubits_list = std::vector< ::bra::gate::gate::qubits_type >{};
+            matrices.reserve(run_last - run_first);
+            qubits_list.reserve(run_last - run_first);
+            for (auto iter = run_first; iter != run_last; ++iter)
+            {
+              matrices.push_back((*iter)->matrix());
+              qubits_list.push_back((*iter)->fusible_qubits());
+            }
+
+            result.push_back(
+              std::unique_ptr< ::bra::gate::gate >{
+                new ::bra::gate::cache_blocked{std::move(matrices), std::move(qubits_list), num_block_qubits}});
+          }
+
+          run_first = run_last;
+        };
+
+    for (auto iter = data_.begin(), last = data_.end(); iter != last; ++iter)
+    {
+      auto const qubits = (*iter)->fusible_qubits();
+      if (not qubits.empty()
+          and std::all_of(
+                qubits.begin(), qubits.end(),
+                [num_block_qubits](qubit_type const qubit)
+                { return static_cast<bit_integer_type>(qubit) < num_block_qubits; }))
+        continue;
+
+      flush(iter);
+      result.push_back(std::move(*iter));
+      run_first = std::next(iter);
+    }
+    flush(data_.end());
+
+    data_.swap(result);
+  }
+
+  gates::size_type gates::extract_clifford_prefix(::bra::stabilizer_tableau& tableau)
+  {
+    auto const last
+      = std::find_if_not(
+          data_.begin(), data_.end(),
+          [&tableau](value_type const& gate)
+          {
+            auto const qubits = gate->fusible_qubits();
+            return not qubits.empty() and tableau.apply(gate->matrix(), qubits);
+          });
+    auto const result = static_cast<size_type>(last - data_.begin());
+    data_.erase(data_.begin(), last);
+    return result;
+  }
+
+  gates::size_type gates::simplify(bit_integer_type const max_num_gate_qubits)
+  {
+    auto const old_size = data_.size();
+    auto result = data_type{data_.get_allocator()};
+    result.reserve(data_.size());
+
+    // qubit_histories[q] is the indices of result acting on q, and the last one is the latest gate on q. Gates on
+    // disjoint qubits commute, so each gate only meets the latest gate on any of its qubits. Cancelled gates are reset
+    // to null and removed at last
+    using real_type = ::bra::state::real_type;
+    auto const tolerance = real_type{64} * std::numeric_limits<real_type>::epsilon();
+    auto qubit_histories = std::vector<std::vector<std::size_t>>(num_qubits_);
+    for (auto& gate: data_)
+    {
+      auto qubits = gate->fusible_qubits();
+      if (qubits.empty())
+      {
+        // gates other than unitary ones are not moved
+        for (auto& qubit_history: qubit_histories)
+          qubit_history.clear();
+        result.push_back(std::move(gate));
+        continue;
+      }
+
+      auto const previous_index_iter
+        = std::max_element(
+            qubits.begin(), qubits.end(),
+            [&qubit_histories](qubit_type const lhs, qubit_type const rhs)
+            {
+              auto const& lhs_history = qubit_histories[static_cast<bit_integer_type>(lhs)];
+              auto const& rhs_history = qubit_histories[static_cast<bit_integer_type>(rhs)];
+              return not rhs_history.empty() and (lhs_history.empty() or lhs_history.back() < rhs_history.back());
+            });
+      auto const& previous_history = qubit_histories[static_cast<bit_integer_type>(*previous_index_iter)];
+
+      // The previous gate can be cancelled or merged if it acts on the same qubits, and then it is the latest gate on
+      // each of them
+      if (qubits.size() <= max_num_gate_qubits and not previous_history.empty())
+      {
+        auto const previous_index = previous_history.back();
+        auto const previous_qubits = result[previous_index]->fusible_qubits();
+        if (previous_qubits.size() == qubits.size()
+            and std::is_permutation(qubits.begin(), qubits.end(), previous_qubits.begin()))
+        {
+          auto const product
+            = ::bra::gates_detail::multiply_matrices(
+                ::bra::gates_detail::expand_matrix(gate->matrix(), qubits, previous_qubits),
+                result[previous_index]->matrix());
+          auto const num_indices = std::size_t{1u} << qubits.size();
+          auto const is_close
+            = [&product, num_indices, tolerance](std::size_t const row, std::size_t const column, complex_type const& value)
+              { return std::abs(product[row * num_indices + column] - value) < tolerance; };
+          auto is_diagonal_one = true; // whether the product is diag(1, ..., 1, x)
+          for (auto row = std::size_t{0u}; row < num_indices and is_diagonal_one; ++row)
+            for (auto column = std::size_t{0u}; column < num_indices and is_diagonal_one; ++column)
+              if (row != num_indices - 1u or column != num_indices - 1u)
+                is_diagonal_one = is_close(row, column, row == column ? complex_type{1} : complex_type{});
+
+          if (is_diagonal_one and is_close(num_indices - 1u, num_indices - 1u, complex_type{1}))
+          {
+            result[previous_index].reset();
+            for (auto const qubit: qubits)
+              qubit_histories[static_cast<bit_integer_type>(qubit)].pop_back();
+            continue;
+          }
+
+          if (is_diagonal_one and qubits.size() == 1u)
+          {
+            result[previous_index].reset(
+              new ::bra::gate::u1{std::arg(product.back()), qubits.front()});
+            continue;
+          }
+        }
+      }
+
+      for (auto const qubit: qubits)
+        qubit_histories[static_cast<bit_integer_type>(qubit)].push_back(result.size());
+      result.push_back(std::move(gate));
+    }
+
+    result.erase(
+      std::remove(result.begin(), result.end(), value_type{}), result.end());
+    data_.swap(result);
+    return old_size - data_.size();
+  }
+
+  void gates::merge_diagonals(bit_integer_type const max_num_table_qubits)
+  {
+    auto result = data_type{data_.get_allocator()};
+    result.reserve(data_.size());
+
+    // [run_first, run_last) is the present run of diagonal gates, whose product is the product of diagonals[i]
+    // acting on qubits_list[i]. Diagonal gates commute, so each gate is merged into any table which can hold it
+    auto run_first = data_.begin();
+    auto diagonals = std::vector< ::bra::gate::gate::matrix_type >{};
+    auto qubits_list = std::vector< ::bra::gate::gate::qubits_type >{};
+    auto const flush
+      = [&result, &run_first, &diagonals, &qubits_list](iterator const run_last)
+        {
+          if (run_last - run_first == 1)
+            result.push_back(std::move(*run_first));
+          else if (run_last - run_first > 1)
+            result.push_back(
+              std::unique_ptr< ::bra::gate::gate >{
+                new ::bra::gate::diagonal{std::move(diagonals), std::move(qubits_list)}});
+
+          run_first = run_last;
+          diagonals.clear();
+          qubits_list.clear();
+        };
+
+    for (auto iter = data_.begin(), last = data_.end(); iter != last; ++iter)
+    {
+      auto qubits = (*iter)->fusible_qubits();
+      auto const matrix = qubits.empty() ? ::bra::gate::gate::matrix_type{} : (*iter)->matrix();
+      if (qubits.empty() or qubits.size() > max_num_table_qubits or not ::bra::gates_detail::is_diagonal(matrix))
+      {
+        flush(iter);
+        result.push_back(std::move(*iter));
+        run_first = std::next(iter);
+        continue;
+      }
+
+      auto const num_indices = std::size_t{1u} << qubits.size();
+      auto diagonal = ::bra::gate::gate::matrix_type{};
+      diagonal.reserve(num_indices);
+      for (auto index = std::size_t{0u}; index < num_indices; ++index)
+        diagonal.push_back(matrix[index * num_indices + index]);
+
+      auto table_index = std::size_t{0u};
+      auto all_qubits = ::bra::gate::gate::qubits_type{};
+      for (auto const num_tables = qubits_list.size(); table_index < num_tables; ++table_index)
+      {
+        all_qubits = qubits_list[table_index];
+        for (auto const qubit: qubits)
+          if (std::find(all_qubits.begin(), all_qubits.end(), qubit) == all_qubits.end())
+            all_qubits.push_back(qubit);
+
+        if (all_qubits.size() <= max_num_table_qubits)
+          break;
+      }
+
+      if (table_index == qubits_list.size())
+      {
+        diagonals.push_back(std::move(diagonal));
+        qubits_list.push_back(std::move(qubits));
+        continue;
+      }
+
+      auto const old_diagonal
+        = ::bra::gates_detail::expand_diagonal(diagonals[table_index], qubits_list[table_index], all_qubits);
+      auto const new_diagonal = ::bra::gates_detail::expand_diagonal(diagonal, qubits, all_qubits);
+      diagonals[table_index].resize(old_diagonal.size());
+      std::transform(
+        old_diagonal.begin(), old_diagonal.end(), new_diagonal.begin(), diagonals[table_index].begin(),
+        std::multiplies< ::bra::gate::gate::complex_type >{});
+      qubits_list[table_index] = std::move(all_qubits);
+    }
+    flush(data_.end());
+
+    data_.swap(result);
+  }
+
+#ifndef BRA_NO_MPI
+  void gates::plan_qubit_remapping(bit_integer_type const max_num_remapped_qubits)
+  {
+    // call_with_qubit_array supports at most five qubits
+    auto const max_num_pairs = std::min(max_num_remapped_qubits, bit_integer_type{5u});
+    if (max_num_pairs == bit_integer_type{0u})
+      return;
+
+    // positions[qubit] is the planned position of qubit, which is local if it is lower than num_lqubits_
+    auto positions = std::vector<bit_integer_type>(num_qubits_);
+    for (auto bit = bit_integer_type{0u}; bit < num_qubits_; ++bit)
+      positions[bit] = static_cast<bit_integer_type>(initial_permutation_[bit].qubit());
+    auto const is_local
+      = [this, &positions](qubit_type const qubit)
+        { return positions[static_cast<bit_integer_type>(qubit)] < num_lqubits_; };
+
+    // uses[qubit] is the list of indices of gates needing qubit to be local, and the first
+    // next_use_indices[qubit] elements of it have already been passed
+    auto const num_gates = data_.size();
+    auto local_qubits_list = std::vector< ::bra::gate::gate::qubits_type >{};
+    local_qubits_list.reserve(num_gates);
+    auto uses = std::vector<std::vector<std::size_t>>(num_qubits_);
+    for (auto gate_index = std::size_t{0u}; gate_index < num_gates; ++gate_index)
+    {
+      local_qubits_list.push_back(data_[gate_index]->local_qubits());
+      for (auto const qubit: local_qubits_list.back())
+        uses[static_cast<bit_integer_type>(qubit)].push_back(gate_index);
+    }
+
+    auto next_use_indices = std::vector<std::size_t>(num_qubits_);
+    auto constexpr never = std::numeric_limits<std::size_t>::max();
+    auto const next_use
+      = [&uses, &next_use_indices, never](qubit_type const qubit)
+        {
+          auto const bit = static_cast<bit_integer_type>(qubit);
+          return next_use_indices[bit] < uses[bit].size() ? uses[bit][next_use_indices[bit]] : never;
+        };
+
+    auto result = data_type{data_.get_allocator()};
+    result.reserve(num_gates);
+
+    for (auto gate_index = std::size_t{0u}; gate_index < num_gates; ++gate_index)
+    {
+      auto const& needed_qubits = local_qubits_list[gate_index];
+      for (auto const qubit: needed_qubits)
+        ++next_use_indices[static_cast<bit_integer_type>(qubit)];
+
+      auto nonlocal_qubits = ::bra::gate::gate::qubits_type{};
+      std::copy_if(
+        needed_qubits.begin(), needed_qubits.end(), std::back_inserter(nonlocal_qubits),
+        [&is_local](qubit_type const qubit) { return not is_local(qubit); });
+
+      // victims are local qubits not needed by this gate, the one used farthest in the future first (Belady's rule)
+      auto evicted_qubits = ::bra::gate::gate::qubits_type{};
+      if (not nonlocal_qubits.empty() and nonlocal_qubits.size() <= max_num_pairs)
+      {
+        for (auto bit = bit_integer_type{0u}; bit < num_qubits_; ++bit)
+        {
+          auto const qubit = qubit_type{bit};
+          if (is_local(qubit)
+              and std::find(needed_qubits.begin(), needed_qubits.end(), qubit) == needed_qubits.end())
+            evicted_qubits.push_back(qubit);
+        }
+        std::stable_sort(
+          evicted_qubits.begin(), evicted_qubits.end(),
+          [&next_use](qubit_type const lhs, qubit_type const rhs) { return next_use(lhs) > next_use(rhs); });
+      }
+
+      if (nonlocal_qubits.empty() or evicted_qubits.size() < nonlocal_qubits.size())
+      {
+        result.push_back(std::move(data_[gate_index]));
+        continue;
+      }
+
+      // nonlocal qubits needed soon are brought together while they will be used before the victims for them
+      auto upcoming_qubits = ::bra::gate::gate::qubits_type{};
+      for (auto bit = bit_integer_type{0u}; bit < num_qubits_; ++bit)
+      {
+        auto const qubit = qubit_type{bit};
+        if (not is_local(qubit) and next_use(qubit) != never
+            and std::find(nonlocal_qubits.begin(), nonlocal_qubits.end(), qubit) == nonlocal_qubits.end())
+          upcoming_qubits.push_back(qubit);
+      }
+      std::stable_sort(
+        upcoming_qubits.begin(), upcoming_qubits.end(),
+        [&next_use](qubit_type const lhs, qubit_type const rhs) { return next_use(lhs) < next_use(rhs); });
+
+      for (auto const qubit: upcoming_qubits)
+      {
+        auto const num_pairs = nonlocal_qubits.size();
+        if (num_pairs == max_num_pairs or num_pairs == evicted_qubits.size()
+            or next_use(evicted_qubits[num_pairs]) <= next_use(qubit))
+          break;
+
+        nonlocal_qubits.push_back(qubit);
+      }
+      evicted_qubits.resize(nonlocal_qubits.size());
+
+      for (auto index = std::size_t{0u}; index < nonlocal_qubits.size(); ++index)
+        std::swap(
+          positions[static_cast<bit_integer_type>(nonlocal_qubits[index])],
+          positions[static_cast<bit_integer_type>(evicted_qubits[index])]);
+
+      result.push_back(
+        std::unique_ptr< ::bra::gate::gate >{
+          new ::bra::gate::remap_qubits{std::move(nonlocal_qubits), std::move(evicted_qubits)}});
+      result.push_back(std::move(data_[gate_index]));
+    }
+
+    data_.swap(result);
+  }
+#endif // BRA_NO_MPI
+
   void gates::swap(gates& other)
     noexcept(
       BRA_is_nothrow_swappable<data_type>::value
@@ -649,6 +1527,7 @@ namespace bra
     swap(num_lqubits_, other.num_lqubits_);
     swap(initial_state_value_, other.initial_state_value_);
     swap(initial_permutation_, other.initial_permutation_);
+    swap(mpi_buffer_size_, other.mpi_buffer_size_);
     swap(phase_coefficients_, other.phase_coefficients_);
     swap(root_, other.root_);
 #else // BRA_NO_MPI
@@ -699,11 +1578,10 @@ namespace bra
     return boost::lexical_cast<state_integer_type>(*++iter);
   }
 
-#ifndef BRA_NO_MPI
-  std::vector<gates::permutated_qubit_type>
+  std::vector<gates::bit_integer_type>
   gates::read_initial_permutation(gates::columns_type const& columns) const
   {
-    auto result = std::vector<permutated_qubit_type>{};
+    auto result = std::vector<bit_integer_type>{};
     result.reserve(boost::size(columns)-2u);
 
     auto iter = std::begin(columns);
@@ -712,11 +1590,10 @@ namespace bra
 
     auto const last = std::end(columns);
     for (; iter != last; ++iter)
-      result.push_back(static_cast<permutated_qubit_type>(boost::lexical_cast<bit_integer_type>(*iter)));
+      result.push_back(boost::lexical_cast<bit_integer_type>(*iter));
 
     return result;
   }
-#endif
 
   gates::qubit_type gates::read_target(gates::columns_type const& columns) const
   {
@@ -997,6 +1874,76 @@ namespace bra
 
     return std::make_tuple(::bra::depolarizing_statement::channel, px, py, pz, seed);
   }
+
+  std::tuple< ::bra::expectation_statement, std::string > gates::read_expectation_statement(gates::columns_type& columns) const
+  {
+    if (boost::size(columns) != 3u)
+      throw wrong_mnemonics_error{columns};
+
+    auto iter = std::begin(columns);
+    boost::algorithm::to_upper(*++iter);
+
+    if (*iter != "VALUE")
+      throw wrong_mnemonics_error{columns};
+
+    return std::make_tuple(::bra::expectation_statement::value, *++iter);
+  }
+
+  // Each line of a Hamiltonian file is "coefficient P_0q_0 P_1q_1 ...", e.g. "0.5 X0 Z3 Y12", where P_i is X, Y or Z
+  // and q_i is a qubit, which appears at most once in a line. A line with only a coefficient is the identity term.
+  // Empty lines and characters after '!' are ignored as in circuit files
+  std::vector<gates::pauli_term_type> gates::read_hamiltonian(
+    std::string const& filename, gates::columns_type const& columns) const
+  {
+    auto file_stream = std::ifstream{filename.c_str()};
+    if (not file_stream)
+      throw wrong_mnemonics_error{columns};
+
+    auto result = std::vector<pauli_term_type>{};
+    auto line = std::string{};
+    auto term_columns = columns_type{};
+    while (std::getline(file_stream, line))
+    {
+      line.erase(std::find(line.begin(), line.end(), '!'), line.end());
+      boost::algorithm::trim(line);
+      if (line.empty())
+        continue;
+
+      boost::algorithm::split(
+        term_columns, line, boost::algorithm::is_space(),
+        boost::algorithm::token_compress_on);
+
+      auto iter = std::begin(term_columns);
+      auto term = pauli_term_type{boost::lexical_cast<real_type>(*iter), state_integer_type{0u}, state_integer_type{0u}};
+
+      auto const last = std::end(term_columns);
+      for (++iter; iter != last; ++iter)
+      {
+        if (iter->size() < 2u)
+          throw wrong_mnemonics_error{term_columns};
+
+        auto const qubit = ket::make_qubit<state_integer_type>(boost::lexical_cast<bit_integer_type>(iter->substr(1u)));
+        auto const qubit_mask = ket::utility::integer_exp2<state_integer_type>(qubit);
+        if (static_cast<bit_integer_type>(qubit) >= num_qubits_
+            or ((term.x_mask bitor term.z_mask) bitand qubit_mask) != state_integer_type{0u})
+          throw wrong_mnemonics_error{term_columns};
+
+        auto const pauli = iter->front();
+        if (pauli == 'X' or pauli == 'x')
+          ket::add_pauli_x(term, qubit);
+        else if (pauli == 'Y' or pauli == 'y')
+          ket::add_pauli_y(term, qubit);
+        else if (pauli == 'Z' or pauli == 'z')
+          ket::add_pauli_z(term, qubit);
+        else
+          throw wrong_mnemonics_error{term_columns};
+      }
+
+      result.push_back(term);
+    }
+
+    return result;
+  }
 } // namespace bra
 
 
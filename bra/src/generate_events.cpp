@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 #include <ios>
 #include <iomanip>
@@ -38,5 +39,16 @@ namespace bra
     std::string generate_events::do_representation(
       std::ostringstream& repr_stream, int const) const
     { return repr_stream.str(); }
+
+    ::bra::instruction generate_events::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    {
+      auto result = ::bra::make_instruction(::bra::instruction_code::generate_events);
+#ifndef BRA_NO_MPI
+      result.integers[0u] = static_cast<std::uint64_t>(root_.mpi_rank());
+#endif // BRA_NO_MPI
+      result.integers[1u] = static_cast<std::uint64_t>(num_events_);
+      result.integers[2u] = static_cast<std::uint64_t>(seed_);
+      return result;
+    }
   } // namespace gate
 } // namespace bra
@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/hadamard.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/hadamard.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -32,5 +34,17 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    hadamard::qubits_type hadamard::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    hadamard::matrix_type hadamard::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::hadamard(column, qubit_type{0u}); });
+    }
+
+    ::bra::instruction hadamard::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::hadamard, qubit_); }
   } // namespace gate
 } // namespace bra
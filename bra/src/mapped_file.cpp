@@ -0,0 +1,60 @@
+#include <cstddef>
+#include <string>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <bra/mapped_file.hpp>
+
+
+namespace bra
+{
+  cannot_map_file_error::cannot_map_file_error(std::string const& filename)
+    : std::runtime_error{("cannot map a file " + filename).c_str()}
+  { }
+
+  mapped_file::mapped_file(std::string const& filename)
+    : data_{nullptr}, size_{0u}
+  {
+    auto const file_descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (file_descriptor == -1)
+      throw ::bra::cannot_map_file_error{filename};
+
+    struct ::stat file_status;
+    if (::fstat(file_descriptor, &file_status) == -1)
+    {
+      ::close(file_descriptor);
+      throw ::bra::cannot_map_file_error{filename};
+    }
+
+    size_ = static_cast<std::size_t>(file_status.st_size);
+    if (size_ > std::size_t{0u})
+    {
+      data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, file_descriptor, 0);
+      if (data_ == MAP_FAILED)
+      {
+        ::close(file_descriptor);
+        throw ::bra::cannot_map_file_error{filename};
+      }
+    }
+
+    // the mapping is kept after the file is closed
+    ::close(file_descriptor);
+  }
+
+  mapped_file::~mapped_file() noexcept
+  {
+    if (data_ != nullptr)
+      ::munmap(data_, size_);
+  }
+
+  mapped_file::mapped_file(mapped_file&& other) noexcept
+    : data_{other.data_}, size_{other.size_}
+  {
+    other.data_ = nullptr;
+    other.size_ = std::size_t{0u};
+  }
+} // namespace bra
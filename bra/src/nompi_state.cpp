@@ -1,5 +1,6 @@
 #ifdef BRA_NO_MPI
 # include <vector>
+# include <iterator>
 
 # include <yampi/communicator.hpp>
 # include <yampi/environment.hpp>
@@ -15,16 +16,25 @@
 # include <ket/gate/controlled_phase_shift.hpp>
 # include <ket/gate/controlled_v.hpp>
 # include <ket/gate/toffoli.hpp>
+# include <ket/gate/unitary.hpp>
+# include <ket/gate/diagonal.hpp>
+# include <ket/gate/pauli_string.hpp>
 # include <ket/gate/projective_measurement.hpp>
 # include <ket/gate/clear.hpp>
 # include <ket/gate/set.hpp>
 # include <ket/all_spin_expectation_values.hpp>
 # include <ket/measure.hpp>
 # include <ket/generate_events.hpp>
+# include <ket/expectation_value.hpp>
 # include <ket/shor_box.hpp>
+# include <ket/utility/loop_n.hpp>
 
 # include <bra/nompi_state.hpp>
 # include <bra/state.hpp>
+# include <bra/stabilizer_tableau.hpp>
+# include <bra/utility/call_with_qubit_array.hpp>
+# include <bra/utility/apply_unitaries_in_blocks.hpp>
+# include <bra/utility/diagonal_coefficients.hpp>
 
 
 namespace bra
@@ -170,6 +180,39 @@ namespace bra
       data_, target_qubit, control_qubit1, control_qubit2);
   }
 
+  void nompi_state::do_unitary(
+    std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits)
+  {
+    bra::utility::call_with_qubit_array(
+      qubits,
+      [this, &matrix](auto const& qubit_array)
+      { ket::gate::ranges::unitary(parallel_policy_, data_, matrix, qubit_array); });
+  }
+
+  void nompi_state::do_cache_blocked_unitaries(
+    std::vector<std::vector<complex_type>> const& matrices,
+    std::vector<std::vector<qubit_type>> const& qubits_list,
+    bit_integer_type const num_block_qubits)
+  {
+    bra::utility::apply_unitaries_in_blocks(
+      parallel_policy_, std::begin(data_), std::end(data_), matrices, qubits_list, num_block_qubits);
+  }
+
+  void nompi_state::do_diagonal(
+    std::vector<std::vector<complex_type>> const& diagonals,
+    std::vector<std::vector<qubit_type>> const& qubits_list)
+  {
+    ket::gate::ranges::diagonal(
+      parallel_policy_, data_,
+      bra::utility::diagonal_coefficients<complex_type, state_integer_type>{diagonals, qubits_list});
+  }
+
+  void nompi_state::do_remap_qubits(std::vector<qubit_type> const&, std::vector<qubit_type> const&)
+  { }
+
+  void nompi_state::do_pauli_string(state_integer_type const x_mask, state_integer_type const z_mask)
+  { ket::gate::ranges::pauli_string(parallel_policy_, data_, x_mask, z_mask); }
+
   ket::gate::outcome nompi_state::do_projective_measurement(qubit_type const qubit)
   {
     return ket::gate::ranges::projective_measurement(
@@ -203,6 +246,9 @@ namespace bra
         generated_events_, data_, num_events, random_number_generator_, static_cast<seed_type>(seed));
   }
 
+  nompi_state::real_type nompi_state::do_expectation_value(std::vector<pauli_term_type> const& pauli_terms)
+  { return ket::ranges::expectation_value(parallel_policy_, data_, pauli_terms); }
+
   void nompi_state::do_shor_box(
     state_integer_type const divisor, state_integer_type const base,
     std::vector<qubit_type> const& exponent_qubits,
@@ -218,6 +264,16 @@ namespace bra
 
   void nompi_state::do_set(qubit_type const qubit)
   { ket::gate::ranges::set(parallel_policy_, data_, qubit); }
+
+  void nompi_state::do_assign_stabilizer_state(bra::stabilizer_tableau const& tableau)
+  {
+    auto const amplitudes = tableau.amplitudes();
+    auto const first = std::begin(data_);
+    ket::utility::loop_n(
+      parallel_policy_, static_cast<state_integer_type>(std::end(data_) - first),
+      [first, &amplitudes](state_integer_type const index, int const)
+      { *(first + index) = amplitudes(index); });
+  }
 } // namespace bra
 
 
@@ -1,5 +1,8 @@
 #ifndef BRA_NO_MPI
+# include <cstddef>
 # include <vector>
+# include <algorithm>
+# include <iterator>
 
 # include <yampi/communicator.hpp>
 # include <yampi/environment.hpp>
@@ -15,16 +18,29 @@
 # include <ket/mpi/gate/controlled_phase_shift.hpp>
 # include <ket/mpi/gate/controlled_v.hpp>
 # include <ket/mpi/gate/toffoli.hpp>
+# include <ket/mpi/gate/unitary.hpp>
+# include <ket/mpi/gate/diagonal.hpp>
+# include <ket/mpi/gate/pauli_string.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/remap_qubits.hpp>
+# include <ket/mpi/page/unmark_zero_pages.hpp>
 # include <ket/mpi/gate/projective_measurement.hpp>
 # include <ket/mpi/gate/clear.hpp>
 # include <ket/mpi/gate/set.hpp>
 # include <ket/mpi/all_spin_expectation_values.hpp>
 # include <ket/mpi/measure.hpp>
 # include <ket/mpi/generate_events.hpp>
+# include <ket/mpi/expectation_value.hpp>
 # include <ket/mpi/shor_box.hpp>
+# include <ket/utility/loop_n.hpp>
 
 # include <bra/paged_general_mpi_state.hpp>
 # include <bra/state.hpp>
+# include <bra/stabilizer_tableau.hpp>
+# include <bra/utility/call_with_qubit_array.hpp>
+# include <bra/utility/apply_unitaries_in_blocks.hpp>
+# include <bra/utility/diagonal_coefficients.hpp>
 
 
 #include<ket/mpi/utility/debug/print_data.hpp>
@@ -49,7 +65,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        mpi_policy_, parallel_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, communicator, environment}
   { }
 
@@ -66,7 +82,7 @@ namespace bra
       parallel_policy_{num_threads_per_process},
       mpi_policy_{},
       data_{
-        mpi_policy_, num_local_qubits, num_page_qubits, initial_integer,
+        mpi_policy_, parallel_policy_, num_local_qubits, num_page_qubits, initial_integer,
         permutation_, communicator, environment}
   { }
 
@@ -288,6 +304,103 @@ namespace bra
       data_, target_qubit, control_qubit1, control_qubit2, permutation_, buffer_, communicator_, environment_);
   }
 
+  void paged_general_mpi_state::do_unitary(
+    std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits)
+  {
+    bra::utility::call_with_qubit_array(
+      qubits,
+      [this, &matrix](auto const& qubit_array)
+      {
+        ket::mpi::gate::unitary(
+          mpi_policy_, parallel_policy_,
+          data_, matrix, qubit_array, permutation_, buffer_, communicator_, environment_);
+      });
+  }
+
+  void paged_general_mpi_state::do_cache_blocked_unitaries(
+    std::vector<std::vector<complex_type>> const& matrices,
+    std::vector<std::vector<qubit_type>> const& qubits_list,
+    bit_integer_type const num_block_qubits)
+  {
+    auto permutated_qubits_list = qubits_list;
+    for (auto& permutated_qubits: permutated_qubits_list)
+      for (auto& qubit: permutated_qubits)
+        qubit = permutation_[qubit].qubit();
+
+    // gates are applied one by one if some of them need communication or act on higher qubits
+    if (not bra::utility::are_in_local_blocks(
+          mpi_policy_, data_, permutated_qubits_list, num_block_qubits, communicator_, environment_))
+    {
+      for (auto index = std::size_t{0u}; index < matrices.size(); ++index)
+        do_unitary(matrices[index], qubits_list[index]);
+      return;
+    }
+
+    ket::mpi::utility::for_each_nonzero_local_range(
+      mpi_policy_, data_, communicator_, environment_,
+      [this, &matrices, &permutated_qubits_list, num_block_qubits](auto const first, auto const last)
+      {
+        bra::utility::apply_unitaries_in_blocks(
+          parallel_policy_, first, last, matrices, permutated_qubits_list, num_block_qubits);
+      });
+  }
+
+  void paged_general_mpi_state::do_diagonal(
+    std::vector<std::vector<complex_type>> const& diagonals,
+    std::vector<std::vector<qubit_type>> const& qubits_list)
+  {
+    auto permutated_qubits_list = qubits_list;
+    for (auto& permutated_qubits: permutated_qubits_list)
+      for (auto& qubit: permutated_qubits)
+        qubit = permutation_[qubit].qubit();
+
+    ket::mpi::gate::diagonal(
+      mpi_policy_, parallel_policy_, data_,
+      bra::utility::diagonal_coefficients<complex_type, state_integer_type>{diagonals, permutated_qubits_list},
+      communicator_, environment_);
+  }
+
+  void paged_general_mpi_state::do_remap_qubits(
+    std::vector<qubit_type> const& nonlocal_qubits, std::vector<qubit_type> const& evicted_qubits)
+  {
+    auto const num_local_qubits
+      = static_cast<bit_integer_type>(
+          ket::mpi::utility::policy::num_local_qubits(mpi_policy_, data_, communicator_, environment_));
+
+    // the planned layout may differ from the actual one, e.g. after gates interchanging qubits by themselves
+    auto actual_nonlocal_qubits = std::vector<qubit_type>{};
+    auto actual_evicted_qubits = std::vector<qubit_type>{};
+    for (auto index = std::size_t{0u}; index < nonlocal_qubits.size(); ++index)
+      if (permutation_[nonlocal_qubits[index]] >= permutated_qubit_type{num_local_qubits}
+          and permutation_[evicted_qubits[index]] < permutated_qubit_type{num_local_qubits})
+      {
+        actual_nonlocal_qubits.push_back(nonlocal_qubits[index]);
+        actual_evicted_qubits.push_back(evicted_qubits[index]);
+      }
+
+    if (actual_nonlocal_qubits.empty())
+      return;
+
+    bra::utility::call_with_qubit_array(
+      actual_nonlocal_qubits,
+      [this, &actual_evicted_qubits](auto const& nonlocal_qubit_array)
+      {
+        auto evicted_qubit_array = nonlocal_qubit_array;
+        std::copy(
+          std::begin(actual_evicted_qubits), std::end(actual_evicted_qubits), std::begin(evicted_qubit_array));
+        ket::mpi::utility::remap_qubits(
+          mpi_policy_, parallel_policy_,
+          data_, nonlocal_qubit_array, evicted_qubit_array, permutation_, buffer_, communicator_, environment_);
+      });
+  }
+
+  void paged_general_mpi_state::do_pauli_string(state_integer_type const x_mask, state_integer_type const z_mask)
+  {
+    ket::mpi::gate::pauli_string(
+      mpi_policy_, parallel_policy_,
+      data_, x_mask, z_mask, permutation_, buffer_, communicator_, environment_);
+  }
+
   ket::gate::outcome paged_general_mpi_state::do_projective_measurement(
     qubit_type const qubit, yampi::rank const root)
   {
@@ -327,6 +440,13 @@ namespace bra
         communicator_, environment_);
   }
 
+  paged_general_mpi_state::real_type paged_general_mpi_state::do_expectation_value(std::vector<pauli_term_type> const& pauli_terms)
+  {
+    return ket::mpi::expectation_value(
+      mpi_policy_, parallel_policy_,
+      data_, pauli_terms, permutation_, buffer_, communicator_, environment_);
+  }
+
   void paged_general_mpi_state::do_shor_box(
     state_integer_type const divisor, state_integer_type const base,
     std::vector<qubit_type> const& exponent_qubits,
@@ -351,6 +471,29 @@ namespace bra
       mpi_policy_, parallel_policy_,
       data_, qubit, permutation_, buffer_, communicator_, environment_);
   }
+
+  void paged_general_mpi_state::do_assign_stabilizer_state(bra::stabilizer_tableau const& tableau)
+  {
+    auto const amplitudes
+      = tableau.amplitudes(
+          [this](state_integer_type const mask) { return ket::mpi::permutate_bits(permutation_, mask); });
+    auto const present_rank = communicator_.rank(environment_);
+    auto range_first_index = state_integer_type{0u};
+    ket::mpi::utility::for_each_local_range(
+      mpi_policy_, data_, communicator_, environment_,
+      [this, &amplitudes, present_rank, &range_first_index](auto const first, auto const last)
+      {
+        using ket::mpi::utility::rank_index_to_qubit_value;
+        auto const first_value = rank_index_to_qubit_value(mpi_policy_, data_, present_rank, range_first_index);
+        auto const range_size = static_cast<state_integer_type>(last - first);
+        ket::utility::loop_n(
+          parallel_policy_, range_size,
+          [first, first_value, &amplitudes](state_integer_type const index, int const)
+          { *(first + index) = amplitudes(first_value + index); });
+        range_first_index += range_size;
+      });
+    ket::mpi::page::unmark_zero_pages(data_);
+  }
 } // namespace bra
 
 
@@ -0,0 +1,262 @@
+#include <cstddef>
+#include <cstdint>
+
+#ifndef BRA_NO_MPI
+# include <yampi/rank.hpp>
+
+# include <ket/mpi/utility/num_sent_bytes.hpp>
+#endif // BRA_NO_MPI
+
+#include <bra/program.hpp>
+#include <bra/instruction.hpp>
+#include <bra/state.hpp>
+#include <bra/gates.hpp>
+#include <bra/gate/gate.hpp>
+#include <bra/tracer.hpp>
+
+
+namespace bra
+{
+  program::program()
+    : data_{}, operands_list_{}
+  { }
+
+  program::program(::bra::gates const& gates)
+    : data_{}, operands_list_{}
+  {
+    data_.reserve(gates.size());
+    for (auto const& gate_ptr: gates)
+      push_back(*gate_ptr);
+  }
+
+  void program::push_back(::bra::gate::gate const& gate)
+  { data_.push_back(gate.instruction(operands_list_)); }
+
+  ::bra::state& program::apply(::bra::state& state) const
+  {
+    for (auto const& instruction: data_)
+      apply_instruction(state, instruction);
+
+    return state;
+  }
+
+  ::bra::state& program::apply(::bra::state& state, ::bra::tracer& tracer) const
+  {
+    for (auto index = std::size_t{0u}, size = data_.size(); index < size; ++index)
+    {
+#ifndef BRA_NO_MPI
+      auto const old_num_sent_bytes = ket::mpi::utility::num_sent_bytes();
+#endif // BRA_NO_MPI
+      auto const start_time = tracer.now();
+      apply_instruction(state, data_[index]);
+#ifndef BRA_NO_MPI
+      tracer.record(index, start_time, tracer.now(), ket::mpi::utility::num_sent_bytes() - old_num_sent_bytes);
+#else // BRA_NO_MPI
+      tracer.record(index, start_time, tracer.now(), std::uint64_t{0u});
+#endif // BRA_NO_MPI
+    }
+
+    return state;
+  }
+
+  void program::apply_instruction(::bra::state& state, ::bra::instruction const& instruction) const
+  {
+    switch (instruction.code)
+    {
+     case ::bra::instruction_code::hadamard:
+      state.hadamard(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_hadamard:
+      state.adj_hadamard(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::pauli_x:
+      state.pauli_x(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_pauli_x:
+      state.adj_pauli_x(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::pauli_y:
+      state.pauli_y(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_pauli_y:
+      state.adj_pauli_y(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::pauli_z:
+      state.pauli_z(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_pauli_z:
+      state.adj_pauli_z(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::phase_shift:
+      state.phase_shift(instruction.phase_coefficient, instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_phase_shift:
+      state.adj_phase_shift(instruction.phase_coefficient, instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::u1:
+      state.u1(instruction.phases[0u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_u1:
+      state.adj_u1(instruction.phases[0u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::u2:
+      state.u2(instruction.phases[0u], instruction.phases[1u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_u2:
+      state.adj_u2(instruction.phases[0u], instruction.phases[1u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::u3:
+      state.u3(instruction.phases[0u], instruction.phases[1u], instruction.phases[2u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_u3:
+      state.adj_u3(instruction.phases[0u], instruction.phases[1u], instruction.phases[2u], instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::x_rotation_half_pi:
+      state.x_rotation_half_pi(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_x_rotation_half_pi:
+      state.adj_x_rotation_half_pi(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::y_rotation_half_pi:
+      state.y_rotation_half_pi(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::adj_y_rotation_half_pi:
+      state.adj_y_rotation_half_pi(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::controlled_not:
+      state.controlled_not(instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::adj_controlled_not:
+      state.adj_controlled_not(instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::controlled_phase_shift:
+      state.controlled_phase_shift(instruction.phase_coefficient, instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::adj_controlled_phase_shift:
+      state.adj_controlled_phase_shift(instruction.phase_coefficient, instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::controlled_v:
+      state.controlled_v(instruction.phase_coefficient, instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::adj_controlled_v:
+      state.adj_controlled_v(instruction.phase_coefficient, instruction.target_qubit, instruction.control_qubit1);
+      break;
+
+     case ::bra::instruction_code::toffoli:
+      state.toffoli(instruction.target_qubit, instruction.control_qubit1, instruction.control_qubit2);
+      break;
+
+     case ::bra::instruction_code::adj_toffoli:
+      state.adj_toffoli(instruction.target_qubit, instruction.control_qubit1, instruction.control_qubit2);
+      break;
+
+     case ::bra::instruction_code::clear:
+      state.clear(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::set:
+      state.set(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::unitary:
+      state.unitary(
+        operands_list_[instruction.operands_index].matrices.front(),
+        operands_list_[instruction.operands_index].qubits_list.front());
+      break;
+
+     case ::bra::instruction_code::cache_blocked_unitaries:
+      state.cache_blocked_unitaries(
+        operands_list_[instruction.operands_index].matrices, operands_list_[instruction.operands_index].qubits_list,
+        static_cast< ::bra::state::bit_integer_type >(instruction.integers[0u]));
+      break;
+
+     case ::bra::instruction_code::diagonal:
+      state.diagonal(
+        operands_list_[instruction.operands_index].matrices, operands_list_[instruction.operands_index].qubits_list);
+      break;
+
+     case ::bra::instruction_code::remap_qubits:
+      state.remap_qubits(
+        operands_list_[instruction.operands_index].qubits_list[0u],
+        operands_list_[instruction.operands_index].qubits_list[1u]);
+      break;
+
+     case ::bra::instruction_code::expectation_value:
+      state.expectation_value(operands_list_[instruction.operands_index].pauli_terms);
+      break;
+
+     case ::bra::instruction_code::shor_box:
+      state.shor_box(
+        static_cast< ::bra::state::bit_integer_type >(instruction.integers[0u]),
+        instruction.integers[1u], instruction.integers[2u]);
+      break;
+
+     case ::bra::instruction_code::depolarizing_channel:
+      state.depolarizing_channel(
+        instruction.phases[0u], instruction.phases[1u], instruction.phases[2u],
+        static_cast<int>(instruction.integers[0u]));
+      break;
+
+#ifndef BRA_NO_MPI
+     case ::bra::instruction_code::projective_measurement:
+      state.projective_measurement(instruction.target_qubit, yampi::rank{static_cast<int>(instruction.integers[0u])});
+      break;
+
+     case ::bra::instruction_code::measurement:
+      state.measurement(yampi::rank{static_cast<int>(instruction.integers[0u])});
+      break;
+
+     case ::bra::instruction_code::exit:
+      state.exit(yampi::rank{static_cast<int>(instruction.integers[0u])});
+      break;
+
+     case ::bra::instruction_code::generate_events:
+      state.generate_events(
+        yampi::rank{static_cast<int>(instruction.integers[0u])},
+        static_cast<int>(instruction.integers[1u]), static_cast<int>(instruction.integers[2u]));
+      break;
+#else // BRA_NO_MPI
+     case ::bra::instruction_code::projective_measurement:
+      state.projective_measurement(instruction.target_qubit);
+      break;
+
+     case ::bra::instruction_code::measurement:
+      state.measurement();
+      break;
+
+     case ::bra::instruction_code::exit:
+      state.exit();
+      break;
+
+     case ::bra::instruction_code::generate_events:
+      state.generate_events(static_cast<int>(instruction.integers[1u]), static_cast<int>(instruction.integers[2u]));
+      break;
+#endif // BRA_NO_MPI
+    }
+  }
+} // namespace bra
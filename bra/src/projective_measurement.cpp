@@ -1,3 +1,4 @@
+#include <cstdint>
 #include <string>
 #include <ios>
 #include <iomanip>
@@ -45,5 +46,17 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    projective_measurement::qubits_type projective_measurement::do_local_qubits() const
+    { return {qubit_}; }
+
+    ::bra::instruction projective_measurement::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    {
+      auto result = ::bra::make_instruction(::bra::instruction_code::projective_measurement, qubit_);
+#ifndef BRA_NO_MPI
+      result.integers[0u] = static_cast<std::uint64_t>(root_.mpi_rank());
+#endif // BRA_NO_MPI
+      return result;
+    }
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,49 @@
+#include <cstddef>
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include <ket/qubit_io.hpp>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/remap_qubits.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const remap_qubits::name_ = "REMAP";
+
+    remap_qubits::remap_qubits(qubits_type&& nonlocal_qubits, qubits_type&& evicted_qubits)
+      : ::bra::gate::gate{},
+        nonlocal_qubits_{std::move(nonlocal_qubits)}, evicted_qubits_{std::move(evicted_qubits)}
+    { }
+
+    ::bra::state& remap_qubits::do_apply(::bra::state& state) const
+    { return state.remap_qubits(nonlocal_qubits_, evicted_qubits_); }
+
+    std::string const& remap_qubits::do_name() const { return name_; }
+    std::string remap_qubits::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream << std::right;
+      for (auto index = std::size_t{0u}; index < nonlocal_qubits_.size(); ++index)
+        repr_stream
+          << std::setw(parameter_width) << nonlocal_qubits_[index]
+          << std::setw(parameter_width) << evicted_qubits_[index];
+      return repr_stream.str();
+    }
+
+    ::bra::instruction remap_qubits::do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+    {
+      auto operands = ::bra::instruction_operands{};
+      operands.qubits_list.push_back(nonlocal_qubits_);
+      operands.qubits_list.push_back(evicted_qubits_);
+      return ::bra::make_instruction(::bra::instruction_code::remap_qubits, std::move(operands), operands_list);
+    }
+  } // namespace gate
+} // namespace bra
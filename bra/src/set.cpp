@@ -32,5 +32,11 @@ namespace bra
         << std::setw(parameter_width) << qubit_;
       return repr_stream.str();
     }
+
+    set::qubits_type set::do_local_qubits() const
+    { return {qubit_}; }
+
+    ::bra::instruction set::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::set, qubit_); }
   } // namespace gate
 } // namespace bra
@@ -25,5 +25,12 @@ namespace bra
     std::string shor_box::do_representation(
       std::ostringstream& repr_stream, int const) const
     { return repr_stream.str(); }
+
+    ::bra::instruction shor_box::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    {
+      auto result = ::bra::make_instruction(::bra::instruction_code::shor_box);
+      result.integers = {num_exponent_qubits_, divisor_, base_};
+      return result;
+    }
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,245 @@
+#include <cassert>
+#include <cstddef>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+#include <ket/utility/parity.hpp>
+
+#include <bra/stabilizer_tableau.hpp>
+
+
+namespace bra
+{
+  ::bra::pauli_operator operator*(::bra::pauli_operator const& lhs, ::bra::pauli_operator const& rhs)
+  {
+    auto const phase
+      = lhs.phase + rhs.phase + (ket::utility::parity(lhs.z_mask bitand rhs.x_mask) ? 2u : 0u);
+    return ::bra::pauli_operator{phase % 4u, lhs.x_mask xor rhs.x_mask, lhs.z_mask xor rhs.z_mask};
+  }
+
+  stabilizer_amplitudes::stabilizer_amplitudes(
+    std::vector< ::bra::pauli_operator > stabilizers, bit_integer_type const num_qubits)
+    : x_stabilizers_{}, pivot_masks_{}, support_value_{state_integer_type{0u}}, magnitude_{real_type{1}}
+  {
+    // Gauss-Jordan elimination on x_masks: the first num_x_stabilizers stabilizers have distinct pivots
+    auto const first = std::begin(stabilizers);
+    auto const last = std::end(stabilizers);
+    auto num_x_stabilizers = std::size_t{0u};
+    for (auto bit = num_qubits; bit-- > bit_integer_type{0u}; )
+    {
+      auto const pivot_mask = state_integer_type{1u} << bit;
+      auto const found
+        = std::find_if(
+            first + num_x_stabilizers, last,
+            [pivot_mask](::bra::pauli_operator const& stabilizer)
+            { return (stabilizer.x_mask bitand pivot_mask) != state_integer_type{0u}; });
+      if (found == last)
+        continue;
+
+      std::iter_swap(first + num_x_stabilizers, found);
+      for (auto index = std::size_t{0u}; index < stabilizers.size(); ++index)
+        if (index != num_x_stabilizers and (stabilizers[index].x_mask bitand pivot_mask) != state_integer_type{0u})
+          stabilizers[index] = stabilizers[index] * stabilizers[num_x_stabilizers];
+
+      pivot_masks_.push_back(pivot_mask);
+      ++num_x_stabilizers;
+    }
+
+    x_stabilizers_.assign(first, first + num_x_stabilizers);
+    magnitude_ = std::pow(real_type{2}, -static_cast<real_type>(num_x_stabilizers) / real_type{2});
+
+    // The rest are (-1)^s Z^z, and Gauss-Jordan elimination on their z_masks gives a value satisfying
+    // parity(z & value) == s for all of them, which is in the support
+    auto num_z_stabilizers = num_x_stabilizers;
+    auto z_pivot_masks = std::vector<state_integer_type>{};
+    for (auto bit = num_qubits; bit-- > bit_integer_type{0u}; )
+    {
+      auto const pivot_mask = state_integer_type{1u} << bit;
+      auto const found
+        = std::find_if(
+            first + num_z_stabilizers, last,
+            [pivot_mask](::bra::pauli_operator const& stabilizer)
+            { return (stabilizer.z_mask bitand pivot_mask) != state_integer_type{0u}; });
+      if (found == last)
+        continue;
+
+      std::iter_swap(first + num_z_stabilizers, found);
+      for (auto index = num_x_stabilizers; index < stabilizers.size(); ++index)
+        if (index != num_z_stabilizers and (stabilizers[index].z_mask bitand pivot_mask) != state_integer_type{0u})
+          stabilizers[index] = stabilizers[index] * stabilizers[num_z_stabilizers];
+
+      z_pivot_masks.push_back(pivot_mask);
+      ++num_z_stabilizers;
+    }
+
+    for (auto index = std::size_t{0u}; index < z_pivot_masks.size(); ++index)
+    {
+      assert(stabilizers[num_x_stabilizers + index].phase % 2u == 0u);
+      if (stabilizers[num_x_stabilizers + index].phase == 2u)
+        support_value_ |= z_pivot_masks[index];
+    }
+  }
+
+  stabilizer_amplitudes::complex_type stabilizer_amplitudes::operator()(state_integer_type const value) const
+  {
+    // If value = support_value_ xor x, the product g = i^p X^x Z^z of the stabilizers for the pivots of x satisfies
+    // <value|psi> = <value|g|psi> = i^p (-1)^|z & support_value_| <support_value_|psi>
+    auto difference = value xor support_value_;
+    auto product = ::bra::pauli_operator{0u, state_integer_type{0u}, state_integer_type{0u}};
+    for (auto index = std::size_t{0u}; index < x_stabilizers_.size(); ++index)
+      if ((difference bitand pivot_masks_[index]) != state_integer_type{0u})
+      {
+        product = product * x_stabilizers_[index];
+        difference xor_eq x_stabilizers_[index].x_mask;
+      }
+
+    if (difference != state_integer_type{0u})
+      return complex_type{real_type{0}};
+
+    auto const phase = (product.phase + (ket::utility::parity(product.z_mask bitand support_value_) ? 2u : 0u)) % 4u;
+    switch (phase)
+    {
+     case 0u:
+      return complex_type{magnitude_, real_type{0}};
+     case 1u:
+      return complex_type{real_type{0}, magnitude_};
+     case 2u:
+      return complex_type{-magnitude_, real_type{0}};
+     default:
+      return complex_type{real_type{0}, -magnitude_};
+    }
+  }
+
+  stabilizer_tableau::stabilizer_tableau(state_integer_type const initial_state_value, bit_integer_type const num_qubits)
+    : stabilizers_{}, num_qubits_{num_qubits}
+  {
+    stabilizers_.reserve(num_qubits);
+    for (auto bit = bit_integer_type{0u}; bit < num_qubits; ++bit)
+    {
+      auto const mask = state_integer_type{1u} << bit;
+      stabilizers_.push_back(
+        ::bra::pauli_operator{
+          (initial_state_value bitand mask) != state_integer_type{0u} ? 2u : 0u, state_integer_type{0u}, mask});
+    }
+  }
+
+  constexpr stabilizer_tableau::bit_integer_type stabilizer_tableau::max_num_gate_qubits;
+
+  bool stabilizer_tableau::apply(std::vector<complex_type> const& matrix, std::vector<qubit_type> const& qubits)
+  {
+    auto const num_gate_qubits = static_cast<bit_integer_type>(qubits.size());
+    if (num_gate_qubits == bit_integer_type{0u} or num_gate_qubits > max_num_gate_qubits)
+      return false;
+
+    auto const dimension = std::size_t{1u} << num_gate_qubits;
+    assert(matrix.size() == dimension * dimension);
+
+    using real_type = ::bra::state::real_type;
+    auto const tolerance = std::sqrt(std::numeric_limits<real_type>::epsilon());
+    auto const global_mask
+      = [&qubits, num_gate_qubits](std::size_t const local_mask)
+        {
+          auto result = state_integer_type{0u};
+          for (auto index = bit_integer_type{0u}; index < num_gate_qubits; ++index)
+            if (((local_mask >> index) bitand std::size_t{1u}) != std::size_t{0u})
+              result |= state_integer_type{1u} << static_cast<bit_integer_type>(qubits[index]);
+          return result;
+        };
+
+    // generators[i] is U X_i U^dagger for i < num_gate_qubits, and U Z_(i-num_gate_qubits) U^dagger otherwise.
+    // Each of them is expanded as sum_(x, z) c(x, z) X^x Z^z, and U is Clifford iff one of c(x, z) is a power of i
+    auto generators = std::vector< ::bra::pauli_operator >{};
+    generators.reserve(2u * num_gate_qubits);
+    auto conjugated_matrix = std::vector<complex_type>(dimension * dimension);
+    for (auto generator_index = bit_integer_type{0u}; generator_index < 2u * num_gate_qubits; ++generator_index)
+    {
+      auto const is_z = generator_index >= num_gate_qubits;
+      auto const bit_mask = std::size_t{1u} << (is_z ? generator_index - num_gate_qubits : generator_index);
+      for (auto row = std::size_t{0u}; row < dimension; ++row)
+        for (auto column = std::size_t{0u}; column < dimension; ++column)
+        {
+          auto element = complex_type{real_type{0}};
+          for (auto index = std::size_t{0u}; index < dimension; ++index)
+            if (is_z)
+              element
+                += ((index bitand bit_mask) != std::size_t{0u} ? -matrix[row * dimension + index] : matrix[row * dimension + index])
+                   * std::conj(matrix[column * dimension + index]);
+            else
+              element += matrix[row * dimension + (index xor bit_mask)] * std::conj(matrix[column * dimension + index]);
+          conjugated_matrix[row * dimension + column] = element;
+        }
+
+      auto is_clifford = false;
+      for (auto x_mask = std::size_t{0u}; x_mask < dimension and not is_clifford; ++x_mask)
+        for (auto z_mask = std::size_t{0u}; z_mask < dimension and not is_clifford; ++z_mask)
+        {
+          auto coefficient = complex_type{real_type{0}};
+          for (auto column = std::size_t{0u}; column < dimension; ++column)
+            coefficient
+              += ket::utility::parity(z_mask bitand column)
+                 ? -conjugated_matrix[(column xor x_mask) * dimension + column]
+                 : conjugated_matrix[(column xor x_mask) * dimension + column];
+          coefficient /= static_cast<real_type>(dimension);
+
+          // sum_(x, z) |c(x, z)|^2 = 1 because the conjugated matrix is unitary
+          if (std::norm(coefficient) < real_type{0.5})
+            continue;
+
+          auto power = complex_type{real_type{1}};
+          for (auto phase = 0u; phase < 4u; ++phase, power *= complex_type{real_type{0}, real_type{1}})
+            if (std::abs(coefficient - power) < tolerance)
+            {
+              generators.push_back(::bra::pauli_operator{phase, global_mask(x_mask), global_mask(z_mask)});
+              is_clifford = true;
+              break;
+            }
+
+          if (not is_clifford)
+            return false;
+        }
+
+      if (not is_clifford)
+        return false;
+    }
+
+    // images[x + (z << num_gate_qubits)] is U X^x Z^z U^dagger, which is the product of the images of the X's and
+    // those of the Z's in this order
+    auto const num_images = std::size_t{1u} << (2u * num_gate_qubits);
+    auto images = std::vector< ::bra::pauli_operator >{};
+    images.reserve(num_images);
+    images.push_back(::bra::pauli_operator{0u, state_integer_type{0u}, state_integer_type{0u}});
+    for (auto index = std::size_t{1u}, highest_bit = std::size_t{0u}; index < num_images; ++index)
+    {
+      if (index == (std::size_t{2u} << highest_bit))
+        ++highest_bit;
+      images.push_back(images[index xor (std::size_t{1u} << highest_bit)] * generators[highest_bit]);
+    }
+
+    auto const gate_mask = global_mask(dimension - std::size_t{1u});
+    for (auto& stabilizer: stabilizers_)
+    {
+      auto image_index = std::size_t{0u};
+      for (auto index = bit_integer_type{0u}; index < num_gate_qubits; ++index)
+      {
+        auto const qubit_mask = state_integer_type{1u} << static_cast<bit_integer_type>(qubits[index]);
+        if ((stabilizer.x_mask bitand qubit_mask) != state_integer_type{0u})
+          image_index |= std::size_t{1u} << index;
+        if ((stabilizer.z_mask bitand qubit_mask) != state_integer_type{0u})
+          image_index |= std::size_t{1u} << (index + num_gate_qubits);
+      }
+
+      // i^p X^x Z^z = (i^p X^x' Z^z') (X^x'' Z^z''), where x' and x'' are the bits of x out of and on the gate qubits
+      stabilizer
+        = ::bra::pauli_operator{
+            stabilizer.phase, stabilizer.x_mask bitand compl gate_mask, stabilizer.z_mask bitand compl gate_mask}
+          * images[image_index];
+    }
+
+    return true;
+  }
+} // namespace bra
@@ -14,8 +14,10 @@
 #endif // BRA_NO_MPI
 
 #include <ket/qubit.hpp>
+#include <ket/utility/parity.hpp>
 
 #include <bra/state.hpp>
+#include <bra/stabilizer_tableau.hpp>
 #include <bra/utility/closest_floating_point_of.hpp>
 
 #ifndef BRA_NO_MPI
@@ -38,6 +40,9 @@ namespace bra
       maybe_expectation_values_{},
       measured_value_{},
       generated_events_{},
+      observable_expectation_values_{},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
       random_number_generator_{seed},
       permutation_{static_cast<permutation_type::size_type>(total_num_qubits)},
       buffer_{},
@@ -57,6 +62,9 @@ namespace bra
       maybe_expectation_values_{},
       measured_value_{},
       generated_events_{},
+      observable_expectation_values_{},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
       random_number_generator_{seed},
       permutation_{
         std::begin(initial_permutation), std::end(initial_permutation)},
@@ -73,6 +81,9 @@ namespace bra
       maybe_expectation_values_{},
       measured_value_{},
       generated_events_{},
+      observable_expectation_values_{},
+      pauli_frame_x_mask_{0u},
+      pauli_frame_z_mask_{0u},
       random_number_generator_{seed},
       finish_times_and_processes_{}
   { finish_times_and_processes_.reserve(2u); }
@@ -81,6 +92,7 @@ namespace bra
 #ifndef BRA_NO_MPI
   ::bra::state& state::projective_measurement(qubit_type const qubit, yampi::rank const root)
   {
+    apply_pauli_frame();
     last_outcomes_[static_cast<bit_integer_type>(qubit)]
       = do_projective_measurement(qubit, root);
     return *this;
@@ -88,6 +100,7 @@ namespace bra
 
   ::bra::state& state::measurement(yampi::rank const root)
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(environment_), ::bra::finished_process::operations));
@@ -102,6 +115,7 @@ namespace bra
 
   ::bra::state& state::generate_events(yampi::rank const root, int const num_events, int const seed)
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(environment_), ::bra::finished_process::operations));
@@ -116,6 +130,7 @@ namespace bra
 
   ::bra::state& state::exit(yampi::rank const root)
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(environment_), ::bra::finished_process::operations));
@@ -130,6 +145,7 @@ namespace bra
 #else // BRA_NO_MPI
   ::bra::state& state::projective_measurement(qubit_type const qubit)
   {
+    apply_pauli_frame();
     last_outcomes_[static_cast<bit_integer_type>(qubit)]
       = do_projective_measurement(qubit);
     return *this;
@@ -137,6 +153,7 @@ namespace bra
 
   ::bra::state& state::measurement()
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(), ::bra::finished_process::operations));
@@ -151,6 +168,7 @@ namespace bra
 
   ::bra::state& state::generate_events(int const num_events, int const seed)
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(), ::bra::finished_process::operations));
@@ -165,6 +183,7 @@ namespace bra
 
   ::bra::state& state::exit()
   {
+    apply_pauli_frame();
     finish_times_and_processes_.push_back(
       std::make_pair(
         BRA_clock::now(), ::bra::finished_process::operations));
@@ -178,6 +197,38 @@ namespace bra
   }
 #endif // BRA_NO_MPI
 
+  // <psi|P H P|psi> is computed instead of applying the Pauli frame P, where P h P = -h if h anticommutes with P
+  ::bra::state& state::expectation_value(std::vector<pauli_term_type> const& pauli_terms)
+  {
+    auto conjugated_pauli_terms = pauli_terms;
+    for (auto& term: conjugated_pauli_terms)
+      if (ket::utility::parity(
+            (pauli_frame_x_mask_ bitand term.z_mask) xor (pauli_frame_z_mask_ bitand term.x_mask)))
+        term.coefficient = -term.coefficient;
+
+#ifndef BRA_NO_MPI
+    finish_times_and_processes_.push_back(
+      std::make_pair(
+        BRA_clock::now(environment_), ::bra::finished_process::operations));
+
+    observable_expectation_values_.push_back(do_expectation_value(conjugated_pauli_terms));
+    finish_times_and_processes_.push_back(
+      std::make_pair(
+        BRA_clock::now(environment_), ::bra::finished_process::expectation_value));
+#else // BRA_NO_MPI
+    finish_times_and_processes_.push_back(
+      std::make_pair(
+        BRA_clock::now(), ::bra::finished_process::operations));
+
+    observable_expectation_values_.push_back(do_expectation_value(conjugated_pauli_terms));
+    finish_times_and_processes_.push_back(
+      std::make_pair(
+        BRA_clock::now(), ::bra::finished_process::expectation_value));
+#endif // BRA_NO_MPI
+
+    return *this;
+  }
+
   ::bra::state& state::shor_box(bit_integer_type const num_exponent_qubits, state_integer_type const divisor, state_integer_type const base)
   {
     auto exponent_qubits = std::vector<qubit_type>(num_exponent_qubits);
@@ -190,11 +241,21 @@ namespace bra
       std::begin(modular_exponentiation_qubits), std::end(modular_exponentiation_qubits),
       qubit_type{0u});
 
+    apply_pauli_frame();
     do_shor_box(divisor, base, exponent_qubits, modular_exponentiation_qubits);
 
     return *this;
   }
 
+  ::bra::state& state::assign_stabilizer_state(::bra::stabilizer_tableau const& tableau)
+  {
+    pauli_frame_x_mask_ = state_integer_type{0u};
+    pauli_frame_z_mask_ = state_integer_type{0u};
+    do_assign_stabilizer_state(tableau);
+
+    return *this;
+  }
+
   ::bra::state& state::depolarizing_channel(real_type const px, real_type const py, real_type const pz, int const seed)
   {
     using floating_point_type = typename ::bra::utility::closest_floating_point_of<real_type>::type;
@@ -205,11 +266,14 @@ namespace bra
       {
         auto const probability = static_cast<real_type>(distribution(random_number_generator_));
         if (probability < px)
-          pauli_x(qubit);
+          pauli_frame_x_mask_ ^= qubit_mask(qubit);
         else if (probability < px + py)
-          pauli_y(qubit);
+        {
+          pauli_frame_x_mask_ ^= qubit_mask(qubit);
+          pauli_frame_z_mask_ ^= qubit_mask(qubit);
+        }
         else if (probability < px + py + pz)
-          pauli_z(qubit);
+          pauli_frame_z_mask_ ^= qubit_mask(qubit);
       }
     else
     {
@@ -218,16 +282,91 @@ namespace bra
       {
         auto const probability = static_cast<real_type>(distribution(temporal_random_number_generator));
         if (probability < px)
-          pauli_x(qubit);
+          pauli_frame_x_mask_ ^= qubit_mask(qubit);
         else if (probability < px + py)
-          pauli_y(qubit);
+        {
+          pauli_frame_x_mask_ ^= qubit_mask(qubit);
+          pauli_frame_z_mask_ ^= qubit_mask(qubit);
+        }
         else if (probability < px + py + pz)
-          pauli_z(qubit);
+          pauli_frame_z_mask_ ^= qubit_mask(qubit);
       }
     }
 
     return *this;
   }
+  ::bra::state& state::cache_blocked_unitaries(
+    std::vector<std::vector<complex_type>> const& matrices,
+    std::vector<std::vector<qubit_type>> const& qubits_list,
+    bit_integer_type const num_block_qubits)
+  {
+    auto mask = state_integer_type{0u};
+    for (auto const& qubits: qubits_list)
+      mask |= qubits_mask(qubits);
+    apply_pauli_frame_if_noncommuting(mask, mask);
+
+    do_cache_blocked_unitaries(matrices, qubits_list, num_block_qubits);
+    return *this;
+  }
+
+  // Z's commute with diagonal gates
+  ::bra::state& state::diagonal(
+    std::vector<std::vector<complex_type>> const& diagonals,
+    std::vector<std::vector<qubit_type>> const& qubits_list)
+  {
+    auto mask = state_integer_type{0u};
+    for (auto const& qubits: qubits_list)
+      mask |= qubits_mask(qubits);
+    apply_pauli_frame_if_noncommuting(mask, state_integer_type{0u});
+
+    do_diagonal(diagonals, qubits_list);
+    return *this;
+  }
+
+  state::state_integer_type state::qubits_mask(std::vector<qubit_type> const& qubits)
+  {
+    auto result = state_integer_type{0u};
+    for (auto const qubit: qubits)
+      result |= qubit_mask(qubit);
+    return result;
+  }
+
+  void state::apply_pauli_frame()
+  {
+    if (pauli_frame_x_mask_ == state_integer_type{0u} and pauli_frame_z_mask_ == state_integer_type{0u})
+      return;
+
+    do_pauli_string(pauli_frame_x_mask_, pauli_frame_z_mask_);
+    pauli_frame_x_mask_ = state_integer_type{0u};
+    pauli_frame_z_mask_ = state_integer_type{0u};
+  }
+
+  void state::apply_pauli_frame_if_noncommuting(state_integer_type const x_mask, state_integer_type const z_mask)
+  {
+    if ((pauli_frame_x_mask_ bitand x_mask) != state_integer_type{0u}
+        or (pauli_frame_z_mask_ bitand z_mask) != state_integer_type{0u})
+      apply_pauli_frame();
+  }
+
+  void state::swap_pauli_frame_bits(qubit_type const qubit)
+  {
+    auto const mask = qubit_mask(qubit);
+    if (((pauli_frame_x_mask_ xor pauli_frame_z_mask_) bitand mask) == state_integer_type{0u})
+      return;
+
+    pauli_frame_x_mask_ ^= mask;
+    pauli_frame_z_mask_ ^= mask;
+  }
+
+  // CNOT maps X on the control qubit to XX, and Z on the target qubit to ZZ
+  void state::propagate_pauli_frame_through_controlled_not(
+    qubit_type const target_qubit, control_qubit_type const control_qubit)
+  {
+    if ((pauli_frame_x_mask_ bitand qubit_mask(control_qubit.qubit())) != state_integer_type{0u})
+      pauli_frame_x_mask_ ^= qubit_mask(target_qubit);
+    if ((pauli_frame_z_mask_ bitand qubit_mask(target_qubit)) != state_integer_type{0u})
+      pauli_frame_z_mask_ ^= qubit_mask(control_qubit.qubit());
+  }
 } // namespace bra
 
 
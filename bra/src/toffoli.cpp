@@ -5,10 +5,12 @@
 
 #include <ket/qubit_io.hpp>
 #include <ket/control_io.hpp>
+#include <ket/gate/toffoli.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/toffoli.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -37,5 +39,21 @@ namespace bra
         << std::setw(parameter_width) << target_qubit_;
       return repr_stream.str();
     }
+
+    toffoli::qubits_type toffoli::do_fusible_qubits() const
+    { return {target_qubit_, control_qubit1_.qubit(), control_qubit2_.qubit()}; }
+
+    toffoli::matrix_type toffoli::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        3u, [this](matrix_type& column)
+        {
+          ::ket::gate::ranges::toffoli(
+            column, qubit_type{0u}, control_qubit_type{qubit_type{1u}}, control_qubit_type{qubit_type{2u}});
+        });
+    }
+
+    ::bra::instruction toffoli::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::toffoli, target_qubit_, control_qubit1_, control_qubit2_); }
   } // namespace gate
 } // namespace bra
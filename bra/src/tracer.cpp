@@ -0,0 +1,131 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <iterator>
+
+#ifndef BRA_NO_MPI
+# include <yampi/rank.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/environment.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/tag.hpp>
+# include <yampi/status.hpp>
+# include <yampi/send.hpp>
+# include <yampi/receive.hpp>
+#endif // BRA_NO_MPI
+
+#include <bra/tracer.hpp>
+#include <bra/gates.hpp>
+#include <bra/gate/gate.hpp>
+
+
+namespace bra
+{
+  tracer::tracer(std::size_t const capacity)
+    : events_(capacity), num_recorded_events_{0u}, initial_time_{clock_type::now()}
+  { assert(capacity > std::size_t{0u}); }
+
+  std::vector< ::bra::trace_event > tracer::events() const
+  {
+    if (num_recorded_events_ <= events_.size())
+      return std::vector< ::bra::trace_event >(events_.begin(), events_.begin() + num_recorded_events_);
+
+    auto result = std::vector< ::bra::trace_event >{};
+    result.reserve(events_.size());
+    auto const oldest = events_.begin() + num_recorded_events_ % events_.size();
+    std::copy(oldest, events_.end(), std::back_inserter(result));
+    std::copy(events_.begin(), oldest, std::back_inserter(result));
+    return result;
+  }
+
+  namespace tracer_detail
+  {
+    void write_events(
+      std::ostream& output_stream, bool& is_first, std::vector< ::bra::trace_event > const& events,
+      int const rank, ::bra::gates const& gates)
+    {
+      for (auto const& event: events)
+      {
+        auto const& gate = *gates[event.gate_index];
+        output_stream
+          << (is_first ? "\n" : ",\n")
+          << "{\"name\":\"" << gate.name() << "\",\"cat\":\"gate\",\"ph\":\"X\""
+          << ",\"ts\":" << 1.0e+6 * event.start_time << ",\"dur\":" << 1.0e+6 * (event.end_time - event.start_time)
+          << ",\"pid\":" << rank << ",\"tid\":0"
+          << ",\"args\":{\"index\":" << event.gate_index
+          << ",\"gate\":\"" << gate.representation() << '"'
+          << ",\"sent_bytes\":" << event.num_sent_bytes << "}}";
+        is_first = false;
+      }
+    }
+  } // namespace tracer_detail
+
+#ifndef BRA_NO_MPI
+  void tracer::write(
+    std::ostream& output_stream, ::bra::gates const& gates,
+    yampi::rank const root, yampi::communicator const& communicator, yampi::environment const& environment) const
+  {
+    auto const rank = communicator.rank(environment);
+    auto const present_events = events();
+
+    // events are sent as (gate_index, start_time, end_time, num_sent_bytes) arrays of doubles
+    if (rank != root)
+    {
+      auto values = std::vector<double>{};
+      values.reserve(4u * present_events.size());
+      for (auto const& event: present_events)
+      {
+        values.push_back(static_cast<double>(event.gate_index));
+        values.push_back(event.start_time);
+        values.push_back(event.end_time);
+        values.push_back(static_cast<double>(event.num_sent_bytes));
+      }
+
+      auto const num_values = static_cast<int>(values.size());
+      yampi::send(yampi::make_buffer(num_values), root, yampi::tag{0}, communicator, environment);
+      yampi::send(yampi::make_buffer(values.begin(), values.end()), root, yampi::tag{0}, communicator, environment);
+      return;
+    }
+
+    output_stream << "{\"traceEvents\":[";
+    auto is_first = true;
+    auto const size = communicator.size(environment);
+    for (auto source_rank = 0; source_rank < size; ++source_rank)
+    {
+      auto const source = yampi::rank{source_rank};
+      if (source == root)
+      {
+        ::bra::tracer_detail::write_events(output_stream, is_first, present_events, root.mpi_rank(), gates);
+        continue;
+      }
+
+      auto num_values = int{};
+      yampi::receive(yampi::ignore_status(), yampi::make_buffer(num_values), source, yampi::tag{0}, communicator, environment);
+      auto values = std::vector<double>(num_values);
+      yampi::receive(
+        yampi::ignore_status(), yampi::make_buffer(values.begin(), values.end()), source, yampi::tag{0}, communicator, environment);
+
+      auto source_events = std::vector< ::bra::trace_event >{};
+      source_events.reserve(values.size() / 4u);
+      for (auto iter = values.begin(); iter != values.end(); iter += 4)
+        source_events.push_back(
+          ::bra::trace_event{
+            static_cast<std::size_t>(iter[0]), iter[1], iter[2], static_cast<std::uint64_t>(iter[3])});
+      ::bra::tracer_detail::write_events(output_stream, is_first, source_events, source.mpi_rank(), gates);
+    }
+    output_stream << "\n]}\n";
+  }
+#else // BRA_NO_MPI
+  void tracer::write(std::ostream& output_stream, ::bra::gates const& gates) const
+  {
+    output_stream << "{\"traceEvents\":[";
+    auto is_first = true;
+    ::bra::tracer_detail::write_events(output_stream, is_first, events(), 0, gates);
+    output_stream << "\n]}\n";
+  }
+#endif // BRA_NO_MPI
+} // namespace bra
@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/phase_shift.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/u2.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -35,5 +37,17 @@ namespace bra
         << std::setw(parameter_width) << phase2_;
       return repr_stream.str();
     }
+
+    u2::qubits_type u2::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    u2::matrix_type u2::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::phase_shift2(column, phase1_, phase2_, qubit_type{0u}); });
+    }
+
+    ::bra::instruction u2::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::u2, {phase1_, phase2_, real_type{}}, qubit_); }
   } // namespace gate
 } // namespace bra
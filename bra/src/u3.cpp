@@ -4,10 +4,12 @@
 #include <sstream>
 
 #include <ket/qubit_io.hpp>
+#include <ket/gate/phase_shift.hpp>
 
 #include <bra/gate/gate.hpp>
 #include <bra/gate/u3.hpp>
 #include <bra/state.hpp>
+#include <bra/utility/make_gate_matrix.hpp>
 
 
 namespace bra
@@ -36,5 +38,17 @@ namespace bra
         << std::setw(parameter_width) << phase3_;
       return repr_stream.str();
     }
+
+    u3::qubits_type u3::do_fusible_qubits() const
+    { return {qubit_}; }
+
+    u3::matrix_type u3::do_matrix() const
+    {
+      return ::bra::utility::make_gate_matrix<complex_type>(
+        1u, [this](matrix_type& column) { ::ket::gate::ranges::phase_shift3(column, phase1_, phase2_, phase3_, qubit_type{0u}); });
+    }
+
+    ::bra::instruction u3::do_instruction(std::vector< ::bra::instruction_operands >&) const
+    { return ::bra::make_instruction(::bra::instruction_code::u3, {phase1_, phase2_, phase3_}, qubit_); }
   } // namespace gate
 } // namespace bra
@@ -0,0 +1,51 @@
+#include <string>
+#include <ios>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include <ket/qubit_io.hpp>
+
+#include <bra/gate/gate.hpp>
+#include <bra/gate/unitary.hpp>
+#include <bra/state.hpp>
+
+
+namespace bra
+{
+  namespace gate
+  {
+    std::string const unitary::name_ = "UNITARY";
+
+    unitary::unitary(matrix_type&& matrix, qubits_type&& qubits)
+      : ::bra::gate::gate{}, matrix_{std::move(matrix)}, qubits_{std::move(qubits)}
+    { }
+
+    ::bra::state& unitary::do_apply(::bra::state& state) const
+    { return state.unitary(matrix_, qubits_); }
+
+    std::string const& unitary::do_name() const { return name_; }
+    std::string unitary::do_representation(
+      std::ostringstream& repr_stream, int const parameter_width) const
+    {
+      repr_stream << std::right;
+      for (auto const qubit: qubits_)
+        repr_stream << std::setw(parameter_width) << qubit;
+      return repr_stream.str();
+    }
+
+    unitary::qubits_type unitary::do_fusible_qubits() const
+    { return qubits_; }
+
+    unitary::matrix_type unitary::do_matrix() const
+    { return matrix_; }
+
+    ::bra::instruction unitary::do_instruction(std::vector< ::bra::instruction_operands >& operands_list) const
+    {
+      auto operands = ::bra::instruction_operands{};
+      operands.matrices.push_back(matrix_);
+      operands.qubits_list.push_back(qubits_);
+      return ::bra::make_instruction(::bra::instruction_code::unitary, std::move(operands), operands_list);
+    }
+  } // namespace gate
+} // namespace bra
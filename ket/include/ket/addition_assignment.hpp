@@ -5,54 +5,91 @@
 # include <cstddef>
 # include <vector>
 # include <iterator>
+# include <algorithm>
 # include <type_traits>
 
+# include <boost/range/size.hpp>
 # include <boost/range/value_type.hpp>
 
-# include <ket/control.hpp>
-# include <ket/swapped_fourier_transform.hpp>
-# include <ket/gate/controlled_phase_shift.hpp>
+# include <ket/gate/basis_permutation.hpp>
 # include <ket/meta/state_integer_of.hpp>
 # include <ket/meta/bit_integer_of.hpp>
-# include <ket/utility/generate_phase_coefficients.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/loop_n.hpp>
 
 
 namespace ket
 {
-  // lhs += rhs
+  // lhs += rhs: |l>|r_1>...|r_m> -> |l + r_1 + ... + r_m mod 2^n>|r_1>...|r_m>, where the lowest bit of each register
+  //   is its first qubit. It is a permutation of the basis states, so the amplitudes are moved by one pass of
+  //   ket::gate::basis_permutation instead of applying the Fourier transform and O(n^2) controlled phase shifts.
+  //   The overloads taking phase_coefficients are kept for the source compatibility, and they leave it untouched
   namespace addition_assignment_detail
   {
+    // register_addition: t + s (or t - s) modulo 2^n, where t is the value of the lhs register and s is the sum of
+    //   the values of the rhs registers in o. rhs_bits_[k * n + i] is the bit of o for the i-th qubit of the k-th
+    //   rhs register
+    template <typename StateInteger, typename BitInteger>
+    class register_addition
+    {
+      StateInteger lhs_mask_;
+      std::size_t num_qubits_;
+      std::vector<BitInteger> rhs_bits_;
+      bool is_subtraction_;
+
+     public:
+      template <typename QubitsRange, typename BitFunction>
+      register_addition(
+        std::size_t const num_qubits, QubitsRange const& rhs_qubits_range, BitFunction bit_function,
+        bool const is_subtraction)
+        : lhs_mask_{::ket::utility::integer_exp2<StateInteger>(num_qubits) - StateInteger{1u}},
+          num_qubits_{num_qubits},
+          rhs_bits_{},
+          is_subtraction_{is_subtraction}
+      {
+        for (auto const& rhs_qubits: rhs_qubits_range)
+          for (auto const rhs_qubit: rhs_qubits)
+            rhs_bits_.push_back(bit_function(rhs_qubit));
+      }
+
+      StateInteger operator()(StateInteger const value, StateInteger const other_index) const
+      {
+        auto summand = StateInteger{0u};
+        for (auto first_bit = std::size_t{0u}; first_bit < rhs_bits_.size(); first_bit += num_qubits_)
+          for (auto bit = std::size_t{0u}; bit < num_qubits_; ++bit)
+            summand += ((other_index >> rhs_bits_[first_bit + bit]) bitand StateInteger{1u}) << bit;
+
+        return (is_subtraction_ ? value - summand : value + summand) bitand lhs_mask_;
+      }
+    }; // class register_addition<StateInteger, BitInteger>
+
     template <
       typename ParallelPolicy,
-      typename RandomAccessIterator, typename Iterator1, typename Iterator2,
-      typename PhaseCoefficientsAllocator>
+      typename RandomAccessIterator, typename Qubits, typename QubitsRange>
     inline void addition_assignment(
       ParallelPolicy const parallel_policy,
       RandomAccessIterator const first, RandomAccessIterator const last,
-      Iterator1 const& lhs_qubits_first, Iterator2 const& rhs_qubits_first,
-      std::size_t const num_qubits,
-      std::vector<
-        typename std::iterator_traits<RandomAccessIterator>::value_type,
-        PhaseCoefficientsAllocator>& phase_coefficients)
+      Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range, bool const is_subtraction)
     {
-      for (auto phase_exponent = std::size_t{1u};
-           phase_exponent <= num_qubits; ++phase_exponent)
-      {
-        auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-        for (auto control_bit_index = std::size_t{0u};
-             control_bit_index <= num_qubits - phase_exponent; ++control_bit_index)
-        {
-          auto const target_bit_index
-            = control_bit_index + (phase_exponent - std::size_t{1u});
-
-          ::ket::gate::controlled_phase_shift_coeff(
-            parallel_policy,
-            first, last, phase_coefficient,
-            lhs_qubits_first[target_bit_index],
-            ::ket::make_control(rhs_qubits_first[control_bit_index]));
-        }
-      }
+      using qubit_type = typename boost::range_value<Qubits>::type;
+      using state_integer_type = typename ::ket::meta::state_integer_of<qubit_type>::type;
+      using bit_integer_type = typename ::ket::meta::bit_integer_of<qubit_type>::type;
+      static_assert(std::is_unsigned<state_integer_type>::value, "StateInteger should be unsigned");
+      static_assert(std::is_unsigned<bit_integer_type>::value, "BitInteger should be unsigned");
+
+      auto const num_qubits = static_cast<std::size_t>(boost::size(lhs_qubits));
+      assert(
+        std::all_of(
+          std::begin(rhs_qubits_range), std::end(rhs_qubits_range),
+          [num_qubits](typename boost::range_value<QubitsRange const>::type const& rhs_qubits)
+          { return num_qubits == static_cast<std::size_t>(boost::size(rhs_qubits)); }));
+
+      ::ket::gate::basis_permutation(
+        parallel_policy, first, last, lhs_qubits,
+        ::ket::addition_assignment_detail::register_addition<state_integer_type, bit_integer_type>{
+          num_qubits, rhs_qubits_range,
+          [](qubit_type const qubit) { return static_cast<bit_integer_type>(qubit); },
+          is_subtraction});
     }
   } // namespace addition_assignment_detail
 
@@ -67,33 +104,10 @@ namespace ket
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
     std::vector<
       typename std::iterator_traits<RandomAccessIterator>::value_type,
-      PhaseCoefficientsAllocator>& phase_coefficients)
+      PhaseCoefficientsAllocator>&)
   {
-    auto const num_qubits = std::distance(std::begin(lhs_qubits), std::end(rhs_qubits));
-    assert(
-      std::all_of(
-        std::begin(rhs_qubits_range), std::end(rhs_qubits_range),
-        [num_qubits](typename boost::range_value<QubitsRange const>::type const& rhs_qubits)
-        { return num_qubits == std::distance(std::begin(rhs_qubits), std::end(rhs_qubits)); }));
-
-    ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
-
-    using qubit_type = typename boost::range_value<Qubits>::type;
-    static_assert(
-      std::is_unsigned<typename ::ket::meta::state_integer_of<qubit_type>::type>::value,
-      "StateInteger should be unsigned");
-    static_assert(
-      std::is_unsigned<typename ::ket::meta::bit_integer_of<qubit_type>::type>::value,
-      "BitInteger should be unsigned");
-
-    ::ket::swapped_fourier_transform(parallel_policy, first, last, lhs_qubits, phase_coefficients);
-
-    for (auto const& rhs_qubits: rhs_qubits_range)
-      ::ket::addition_assignment_detail::addition_assignment(
-        parallel_policy,
-        first, last, std::begin(lhs_qubits), std::begin(rhs_qubits), num_qubits, phase_coefficients);
-
-    ::ket::adj_swapped_fourier_transform(parallel_policy, first, last, lhs_qubits, phase_coefficients);
+    ::ket::addition_assignment_detail::addition_assignment(
+      parallel_policy, first, last, lhs_qubits, rhs_qubits_range, false);
   }
 
   template <
@@ -125,14 +139,8 @@ namespace ket
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
   {
-    using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
-    auto phase_coefficients
-      = ::ket::utility::generate_phase_coefficients<complex_type>(
-          std::distance(std::begin(lhs_qubits), std::end(lhs_qubits)));
-
-    ::ket::addition_assignment(
-      parallel_policy,
-      first, last, lhs_qubits, rhs_qubits_range, phase_coefficients);
+    ::ket::addition_assignment_detail::addition_assignment(
+      parallel_policy, first, last, lhs_qubits, rhs_qubits_range, false);
   }
 
   template <
@@ -215,43 +223,6 @@ namespace ket
   } // namespace ranges
 
 
-  namespace addition_assignment_detail
-  {
-    template <
-      typename ParallelPolicy, typename RandomAccessIterator,
-      typename Iterator1, typename Iterator2,
-      typename PhaseCoefficientsAllocator>
-    inline void adj_addition_assignment(
-      ParallelPolicy const parallel_policy,
-      RandomAccessIterator const first, RandomAccessIterator const last,
-      Iterator1 const& lhs_qubits_first, Iterator2 const& rhs_qubits_first,
-      std::size_t const num_qubits,
-      std::vector<
-        typename boost::range_value<RandomAccessRange>::type,
-        PhaseCoefficientsAllocator>& phase_coefficients)
-    {
-      for (auto index = std::size_t{0u}; index < num_qubits; ++index)
-      {
-        auto const phase_exponent = num_qubits - index;
-        auto const phase_coefficient = phase_coefficients[phase_exponent];
-
-        for (auto control_bit_index = std::size_t{0u};
-             control_bit_index <= num_qubits - phase_exponent; ++control_bit_index)
-        {
-          auto const target_bit_index
-            = control_bit_index + (phase_exponent - std::size_t{1u});
-
-          ::ket::gate::adj_controlled_phase_shift_coeff(
-            parallel_policy,
-            first, last, phase_coefficient,
-            lhs_qubits_first[target_bit_index],
-            ::ket::make_control(rhs_qubits_first[control_bit_index]));
-        }
-      }
-    }
-  } // namespace addition_assignment_detail
-
-
   template <
     typename ParallelPolicy, typename RandomAccessIterator,
     typename Qubits, typename QubitsRange,
@@ -260,35 +231,12 @@ namespace ket
     ParallelPolicy const parallel_policy,
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
-    std::vector
-      typename boost::range_value<RandomAccessRange>::type,
-      PhaseCoefficientsAllocator>& phase_coefficients)
+    std::vector<
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
+      PhaseCoefficientsAllocator>&)
   {
-    auto const num_qubits = std::distance(std::begin(lhs_qubits), std::end(rhs_qubits));
-    assert(
-      std::all_of(
-        std::begin(rhs_qubits_range), std::end(rhs_qubits_range),
-        [num_qubits](typename boost::range_value<QubitsRange const>::type const& rhs_qubits)
-        { return num_qubits == std::distance(std::begin(rhs_qubits), std::end(rhs_qubits)); }));
-
-    ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
-
-    using qubit_type = typename boost::range_value<Qubits>::type;
-    static_assert(
-      std::is_unsigned<typename ::ket::meta::state_integer_of<qubit_type>::type>::value,
-      "StateInteger should be unsigned");
-    static_assert(
-      std::is_unsigned<typename ::ket::meta::bit_integer_of<qubit_type>::type>::value,
-      "BitInteger should be unsigned");
-
-    ::ket::swapped_fourier_transform(parallel_policy, first, last, lhs_qubits, phase_coefficients);
-
-    for (auto const& rhs_qubits: rhs_qubits_range)
-      ::ket::addition_assignment_detail::adj_addition_assignment(
-        parallel_policy,
-        first, last, std::begin(lhs_qubits), std::begin(rhs_qubits), num_qubits, phase_coefficients);
-
-    ::ket::adj_swapped_fourier_transform(parallel_policy, first, last, lhs_qubits, phase_coefficients);
+    ::ket::addition_assignment_detail::addition_assignment(
+      parallel_policy, first, last, lhs_qubits, rhs_qubits_range, true);
   }
 
   template <
@@ -301,8 +249,8 @@ namespace ket
   adj_addition_assignment(
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
-    std::vector
-      typename boost::range_value<RandomAccessRange>::type,
+    std::vector<
+      typename std::iterator_traits<RandomAccessIterator>::value_type,
       PhaseCoefficientsAllocator>& phase_coefficients)
   {
     ::ket::adj_addition_assignment(
@@ -321,14 +269,8 @@ namespace ket
     RandomAccessIterator const first, RandomAccessIterator const last,
     Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range)
   {
-    using complex_type = std::iterator_traits<RandomAccessIterator>::value_type;
-    auto phase_coefficients
-      = ::ket::utility::generate_phase_coefficients<complex_type>(
-          std::distance(std::begin(lhs_qubits), std::end(lhs_qubits)));
-
-    ::ket::adj_addition_assignment(
-      parallel_policy,
-      first, last, lhs_qubits, rhs_qubits_range, phase_coefficients);
+    ::ket::addition_assignment_detail::addition_assignment(
+      parallel_policy, first, last, lhs_qubits, rhs_qubits_range, true);
   }
 
   template <
@@ -352,7 +294,7 @@ namespace ket
     inline RandomAccessRange& adj_addition_assignment(
       ParallelPolicy const parallel_policy, RandomAccessRange& state,
       Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range,
-      std::vector
+      std::vector<
         typename boost::range_value<RandomAccessRange>::type,
         PhaseCoefficientsAllocator>& phase_coefficients)
     {
@@ -363,7 +305,9 @@ namespace ket
       return state;
     }
 
-    template <typename RandomAccessRange, typename Qubits, typename QubitsRange>
+    template <
+      typename RandomAccessRange, typename Qubits, typename QubitsRange,
+      typename PhaseCoefficientsAllocator>
     inline typename std::enable_if<
       not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value,
       RandomAccessRange&>::type
@@ -2,23 +2,181 @@
 # define KET_ALL_EXPECTATION_VALUES_HPP
 
 # include <cassert>
+# include <cstddef>
+# include <complex>
 # include <vector>
 # include <array>
 # include <iterator>
 
 # include <boost/range/value_type.hpp>
+# include <boost/math/constants/constants.hpp>
 
-# include <ket/spin_expectation_value.hpp>
 # include <ket/meta/bit_integer_of.hpp>
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/integer_log2.hpp>
-# ifndef NDEBUG
-#   include <ket/utility/integer_exp2.hpp>
-# endif
+# include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/meta/real_of.hpp>
 
 
 namespace ket
 {
+  namespace all_spin_expectation_values_detail
+  {
+    using hd_spin_type = std::array<long double, 3u>;
+    using hd_spins_type = std::vector<hd_spin_type>;
+
+    // States on at most this number of qubits are regarded as one cache block
+    constexpr unsigned int max_num_one_block_qubits = 16u;
+    // 2^num_strip_width_qubits columns of blocks are processed together for the qubits higher than block qubits
+    constexpr unsigned int num_strip_width_qubits = 2u;
+
+    // accumulate_spins(parallel_policy, first, last, hd_spins): hd_spins[q] += (<X_q>, <Y_q>, 2<Z_q>) for all the
+    //   qubits q < log2(last - first), in two sweeps over [first, last).
+    //   The state is regarded as a matrix whose rows are blocks of 2^b elements. The first sweep goes over blocks, and
+    //   the pairs of the qubits lower than b are in the same block, which is in cache. The second sweep goes over
+    //   strips of 2^num_strip_width_qubits columns, which cover all the pairs of the qubits not lower than b.
+    //   b is chosen so that both blocks and strips have about 2^(n/2) elements
+    template <typename ParallelPolicy, typename RandomAccessIterator>
+    inline void accumulate_spins(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      hd_spins_type& hd_spins)
+    {
+      auto const num_elements = static_cast<std::size_t>(last - first);
+      auto const num_qubits = ::ket::utility::integer_log2<unsigned int>(num_elements);
+      assert(::ket::utility::integer_exp2<std::size_t>(num_qubits) == num_elements);
+      assert(hd_spins.size() >= num_qubits);
+
+      auto const num_block_qubits
+        = num_qubits <= max_num_one_block_qubits ? num_qubits : (num_qubits + num_strip_width_qubits + 1u) / 2u;
+      auto const block_size = ::ket::utility::integer_exp2<std::size_t>(num_block_qubits);
+      auto const num_blocks = ::ket::utility::integer_exp2<std::size_t>(num_qubits - num_block_qubits);
+
+      auto const add_spins
+        = [&hd_spins](hd_spins_type const& partial_spins)
+          {
+            for (auto qubit = std::size_t{0u}; qubit < partial_spins.size(); ++qubit)
+            {
+              hd_spins[qubit][0u] += partial_spins[qubit][0u];
+              hd_spins[qubit][1u] += partial_spins[qubit][1u];
+              hd_spins[qubit][2u] += partial_spins[qubit][2u];
+            }
+          };
+
+      auto const block_accumulators
+        = ::ket::utility::loop_n_reduce_by_thread(
+            parallel_policy, num_blocks, hd_spins_type(num_qubits),
+            [first, num_qubits, num_block_qubits, block_size](
+              std::size_t const block_index, int const, hd_spins_type& partial_spins)
+            {
+              auto const block_first = first + block_index * block_size;
+              for (auto qubit = 0u; qubit < num_block_qubits; ++qubit)
+              {
+                auto const qubit_mask = ::ket::utility::integer_exp2<std::size_t>(qubit);
+                auto const lower_bits_mask = qubit_mask - std::size_t{1u};
+                auto const upper_bits_mask = compl lower_bits_mask;
+                auto& partial_spin = partial_spins[qubit];
+
+                for (auto value_wo_qubit = std::size_t{0u}; value_wo_qubit < block_size / 2u; ++value_wo_qubit)
+                {
+                  // xxxxx0xxxxxx
+                  auto const zero_index
+                    = ((value_wo_qubit bitand upper_bits_mask) << 1u) bitor (value_wo_qubit bitand lower_bits_mask);
+                  // xxxxx1xxxxxx
+                  auto const one_index = zero_index bitor qubit_mask;
+
+                  using std::conj;
+                  auto const conj_zero_value = conj(*(block_first + zero_index));
+                  auto const one_value = *(block_first + one_index);
+                  auto const conj_zero_times_one = conj_zero_value * one_value;
+
+                  using std::real;
+                  partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
+                  using std::imag;
+                  partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
+                  using std::norm;
+                  partial_spin[2u]
+                    += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
+                }
+              }
+
+              if (num_block_qubits == num_qubits)
+                return;
+
+              // <Z> of the higher qubits only needs the norm of the block
+              auto block_norm = 0.0l;
+              for (auto index = std::size_t{0u}; index < block_size; ++index)
+              {
+                using std::norm;
+                block_norm += static_cast<long double>(norm(*(block_first + index)));
+              }
+
+              for (auto qubit = num_block_qubits; qubit < num_qubits; ++qubit)
+                partial_spins[qubit][2u]
+                  += ((block_index >> (qubit - num_block_qubits)) bitand std::size_t{1u}) == std::size_t{0u}
+                     ? block_norm : -block_norm;
+            });
+      for (auto const& partial_spins: block_accumulators)
+        add_spins(partial_spins);
+
+      if (num_block_qubits == num_qubits)
+        return;
+
+      auto const strip_width = ::ket::utility::integer_exp2<std::size_t>(num_strip_width_qubits);
+      auto const strip_accumulators
+        = ::ket::utility::loop_n_reduce_by_thread(
+            parallel_policy, block_size / strip_width, hd_spins_type(num_qubits),
+            [first, num_qubits, num_block_qubits, num_blocks, strip_width](
+              std::size_t const strip_index, int const, hd_spins_type& partial_spins)
+            {
+              auto const strip_first = first + strip_index * strip_width;
+              for (auto qubit = num_block_qubits; qubit < num_qubits; ++qubit)
+              {
+                auto const block_qubit_mask = ::ket::utility::integer_exp2<std::size_t>(qubit - num_block_qubits);
+                auto const lower_bits_mask = block_qubit_mask - std::size_t{1u};
+                auto const upper_bits_mask = compl lower_bits_mask;
+                auto& partial_spin = partial_spins[qubit];
+
+                for (auto block_index_wo_qubit = std::size_t{0u}; block_index_wo_qubit < num_blocks / 2u; ++block_index_wo_qubit)
+                {
+                  auto const zero_block_index
+                    = ((block_index_wo_qubit bitand upper_bits_mask) << 1u)
+                      bitor (block_index_wo_qubit bitand lower_bits_mask);
+                  auto const zero_first = strip_first + (zero_block_index << num_block_qubits);
+                  auto const one_first = strip_first + ((zero_block_index bitor block_qubit_mask) << num_block_qubits);
+
+                  for (auto column = std::size_t{0u}; column < strip_width; ++column)
+                  {
+                    using std::conj;
+                    auto const conj_zero_times_one = conj(*(zero_first + column)) * *(one_first + column);
+
+                    using std::real;
+                    partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
+                    using std::imag;
+                    partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
+                  }
+                }
+              }
+            });
+      for (auto const& partial_spins: strip_accumulators)
+        add_spins(partial_spins);
+    }
+
+    template <typename Real>
+    inline std::array<Real, 3u> to_spin(hd_spin_type const& hd_spin)
+    {
+      auto result = std::array<Real, 3u>{};
+      result[0u] = static_cast<Real>(hd_spin[0u]);
+      result[1u] = static_cast<Real>(hd_spin[1u]);
+      result[2u] = static_cast<Real>(hd_spin[2u]);
+
+      using boost::math::constants::half;
+      result[2u] *= half<Real>();
+      return result;
+    }
+  } // namespace all_spin_expectation_values_detail
+
+  // The spins of all the qubits are computed together in two sweeps over the state
   template <typename Qubit, typename ParallelPolicy, typename RandomAccessIterator>
   inline
   std::vector<
@@ -35,16 +193,17 @@ namespace ket
       ::ket::utility::integer_exp2<bit_integer_type>(num_qubits)
         == static_cast<bit_integer_type>(last - first));
 
+    auto hd_spins = ::ket::all_spin_expectation_values_detail::hd_spins_type(num_qubits);
+    ::ket::all_spin_expectation_values_detail::accumulate_spins(parallel_policy, first, last, hd_spins);
+
     using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
     using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
     using spin_type = std::array<real_type, 3u>;
     auto result = std::vector<spin_type>{};
     result.reserve(num_qubits);
 
-    auto const last_qubit = Qubit{num_qubits};
-    for (auto qubit = Qubit{bit_integer_type{0u}}; qubit < last_qubit; ++qubit)
-      result.push_back(
-        ::ket::spin_expectation_value(parallel_policy, first, last, qubit));
+    for (auto const& hd_spin: hd_spins)
+      result.push_back(::ket::all_spin_expectation_values_detail::to_spin<real_type>(hd_spin));
 
     return result;
   }
@@ -0,0 +1,257 @@
+#ifndef KET_EXPECTATION_VALUE_HPP
+# define KET_EXPECTATION_VALUE_HPP
+
+# include <cstddef>
+# include <cassert>
+# include <complex>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <functional>
+# include <type_traits>
+
+# include <boost/range/value_type.hpp>
+
+# include <ket/pauli_term.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/parity.hpp>
+# include <ket/utility/meta/real_of.hpp>
+
+
+namespace ket
+{
+  // <psi|P|psi> = sum_i (-1)^{parity(i & z_mask)} Re(i^{n_Y} conj(a_{i ^ x_mask}) a_i) for P = X^x_mask Z^z_mask
+  // with n_Y Y's. The terms sharing x_mask are evaluated together by one sweep, which computes
+  // conj(a_{i ^ x_mask}) a_i once for all of them
+  namespace expectation_value_detail
+  {
+    template <typename StateInteger>
+    inline StateInteger count_bits(StateInteger value)
+    {
+      auto result = StateInteger{0u};
+      for (; value != StateInteger{0u}; value &= value - StateInteger{1u})
+        ++result;
+      return result;
+    }
+
+    // real_weight * Re(f) + imag_weight * Im(f) == coefficient * Re(i^{n_Y} f)
+    template <typename StateInteger>
+    struct weighted_z_mask
+    {
+      StateInteger z_mask;
+      long double real_weight;
+      long double imag_weight;
+    }; // struct weighted_z_mask<StateInteger>
+
+    template <typename PauliTermIterator, typename ZMaskFunction>
+    inline std::vector<
+      ::ket::expectation_value_detail::weighted_z_mask<
+        typename std::iterator_traits<PauliTermIterator>::value_type::state_integer_type> >
+    to_weighted_z_masks(PauliTermIterator const first, PauliTermIterator const last, ZMaskFunction&& z_mask_function)
+    {
+      using state_integer_type = typename std::iterator_traits<PauliTermIterator>::value_type::state_integer_type;
+      auto result = std::vector< ::ket::expectation_value_detail::weighted_z_mask<state_integer_type> >{};
+      result.reserve(last - first);
+
+      for (auto iter = first; iter != last; ++iter)
+      {
+        auto const& term = *iter;
+        auto const coefficient = static_cast<long double>(term.coefficient);
+        auto const z_mask = z_mask_function(term.z_mask);
+        switch (::ket::expectation_value_detail::count_bits(term.x_mask bitand term.z_mask) % state_integer_type{4u})
+        {
+         case 0u: result.push_back({z_mask, coefficient, 0.0l}); break;
+         case 1u: result.push_back({z_mask, 0.0l, -coefficient}); break;
+         case 2u: result.push_back({z_mask, -coefficient, 0.0l}); break;
+         default: result.push_back({z_mask, 0.0l, coefficient}); break;
+        }
+      }
+
+      return result;
+    }
+
+    // the terms sorted by x_mask, and the boundaries of the groups of the terms sharing their x_mask: the group g is
+    // [terms[boundaries[g]], terms[boundaries[g + 1]]), in increasing order of x_mask
+    template <typename PauliTerm>
+    struct x_mask_groups
+    {
+      std::vector<PauliTerm> terms;
+      std::vector<std::size_t> boundaries;
+    }; // struct x_mask_groups<PauliTerm>
+
+    template <typename PauliTerms>
+    inline ::ket::expectation_value_detail::x_mask_groups<typename boost::range_value<PauliTerms const>::type>
+    group_by_x_mask(PauliTerms const& pauli_terms)
+    {
+      using pauli_term_type = typename boost::range_value<PauliTerms const>::type;
+      auto result = ::ket::expectation_value_detail::x_mask_groups<pauli_term_type>{};
+      auto& terms = result.terms;
+      terms.assign(std::begin(pauli_terms), std::end(pauli_terms));
+      std::stable_sort(
+        std::begin(terms), std::end(terms),
+        [](pauli_term_type const& lhs, pauli_term_type const& rhs) { return lhs.x_mask < rhs.x_mask; });
+
+      auto& boundaries = result.boundaries;
+      boundaries.push_back(std::size_t{0u});
+      for (auto index = std::size_t{1u}; index < terms.size(); ++index)
+        if (terms[index].x_mask != terms[index - 1u].x_mask)
+          boundaries.push_back(index);
+      if (not terms.empty())
+        boundaries.push_back(terms.size());
+
+      return result;
+    }
+
+    // sum of (-1)^{parity(value & z_mask)} (real_weight Re(f) + imag_weight Im(f)) over the terms and
+    // count indices, where index = index_function(n), value = base_value + index and
+    // f = conj(partner_function(index)) * *(first + index)
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger,
+      typename IndexFunction, typename PartnerFunction>
+    inline long double sum_weighted_products(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, StateInteger const count, StateInteger const base_value,
+      IndexFunction&& index_function, PartnerFunction&& partner_function,
+      std::vector< ::ket::expectation_value_detail::weighted_z_mask<StateInteger> > const& terms)
+    {
+      using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+      return ::ket::utility::loop_n_reduce(
+        parallel_policy, count, 0.0l, std::plus<long double>{},
+        [first, base_value, &index_function, &partner_function, &terms](
+          StateInteger const n, int const, long double& partial_sum)
+        {
+          auto const index = index_function(n);
+          using std::conj;
+          auto const product
+            = conj(static_cast<complex_type>(partner_function(index))) * static_cast<complex_type>(*(first + index));
+          using std::real;
+          auto const real_product = static_cast<long double>(real(product));
+          using std::imag;
+          auto const imag_product = static_cast<long double>(imag(product));
+
+          auto const value = base_value + index;
+          for (auto const& term: terms)
+          {
+            auto const contribution = term.real_weight * real_product + term.imag_weight * imag_product;
+            partial_sum
+              += ::ket::utility::parity(value bitand term.z_mask) ? -contribution : contribution;
+          }
+        });
+    }
+
+    // sum over the size values from first, whose indices are offset by base_value. Since the contributions of i
+    // and i ^ x_mask are complex conjugates of each other, only the indices whose highest bit of x_mask is 0 are
+    // visited if x_mask is not 0
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger>
+    inline long double sum_within(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, StateInteger const size, StateInteger const base_value,
+      StateInteger const x_mask,
+      std::vector< ::ket::expectation_value_detail::weighted_z_mask<StateInteger> > const& terms)
+    {
+      assert(x_mask < size);
+
+      if (x_mask == StateInteger{0u})
+        return ::ket::expectation_value_detail::sum_weighted_products(
+          parallel_policy, first, size, base_value,
+          [](StateInteger const index) { return index; },
+          [first](StateInteger const index) { return *(first + index); },
+          terms);
+
+      auto const highest_qubit_mask
+        = ::ket::utility::integer_exp2<StateInteger>(::ket::utility::integer_log2<StateInteger>(x_mask));
+      auto const lower_bits_mask = highest_qubit_mask - StateInteger{1u};
+      auto const upper_bits_mask = compl lower_bits_mask;
+
+      return 2.0l
+        * ::ket::expectation_value_detail::sum_weighted_products(
+            parallel_policy, first, size / StateInteger{2u}, base_value,
+            [lower_bits_mask, upper_bits_mask](StateInteger const index_wo_qubit)
+            {
+              return ((index_wo_qubit bitand upper_bits_mask) << 1u)
+                bitor (index_wo_qubit bitand lower_bits_mask);
+            },
+            [first, x_mask](StateInteger const index) { return *(first + (index xor x_mask)); },
+            terms);
+    }
+  } // namespace expectation_value_detail
+
+  // expectation_value(parallel_policy, first, last, pauli_terms): <psi|H|psi> for H = sum of pauli_terms, which
+  //   is a range of ::ket::pauli_term
+  template <typename ParallelPolicy, typename RandomAccessIterator, typename PauliTerms>
+  inline
+  typename std::enable_if<
+    ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+    typename ::ket::utility::meta::real_of<
+      typename std::iterator_traits<RandomAccessIterator>::value_type>::type>::type
+  expectation_value(
+    ParallelPolicy const parallel_policy,
+    RandomAccessIterator const first, RandomAccessIterator const last,
+    PauliTerms const& pauli_terms)
+  {
+    using state_integer_type = typename boost::range_value<PauliTerms const>::type::state_integer_type;
+    static_assert(std::is_unsigned<state_integer_type>::value, "StateInteger should be unsigned");
+    auto const size = static_cast<state_integer_type>(last - first);
+    assert(
+      ::ket::utility::integer_exp2<state_integer_type>(::ket::utility::integer_log2<state_integer_type>(size))
+      == size);
+
+    auto result = 0.0l;
+    auto const groups = ::ket::expectation_value_detail::group_by_x_mask(pauli_terms);
+    for (auto group_index = std::size_t{0u}; group_index + 1u < groups.boundaries.size(); ++group_index)
+    {
+      auto const group_first = std::begin(groups.terms) + groups.boundaries[group_index];
+      auto const group_last = std::begin(groups.terms) + groups.boundaries[group_index + 1u];
+      result
+        += ::ket::expectation_value_detail::sum_within(
+             parallel_policy, first, size, state_integer_type{0u}, group_first->x_mask,
+             ::ket::expectation_value_detail::to_weighted_z_masks(
+               group_first, group_last, [](state_integer_type const z_mask) { return z_mask; }));
+    }
+
+    using real_type
+      = typename ::ket::utility::meta::real_of<
+          typename std::iterator_traits<RandomAccessIterator>::value_type>::type;
+    return static_cast<real_type>(result);
+  }
+
+  template <typename RandomAccessIterator, typename PauliTerms>
+  inline
+  typename std::enable_if<
+    not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessIterator>::value,
+    typename ::ket::utility::meta::real_of<
+      typename std::iterator_traits<RandomAccessIterator>::value_type>::type>::type
+  expectation_value(
+    RandomAccessIterator const first, RandomAccessIterator const last,
+    PauliTerms const& pauli_terms)
+  { return ::ket::expectation_value(::ket::utility::policy::make_sequential(), first, last, pauli_terms); }
+
+
+  namespace ranges
+  {
+    template <typename ParallelPolicy, typename RandomAccessRange, typename PauliTerms>
+    inline
+    typename std::enable_if<
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+      typename ::ket::utility::meta::real_of<
+        typename boost::range_value<RandomAccessRange const>::type>::type>::type
+    expectation_value(
+      ParallelPolicy const parallel_policy,
+      RandomAccessRange const& state, PauliTerms const& pauli_terms)
+    { return ::ket::expectation_value(parallel_policy, std::begin(state), std::end(state), pauli_terms); }
+
+    template <typename RandomAccessRange, typename PauliTerms>
+    inline
+    typename std::enable_if<
+      not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value,
+      typename ::ket::utility::meta::real_of<
+        typename boost::range_value<RandomAccessRange const>::type>::type>::type
+    expectation_value(RandomAccessRange const& state, PauliTerms const& pauli_terms)
+    { return ::ket::expectation_value(std::begin(state), std::end(state), pauli_terms); }
+  } // namespace ranges
+} // namespace ket
+
+
+#endif // KET_EXPECTATION_VALUE_HPP
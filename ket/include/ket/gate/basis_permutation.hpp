@@ -0,0 +1,143 @@
+#ifndef KET_GATE_BASIS_PERMUTATION_HPP
+# define KET_GATE_BASIS_PERMUTATION_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <iterator>
+# include <vector>
+# include <algorithm>
+# include <type_traits>
+
+# include <boost/range/size.hpp>
+# include <boost/range/value_type.hpp>
+
+# include <ket/meta/state_integer_of.hpp>
+# include <ket/meta/bit_integer_of.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/loop_n.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // basis_permutation: |t>|o> -> |permutation_function(t, o)>|o>, where t is the value of qubits (the i-th bit of
+    //   t is the value of qubits[i]) and o is the index of the basis state whose bits of qubits are cleared.
+    //   permutation_function(., o) has to be a bijection on [0, 2^n) for each o, where n is the number of qubits.
+    //   Reversible arithmetic on registers, e.g. lhs += rhs, is applied by one gather/scatter pass over the 2^n
+    //   amplitudes sharing each o. permutation_function is called concurrently if parallel_policy is parallel
+    namespace basis_permutation_detail
+    {
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator, typename Qubits, typename PermutationFunction>
+      void basis_permutation_impl(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        Qubits const& qubits, PermutationFunction const& permutation_function)
+      {
+        using qubit_type = typename boost::range_value<Qubits>::type;
+        using state_integer_type = typename ::ket::meta::state_integer_of<qubit_type>::type;
+        using bit_integer_type = typename ::ket::meta::bit_integer_of<qubit_type>::type;
+        static_assert(std::is_unsigned<state_integer_type>::value, "StateInteger should be unsigned");
+        static_assert(std::is_unsigned<bit_integer_type>::value, "BitInteger should be unsigned");
+
+        auto const num_qubits = static_cast<bit_integer_type>(boost::size(qubits));
+        auto const num_values = ::ket::utility::integer_exp2<state_integer_type>(num_qubits);
+        assert(num_values <= static_cast<state_integer_type>(last - first));
+
+        // qubit_offsets[t]: the index of |t>|0>
+        auto qubit_offsets = std::vector<state_integer_type>(num_values, state_integer_type{0u});
+        auto const qubits_first = std::begin(qubits);
+        for (auto value = state_integer_type{1u}, highest_bit = bit_integer_type{0u}; value < num_values; ++value)
+        {
+          if (value == (state_integer_type{2u} << highest_bit))
+            ++highest_bit;
+
+          qubit_offsets[value]
+            = qubit_offsets[value xor (state_integer_type{1u} << highest_bit)]
+              bitor ::ket::utility::integer_exp2<state_integer_type>(qubits_first[highest_bit]);
+        }
+
+        auto sorted_qubits = std::vector<qubit_type>(qubits_first, qubits_first + num_qubits);
+        std::sort(std::begin(sorted_qubits), std::end(sorted_qubits));
+
+        // Each thread permutes the amplitudes through its own buffer
+        using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        auto buffers
+          = std::vector< std::vector<value_type> >(
+              ::ket::utility::num_threads(parallel_policy), std::vector<value_type>(num_values));
+
+        using ::ket::utility::loop_n;
+        loop_n(
+          parallel_policy,
+          static_cast<state_integer_type>(last - first) >> num_qubits,
+          [first, &qubit_offsets, &sorted_qubits, &buffers, &permutation_function, num_values](
+            state_integer_type const value_wo_qubits, int const thread_index)
+          {
+            // xxx0xx0xxx
+            auto other_index = value_wo_qubits;
+            for (auto const qubit: sorted_qubits)
+            {
+              auto const lower_bits_mask
+                = ::ket::utility::integer_exp2<state_integer_type>(qubit) - state_integer_type{1u};
+              other_index
+                = (other_index bitand lower_bits_mask) bitor ((other_index bitand compl lower_bits_mask) << 1u);
+            }
+
+            auto& buffer = buffers[thread_index];
+            for (auto value = state_integer_type{0u}; value < num_values; ++value)
+              buffer[permutation_function(value, other_index)] = *(first + (other_index bitor qubit_offsets[value]));
+            for (auto value = state_integer_type{0u}; value < num_values; ++value)
+              *(first + (other_index bitor qubit_offsets[value])) = buffer[value];
+          });
+      }
+    } // namespace basis_permutation_detail
+
+    template <typename RandomAccessIterator, typename Qubits, typename PermutationFunction>
+    inline void basis_permutation(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Qubits const& qubits, PermutationFunction const& permutation_function)
+    {
+      ::ket::gate::basis_permutation_detail::basis_permutation_impl(
+        ::ket::utility::policy::make_sequential(), first, last, qubits, permutation_function);
+    }
+
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename Qubits, typename PermutationFunction>
+    inline void basis_permutation(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Qubits const& qubits, PermutationFunction const& permutation_function)
+    {
+      ::ket::gate::basis_permutation_detail::basis_permutation_impl(
+        parallel_policy, first, last, qubits, permutation_function);
+    }
+
+    namespace ranges
+    {
+      template <typename RandomAccessRange, typename Qubits, typename PermutationFunction>
+      inline RandomAccessRange& basis_permutation(
+        RandomAccessRange& state, Qubits const& qubits, PermutationFunction const& permutation_function)
+      {
+        ::ket::gate::basis_permutation_detail::basis_permutation_impl(
+          ::ket::utility::policy::make_sequential(),
+          std::begin(state), std::end(state), qubits, permutation_function);
+        return state;
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Qubits, typename PermutationFunction>
+      inline RandomAccessRange& basis_permutation(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, Qubits const& qubits, PermutationFunction const& permutation_function)
+      {
+        ::ket::gate::basis_permutation_detail::basis_permutation_impl(
+          parallel_policy, std::begin(state), std::end(state), qubits, permutation_function);
+        return state;
+      }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_BASIS_PERMUTATION_HPP
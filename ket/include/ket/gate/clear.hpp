@@ -4,6 +4,7 @@
 # include <cassert>
 # include <cmath>
 # include <iterator>
+# include <functional>
 # include <utility>
 # include <type_traits>
 
@@ -51,31 +52,30 @@ namespace ket
 
         using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
         using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-        auto zero_probability = real_type{0};
-
-        using ::ket::utility::loop_n;
-        loop_n(
-          parallel_policy,
-          static_cast<StateInteger>(last - first) / 2u,
-          [&zero_probability, first, qubit_mask, lower_bits_mask, upper_bits_mask](
-            StateInteger const value_wo_qubit, int const)
-          {
-            // xxxxx0xxxxxx
-            auto const zero_index
-              = ((value_wo_qubit bitand upper_bits_mask) << 1u)
-                bitor (value_wo_qubit bitand lower_bits_mask);
-            // xxxxx1xxxxxx
-            auto const one_index = zero_index bitor qubit_mask;
-            *(first+one_index) = complex_type{0};
-
-            using std::norm;
-            zero_probability += norm(*(first + zero_index));
-          });
+        auto const zero_probability
+          = ::ket::utility::loop_n_reduce(
+              parallel_policy,
+              static_cast<StateInteger>(last - first) / 2u, real_type{0}, std::plus<real_type>{},
+              [first, qubit_mask, lower_bits_mask, upper_bits_mask](
+                StateInteger const value_wo_qubit, int const, real_type& partial_zero_probability)
+              {
+                // xxxxx0xxxxxx
+                auto const zero_index
+                  = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                    bitor (value_wo_qubit bitand lower_bits_mask);
+                // xxxxx1xxxxxx
+                auto const one_index = zero_index bitor qubit_mask;
+                *(first+one_index) = complex_type{0};
+
+                using std::norm;
+                partial_zero_probability += norm(*(first + zero_index));
+              });
 
         using std::pow;
         using boost::math::constants::half;
         auto const multiplier = pow(zero_probability, -half<real_type>());
 
+        using ::ket::utility::loop_n;
         loop_n(
           parallel_policy,
           static_cast<StateInteger>(last - first)/2u,
@@ -8,6 +8,8 @@
 # include <utility>
 # include <type_traits>
 
+# include <boost/range/value_type.hpp>
+
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
 # include <ket/utility/loop_n.hpp>
@@ -92,7 +92,7 @@ namespace ket
             auto const target_control_on_index = control_on_index bitor target_qubit_mask;
             auto const control_on_iter = first + control_on_index;
             auto const target_control_on_iter = first + target_control_on_index;
-            auto const control_on_iter_value = *control_on_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const control_on_iter_value = *control_on_iter;
 
             using boost::math::constants::half;
             *control_on_iter
@@ -210,7 +210,7 @@ namespace ket
       template <
         typename RandomAccessRange, typename Complex,
         typename StateInteger, typename BitInteger>
-      inline RandomAccessRange& adj_ontrolled_v_coeff(
+      inline RandomAccessRange& adj_controlled_v_coeff(
         RandomAccessRange& state, Complex const& phase_coefficient,
         ::ket::qubit<StateInteger, BitInteger> const target_qubit,
         ::ket::control< ::ket::qubit<StateInteger, BitInteger> > const
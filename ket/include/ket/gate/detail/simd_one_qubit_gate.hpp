@@ -0,0 +1,246 @@
+#ifndef KET_GATE_DETAIL_SIMD_ONE_QUBIT_GATE_HPP
+# define KET_GATE_DETAIL_SIMD_ONE_QUBIT_GATE_HPP
+
+# include <cstddef>
+# include <complex>
+# include <iterator>
+# include <memory>
+# include <utility>
+# include <type_traits>
+
+# include <ket/qubit.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/planar_complex_vector.hpp>
+# include <ket/utility/meta/is_contiguous_iterator.hpp>
+# include <ket/utility/simd/complex_vector.hpp>
+# include <ket/utility/simd/planar_complex_array.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    namespace detail
+    {
+      template <typename RandomAccessIterator, typename Value = typename std::iterator_traits<RandomAccessIterator>::value_type>
+      struct is_simd_applicable
+        : std::false_type
+      { }; // struct is_simd_applicable<RandomAccessIterator, Value>
+
+      template <typename RandomAccessIterator, typename Real>
+      struct is_simd_applicable<RandomAccessIterator, std::complex<Real>>
+        : std::integral_constant<
+            bool,
+            ::ket::utility::meta::is_contiguous_iterator<RandomAccessIterator>::value
+            and ::ket::utility::simd::has_complex_vector<Real>::value>
+      { }; // struct is_simd_applicable<RandomAccessIterator, std::complex<Real>>
+
+      // simd_one_qubit_gate(parallel_policy, first, last, qubit, function):
+      //   function(zero_value, one_value) updates complex_vector's whose elements are amplitudes with 0 and 1 at qubit.
+      //   If qubit is not lower than complex_vector::num_in_vector_bits, zero_value and one_value are loaded from
+      //   contiguous 2^qubit amplitudes. Otherwise both partners are in one vector, and they are gathered by shuffles.
+      //   For planar_complex_iterator's, zero_value and one_value are planar_complex_array's of
+      //   min(2^qubit, 64 bytes / sizeof(Real)) amplitudes, so no shuffles are needed.
+      //   Returns false without doing anything if SIMD kernels are not available (then the caller runs its scalar loop)
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator,
+        typename StateInteger, typename BitInteger, typename Function>
+      inline typename std::enable_if<
+        not ::ket::gate::detail::is_simd_applicable<RandomAccessIterator>::value
+        and not ::ket::utility::meta::is_planar_complex_iterator<RandomAccessIterator>::value, bool>::type
+      simd_one_qubit_gate(
+        ParallelPolicy const, RandomAccessIterator const, RandomAccessIterator const,
+        ::ket::qubit<StateInteger, BitInteger> const, Function&&)
+      { return false; }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator,
+        typename StateInteger, typename BitInteger, typename Function>
+      inline typename std::enable_if<
+        ::ket::gate::detail::is_simd_applicable<RandomAccessIterator>::value, bool>::type
+      simd_one_qubit_gate(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Function&& function)
+      {
+        using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        using vector_type = ::ket::utility::simd::complex_vector<typename complex_type::value_type>;
+        constexpr auto vector_size = static_cast<StateInteger>(vector_type::size);
+        constexpr auto num_in_vector_bits = static_cast<BitInteger>(vector_type::num_in_vector_bits);
+
+        auto const state_size = static_cast<StateInteger>(last - first);
+        if (state_size < StateInteger{2u} * vector_size)
+          return false;
+
+        auto const data = std::addressof(*first);
+        using ::ket::utility::loop_n;
+        if (static_cast<BitInteger>(qubit) >= num_in_vector_bits)
+        {
+          auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
+          auto const lower_bits_mask = qubit_mask - StateInteger{1u};
+          auto const upper_bits_mask = compl lower_bits_mask;
+
+          loop_n(
+            parallel_policy,
+            state_size / (StateInteger{2u} * vector_size),
+            [data, qubit_mask, lower_bits_mask, upper_bits_mask, &function](
+              StateInteger const vector_index, int const)
+            {
+              auto const value_wo_qubit = vector_index * vector_size;
+              // xxxxx0xxxxxx
+              auto const zero_index
+                = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                  bitor (value_wo_qubit bitand lower_bits_mask);
+              // xxxxx1xxxxxx
+              auto const one_index = zero_index bitor qubit_mask;
+
+              auto zero_value = vector_type::load(data + zero_index);
+              auto one_value = vector_type::load(data + one_index);
+              function(zero_value, one_value);
+              zero_value.store(data + zero_index);
+              one_value.store(data + one_index);
+            });
+        }
+        else
+        {
+          auto const bit = static_cast<unsigned int>(static_cast<BitInteger>(qubit));
+
+          loop_n(
+            parallel_policy,
+            state_size / vector_size,
+            [data, bit, &function](StateInteger const vector_index, int const)
+            {
+              auto const pointer = data + vector_index * vector_size;
+              auto const value = vector_type::load(pointer);
+              auto const partner_value = swap_partners(value, bit);
+
+              auto zero_value = select(value, partner_value, bit);
+              auto one_value = select(partner_value, value, bit);
+              function(zero_value, one_value);
+              select(zero_value, one_value, bit).store(pointer);
+            });
+        }
+
+        return true;
+      }
+
+      namespace simd_one_qubit_gate_detail
+      {
+        template <typename Real, std::size_t num_in_vector_bits>
+        struct planar_one_qubit_gate
+        {
+          template <
+            typename ParallelPolicy, typename StateInteger, typename BitInteger, typename Function>
+          static void call(
+            ParallelPolicy const parallel_policy,
+            Real* const real_data, Real* const imag_data, StateInteger const state_size,
+            ::ket::qubit<StateInteger, BitInteger> const qubit, Function&& function)
+          {
+            if (static_cast<BitInteger>(qubit) < static_cast<BitInteger>(num_in_vector_bits))
+            {
+              ::ket::gate::detail::simd_one_qubit_gate_detail::planar_one_qubit_gate<Real, num_in_vector_bits - 1u>::call(
+                parallel_policy, real_data, imag_data, state_size, qubit, std::forward<Function>(function));
+              return;
+            }
+
+            using vector_type
+              = ::ket::utility::simd::planar_complex_array<Real, ::ket::utility::integer_exp2<std::size_t>(num_in_vector_bits)>;
+            constexpr auto vector_size = static_cast<StateInteger>(vector_type::size);
+
+            auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
+            auto const lower_bits_mask = qubit_mask - StateInteger{1u};
+            auto const upper_bits_mask = compl lower_bits_mask;
+
+            using ::ket::utility::loop_n;
+            loop_n(
+              parallel_policy,
+              state_size / (StateInteger{2u} * vector_size),
+              [real_data, imag_data, qubit_mask, lower_bits_mask, upper_bits_mask, &function](
+                StateInteger const vector_index, int const)
+              {
+                auto const value_wo_qubit = vector_index * vector_size;
+                // xxxxx0xxxxxx
+                auto const zero_index
+                  = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                    bitor (value_wo_qubit bitand lower_bits_mask);
+                // xxxxx1xxxxxx
+                auto const one_index = zero_index bitor qubit_mask;
+
+                auto zero_value = vector_type::load(real_data + zero_index, imag_data + zero_index);
+                auto one_value = vector_type::load(real_data + one_index, imag_data + one_index);
+                function(zero_value, one_value);
+                zero_value.store(real_data + zero_index, imag_data + zero_index);
+                one_value.store(real_data + one_index, imag_data + one_index);
+              });
+          }
+        }; // struct planar_one_qubit_gate<Real, num_in_vector_bits>
+
+        template <typename Real>
+        struct planar_one_qubit_gate<Real, 0u>
+        {
+          template <
+            typename ParallelPolicy, typename StateInteger, typename BitInteger, typename Function>
+          static void call(
+            ParallelPolicy const parallel_policy,
+            Real* const real_data, Real* const imag_data, StateInteger const state_size,
+            ::ket::qubit<StateInteger, BitInteger> const qubit, Function&& function)
+          {
+            using vector_type = ::ket::utility::simd::planar_complex_array<Real, 1u>;
+
+            auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
+            auto const lower_bits_mask = qubit_mask - StateInteger{1u};
+            auto const upper_bits_mask = compl lower_bits_mask;
+
+            using ::ket::utility::loop_n;
+            loop_n(
+              parallel_policy,
+              state_size / StateInteger{2u},
+              [real_data, imag_data, qubit_mask, lower_bits_mask, upper_bits_mask, &function](
+                StateInteger const value_wo_qubit, int const)
+              {
+                // xxxxx0xxxxxx
+                auto const zero_index
+                  = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                    bitor (value_wo_qubit bitand lower_bits_mask);
+                // xxxxx1xxxxxx
+                auto const one_index = zero_index bitor qubit_mask;
+
+                auto zero_value = vector_type::load(real_data + zero_index, imag_data + zero_index);
+                auto one_value = vector_type::load(real_data + one_index, imag_data + one_index);
+                function(zero_value, one_value);
+                zero_value.store(real_data + zero_index, imag_data + zero_index);
+                one_value.store(real_data + one_index, imag_data + one_index);
+              });
+          }
+        }; // struct planar_one_qubit_gate<Real, 0u>
+      } // namespace simd_one_qubit_gate_detail
+
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator,
+        typename StateInteger, typename BitInteger, typename Function>
+      inline typename std::enable_if<
+        ::ket::utility::meta::is_planar_complex_iterator<RandomAccessIterator>::value, bool>::type
+      simd_one_qubit_gate(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Function&& function)
+      {
+        using real_type = typename std::iterator_traits<RandomAccessIterator>::value_type::value_type;
+        // a planar_complex_array fills 512-bit registers at most: 8 doubles, 16 floats
+        constexpr auto num_in_vector_bits
+          = ::ket::utility::integer_log2<std::size_t>(
+              sizeof(real_type) >= std::size_t{64u} ? std::size_t{1u} : std::size_t{64u} / sizeof(real_type));
+
+        ::ket::gate::detail::simd_one_qubit_gate_detail::planar_one_qubit_gate<real_type, num_in_vector_bits>::call(
+          parallel_policy, first.real_part_ptr(), first.imag_part_ptr(), static_cast<StateInteger>(last - first),
+          qubit, std::forward<Function>(function));
+        return true;
+      }
+    } // namespace detail
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_DETAIL_SIMD_ONE_QUBIT_GATE_HPP
@@ -0,0 +1,82 @@
+#ifndef KET_GATE_DIAGONAL_HPP
+# define KET_GATE_DIAGONAL_HPP
+
+# include <iterator>
+# include <type_traits>
+
+# include <ket/utility/loop_n.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // diagonal: multiplies the amplitude of |i> by coefficient_function(i)
+    //   Any product of diagonal gates (Z, S, T, phase shifts, controlled phase shifts, ...) is applied by one sweep
+    //   over the state. coefficient_function is called concurrently if parallel_policy is parallel
+    namespace diagonal_detail
+    {
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename CoefficientFunction>
+      void diagonal_impl(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        CoefficientFunction const& coefficient_function)
+      {
+        using state_integer_type
+          = typename std::make_unsigned<typename std::iterator_traits<RandomAccessIterator>::difference_type>::type;
+
+        using ::ket::utility::loop_n;
+        loop_n(
+          parallel_policy,
+          static_cast<state_integer_type>(last - first),
+          [first, &coefficient_function](state_integer_type const index, int const)
+          { *(first + index) *= coefficient_function(index); });
+      }
+    } // namespace diagonal_detail
+
+    template <typename RandomAccessIterator, typename CoefficientFunction>
+    inline void diagonal(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      CoefficientFunction const& coefficient_function)
+    {
+      ::ket::gate::diagonal_detail::diagonal_impl(
+        ::ket::utility::policy::make_sequential(), first, last, coefficient_function);
+    }
+
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename CoefficientFunction>
+    inline void diagonal(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      CoefficientFunction const& coefficient_function)
+    {
+      ::ket::gate::diagonal_detail::diagonal_impl(
+        parallel_policy, first, last, coefficient_function);
+    }
+
+    namespace ranges
+    {
+      template <typename RandomAccessRange, typename CoefficientFunction>
+      inline RandomAccessRange& diagonal(
+        RandomAccessRange& state, CoefficientFunction const& coefficient_function)
+      {
+        ::ket::gate::diagonal_detail::diagonal_impl(
+          ::ket::utility::policy::make_sequential(),
+          std::begin(state), std::end(state), coefficient_function);
+        return state;
+      }
+
+      template <typename ParallelPolicy, typename RandomAccessRange, typename CoefficientFunction>
+      inline RandomAccessRange& diagonal(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, CoefficientFunction const& coefficient_function)
+      {
+        ::ket::gate::diagonal_detail::diagonal_impl(
+          parallel_policy, std::begin(state), std::end(state), coefficient_function);
+        return state;
+      }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_DIAGONAL_HPP
@@ -0,0 +1,166 @@
+#ifndef KET_GATE_PAULI_STRING_HPP
+# define KET_GATE_PAULI_STRING_HPP
+
+# include <cassert>
+# include <iterator>
+# include <type_traits>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/parity.hpp>
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // pauli_string: applies X^x_mask Z^z_mask, that is, a_i is replaced with (-1)^{parity((i ^ x_mask) & z_mask)} a_{i ^ x_mask}.
+    //   Any product of Pauli gates is applied by one sweep over the state, up to a global phase
+    //   (Y = i X Z on each qubit whose bits of both masks are 1)
+    namespace pauli_string_detail
+    {
+      // first + index is the value of first_value + index, and partner_first + (index ^ x_mask) is that of
+      // partner_first_value + (index ^ x_mask). Both of them are replaced for the indices index_function(n),
+      // n = 0, ..., count - 1
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger, typename IndexFunction>
+      inline void swap_with_signs(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const partner_first, StateInteger const count,
+        IndexFunction&& index_function, StateInteger const x_mask,
+        StateInteger const first_value, StateInteger const partner_first_value, StateInteger const z_mask)
+      {
+        using ::ket::utility::loop_n;
+        loop_n(
+          parallel_policy, count,
+          [first, partner_first, &index_function, x_mask, first_value, partner_first_value, z_mask](
+            StateInteger const n, int const)
+          {
+            auto const index = index_function(n);
+            auto const partner_index = index xor x_mask;
+
+            using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+            auto const value = static_cast<complex_type>(*(first + index));
+            auto const partner_value = static_cast<complex_type>(*(partner_first + partner_index));
+            *(first + index)
+              = ::ket::utility::parity((partner_first_value + partner_index) bitand z_mask)
+                ? -partner_value : partner_value;
+            *(partner_first + partner_index)
+              = ::ket::utility::parity((first_value + index) bitand z_mask) ? -value : value;
+          });
+      }
+
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger>
+      inline void apply_signs(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, StateInteger const count,
+        StateInteger const first_value, StateInteger const z_mask)
+      {
+        if (z_mask == StateInteger{0u})
+          return;
+
+        using ::ket::utility::loop_n;
+        loop_n(
+          parallel_policy, count,
+          [first, first_value, z_mask](StateInteger const index, int const)
+          {
+            using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+            if (::ket::utility::parity((first_value + index) bitand z_mask))
+              *(first + index) = -static_cast<complex_type>(*(first + index));
+          });
+      }
+
+      // first + index is the value of first_value + index
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger>
+      inline void pauli_string_within(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, StateInteger const size, StateInteger const first_value,
+        StateInteger const x_mask, StateInteger const z_mask)
+      {
+        assert(x_mask < size);
+
+        if (x_mask == StateInteger{0u})
+        {
+          ::ket::gate::pauli_string_detail::apply_signs(parallel_policy, first, size, first_value, z_mask);
+          return;
+        }
+
+        auto const highest_qubit_mask
+          = ::ket::utility::integer_exp2<StateInteger>(::ket::utility::integer_log2<StateInteger>(x_mask));
+        auto const lower_bits_mask = highest_qubit_mask - StateInteger{1u};
+        auto const upper_bits_mask = compl lower_bits_mask;
+
+        ::ket::gate::pauli_string_detail::swap_with_signs(
+          parallel_policy, first, first, size / StateInteger{2u},
+          [lower_bits_mask, upper_bits_mask](StateInteger const index_wo_qubit)
+          {
+            // xxxxx0xxxxxx, where 0 is at the highest bit of x_mask
+            return ((index_wo_qubit bitand upper_bits_mask) << 1u)
+              bitor (index_wo_qubit bitand lower_bits_mask);
+          },
+          x_mask, first_value, first_value, z_mask);
+      }
+
+      template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger>
+      void pauli_string_impl(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        StateInteger const x_mask, StateInteger const z_mask)
+      {
+        static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+        auto const size = static_cast<StateInteger>(last - first);
+        assert(
+          ::ket::utility::integer_exp2<StateInteger>(::ket::utility::integer_log2<StateInteger>(size)) == size);
+        assert(z_mask < size);
+
+        ::ket::gate::pauli_string_detail::pauli_string_within(
+          parallel_policy, first, size, StateInteger{0u}, x_mask, z_mask);
+      }
+    } // namespace pauli_string_detail
+
+    template <typename RandomAccessIterator, typename StateInteger>
+    inline void pauli_string(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      StateInteger const x_mask, StateInteger const z_mask)
+    {
+      ::ket::gate::pauli_string_detail::pauli_string_impl(
+        ::ket::utility::policy::make_sequential(), first, last, x_mask, z_mask);
+    }
+
+    template <typename ParallelPolicy, typename RandomAccessIterator, typename StateInteger>
+    inline void pauli_string(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      StateInteger const x_mask, StateInteger const z_mask)
+    {
+      ::ket::gate::pauli_string_detail::pauli_string_impl(
+        parallel_policy, first, last, x_mask, z_mask);
+    }
+
+    namespace ranges
+    {
+      template <typename RandomAccessRange, typename StateInteger>
+      inline RandomAccessRange& pauli_string(
+        RandomAccessRange& state, StateInteger const x_mask, StateInteger const z_mask)
+      {
+        ::ket::gate::pauli_string_detail::pauli_string_impl(
+          ::ket::utility::policy::make_sequential(), std::begin(state), std::end(state), x_mask, z_mask);
+        return state;
+      }
+
+      template <typename ParallelPolicy, typename RandomAccessRange, typename StateInteger>
+      inline RandomAccessRange& pauli_string(
+        ParallelPolicy const parallel_policy, RandomAccessRange& state,
+        StateInteger const x_mask, StateInteger const z_mask)
+      {
+        ::ket::gate::pauli_string_detail::pauli_string_impl(
+          parallel_policy, std::begin(state), std::end(state), x_mask, z_mask);
+        return state;
+      }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_PAULI_STRING_HPP
@@ -13,6 +13,9 @@
 # ifndef NDEBUG
 #   include <ket/utility/integer_log2.hpp>
 # endif
+# ifdef KET_USE_SIMD
+#   include <ket/gate/detail/simd_one_qubit_gate.hpp>
+# endif // KET_USE_SIMD
 
 
 namespace ket
@@ -21,6 +24,19 @@ namespace ket
   {
     namespace pauli_x_detail
     {
+# ifdef KET_USE_SIMD
+      // |1>, |0>
+      struct simd_pauli_x
+      {
+        template <typename ComplexVector>
+        void operator()(ComplexVector& zero_value, ComplexVector& one_value) const
+        {
+          using std::swap;
+          swap(zero_value, one_value);
+        }
+      }; // struct simd_pauli_x
+# endif // KET_USE_SIMD
+
       template <
         typename ParallelPolicy, typename RandomAccessIterator,
         typename StateInteger, typename BitInteger>
@@ -41,6 +57,13 @@ namespace ket
             ::ket::utility::integer_log2<BitInteger>(last - first))
           == static_cast<StateInteger>(last - first));
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::pauli_x_detail::simd_pauli_x{}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -14,6 +14,9 @@
 #   include <ket/utility/integer_log2.hpp>
 # endif
 # include <ket/utility/imaginary_unit.hpp>
+# ifdef KET_USE_SIMD
+#   include <ket/gate/detail/simd_one_qubit_gate.hpp>
+# endif // KET_USE_SIMD
 
 
 namespace ket
@@ -22,6 +25,21 @@ namespace ket
   {
     namespace pauli_y_detail
     {
+# ifdef KET_USE_SIMD
+      // -i|1>, i|0>
+      struct simd_pauli_y
+      {
+        template <typename ComplexVector>
+        void operator()(ComplexVector& zero_value, ComplexVector& one_value) const
+        {
+          using real_type = typename ComplexVector::real_type;
+          auto const new_zero_value = times_i(one_value) * real_type{-1};
+          one_value = times_i(zero_value);
+          zero_value = new_zero_value;
+        }
+      }; // struct simd_pauli_y
+# endif // KET_USE_SIMD
+
       template <
         typename ParallelPolicy, typename RandomAccessIterator,
         typename StateInteger, typename BitInteger>
@@ -42,6 +60,13 @@ namespace ket
             ::ket::utility::integer_log2<BitInteger>(last - first))
           == static_cast<StateInteger>(last - first));
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::pauli_y_detail::simd_pauli_y{}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
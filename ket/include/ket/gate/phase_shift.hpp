@@ -17,6 +17,9 @@
 # endif
 # include <ket/utility/exp_i.hpp>
 # include <ket/utility/meta/real_of.hpp>
+# ifdef KET_USE_SIMD
+#   include <ket/gate/detail/simd_one_qubit_gate.hpp>
+# endif // KET_USE_SIMD
 
 
 namespace ket
@@ -26,6 +29,36 @@ namespace ket
     // phase_shift_coeff
     namespace phase_shift_detail
     {
+# ifdef KET_USE_SIMD
+      // |0>, phase_coefficient |1>
+      template <typename Complex>
+      struct simd_phase_shift_coeff
+      {
+        Complex phase_coefficient_;
+
+        template <typename ComplexVector>
+        void operator()(ComplexVector&, ComplexVector& one_value) const
+        { one_value = one_value * ComplexVector::broadcast(phase_coefficient_); }
+      }; // struct simd_phase_shift_coeff<Complex>
+
+      // general 2x2 matrix used by phase_shift2 and phase_shift3: m00 |0> + m10 |1>, m01 |0> + m11 |1>
+      template <typename Complex>
+      struct simd_matrix2
+      {
+        Complex m00_, m01_, m10_, m11_;
+
+        template <typename ComplexVector>
+        void operator()(ComplexVector& zero_value, ComplexVector& one_value) const
+        {
+          auto const new_zero_value
+            = zero_value * ComplexVector::broadcast(m00_) + one_value * ComplexVector::broadcast(m01_);
+          one_value
+            = zero_value * ComplexVector::broadcast(m10_) + one_value * ComplexVector::broadcast(m11_);
+          zero_value = new_zero_value;
+        }
+      }; // struct simd_matrix2<Complex>
+# endif // KET_USE_SIMD
+
       template <
         typename ParallelPolicy, typename RandomAccessIterator,
         typename Complex, typename StateInteger, typename BitInteger>
@@ -51,6 +84,13 @@ namespace ket
             ::ket::utility::integer_log2<BitInteger>(last - first))
           == static_cast<StateInteger>(last - first));
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::phase_shift_detail::simd_phase_shift_coeff<Complex>{phase_coefficient}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -310,6 +350,15 @@ namespace ket
         using boost::math::constants::one_div_root_two;
         auto const modified_phase_coefficient1 = one_div_root_two<Real>() * phase_coefficient1;
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::phase_shift_detail::simd_matrix2<complex_type>{
+                complex_type{one_div_root_two<Real>()}, -one_div_root_two<Real>() * phase_coefficient2,
+                modified_phase_coefficient1, modified_phase_coefficient1 * phase_coefficient2}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -330,7 +379,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             *zero_iter -= phase_coefficient2 * *one_iter;
             *zero_iter *= one_div_root_two<Real>();
@@ -433,6 +482,15 @@ namespace ket
         using boost::math::constants::one_div_root_two;
         auto const modified_phase_coefficient2 = one_div_root_two<Real>() * phase_coefficient2;
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::phase_shift_detail::simd_matrix2<complex_type>{
+                complex_type{one_div_root_two<Real>()}, one_div_root_two<Real>() * phase_coefficient1,
+                -modified_phase_coefficient2, modified_phase_coefficient2 * phase_coefficient1}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -453,7 +511,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             *zero_iter += phase_coefficient1 * *one_iter;
             *zero_iter *= one_div_root_two<Real>();
@@ -562,6 +620,15 @@ namespace ket
         auto const sine_phase_coefficient3 = sine * phase_coefficient3;
         auto const cosine_phase_coefficient3 = cosine * phase_coefficient3;
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::phase_shift_detail::simd_matrix2<complex_type>{
+                complex_type{cosine}, -sine_phase_coefficient3,
+                sine * phase_coefficient2, cosine_phase_coefficient3 * phase_coefficient2}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -583,7 +650,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             *zero_iter *= cosine;
             *zero_iter -= sine_phase_coefficient3 * *one_iter;
@@ -692,6 +759,15 @@ namespace ket
         auto const sine_phase_coefficient2 = sine * phase_coefficient2;
         auto const cosine_phase_coefficient2 = cosine * phase_coefficient2;
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::phase_shift_detail::simd_matrix2<complex_type>{
+                complex_type{cosine}, sine_phase_coefficient2,
+                -sine * phase_coefficient3, cosine_phase_coefficient2 * phase_coefficient3}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -713,7 +789,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             *zero_iter *= cosine;
             *zero_iter += sine_phase_coefficient2 * *one_iter;
@@ -46,33 +46,33 @@ namespace ket
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
 
-        auto zero_probability = 0.0l;
-        auto one_probability = 0.0l;
+        using probabilities_type = std::pair<long double, long double>;
+        auto const probabilities
+          = ::ket::utility::loop_n_reduce(
+              parallel_policy,
+              static_cast<StateInteger>(last - first) / 2u,
+              probabilities_type{0.0l, 0.0l},
+              [](probabilities_type const& lhs, probabilities_type const& rhs)
+              { return probabilities_type{lhs.first + rhs.first, lhs.second + rhs.second}; },
+              [first, qubit_mask, lower_bits_mask, upper_bits_mask](
+                StateInteger const value_wo_qubit, int const, probabilities_type& partial_probabilities)
+              {
+                // xxxxx0xxxxxx
+                auto const zero_index
+                  = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                    bitor (value_wo_qubit bitand lower_bits_mask);
+                // xxxxx1xxxxxx
+                auto const one_index = zero_index bitor qubit_mask;
 
-        using ::ket::utility::loop_n;
-        loop_n(
-          parallel_policy,
-          static_cast<StateInteger>(last - first) / 2u,
-          [&zero_probability, &one_probability, first,
-           qubit_mask, lower_bits_mask, upper_bits_mask](
-            StateInteger const value_wo_qubit, int const)
-          {
-            // xxxxx0xxxxxx
-            auto const zero_index
-              = ((value_wo_qubit bitand upper_bits_mask) << 1u)
-                bitor (value_wo_qubit bitand lower_bits_mask);
-            // xxxxx1xxxxxx
-            auto const one_index = zero_index bitor qubit_mask;
-
-            using std::norm;
-            zero_probability += static_cast<long double>(norm(*(first + zero_index)));
-            one_probability += static_cast<long double>(norm(*(first + one_index)));
-          });
+                using std::norm;
+                partial_probabilities.first += static_cast<long double>(norm(*(first + zero_index)));
+                partial_probabilities.second += static_cast<long double>(norm(*(first + one_index)));
+              });
 
         using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
         using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
         return std::make_pair(
-          static_cast<real_type>(zero_probability), static_cast<real_type>(one_probability));
+          static_cast<real_type>(probabilities.first), static_cast<real_type>(probabilities.second));
       }
 
       template <
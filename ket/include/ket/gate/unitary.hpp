@@ -0,0 +1,395 @@
+#ifndef KET_GATE_UNITARY_HPP
+# define KET_GATE_UNITARY_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <complex>
+# include <array>
+# include <iterator>
+# include <algorithm>
+# include <type_traits>
+
+# include <boost/range/begin.hpp>
+# include <boost/range/size.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# ifndef NDEBUG
+#   include <ket/utility/integer_log2.hpp>
+# endif
+
+
+namespace ket
+{
+  namespace gate
+  {
+    // unitary: applies a dense 2^N x 2^N matrix to N qubits
+    //   matrix is a random access range of 4^N elements in row-major order, and the i-th bit
+    //   of its row/column indices corresponds to qubits[i]
+    //   qubits are given either as std::array or as trailing arguments. Each call gathers 2^N amplitudes,
+    //   multiplies them by matrix and scatters them back, so that the state is swept once for any N.
+    //   Gates in bra use N = 1, ..., 5
+    namespace unitary_detail
+    {
+      template <
+        typename ParallelPolicy, typename RandomAccessIterator, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits>
+      void unitary_impl(
+        ParallelPolicy const parallel_policy,
+        RandomAccessIterator const first, RandomAccessIterator const last,
+        Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+      {
+        static_assert(
+          std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
+        static_assert(
+          std::is_unsigned<BitInteger>::value, "BitInteger should be unsigned");
+        static_assert(num_qubits >= 1u, "num_qubits should be positive");
+
+        constexpr auto num_indices = ::ket::utility::integer_exp2<std::size_t>(num_qubits);
+        assert(static_cast<std::size_t>(boost::size(matrix)) == num_indices * num_indices);
+        assert(
+          ::ket::utility::integer_exp2<StateInteger>(
+            ::ket::utility::integer_log2<BitInteger>(last - first))
+          == static_cast<StateInteger>(last - first));
+        assert(
+          ::ket::utility::integer_exp2<StateInteger>(num_qubits)
+          <= static_cast<StateInteger>(last - first));
+
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        auto sorted_qubits = qubits;
+        std::sort(std::begin(sorted_qubits), std::end(sorted_qubits));
+        assert(std::adjacent_find(std::begin(sorted_qubits), std::end(sorted_qubits)) == std::end(sorted_qubits));
+        assert(
+          ::ket::utility::integer_exp2<StateInteger>(sorted_qubits.back())
+          < static_cast<StateInteger>(last - first));
+
+        // inserting a zero bit at each of sorted qubits (from the lowest) makes the index of |0...0> in the gathered amplitudes
+        auto lower_bits_masks = std::array<StateInteger, num_qubits>{};
+        std::transform(
+          std::begin(sorted_qubits), std::end(sorted_qubits), std::begin(lower_bits_masks),
+          [](qubit_type const qubit)
+          { return ::ket::utility::integer_exp2<StateInteger>(qubit) - StateInteger{1u}; });
+
+        // index_offsets[i]: offset of the amplitude corresponding to the i-th row/column of matrix
+        auto index_offsets = std::array<StateInteger, num_indices>{};
+        for (auto index = std::size_t{0u}; index < num_indices; ++index)
+          for (auto qubit_index = std::size_t{0u}; qubit_index < num_qubits; ++qubit_index)
+            if (((index >> qubit_index) bitand std::size_t{1u}) == std::size_t{1u})
+              index_offsets[index] |= ::ket::utility::integer_exp2<StateInteger>(qubits[qubit_index]);
+
+        using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+        auto matrix_elements = std::array<complex_type, num_indices * num_indices>{};
+        std::transform(
+          boost::begin(matrix), boost::begin(matrix) + num_indices * num_indices,
+          std::begin(matrix_elements),
+          [](typename std::iterator_traits<decltype(boost::begin(matrix))>::value_type const& element)
+          { return static_cast<complex_type>(element); });
+
+        using ::ket::utility::loop_n;
+        loop_n(
+          parallel_policy,
+          static_cast<StateInteger>(last - first) >> num_qubits,
+          [first, &lower_bits_masks, &index_offsets, &matrix_elements](
+            StateInteger const value_wo_qubits, int const)
+          {
+            auto base_index = value_wo_qubits;
+            for (auto const lower_bits_mask: lower_bits_masks)
+              base_index
+                = ((base_index bitand compl lower_bits_mask) << 1u)
+                  bitor (base_index bitand lower_bits_mask);
+
+            auto amplitudes = std::array<complex_type, num_indices>{};
+            for (auto index = std::size_t{0u}; index < num_indices; ++index)
+              amplitudes[index] = *(first + (base_index bitor index_offsets[index]));
+
+            for (auto row = std::size_t{0u}; row < num_indices; ++row)
+            {
+              auto result = complex_type{};
+              for (auto column = std::size_t{0u}; column < num_indices; ++column)
+                result += matrix_elements[row * num_indices + column] * amplitudes[column];
+              *(first + (base_index bitor index_offsets[row])) = result;
+            }
+          });
+      }
+
+      template <typename Matrix>
+      Matrix conjugate_transpose(Matrix matrix)
+      {
+        auto const num_elements = static_cast<std::size_t>(boost::size(matrix));
+        auto num_indices = std::size_t{1u};
+        while (num_indices * num_indices < num_elements)
+          num_indices <<= 1u;
+        assert(num_indices * num_indices == num_elements);
+
+        auto const matrix_first = boost::begin(matrix);
+        using std::conj;
+        for (auto row = std::size_t{0u}; row < num_indices; ++row)
+        {
+          *(matrix_first + (row * num_indices + row)) = conj(*(matrix_first + (row * num_indices + row)));
+          for (auto column = row + std::size_t{1u}; column < num_indices; ++column)
+          {
+            auto const upper_element = *(matrix_first + (row * num_indices + column));
+            *(matrix_first + (row * num_indices + column)) = conj(*(matrix_first + (column * num_indices + row)));
+            *(matrix_first + (column * num_indices + row)) = conj(upper_element);
+          }
+        }
+
+        return matrix;
+      }
+    } // namespace unitary_detail
+
+    template <
+      typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, std::size_t num_qubits>
+    inline void unitary(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+    {
+      ::ket::gate::unitary_detail::unitary_impl(
+        ::ket::utility::policy::make_sequential(), first, last, matrix, qubits);
+    }
+
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, std::size_t num_qubits>
+    inline void unitary(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+    {
+      ::ket::gate::unitary_detail::unitary_impl(
+        parallel_policy, first, last, matrix, qubits);
+    }
+
+    namespace ranges
+    {
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits>
+      inline RandomAccessRange& unitary(
+        RandomAccessRange& state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+      {
+        ::ket::gate::unitary_detail::unitary_impl(
+          ::ket::utility::policy::make_sequential(),
+          std::begin(state), std::end(state), matrix, qubits);
+        return state;
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits>
+      inline RandomAccessRange& unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+      {
+        ::ket::gate::unitary_detail::unitary_impl(
+          parallel_policy, std::begin(state), std::end(state), matrix, qubits);
+        return state;
+      }
+    } // namespace ranges
+
+
+    template <
+      typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, typename... Qubits>
+    inline typename std::enable_if<
+      not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessIterator>::value,
+      void>::type
+    unitary(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+    {
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      ::ket::gate::unitary(
+        first, last, matrix,
+        std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+    }
+
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, typename... Qubits>
+    inline typename std::enable_if<
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+      void>::type
+    unitary(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+    {
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      ::ket::gate::unitary(
+        parallel_policy, first, last, matrix,
+        std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+    }
+
+    namespace ranges
+    {
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, typename... Qubits>
+      inline typename std::enable_if<
+        not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value,
+        RandomAccessRange&>::type
+      unitary(
+        RandomAccessRange& state, Matrix const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+      {
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        return ::ket::gate::ranges::unitary(
+          state, matrix, std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, typename... Qubits>
+      inline typename std::enable_if<
+        ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+        RandomAccessRange&>::type
+      unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, Matrix const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+      {
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        return ::ket::gate::ranges::unitary(
+          parallel_policy, state, matrix,
+          std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+      }
+    } // namespace ranges
+
+
+    template <
+      typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, std::size_t num_qubits>
+    inline void adj_unitary(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+    {
+      ::ket::gate::unitary(
+        first, last, ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits);
+    }
+
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, std::size_t num_qubits>
+    inline void adj_unitary(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+    {
+      ::ket::gate::unitary(
+        parallel_policy, first, last,
+        ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits);
+    }
+
+    namespace ranges
+    {
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits>
+      inline RandomAccessRange& adj_unitary(
+        RandomAccessRange& state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+      {
+        return ::ket::gate::ranges::unitary(
+          state, ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits>
+      inline RandomAccessRange& adj_unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits)
+      {
+        return ::ket::gate::ranges::unitary(
+          parallel_policy, state,
+          ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits);
+      }
+    } // namespace ranges
+
+    template <
+      typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, typename... Qubits>
+    inline typename std::enable_if<
+      not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessIterator>::value,
+      void>::type
+    adj_unitary(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+    {
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      ::ket::gate::adj_unitary(
+        first, last, matrix,
+        std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+    }
+
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename Matrix,
+      typename StateInteger, typename BitInteger, typename... Qubits>
+    inline typename std::enable_if<
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+      void>::type
+    adj_unitary(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      Matrix const& matrix,
+      ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+    {
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      ::ket::gate::adj_unitary(
+        parallel_policy, first, last, matrix,
+        std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+    }
+
+    namespace ranges
+    {
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, typename... Qubits>
+      inline typename std::enable_if<
+        not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value,
+        RandomAccessRange&>::type
+      adj_unitary(
+        RandomAccessRange& state, Matrix const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+      {
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        return ::ket::gate::ranges::adj_unitary(
+          state, matrix, std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, typename... Qubits>
+      inline typename std::enable_if<
+        ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+        RandomAccessRange&>::type
+      adj_unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& state, Matrix const& matrix,
+        ::ket::qubit<StateInteger, BitInteger> const qubit, Qubits const... qubits)
+      {
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        return ::ket::gate::ranges::adj_unitary(
+          parallel_policy, state, matrix,
+          std::array<qubit_type, sizeof...(Qubits) + 1u>{qubit, qubits...});
+      }
+    } // namespace ranges
+  } // namespace gate
+} // namespace ket
+
+
+#endif // KET_GATE_UNITARY_HPP
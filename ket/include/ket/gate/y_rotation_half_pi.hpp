@@ -15,6 +15,9 @@
 #   include <ket/utility/integer_log2.hpp>
 # endif
 # include <ket/utility/meta/real_of.hpp>
+# ifdef KET_USE_SIMD
+#   include <ket/gate/detail/simd_one_qubit_gate.hpp>
+# endif // KET_USE_SIMD
 
 
 namespace ket
@@ -23,6 +26,38 @@ namespace ket
   {
     namespace y_rotation_half_pi_detail
     {
+# ifdef KET_USE_SIMD
+      // (|0> + |1>)/sqrt(2), (|1> - |0>)/sqrt(2)
+      struct simd_y_rotation_half_pi
+      {
+        template <typename ComplexVector>
+        void operator()(ComplexVector& zero_value, ComplexVector& one_value) const
+        {
+          using real_type = typename ComplexVector::real_type;
+          using boost::math::constants::one_div_root_two;
+          auto const new_zero_value = (zero_value + one_value) * one_div_root_two<real_type>();
+          one_value = (one_value - zero_value) * one_div_root_two<real_type>();
+          zero_value = new_zero_value;
+        }
+      }; // struct simd_y_rotation_half_pi
+# endif // KET_USE_SIMD
+
+# ifdef KET_USE_SIMD
+      // (|0> - |1>)/sqrt(2), (|1> + |0>)/sqrt(2)
+      struct simd_adj_y_rotation_half_pi
+      {
+        template <typename ComplexVector>
+        void operator()(ComplexVector& zero_value, ComplexVector& one_value) const
+        {
+          using real_type = typename ComplexVector::real_type;
+          using boost::math::constants::one_div_root_two;
+          auto const new_zero_value = (zero_value - one_value) * one_div_root_two<real_type>();
+          one_value = (one_value + zero_value) * one_div_root_two<real_type>();
+          zero_value = new_zero_value;
+        }
+      }; // struct simd_adj_y_rotation_half_pi
+# endif // KET_USE_SIMD
+
       template <
         typename ParallelPolicy, typename RandomAccessIterator,
         typename StateInteger, typename BitInteger>
@@ -43,6 +78,13 @@ namespace ket
             ::ket::utility::integer_log2<BitInteger>(last - first))
           == static_cast<StateInteger>(last - first));
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::y_rotation_half_pi_detail::simd_y_rotation_half_pi{}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -62,7 +104,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
             using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
@@ -149,6 +191,13 @@ namespace ket
             ::ket::utility::integer_log2<BitInteger>(last - first))
           == static_cast<StateInteger>(last - first));
 
+# ifdef KET_USE_SIMD
+        if (::ket::gate::detail::simd_one_qubit_gate(
+              parallel_policy, first, last, qubit,
+              ::ket::gate::y_rotation_half_pi_detail::simd_adj_y_rotation_half_pi{}))
+          return;
+# endif // KET_USE_SIMD
+
         auto const qubit_mask = ::ket::utility::integer_exp2<StateInteger>(qubit);
         auto const lower_bits_mask = qubit_mask - StateInteger{1u};
         auto const upper_bits_mask = compl lower_bits_mask;
@@ -168,7 +217,7 @@ namespace ket
             auto const one_index = zero_index bitor qubit_mask;
             auto const zero_iter = first + zero_index;
             auto const one_iter = first + one_index;
-            auto const zero_iter_value = *zero_iter;
+            typename std::iterator_traits<RandomAccessIterator>::value_type const zero_iter_value = *zero_iter;
 
             using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
             using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
@@ -6,6 +6,7 @@
 # include <iterator>
 # include <type_traits>
 # include <vector>
+# include <algorithm>
 
 # include <boost/range/size.hpp>
 # include <boost/range/value_type.hpp>
@@ -14,13 +15,19 @@
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 
+# include <ket/qubit.hpp>
 # include <ket/control.hpp>
+# include <ket/addition_assignment.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/generate_phase_coefficients.hpp>
 # include <ket/mpi/swapped_fourier_transform.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/gate/controlled_phase_shift.hpp>
+# include <ket/mpi/gate/basis_permutation.hpp>
+# include <ket/mpi/page/is_on_page.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/remap_qubits.hpp>
 # include <ket/mpi/utility/logger.hpp>
 
 
@@ -28,7 +35,7 @@ namespace ket
 {
   namespace mpi
   {
-    // lhs += rhs
+    // lhs += rhs: see ket::addition_assignment
     namespace addition_assignment_detail
     {
       template <
@@ -116,6 +123,106 @@ namespace ket
           }
         }
       }
+
+      // make_lhs_qubits_local: lhs += rhs is applied by ket::mpi::gate::basis_permutation if all the lhs qubits are
+      //   in each local range. The nonlocal lhs qubits are exchanged with local qubits out of lhs_qubits by
+      //   remap_nonlocal_qubits. It fails if lhs_qubits has more qubits than local qubits or some of them are on
+      //   pages, and then the Fourier-transform-based addition is used
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Qubits,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline bool make_lhs_qubits_local(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Qubits const& lhs_qubits,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<
+          typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        if (static_cast<BitInteger>(boost::size(lhs_qubits)) > num_local_qubits)
+          return false;
+
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
+        auto const is_nonlocal
+          = [&permutation, num_local_qubits](qubit_type const qubit)
+            { return permutation[qubit] >= permutated_qubit_type{num_local_qubits}; };
+        while (std::any_of(std::begin(lhs_qubits), std::end(lhs_qubits), is_nonlocal))
+          ::ket::mpi::utility::remap_nonlocal_qubits(
+            mpi_policy, parallel_policy, local_state, std::begin(lhs_qubits), std::end(lhs_qubits),
+            permutation, buffer, communicator, environment);
+
+        return std::none_of(
+          std::begin(lhs_qubits), std::end(lhs_qubits),
+          [&permutation, &local_state](qubit_type const qubit)
+          { return ::ket::mpi::page::is_on_page(permutation[qubit], local_state); });
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Qubits,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline bool make_lhs_qubits_local(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Qubits const& lhs_qubits,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<
+          typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        if (static_cast<BitInteger>(boost::size(lhs_qubits)) > num_local_qubits)
+          return false;
+
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
+        auto const is_nonlocal
+          = [&permutation, num_local_qubits](qubit_type const qubit)
+            { return permutation[qubit] >= permutated_qubit_type{num_local_qubits}; };
+        while (std::any_of(std::begin(lhs_qubits), std::end(lhs_qubits), is_nonlocal))
+          ::ket::mpi::utility::remap_nonlocal_qubits(
+            mpi_policy, parallel_policy, local_state, std::begin(lhs_qubits), std::end(lhs_qubits),
+            permutation, buffer, datatype, communicator, environment);
+
+        return std::none_of(
+          std::begin(lhs_qubits), std::end(lhs_qubits),
+          [&permutation, &local_state](qubit_type const qubit)
+          { return ::ket::mpi::page::is_on_page(permutation[qubit], local_state); });
+      }
+
+      // The rhs qubits may be anywhere because their values are read from permutated qubit values
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename RandomAccessRange, typename Qubits, typename QubitsRange,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline void permutate_lhs_values(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state,
+        Qubits const& lhs_qubits, QubitsRange const& rhs_qubits_range, bool const is_subtraction,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::gate::basis_permutation(
+          mpi_policy, parallel_policy, local_state, lhs_qubits,
+          ::ket::addition_assignment_detail::register_addition<StateInteger, BitInteger>{
+            static_cast<std::size_t>(boost::size(lhs_qubits)), rhs_qubits_range,
+            [&permutation](::ket::qubit<StateInteger, BitInteger> const qubit)
+            { return static_cast<BitInteger>(permutation[qubit].qubit()); },
+            is_subtraction},
+          permutation, communicator, environment);
+      }
     } // namespace addition_assignment_detail
 
     template <
@@ -148,6 +255,17 @@ namespace ket
       ::ket::mpi::utility::log_with_time_guard<char> print{"Addition", environment};
 
       auto const num_qubits = boost::size(lhs_qubits);
+      if (::ket::mpi::addition_assignment_detail::make_lhs_qubits_local(
+            mpi_policy, parallel_policy, local_state, lhs_qubits, permutation,
+            buffer, communicator, environment))
+      {
+        ::ket::mpi::addition_assignment_detail::permutate_lhs_values(
+          mpi_policy, parallel_policy, local_state, lhs_qubits, rhs_qubits_range, false,
+          permutation, communicator, environment);
+        return local_state;
+      }
+
+      // the phase coefficients are needed only when the lhs qubits cannot be made local
       ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
 
       using ::ket::mpi::swapped_fourier_transform;
@@ -203,6 +321,17 @@ namespace ket
       ::ket::mpi::utility::log_with_time_guard<char> print{"Addition", environment};
 
       auto const num_qubits = boost::size(lhs_qubits);
+      if (::ket::mpi::addition_assignment_detail::make_lhs_qubits_local(
+            mpi_policy, parallel_policy, local_state, lhs_qubits, permutation,
+            buffer, datatype, communicator, environment))
+      {
+        ::ket::mpi::addition_assignment_detail::permutate_lhs_values(
+          mpi_policy, parallel_policy, local_state, lhs_qubits, rhs_qubits_range, false,
+          permutation, communicator, environment);
+        return local_state;
+      }
+
+      // the phase coefficients are needed only when the lhs qubits cannot be made local
       ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
 
       using ::ket::mpi::swapped_fourier_transform;
@@ -362,8 +491,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         mpi_policy, parallel_policy,
@@ -392,8 +520,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         mpi_policy, parallel_policy,
@@ -419,8 +546,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -449,8 +575,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -477,8 +602,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -507,8 +631,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -640,6 +763,17 @@ namespace ket
       ::ket::mpi::utility::log_with_time_guard<char> print{"Adj(Addition)", environment};
 
       auto const num_qubits = boost::size(lhs_qubits);
+      if (::ket::mpi::addition_assignment_detail::make_lhs_qubits_local(
+            mpi_policy, parallel_policy, local_state, lhs_qubits, permutation,
+            buffer, communicator, environment))
+      {
+        ::ket::mpi::addition_assignment_detail::permutate_lhs_values(
+          mpi_policy, parallel_policy, local_state, lhs_qubits, rhs_qubits_range, true,
+          permutation, communicator, environment);
+        return local_state;
+      }
+
+      // the phase coefficients are needed only when the lhs qubits cannot be made local
       ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
 
       using ::ket::mpi::swapped_fourier_transform;
@@ -695,6 +829,17 @@ namespace ket
       ::ket::mpi::utility::log_with_time_guard<char> print{"Adj(Addition)", environment};
 
       auto const num_qubits = boost::size(lhs_qubits);
+      if (::ket::mpi::addition_assignment_detail::make_lhs_qubits_local(
+            mpi_policy, parallel_policy, local_state, lhs_qubits, permutation,
+            buffer, datatype, communicator, environment))
+      {
+        ::ket::mpi::addition_assignment_detail::permutate_lhs_values(
+          mpi_policy, parallel_policy, local_state, lhs_qubits, rhs_qubits_range, true,
+          permutation, communicator, environment);
+        return local_state;
+      }
+
+      // the phase coefficients are needed only when the lhs qubits cannot be made local
       ::ket::utility::generate_phase_coefficients(phase_coefficients, num_qubits);
 
       using ::ket::mpi::swapped_fourier_transform;
@@ -856,8 +1001,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         mpi_policy, parallel_policy,
@@ -886,8 +1030,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         mpi_policy, parallel_policy,
@@ -913,8 +1056,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -943,8 +1085,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -972,8 +1113,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -1003,8 +1143,7 @@ namespace ket
       yampi::environment const& environment)
     {
       using complex_type = typename boost::range_value<RandomAccessRange>::type;
-      auto phase_coefficients
-        = ::ket::utility::generate_phase_coefficients<complex_type>(boost::size(lhs_qubits));
+      auto phase_coefficients = std::vector<complex_type>{};
 
       return adj_addition_assignment(
         ::ket::mpi::utility::policy::make_general_mpi(),
@@ -1,29 +1,276 @@
 #ifndef KET_MPI_ALL_EXPECTATION_VALUES_HPP
 # define KET_MPI_ALL_EXPECTATION_VALUES_HPP
 
+# include <cstddef>
+# include <complex>
 # include <array>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <utility>
 # include <type_traits>
 
 # include <boost/optional.hpp>
 
+# include <boost/math/constants/constants.hpp>
+# include <boost/range/size.hpp>
 # include <boost/range/value_type.hpp>
 
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 # include <yampi/communicator.hpp>
+# include <yampi/rank.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/all_reduce.hpp>
+# include <yampi/reduce.hpp>
+# include <yampi/binary_operation.hpp>
 
 # include <ket/qubit.hpp>
+# include <ket/spin_expectation_value.hpp>
+# include <ket/all_spin_expectation_values.hpp>
 # include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_log2.hpp>
 # include <ket/utility/meta/real_of.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
-# include <ket/mpi/spin_expectation_value.hpp>
+# include <ket/mpi/page/is_on_page.hpp>
+# include <ket/mpi/page/spin_expectation_value.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/for_each_swapped_chunk.hpp>
+# include <ket/mpi/utility/logger.hpp>
 
 
 namespace ket
 {
   namespace mpi
   {
+    namespace all_spin_expectation_values_detail
+    {
+      template <typename Real, typename Spin>
+      inline void add_spin(std::vector<Real>& spins, std::size_t const qubit, Spin const& spin)
+      {
+        spins[3u * qubit] += static_cast<Real>(spin[0u]);
+        spins[3u * qubit + 1u] += static_cast<Real>(spin[1u]);
+        spins[3u * qubit + 2u] += static_cast<Real>(spin[2u]);
+      }
+
+      // spin of a local permutated qubit on this process
+      template <typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename StateInteger, typename BitInteger>
+      inline std::array<typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type, 3u>
+      local_spin(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> > const permutated_qubit,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        if (::ket::mpi::page::is_on_page(permutated_qubit, local_state))
+          return ::ket::mpi::page::spin_expectation_value(parallel_policy, local_state, permutated_qubit);
+
+        using complex_type = typename boost::range_value<LocalState>::type;
+        using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
+        auto result = std::array<real_type, 3u>{};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [parallel_policy, permutated_qubit, &result](auto const first, auto const last)
+          {
+            auto const spin = ::ket::spin_expectation_value(parallel_policy, first, last, permutated_qubit.qubit());
+            result[0u] += spin[0u];
+            result[1u] += spin[1u];
+            result[2u] += spin[2u];
+          });
+        return result;
+      }
+
+      // global qubits are made local one by one by interchanges
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename LocalState, typename StateInteger, typename BitInteger, typename Allocator,
+        typename ForEachSwappedChunk, typename Real, typename Interchange>
+      inline void add_global_spins(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector< ::ket::qubit<StateInteger, BitInteger> > const& global_qubits,
+        ForEachSwappedChunk&&, Interchange&& interchange, std::vector<Real>& spins,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        for (auto const qubit: global_qubits)
+        {
+          interchange(std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{qubit});
+          ::ket::mpi::all_spin_expectation_values_detail::add_spin(
+            spins, static_cast<std::size_t>(static_cast<BitInteger>(qubit)),
+            ::ket::mpi::all_spin_expectation_values_detail::local_spin(
+              mpi_policy, parallel_policy, local_state, permutation[qubit], communicator, environment));
+        }
+      }
+
+      // Without unit qubits, the processes whose ranks differ only in the bit of a global qubit have the pairs of the
+      // qubit at the same local indices. <Z> only needs the norms of the processes, and each process of a pair computes
+      // the partial sums of <X> and <Y> over one half of the local indices, receiving the other half of the values of its
+      // partner chunk by chunk by for_each_swapped_chunk(sent_first_index, num_values, min_chunk_size, target_rank,
+      // function) (see ::ket::mpi::utility::for_each_swapped_chunk)
+      template <
+        typename ParallelPolicy,
+        typename LocalState, typename StateInteger, typename BitInteger, typename Allocator,
+        typename ForEachSwappedChunk, typename Real, typename Interchange>
+      inline void add_global_spins(
+        ::ket::mpi::utility::policy::general_mpi const mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector< ::ket::qubit<StateInteger, BitInteger> > const& global_qubits,
+        ForEachSwappedChunk&& for_each_swapped_chunk, Interchange&&, std::vector<Real>& spins,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        if (global_qubits.empty())
+          return;
+
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        auto const present_rank = communicator.rank(environment).mpi_rank();
+        auto const half_size = static_cast<std::size_t>(boost::size(local_state)) / 2u;
+
+        auto local_norm = Real{0};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&local_norm](auto const first, auto const last)
+          {
+            for (auto iter = first; iter != last; ++iter)
+            {
+              using std::norm;
+              local_norm += static_cast<Real>(norm(*iter));
+            }
+          });
+
+        using boost::math::constants::half;
+        for (auto const qubit: global_qubits)
+        {
+          auto const rank_bit
+            = static_cast<BitInteger>(permutation[qubit].qubit()) - num_local_qubits;
+          auto const is_zero_rank = ((present_rank >> rank_bit) bitand 1) == 0;
+          auto const partner_rank = present_rank xor (1 << rank_bit);
+          auto const bit = static_cast<std::size_t>(static_cast<BitInteger>(qubit));
+          spins[3u * bit + 2u] += is_zero_rank ? half<Real>() * local_norm : -half<Real>() * local_norm;
+
+          auto const computed_first_index = is_zero_rank ? std::size_t{0u} : half_size;
+          auto const sent_first_index = is_zero_rank ? half_size : std::size_t{0u};
+          for_each_swapped_chunk(
+            sent_first_index, half_size, std::size_t{1u}, yampi::rank{partner_rank},
+            [mpi_policy, parallel_policy, &local_state, computed_first_index, is_zero_rank, &spins, bit,
+             &communicator, &environment](
+              std::size_t const chunk_first_index, std::size_t const chunk_last_index, auto const receive_buffer_first)
+            {
+              ::ket::mpi::utility::for_each_local_subrange(
+                mpi_policy, local_state, computed_first_index + chunk_first_index, computed_first_index + chunk_last_index,
+                communicator, environment,
+                [parallel_policy, receive_buffer_first, is_zero_rank, &spins, bit](
+                  auto const first, auto const last, std::size_t const offset)
+                {
+                  using hd_spin_type = ::ket::all_spin_expectation_values_detail::hd_spin_type;
+                  auto const partner_first = receive_buffer_first + offset;
+                  auto const hd_spin
+                    = ::ket::utility::loop_n_reduce(
+                        parallel_policy, static_cast<std::size_t>(last - first), hd_spin_type{},
+                        [](hd_spin_type accumulated_spin, hd_spin_type const& spin)
+                        {
+                          accumulated_spin[0u] += spin[0u];
+                          accumulated_spin[1u] += spin[1u];
+                          return accumulated_spin;
+                        },
+                        [first, partner_first, is_zero_rank](std::size_t const index, int const, hd_spin_type& partial_spin)
+                        {
+                          auto const present_value = static_cast<typename std::iterator_traits<decltype(partner_first)>::value_type>(*(first + index));
+                          auto const partner_value = *(partner_first + index);
+                          using std::conj;
+                          auto const conj_zero_times_one
+                            = is_zero_rank ? conj(present_value) * partner_value : conj(partner_value) * present_value;
+
+                          using std::real;
+                          partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
+                          using std::imag;
+                          partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
+                        });
+                  spins[3u * bit] += static_cast<Real>(hd_spin[0u]);
+                  spins[3u * bit + 1u] += static_cast<Real>(hd_spin[1u]);
+                });
+            });
+        }
+      }
+
+      // spins_before_reduction: the flattened spins of all the qubits, whose sums over processes are the expectation
+      //   values. The spins of the local qubits are computed by two sweeps over each local range (see
+      //   ::ket::all_spin_expectation_values), and those of the page qubits and the global qubits follow
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename LocalState, typename StateInteger, typename BitInteger, typename Allocator,
+        typename ForEachSwappedChunk, typename Interchange>
+      inline std::vector<typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>
+      spins_before_reduction(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        BitInteger const num_qubits,
+        ForEachSwappedChunk&& for_each_swapped_chunk, Interchange&& interchange,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        using complex_type = typename boost::range_value<LocalState>::type;
+        using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
+        auto result = std::vector<real_type>(3u * num_qubits);
+
+        auto hd_spins = ::ket::all_spin_expectation_values_detail::hd_spins_type{};
+        auto num_range_qubits = BitInteger{0u};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [parallel_policy, &hd_spins, &num_range_qubits](auto const first, auto const last)
+          {
+            num_range_qubits = ::ket::utility::integer_log2<BitInteger>(last - first);
+            hd_spins.resize(num_range_qubits);
+            ::ket::all_spin_expectation_values_detail::accumulate_spins(parallel_policy, first, last, hd_spins);
+          });
+
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        auto global_qubits = std::vector<qubit_type>{};
+        auto const last_qubit = qubit_type{num_qubits};
+        for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
+        {
+          auto const permutated_qubit = permutation[qubit];
+          auto const permutated_bit = static_cast<BitInteger>(permutated_qubit.qubit());
+          auto const bit = static_cast<std::size_t>(static_cast<BitInteger>(qubit));
+          if (permutated_bit < num_range_qubits)
+            ::ket::mpi::all_spin_expectation_values_detail::add_spin(
+              result, bit, ::ket::all_spin_expectation_values_detail::to_spin<real_type>(hd_spins[permutated_bit]));
+          else if (permutated_bit < num_local_qubits)
+            ::ket::mpi::all_spin_expectation_values_detail::add_spin(
+              result, bit,
+              ::ket::mpi::all_spin_expectation_values_detail::local_spin(
+                mpi_policy, parallel_policy, local_state, permutated_qubit, communicator, environment));
+          else
+            global_qubits.push_back(qubit);
+        }
+
+        ::ket::mpi::all_spin_expectation_values_detail::add_global_spins(
+          mpi_policy, parallel_policy, local_state, permutation, global_qubits,
+          std::forward<ForEachSwappedChunk>(for_each_swapped_chunk), std::forward<Interchange>(interchange), result,
+          communicator, environment);
+
+        return result;
+      }
+
+      template <typename SpinsAllocator, typename Real>
+      inline std::vector<std::array<Real, 3u>, SpinsAllocator> to_spins(std::vector<Real> const& flattened_spins)
+      {
+        auto result = std::vector<std::array<Real, 3u>, SpinsAllocator>{};
+        result.reserve(flattened_spins.size() / 3u);
+        for (auto index = std::size_t{0u}; index < flattened_spins.size(); index += 3u)
+          result.push_back(
+            std::array<Real, 3u>{{flattened_spins[index], flattened_spins[index + 1u], flattened_spins[index + 2u]}});
+        return result;
+      }
+    } // namespace all_spin_expectation_values_detail
+
     // all_reduce version
     template <
       typename SpinsAllocator,
@@ -46,21 +293,34 @@ namespace ket
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
-      using complex_type = typename boost::range_value<LocalState>::type;
-      using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      using spin_type = std::array<real_type, 3u>;
-      auto result = std::vector<spin_type, SpinsAllocator>{};
-      result.reserve(num_qubits);
-
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-        result.push_back(
-          ::ket::mpi::spin_expectation_value(
-            mpi_policy, parallel_policy, local_state, qubit, permutation, buffer,
-            communicator, environment));
-
-      return result;
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Spins", environment};
+
+      auto const spins
+        = ::ket::mpi::all_spin_expectation_values_detail::spins_before_reduction(
+            mpi_policy, parallel_policy, local_state, permutation, num_qubits,
+            [&mpi_policy, &local_state, &buffer, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, target_rank,
+                communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &communicator, &environment](
+              auto const& qubits)
+            {
+              ::ket::mpi::utility::maybe_interchange_qubits(
+                mpi_policy, parallel_policy, local_state, qubits, permutation, buffer, communicator, environment);
+            },
+            communicator, environment);
+
+      auto result = spins;
+      yampi::all_reduce(
+        yampi::make_buffer(std::begin(spins), std::end(spins)),
+        std::begin(result), yampi::binary_operation(::yampi::plus_t()),
+        communicator, environment);
+
+      return ::ket::mpi::all_spin_expectation_values_detail::to_spins<SpinsAllocator>(result);
     }
 
     template <
@@ -87,21 +347,35 @@ namespace ket
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
-      using complex_type = typename boost::range_value<LocalState>::type;
-      using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      using spin_type = std::array<real_type, 3u>;
-      auto result = std::vector<spin_type, SpinsAllocator>{};
-      result.reserve(num_qubits);
-
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-        result.push_back(
-          ::ket::mpi::spin_expectation_value(
-            mpi_policy, parallel_policy, local_state, qubit, permutation, buffer,
-            real_datatype, complex_datatype, communicator, environment));
-
-      return result;
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Spins", environment};
+
+      auto const spins
+        = ::ket::mpi::all_spin_expectation_values_detail::spins_before_reduction(
+            mpi_policy, parallel_policy, local_state, permutation, num_qubits,
+            [&mpi_policy, &local_state, &buffer, &complex_datatype, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, complex_datatype,
+                target_rank, communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &complex_datatype, &communicator, &environment](
+              auto const& qubits)
+            {
+              ::ket::mpi::utility::maybe_interchange_qubits(
+                mpi_policy, parallel_policy, local_state, qubits, permutation, buffer, complex_datatype,
+                communicator, environment);
+            },
+            communicator, environment);
+
+      auto result = spins;
+      yampi::all_reduce(
+        yampi::make_buffer(std::begin(spins), std::end(spins), real_datatype),
+        std::begin(result), yampi::binary_operation(::yampi::plus_t()),
+        communicator, environment);
+
+      return ::ket::mpi::all_spin_expectation_values_detail::to_spins<SpinsAllocator>(result);
     }
 
     template <
@@ -417,32 +691,37 @@ namespace ket
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
-      auto const is_root = communicator.rank(environment) == root;
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Spins", environment};
 
-      using complex_type = typename boost::range_value<LocalState>::type;
-      using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      using spin_type = std::array<real_type, 3u>;
-      auto result = std::vector<spin_type, SpinsAllocator>{};
-      if (is_root)
-        result.reserve(num_qubits);
+      auto const spins
+        = ::ket::mpi::all_spin_expectation_values_detail::spins_before_reduction(
+            mpi_policy, parallel_policy, local_state, permutation, num_qubits,
+            [&mpi_policy, &local_state, &buffer, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, target_rank,
+                communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &communicator, &environment](
+              auto const& qubits)
+            {
+              ::ket::mpi::utility::maybe_interchange_qubits(
+                mpi_policy, parallel_policy, local_state, qubits, permutation, buffer, communicator, environment);
+            },
+            communicator, environment);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-      {
-        auto const maybe_expectation_value
-          = ::ket::mpi::spin_expectation_value(
-              mpi_policy, parallel_policy, local_state, qubit, permutation, buffer,
-              root, communicator, environment);
-
-        if (is_root and maybe_expectation_value)
-          result.push_back(*maybe_expectation_value);
-      }
+      auto result = spins;
+      yampi::reduce(root, communicator).call(
+        yampi::make_buffer(std::begin(spins), std::end(spins)),
+        std::begin(result), yampi::binary_operation(yampi::plus_t()),
+        environment);
 
-      if (not is_root)
+      if (communicator.rank(environment) != root)
         return boost::none;
 
-      return result;
+      return ::ket::mpi::all_spin_expectation_values_detail::to_spins<SpinsAllocator>(result);
     }
 
     template <
@@ -471,32 +750,38 @@ namespace ket
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
-      auto const is_root = communicator.rank(environment) == root;
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Spins", environment};
 
-      using complex_type = typename boost::range_value<LocalState>::type;
-      using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      using spin_type = std::array<real_type, 3u>;
-      auto result = std::vector<spin_type, SpinsAllocator>{};
-      if (is_root)
-        result.reserve(num_qubits);
+      auto const spins
+        = ::ket::mpi::all_spin_expectation_values_detail::spins_before_reduction(
+            mpi_policy, parallel_policy, local_state, permutation, num_qubits,
+            [&mpi_policy, &local_state, &buffer, &complex_datatype, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, complex_datatype,
+                target_rank, communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &complex_datatype, &communicator, &environment](
+              auto const& qubits)
+            {
+              ::ket::mpi::utility::maybe_interchange_qubits(
+                mpi_policy, parallel_policy, local_state, qubits, permutation, buffer, complex_datatype,
+                communicator, environment);
+            },
+            communicator, environment);
 
-      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
-      auto const last_qubit = qubit_type{num_qubits};
-      for (auto qubit = qubit_type{BitInteger{0u}}; qubit < last_qubit; ++qubit)
-      {
-        auto const maybe_expectation_value
-          = ::ket::mpi::spin_expectation_value(
-              mpi_policy, parallel_policy, local_state, qubit, permutation, buffer,
-              real_datatype, complex_datatype, root, communicator, environment);
-
-        if (is_root and maybe_expectation_value)
-          result.push_back(*maybe_expectation_value);
-      }
+      auto result = spins;
+      yampi::reduce(root, communicator).call(
+        yampi::make_buffer(std::begin(spins), std::end(spins), real_datatype),
+        std::begin(result), yampi::binary_operation(yampi::plus_t()),
+        environment);
 
-      if (not is_root)
+      if (communicator.rank(environment) != root)
         return boost::none;
 
-      return result;
+      return ::ket::mpi::all_spin_expectation_values_detail::to_spins<SpinsAllocator>(result);
     }
 
     template <
@@ -0,0 +1,449 @@
+#ifndef KET_MPI_EXPECTATION_VALUE_HPP
+# define KET_MPI_EXPECTATION_VALUE_HPP
+
+# include <cstddef>
+# include <complex>
+# include <array>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+# include <memory>
+# include <type_traits>
+
+# include <boost/range/size.hpp>
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/datatype_base.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/rank.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/all_reduce.hpp>
+# include <yampi/binary_operation.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/pauli_term.hpp>
+# include <ket/expectation_value.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/meta/real_of.hpp>
+# include <ket/mpi/permutated.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/for_each_swapped_chunk.hpp>
+# include <ket/mpi/utility/remap_qubits.hpp>
+# include <ket/mpi/utility/logger.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace expectation_value_detail
+    {
+      // the values of i and i ^ permutated_x_mask are on this process. If permutated_x_mask has bits of qubits
+      // between local ranges, e.g. page qubits, the pairs of ranges are found by the second sweep of the ranges
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename StateInteger>
+      inline long double local_group_value(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState const& local_state, StateInteger const permutated_x_mask,
+        std::vector< ::ket::expectation_value_detail::weighted_z_mask<StateInteger> > const& terms,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const present_rank = communicator.rank(environment);
+        auto result = 0.0l;
+        auto range_first_index = StateInteger{0u};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&mpi_policy, parallel_policy, &local_state, permutated_x_mask, &terms,
+           &communicator, &environment, present_rank, &result, &range_first_index](
+            auto const first, auto const last)
+          {
+            auto const range_size = static_cast<StateInteger>(last - first);
+            auto const in_range_x_mask = permutated_x_mask bitand (range_size - StateInteger{1u});
+            auto const partner_range_first_index = range_first_index xor (permutated_x_mask xor in_range_x_mask);
+            using ::ket::mpi::utility::rank_index_to_qubit_value;
+            auto const base_value = rank_index_to_qubit_value(mpi_policy, local_state, present_rank, range_first_index);
+
+            if (partner_range_first_index == range_first_index)
+              result
+                += ::ket::expectation_value_detail::sum_within(
+                     parallel_policy, first, range_size, base_value, in_range_x_mask, terms);
+            // the contributions of the partner range are the complex conjugates of those of this range
+            else if (partner_range_first_index > range_first_index)
+            {
+              auto other_range_first_index = StateInteger{0u};
+              ::ket::mpi::utility::for_each_local_range(
+                mpi_policy, local_state, communicator, environment,
+                [parallel_policy, first, range_size, base_value, in_range_x_mask, &terms,
+                 partner_range_first_index, &result, &other_range_first_index](
+                  auto const partner_first, auto const partner_last)
+                {
+                  if (other_range_first_index == partner_range_first_index)
+                    result
+                      += 2.0l
+                         * ::ket::expectation_value_detail::sum_weighted_products(
+                             parallel_policy, first, range_size, base_value,
+                             [](StateInteger const index) { return index; },
+                             [partner_first, in_range_x_mask](StateInteger const index)
+                             { return *(partner_first + (index xor in_range_x_mask)); },
+                             terms);
+                  other_range_first_index += static_cast<StateInteger>(partner_last - partner_first);
+                });
+            }
+
+            range_first_index += range_size;
+          });
+
+        return result;
+      }
+
+      // Without unit qubits, the values of i ^ permutated_x_mask for the local indices i are on the partner process
+      // whose rank differs in the global bits of permutated_x_mask. If the highest local qubit is not in
+      // permutated_x_mask, each process of a pair computes the doubled contributions of one half of the local
+      // indices, receiving the same half of the values of its partner. Otherwise all the values are exchanged.
+      // The values are exchanged by for_each_swapped_chunk(sent_first_index, num_values, min_chunk_size, target_rank,
+      // function) (see ::ket::mpi::utility::for_each_swapped_chunk) in chunks which are aligned to the highest local bit
+      // of permutated_x_mask
+      template <
+        typename ParallelPolicy, typename LocalState, typename StateInteger, typename ForEachSwappedChunk>
+      inline long double global_group_value(
+        ::ket::mpi::utility::policy::general_mpi const mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState const& local_state, StateInteger const permutated_x_mask,
+        std::vector< ::ket::expectation_value_detail::weighted_z_mask<StateInteger> > const& terms,
+        ForEachSwappedChunk&& for_each_swapped_chunk,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const local_size = static_cast<StateInteger>(boost::size(local_state));
+        auto const num_local_qubits = ::ket::utility::integer_log2<StateInteger>(local_size);
+        auto const local_x_mask = permutated_x_mask bitand (local_size - StateInteger{1u});
+        auto const present_rank = communicator.rank(environment);
+        auto const partner_rank
+          = present_rank.mpi_rank() xor static_cast<int>(permutated_x_mask >> num_local_qubits);
+        auto const is_lower_rank = present_rank.mpi_rank() < partner_rank;
+
+        auto const half_size = local_size / StateInteger{2u};
+        auto const is_halved = (local_x_mask bitand half_size) == StateInteger{0u};
+        auto const num_computed_values = is_halved ? half_size : local_size;
+        auto const computed_first_index
+          = is_halved and not is_lower_rank ? half_size : StateInteger{0u};
+        auto const sent_first_index
+          = is_halved and is_lower_rank ? half_size : StateInteger{0u};
+
+        auto const min_chunk_size
+          = local_x_mask == StateInteger{0u}
+            ? StateInteger{1u}
+            : ::ket::utility::integer_exp2<StateInteger>(
+                ::ket::utility::integer_log2<StateInteger>(local_x_mask) + StateInteger{1u});
+
+        auto result = 0.0l;
+        for_each_swapped_chunk(
+          static_cast<std::size_t>(sent_first_index), static_cast<std::size_t>(num_computed_values),
+          static_cast<std::size_t>(min_chunk_size), yampi::rank{partner_rank},
+          [mpi_policy, parallel_policy, &local_state, local_x_mask, &terms, present_rank, computed_first_index,
+           &result, &communicator, &environment](
+            std::size_t const chunk_first_index, std::size_t const chunk_last_index, auto const receive_buffer_first)
+          {
+            auto const chunk_first_local_index = computed_first_index + static_cast<StateInteger>(chunk_first_index);
+            ::ket::mpi::utility::for_each_local_subrange(
+              mpi_policy, local_state,
+              chunk_first_local_index, chunk_first_local_index + static_cast<StateInteger>(chunk_last_index - chunk_first_index),
+              communicator, environment,
+              [mpi_policy, parallel_policy, &local_state, local_x_mask, &terms, present_rank,
+               receive_buffer_first, chunk_first_local_index, &result](
+                auto const first, auto const last, std::size_t const offset)
+              {
+                using ::ket::mpi::utility::rank_index_to_qubit_value;
+                auto const base_value
+                  = rank_index_to_qubit_value(
+                      mpi_policy, local_state, present_rank, chunk_first_local_index + static_cast<StateInteger>(offset));
+                result
+                  += ::ket::expectation_value_detail::sum_weighted_products(
+                       parallel_policy, first, static_cast<StateInteger>(last - first), base_value,
+                       [](StateInteger const index) { return index; },
+                       [receive_buffer_first, offset, local_x_mask](StateInteger const index)
+                       { return *(receive_buffer_first + ((static_cast<StateInteger>(offset) + index) xor local_x_mask)); },
+                       terms);
+              });
+          });
+
+        return is_halved ? 2.0l * result : result;
+      }
+
+      // nonlocal qubits in x_mask are made local by interchange(nonlocal_qubit, evicted_qubit)
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename LocalState, typename PauliTermIterator, typename StateInteger, typename BitInteger,
+        typename Allocator, typename ForEachSwappedChunk, typename Interchange>
+      inline long double group_value(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, PauliTermIterator const group_first, PauliTermIterator const group_last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        ForEachSwappedChunk&&, Interchange&& interchange,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const x_mask = group_first->x_mask;
+        ::ket::mpi::utility::make_mask_qubits_local(
+          mpi_policy, local_state, x_mask, permutation, interchange, communicator, environment);
+
+        return ::ket::mpi::expectation_value_detail::local_group_value(
+          mpi_policy, parallel_policy, local_state,
+          ::ket::mpi::permutate_bits(permutation, x_mask),
+          ::ket::expectation_value_detail::to_weighted_z_masks(
+            group_first, group_last,
+            [&permutation](StateInteger const z_mask)
+            { return ::ket::mpi::permutate_bits(permutation, z_mask); }),
+          communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy,
+        typename LocalState, typename PauliTermIterator, typename StateInteger, typename BitInteger,
+        typename Allocator, typename ForEachSwappedChunk, typename Interchange>
+      inline long double group_value(
+        ::ket::mpi::utility::policy::general_mpi const mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, PauliTermIterator const group_first, PauliTermIterator const group_last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        ForEachSwappedChunk&& for_each_swapped_chunk, Interchange&&,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const permutated_x_mask
+          = ::ket::mpi::permutate_bits(permutation, group_first->x_mask);
+        auto const terms
+          = ::ket::expectation_value_detail::to_weighted_z_masks(
+              group_first, group_last,
+              [&permutation](StateInteger const z_mask)
+              { return ::ket::mpi::permutate_bits(permutation, z_mask); });
+
+        if (permutated_x_mask < static_cast<StateInteger>(boost::size(local_state)))
+          return ::ket::mpi::expectation_value_detail::local_group_value(
+            mpi_policy, parallel_policy, local_state, permutated_x_mask, terms, communicator, environment);
+
+        return ::ket::mpi::expectation_value_detail::global_group_value(
+          mpi_policy, parallel_policy, local_state, permutated_x_mask, terms,
+          std::forward<ForEachSwappedChunk>(for_each_swapped_chunk), communicator, environment);
+      }
+
+      // the contribution of this process, whose sum over processes is the expectation value
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger, typename Allocator,
+        typename ForEachSwappedChunk, typename Interchange>
+      inline typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type
+      value_before_reduction(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, PauliTerms const& pauli_terms,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        ForEachSwappedChunk&& for_each_swapped_chunk, Interchange&& interchange,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto result = 0.0l;
+        auto const groups = ::ket::expectation_value_detail::group_by_x_mask(pauli_terms);
+        for (auto group_index = std::size_t{0u}; group_index + 1u < groups.boundaries.size(); ++group_index)
+          result
+            += ::ket::mpi::expectation_value_detail::group_value(
+                 mpi_policy, parallel_policy, local_state,
+                 std::begin(groups.terms) + groups.boundaries[group_index],
+                 std::begin(groups.terms) + groups.boundaries[group_index + 1u],
+                 permutation, for_each_swapped_chunk, interchange, communicator, environment);
+
+        using real_type = typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type;
+        return static_cast<real_type>(result);
+      }
+    } // namespace expectation_value_detail
+
+    // expectation_value(mpi_policy, parallel_policy, local_state, pauli_terms, permutation, buffer, ...):
+    //   <psi|H|psi> for H = sum of pauli_terms, a range of ::ket::pauli_term, on all the processes. The state is not
+    //   copied, but the qubits may be interchanged unless mpi_policy is general_mpi
+    template <
+      typename MpiPolicy, typename ParallelPolicy,
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator>
+    inline typename std::enable_if<
+      ::ket::mpi::utility::policy::meta::is_mpi_policy<MpiPolicy>::value,
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Expectation value", environment};
+
+      auto const value
+        = ::ket::mpi::expectation_value_detail::value_before_reduction(
+            mpi_policy, parallel_policy, local_state, pauli_terms, permutation,
+            [&mpi_policy, &local_state, &buffer, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, target_rank,
+                communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &communicator, &environment](
+              ::ket::qubit<StateInteger, BitInteger> const nonlocal_qubit,
+              ::ket::qubit<StateInteger, BitInteger> const evicted_qubit)
+            {
+              ::ket::mpi::utility::remap_qubits(
+                mpi_policy, parallel_policy, local_state,
+                std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{nonlocal_qubit},
+                std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{evicted_qubit},
+                permutation, buffer, communicator, environment);
+            },
+            communicator, environment);
+
+      auto result = value;
+      yampi::all_reduce(
+        yampi::make_buffer(value), std::addressof(result), yampi::binary_operation(::yampi::plus_t()),
+        communicator, environment);
+
+      return result;
+    }
+
+    template <
+      typename MpiPolicy, typename ParallelPolicy,
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator,
+      typename DerivedDatatype1, typename DerivedDatatype2>
+    inline typename std::enable_if<
+      ::ket::mpi::utility::policy::meta::is_mpi_policy<MpiPolicy>::value,
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::datatype_base<DerivedDatatype1> const& real_datatype,
+      yampi::datatype_base<DerivedDatatype2> const& complex_datatype,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      ::ket::mpi::utility::log_with_time_guard<char> print{"Expectation value", environment};
+
+      auto const value
+        = ::ket::mpi::expectation_value_detail::value_before_reduction(
+            mpi_policy, parallel_policy, local_state, pauli_terms, permutation,
+            [&mpi_policy, &local_state, &buffer, &complex_datatype, &communicator, &environment](
+              std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+              yampi::rank const target_rank, auto&& function)
+            {
+              ::ket::mpi::utility::for_each_swapped_chunk(
+                mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, complex_datatype,
+                target_rank, communicator, environment, std::forward<decltype(function)>(function));
+            },
+            [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &complex_datatype,
+             &communicator, &environment](
+              ::ket::qubit<StateInteger, BitInteger> const nonlocal_qubit,
+              ::ket::qubit<StateInteger, BitInteger> const evicted_qubit)
+            {
+              ::ket::mpi::utility::remap_qubits(
+                mpi_policy, parallel_policy, local_state,
+                std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{nonlocal_qubit},
+                std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{evicted_qubit},
+                permutation, buffer, complex_datatype, communicator, environment);
+            },
+            communicator, environment);
+
+      auto result = value;
+      yampi::all_reduce(
+        yampi::make_buffer(value, real_datatype), std::addressof(result), yampi::binary_operation(::yampi::plus_t()),
+        communicator, environment);
+
+      return result;
+    }
+
+    template <
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator>
+    inline typename std::enable_if<
+      (not ::ket::mpi::utility::policy::meta::is_mpi_policy<LocalState>::value)
+        and (not ::ket::utility::policy::meta::is_loop_n_policy<LocalState>::value),
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      return ::ket::mpi::expectation_value(
+        ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
+        local_state, pauli_terms, permutation, buffer, communicator, environment);
+    }
+
+    template <
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator,
+      typename DerivedDatatype1, typename DerivedDatatype2>
+    inline typename std::enable_if<
+      (not ::ket::mpi::utility::policy::meta::is_mpi_policy<LocalState>::value)
+        and (not ::ket::utility::policy::meta::is_loop_n_policy<LocalState>::value),
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::datatype_base<DerivedDatatype1> const& real_datatype,
+      yampi::datatype_base<DerivedDatatype2> const& complex_datatype,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      return ::ket::mpi::expectation_value(
+        ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
+        local_state, pauli_terms, permutation, buffer, real_datatype, complex_datatype, communicator, environment);
+    }
+
+    template <
+      typename ParallelPolicy,
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator>
+    inline typename std::enable_if<
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      ParallelPolicy const parallel_policy,
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      return ::ket::mpi::expectation_value(
+        ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+        local_state, pauli_terms, permutation, buffer, communicator, environment);
+    }
+
+    template <
+      typename ParallelPolicy,
+      typename LocalState, typename PauliTerms, typename StateInteger, typename BitInteger,
+      typename Allocator, typename BufferAllocator,
+      typename DerivedDatatype1, typename DerivedDatatype2>
+    inline typename std::enable_if<
+      ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value,
+      typename ::ket::utility::meta::real_of<typename boost::range_value<LocalState>::type>::type>::type
+    expectation_value(
+      ParallelPolicy const parallel_policy,
+      LocalState& local_state, PauliTerms const& pauli_terms,
+      ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+      std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+      yampi::datatype_base<DerivedDatatype1> const& real_datatype,
+      yampi::datatype_base<DerivedDatatype2> const& complex_datatype,
+      yampi::communicator const& communicator,
+      yampi::environment const& environment)
+    {
+      return ::ket::mpi::expectation_value(
+        ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+        local_state, pauli_terms, permutation, buffer, real_datatype, complex_datatype, communicator, environment);
+    }
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_EXPECTATION_VALUE_HPP
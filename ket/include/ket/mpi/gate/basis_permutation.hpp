@@ -0,0 +1,183 @@
+#ifndef KET_MPI_GATE_BASIS_PERMUTATION_HPP
+# define KET_MPI_GATE_BASIS_PERMUTATION_HPP
+
+# include <boost/config.hpp>
+
+# include <cassert>
+# include <cstddef>
+# include <iterator>
+# include <vector>
+# include <type_traits>
+
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/rank.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/meta/state_integer_of.hpp>
+# include <ket/gate/basis_permutation.hpp>
+# include <ket/mpi/permutated.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/logger.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace gate
+    {
+      // basis_permutation: ket::gate::basis_permutation on the qubits, where o given to permutation_function is a
+      //   *permutated* qubit value (see ket::mpi::gate::diagonal), so the bits of the other registers are read at
+      //   their permutated positions, which may be global.
+      //   All the qubits have to be local and inside each local range of for_each_local_range, e.g. not on pages.
+      //   Then no communication is needed because each local range holds all the 2^n amplitudes sharing o
+      namespace basis_permutation_detail
+      {
+        template <typename StateInteger, typename PermutationFunction>
+        struct shifted_permutation_function
+        {
+          StateInteger first_qubit_value_;
+          PermutationFunction const& permutation_function_;
+
+          StateInteger operator()(StateInteger const value, StateInteger const other_index) const
+          { return permutation_function_(value, first_qubit_value_ bitor other_index); }
+        }; // struct shifted_permutation_function<StateInteger, PermutationFunction>
+
+        template <typename StateInteger, typename PermutationFunction>
+        inline ::ket::mpi::gate::basis_permutation_detail::shifted_permutation_function<StateInteger, PermutationFunction>
+        make_shifted_permutation_function(
+          StateInteger const first_qubit_value, PermutationFunction const& permutation_function)
+        { return {first_qubit_value, permutation_function}; }
+
+# ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+          typename PermutatedQubits, typename PermutationFunction>
+        struct call_basis_permutation
+        {
+          MpiPolicy const& mpi_policy_;
+          ParallelPolicy parallel_policy_;
+          LocalState const& local_state_;
+          PermutatedQubits const& permutated_qubits_;
+          PermutationFunction const& permutation_function_;
+          yampi::rank rank_;
+          std::size_t& range_index_;
+
+          template <typename RandomAccessIterator>
+          void operator()(RandomAccessIterator const first, RandomAccessIterator const last) const
+          {
+            using state_integer_type
+              = typename ::ket::meta::state_integer_of<typename PermutatedQubits::value_type>::type;
+            auto const range_size = static_cast<state_integer_type>(last - first);
+
+            using ::ket::mpi::utility::rank_index_to_qubit_value;
+            auto const first_qubit_value
+              = rank_index_to_qubit_value(
+                  mpi_policy_, local_state_, rank_, static_cast<state_integer_type>(range_index_++ * range_size));
+
+            ::ket::gate::basis_permutation(
+              parallel_policy_, first, last, permutated_qubits_,
+              ::ket::mpi::gate::basis_permutation_detail::make_shifted_permutation_function(
+                first_qubit_value, permutation_function_));
+          }
+        }; // struct call_basis_permutation<MpiPolicy, ParallelPolicy, LocalState, PermutatedQubits, PermutationFunction>
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+      } // namespace basis_permutation_detail
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename RandomAccessRange, typename Qubits, typename PermutationFunction,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline RandomAccessRange& basis_permutation(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Qubits const& qubits, PermutationFunction const& permutation_function,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{"BasisPermutation", environment};
+
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        auto permutated_qubits = std::vector<qubit_type>{};
+        for (auto const qubit: qubits)
+          permutated_qubits.push_back(permutation[qubit].qubit());
+# ifndef NDEBUG
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        for (auto const permutated_qubit: permutated_qubits)
+          assert(permutated_qubit < qubit_type{num_local_qubits});
+# endif // NDEBUG
+
+        auto const rank = communicator.rank(environment);
+        auto range_index = std::size_t{0u};
+
+# ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
+        return ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&mpi_policy, parallel_policy, &local_state, &permutated_qubits, &permutation_function, rank, &range_index](
+            auto const first, auto const last)
+          {
+            auto const range_size = static_cast<StateInteger>(last - first);
+
+            using ::ket::mpi::utility::rank_index_to_qubit_value;
+            auto const first_qubit_value
+              = rank_index_to_qubit_value(
+                  mpi_policy, local_state, rank, static_cast<StateInteger>(range_index++ * range_size));
+
+            ::ket::gate::basis_permutation(
+              parallel_policy, first, last, permutated_qubits,
+              ::ket::mpi::gate::basis_permutation_detail::make_shifted_permutation_function(
+                first_qubit_value, permutation_function));
+          });
+# else // BOOST_NO_CXX14_GENERIC_LAMBDAS
+        using call_basis_permutation_type
+          = ::ket::mpi::gate::basis_permutation_detail::call_basis_permutation<
+              MpiPolicy, ParallelPolicy, RandomAccessRange, std::vector<qubit_type>, PermutationFunction>;
+        return ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          call_basis_permutation_type{
+            mpi_policy, parallel_policy, local_state, permutated_qubits, permutation_function, rank, range_index});
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+      }
+
+      template <
+        typename RandomAccessRange, typename Qubits, typename PermutationFunction,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline RandomAccessRange& basis_permutation(
+        RandomAccessRange& local_state, Qubits const& qubits, PermutationFunction const& permutation_function,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::basis_permutation(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, qubits, permutation_function, permutation, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Qubits, typename PermutationFunction,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline RandomAccessRange& basis_permutation(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Qubits const& qubits, PermutationFunction const& permutation_function,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::basis_permutation(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, qubits, permutation_function, permutation, communicator, environment);
+      }
+    } // namespace gate
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_GATE_BASIS_PERMUTATION_HPP
@@ -74,12 +74,12 @@ namespace ket
             return ::ket::mpi::gate::page::clear(parallel_policy, local_state, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, permutated_qubit](auto const first, auto const last)
             { ::ket::gate::clear(parallel_policy, first, last, permutated_qubit.qubit()); });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::clear_detail::make_call_clear(parallel_policy, permutated_qubit));
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
@@ -100,7 +100,7 @@ namespace ket
               parallel_policy, local_state, permutated_target_qubit, permutated_control_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, permutated_target_qubit, permutated_control_qubit](
               auto const first, auto const last)
@@ -110,7 +110,7 @@ namespace ket
                 permutated_target_qubit.qubit(), permutated_control_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::controlled_not_detail::make_call_controlled_not(
               parallel_policy, permutated_target_qubit, permutated_control_qubit));
@@ -320,7 +320,7 @@ namespace ket
               parallel_policy, local_state, permutated_target_qubit, permutated_control_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, permutated_target_qubit, permutated_control_qubit](
               auto const first, auto const last)
@@ -330,7 +330,7 @@ namespace ket
                 permutated_target_qubit.qubit(), permutated_control_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::controlled_not_detail::make_call_adj_controlled_not(
               parallel_policy, permutated_target_qubit, permutated_control_qubit));
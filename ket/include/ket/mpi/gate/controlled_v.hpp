@@ -109,7 +109,7 @@ namespace ket
               parallel_policy, local_state, phase_coefficient, permutated_target_qubit, permutated_control_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, &phase_coefficient, permutated_target_qubit, permutated_control_qubit](
               auto const first, auto const last)
@@ -119,7 +119,7 @@ namespace ket
                 permutated_target_qubit.qubit(), permutated_control_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::controlled_v_detail::make_call_controlled_v_coeff(
               parallel_policy, phase_coefficient, permutated_target_qubit, permutated_control_qubit));
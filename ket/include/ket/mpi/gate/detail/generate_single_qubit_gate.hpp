@@ -26,7 +26,7 @@ namespace ket\
           if (::ket::mpi::page::is_on_page(permutated_qubit, local_state))\
             return ::ket::mpi::gate::page::gate_name(parallel_policy, local_state, permutated_qubit);\
 \
-          return ::ket::mpi::utility::for_each_local_range(\
+          return ::ket::mpi::utility::for_each_nonzero_local_range(\
             mpi_policy, local_state, communicator, environment,\
             [parallel_policy, permutated_qubit](auto const first, auto const last)\
             { ::ket::gate::gate_name(parallel_policy, first, last, permutated_qubit.qubit()); });\
@@ -177,7 +177,7 @@ namespace ket\
           if (::ket::mpi::page::is_on_page(permutated_qubit, local_state))\
             return ::ket::mpi::gate::page::adj_ ## gate_name(parallel_policy, local_state, permutated_qubit);\
 \
-          return ::ket::mpi::utility::for_each_local_range(\
+          return ::ket::mpi::utility::for_each_nonzero_local_range(\
             mpi_policy, local_state, communicator, environment,\
             [parallel_policy, permutated_qubit](auto const first, auto const last)\
             { ::ket::gate::adj_ ## gate_name(parallel_policy, first, last, permutated_qubit.qubit()); });\
@@ -360,7 +360,7 @@ namespace ket\
           if (::ket::mpi::page::is_on_page(permutated_qubit, local_state))\
             return ::ket::mpi::gate::page::gate_name(parallel_policy, local_state, permutated_qubit);\
 \
-          return ::ket::mpi::utility::for_each_local_range(\
+          return ::ket::mpi::utility::for_each_nonzero_local_range(\
             mpi_policy, local_state, communicator, environment,\
             ::ket::mpi::gate::gate_name ## _detail::make_call_ ## gate_name(parallel_policy, permutated_qubit));\
         }\
@@ -532,7 +532,7 @@ namespace ket\
           if (::ket::mpi::page::is_on_page(permutated_qubit, local_state))\
             return ::ket::mpi::gate::page::adj_ ## gate_name(parallel_policy, local_state, permutated_qubit);\
 \
-          return ::ket::mpi::utility::for_each_local_range(\
+          return ::ket::mpi::utility::for_each_nonzero_local_range(\
             mpi_policy, local_state, communicator, environment,\
             ::ket::mpi::gate::gate_name ## _detail::make_call_adj_ ## gate_name(parallel_policy, permutated_qubit));\
         }\
@@ -736,7 +736,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, permutated_qubit](
               auto const first, auto const last)
@@ -745,7 +745,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_phase_shift2(
               parallel_policy, phase1, phase2, permutated_qubit));
@@ -989,7 +989,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, permutated_qubit](
               auto const first, auto const last)
@@ -998,7 +998,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_adj_phase_shift2(
               parallel_policy, phase1, phase2, permutated_qubit));
@@ -1239,7 +1239,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, phase3, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, phase3, permutated_qubit](
               auto const first, auto const last)
@@ -1248,7 +1248,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, phase3, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_phase_shift3(
               parallel_policy, phase1, phase2, phase3, permutated_qubit));
@@ -1495,7 +1495,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, phase3, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, phase3, permutated_qubit](
               auto const first, auto const last)
@@ -1504,7 +1504,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, phase3, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_adj_phase_shift3(
               parallel_policy, phase1, phase2, phase3, permutated_qubit));
@@ -87,7 +87,7 @@ namespace ket
               parallel_policy, local_state, phase_coefficient, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, &phase_coefficient, permutated_qubit](
               auto const first, auto const last)
@@ -96,7 +96,7 @@ namespace ket
                 parallel_policy, first, last, phase_coefficient, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_phase_shift_coeff(
               parallel_policy, phase_coefficient, permutated_qubit));
@@ -849,7 +849,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, permutated_qubit](
               auto const first, auto const last)
@@ -858,7 +858,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_phase_shift2(
               parallel_policy, phase1, phase2, permutated_qubit));
@@ -1098,7 +1098,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, permutated_qubit](
               auto const first, auto const last)
@@ -1107,7 +1107,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_adj_phase_shift2(
               parallel_policy, phase1, phase2, permutated_qubit));
@@ -1347,7 +1347,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, phase3, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, phase3, permutated_qubit](
               auto const first, auto const last)
@@ -1356,7 +1356,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, phase3, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_phase_shift3(
               parallel_policy, phase1, phase2, phase3, permutated_qubit));
@@ -1599,7 +1599,7 @@ namespace ket
               parallel_policy, local_state, phase1, phase2, phase3, permutated_qubit);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, phase1, phase2, phase3, permutated_qubit](
               auto const first, auto const last)
@@ -1608,7 +1608,7 @@ namespace ket
                 parallel_policy, first, last, phase1, phase2, phase3, permutated_qubit.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::phase_shift_detail::make_call_adj_phase_shift3(
               parallel_policy, phase1, phase2, phase3, permutated_qubit));
@@ -0,0 +1,155 @@
+#ifndef KET_MPI_GATE_DIAGONAL_HPP
+# define KET_MPI_GATE_DIAGONAL_HPP
+
+# include <boost/config.hpp>
+
+# include <cstddef>
+# include <iterator>
+# include <type_traits>
+
+# include <yampi/environment.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/rank.hpp>
+
+# include <ket/gate/diagonal.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/logger.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace gate
+    {
+      // diagonal: multiplies the amplitude of |i> by coefficient_function(i), where i is a *permutated* qubit value,
+      //   that is, its j-th bit is the value of the qubit q with permutation[q] == j.
+      //   No communication is needed because every process knows permutated qubit values of its amplitudes.
+      //   for_each_local_range visits local ranges of the same size in the order of their local indices
+      //   (data blocks, and pages in each data block), so the qubit value of the first element of each range is
+      //   computed from the number of the ranges visited before it
+      namespace diagonal_detail
+      {
+        template <typename StateInteger, typename CoefficientFunction>
+        struct shifted_coefficient_function
+        {
+          StateInteger first_qubit_value_;
+          CoefficientFunction const& coefficient_function_;
+
+          template <typename Index>
+          auto operator()(Index const index) const -> decltype(coefficient_function_(first_qubit_value_))
+          { return coefficient_function_(first_qubit_value_ + static_cast<StateInteger>(index)); }
+        }; // struct shifted_coefficient_function<StateInteger, CoefficientFunction>
+
+        template <typename StateInteger, typename CoefficientFunction>
+        inline ::ket::mpi::gate::diagonal_detail::shifted_coefficient_function<StateInteger, CoefficientFunction>
+        make_shifted_coefficient_function(
+          StateInteger const first_qubit_value, CoefficientFunction const& coefficient_function)
+        { return {first_qubit_value, coefficient_function}; }
+
+# ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename CoefficientFunction>
+        struct call_diagonal
+        {
+          MpiPolicy const& mpi_policy_;
+          ParallelPolicy parallel_policy_;
+          LocalState const& local_state_;
+          CoefficientFunction const& coefficient_function_;
+          yampi::rank rank_;
+          std::size_t& range_index_;
+
+          template <typename RandomAccessIterator>
+          void operator()(RandomAccessIterator const first, RandomAccessIterator const last) const
+          {
+            using state_integer_type
+              = typename std::make_unsigned<typename std::iterator_traits<RandomAccessIterator>::difference_type>::type;
+            auto const range_size = static_cast<state_integer_type>(last - first);
+
+            using ::ket::mpi::utility::rank_index_to_qubit_value;
+            auto const first_qubit_value
+              = rank_index_to_qubit_value(
+                  mpi_policy_, local_state_, rank_, static_cast<state_integer_type>(range_index_++ * range_size));
+
+            ::ket::gate::diagonal(
+              parallel_policy_, first, last,
+              ::ket::mpi::gate::diagonal_detail::make_shifted_coefficient_function(
+                first_qubit_value, coefficient_function_));
+          }
+        }; // struct call_diagonal<MpiPolicy, ParallelPolicy, LocalState, CoefficientFunction>
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+      } // namespace diagonal_detail
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename RandomAccessRange, typename CoefficientFunction>
+      inline RandomAccessRange& diagonal(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, CoefficientFunction const& coefficient_function,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{"Diagonal", environment};
+
+        auto const rank = communicator.rank(environment);
+        auto range_index = std::size_t{0u};
+
+# ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
+        return ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&mpi_policy, parallel_policy, &local_state, &coefficient_function, rank, &range_index](
+            auto const first, auto const last)
+          {
+            using state_integer_type
+              = typename std::make_unsigned<typename std::iterator_traits<decltype(first)>::difference_type>::type;
+            auto const range_size = static_cast<state_integer_type>(last - first);
+
+            using ::ket::mpi::utility::rank_index_to_qubit_value;
+            auto const first_qubit_value
+              = rank_index_to_qubit_value(
+                  mpi_policy, local_state, rank, static_cast<state_integer_type>(range_index++ * range_size));
+
+            ::ket::gate::diagonal(
+              parallel_policy, first, last,
+              ::ket::mpi::gate::diagonal_detail::make_shifted_coefficient_function(
+                first_qubit_value, coefficient_function));
+          });
+# else // BOOST_NO_CXX14_GENERIC_LAMBDAS
+        using call_diagonal_type
+          = ::ket::mpi::gate::diagonal_detail::call_diagonal<MpiPolicy, ParallelPolicy, RandomAccessRange, CoefficientFunction>;
+        return ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          call_diagonal_type{mpi_policy, parallel_policy, local_state, coefficient_function, rank, range_index});
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+      }
+
+      template <typename RandomAccessRange, typename CoefficientFunction>
+      inline RandomAccessRange& diagonal(
+        RandomAccessRange& local_state, CoefficientFunction const& coefficient_function,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::diagonal(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, coefficient_function, communicator, environment);
+      }
+
+      template <typename ParallelPolicy, typename RandomAccessRange, typename CoefficientFunction>
+      inline RandomAccessRange& diagonal(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, CoefficientFunction const& coefficient_function,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::diagonal(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, coefficient_function, communicator, environment);
+      }
+    } // namespace gate
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_GATE_DIAGONAL_HPP
@@ -4,6 +4,7 @@
 # include <boost/config.hpp>
 
 # include <cmath>
+# include <functional>
 
 # include <boost/math/constants/constants.hpp>
 
@@ -44,29 +45,18 @@ namespace ket
         namespace clear_detail
         {
 # ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          template <typename Complex, typename Real>
+          template <typename Complex>
           struct clear1
           {
-            Real& zero_probability_;
-
-            explicit clear1(Real& zero_probability)
-              : zero_probability_{zero_probability}
-            { }
-
-            template <typename Iterator, typename StateInteger>
-            void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const) const
+            template <typename Iterator, typename StateInteger, typename Real>
+            void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const, Real& partial_zero_probability) const
             {
               *(one_first + index) = Complex{0};
 
               using std::norm;
-              zero_probability_ += norm(*(zero_first + index));
+              partial_zero_probability += norm(*(zero_first + index));
             }
-          }; // struct clear1<Complex, Real>
-
-          template <typename Complex, typename Real>
-          inline ::ket::mpi::gate::page::clear_detail::clear1<Complex, Real>
-          make_clear1(Real& zero_probability)
-          { return ::ket::mpi::gate::page::clear_detail::clear1<Complex, Real>{zero_probability}; }
+          }; // struct clear1<Complex>
 
           template <typename Real>
           struct clear2
@@ -98,22 +88,23 @@ namespace ket
           ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> > const permutated_qubit)
         {
           using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
-          auto zero_probability = real_type{0};
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            [&zero_probability](auto const zero_first, auto const one_first, StateInteger const index, int const)
-            {
-              *(one_first + index) = Complex{0};
-
-              using std::norm;
-              zero_probability += norm(*(zero_first + index));
-            });
+          auto const zero_probability
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, real_type{0}, std::plus<real_type>{},
+                [](auto const zero_first, auto const one_first, StateInteger const index, int const, real_type& partial_zero_probability)
+                {
+                  *(one_first + index) = Complex{0};
+
+                  using std::norm;
+                  partial_zero_probability += norm(*(zero_first + index));
+                });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            ::ket::mpi::gate::page::clear_detail::make_clear1<Complex>(zero_probability));
+          auto const zero_probability
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, real_type{0}, std::plus<real_type>{},
+                ::ket::mpi::gate::page::clear_detail::clear1<Complex>{});
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
 
           using std::pow;
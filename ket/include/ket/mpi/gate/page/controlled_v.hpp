@@ -4,6 +4,9 @@
 # include <boost/config.hpp>
 
 # include <cassert>
+# include <iterator>
+
+# include <boost/range/value_type.hpp>
 
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
@@ -47,7 +50,7 @@ namespace ket
             {
               auto const iter_10 = first_10 + index;
               auto const iter_11 = first_11 + index;
-              auto const value_10 = *iter_10;
+              typename std::iterator_traits<Iterator>::value_type const value_10 = *iter_10;
 
               using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
               using boost::math::constants::half;
@@ -94,7 +97,7 @@ namespace ket
             {
               auto const iter_10 = first_10 + index;
               auto const iter_11 = first_11 + index;
-              auto const value_10 = *iter_10;
+              typename boost::range_value<RandomAccessRange>::type const value_10 = *iter_10;
 
               using boost::math::constants::half;
               *iter_10
@@ -152,7 +155,7 @@ namespace ket
 
               auto const control_on_iter = zero_first + one_index;
               auto const target_control_on_iter = one_first + one_index;
-              auto const control_on_value = *control_on_iter;
+              typename std::iterator_traits<Iterator>::value_type const control_on_value = *control_on_iter;
 
               using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
               using boost::math::constants::half;
@@ -218,7 +221,7 @@ namespace ket
 
               auto const control_on_iter = zero_first + one_index;
               auto const target_control_on_iter = one_first + one_index;
-              auto const control_on_value = *control_on_iter;
+              typename boost::range_value<RandomAccessRange>::type const control_on_value = *control_on_iter;
 
               using boost::math::constants::half;
               *control_on_iter
@@ -277,7 +280,7 @@ namespace ket
 
               auto const control_on_iter = one_first + zero_index;
               auto const target_control_on_iter = one_first + one_index;
-              auto const control_on_value = *control_on_iter;
+              typename std::iterator_traits<Iterator>::value_type const control_on_value = *control_on_iter;
 
               using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
               using boost::math::constants::half;
@@ -343,7 +346,7 @@ namespace ket
 
               auto const control_on_iter = one_first + zero_index;
               auto const target_control_on_iter = one_first + one_index;
-              auto const control_on_value = *control_on_iter;
+              typename boost::range_value<RandomAccessRange>::type const control_on_value = *control_on_iter;
 
               using boost::math::constants::half;
               *control_on_iter
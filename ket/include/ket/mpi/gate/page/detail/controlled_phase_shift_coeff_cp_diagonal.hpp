@@ -5,9 +5,11 @@
 
 # include <cassert>
 # include <iterator>
+# include <vector>
 # include <utility>
 
 # include <boost/range/size.hpp>
+# include <boost/range/iterator.hpp>
 
 # include <ket/qubit.hpp>
 # include <ket/control.hpp>
@@ -152,6 +154,14 @@ namespace ket
                 = StateInteger{1u}
                   << (permutated_target_qubit - least_permutated_unit_qubit);
 
+              // The pages are collected first, and then (page, index) is flattened into one index of one parallel loop,
+              // so that the paged state pays one fork/join per gate
+              using page_iterator
+                = typename boost::range_iterator<typename ::ket::mpi::state<Complex, true, Allocator>::page_range_type const>::type;
+              auto one_page_firsts = std::vector<page_iterator>{};
+              auto const num_nonpage_local_qubits
+                = static_cast<BitInteger>(local_state.num_local_qubits() - local_state.num_page_qubits());
+
               auto const num_data_blocks = static_cast<StateInteger>(local_state.num_data_blocks());
               auto const rank_in_unit = ::ket::mpi::utility::policy::rank_in_unit(mpi_policy, rank);
               for (auto data_block_index = StateInteger{0u}; data_block_index < num_data_blocks; ++data_block_index)
@@ -161,8 +171,6 @@ namespace ket
                 if ((unit_qubit_value bitand permutated_target_qubit_mask) == StateInteger{0u})
                   continue;
 
-                auto const num_nonpage_local_qubits
-                  = static_cast<BitInteger>(local_state.num_local_qubits() - local_state.num_page_qubits());
                 auto const permutated_control_qubit_mask
                   = ::ket::utility::integer_exp2<StateInteger>(
                       permutated_control_qubit - static_cast<BitInteger>(num_nonpage_local_qubits));
@@ -179,18 +187,24 @@ namespace ket
                   // x1x
                   auto const one_page_index = zero_page_index bitor permutated_control_qubit_mask;
 
-                  auto const one_page_range = local_state.page_range(std::make_pair(data_block_index, one_page_index));
-                  auto const one_first = std::begin(one_page_range);
+                  auto const one_data_block_page_indices = std::make_pair(data_block_index, one_page_index);
+                  if (local_state.is_zero_page(one_data_block_page_indices))
+                    continue;
 
-                  using ::ket::utility::loop_n;
-                  loop_n(
-                    parallel_policy,
-                    boost::size(one_page_range),
-                    [one_first, phase_coefficient](StateInteger const index, int const)
-                    { *(one_first + index) *= phase_coefficient; });
+                  one_page_firsts.push_back(std::begin(local_state.page_range(one_data_block_page_indices)));
                 }
               }
 
+              auto const nonpage_index_mask
+                = ::ket::utility::integer_exp2<StateInteger>(num_nonpage_local_qubits) - StateInteger{1u};
+              using ::ket::utility::loop_n;
+              loop_n(
+                parallel_policy,
+                static_cast<StateInteger>(one_page_firsts.size()) << num_nonpage_local_qubits,
+                [&one_page_firsts, num_nonpage_local_qubits, nonpage_index_mask, phase_coefficient](
+                  StateInteger const index, int const)
+                { *(one_page_firsts[index >> num_nonpage_local_qubits] + (index bitand nonpage_index_mask)) *= phase_coefficient; });
+
               return local_state;
             }
 
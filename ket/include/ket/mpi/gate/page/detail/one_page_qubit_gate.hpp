@@ -4,8 +4,11 @@
 # include <cstddef>
 # include <cassert>
 # include <iterator>
+# include <vector>
+# include <utility>
 
 # include <boost/range/size.hpp>
+# include <boost/range/iterator.hpp>
 
 # include <ket/meta/bit_integer_of.hpp>
 # include <ket/meta/state_integer_of.hpp>
@@ -27,6 +30,63 @@ namespace ket
       {
         namespace detail
         {
+          // one_page_qubit_page_firsts: the first iterators of the page pairs (x0x, x1x) except pairs of zero pages,
+          //   which are processed by one parallel loop over all the pairs, so that the paged state pays one fork/join per
+          //   gate as the nonpaged one does
+          template <typename Complex, typename Allocator, typename Qubit>
+          inline std::vector<
+            std::pair<
+              typename boost::range_iterator<typename ::ket::mpi::state<Complex, true, Allocator>::page_range_type const>::type,
+              typename boost::range_iterator<typename ::ket::mpi::state<Complex, true, Allocator>::page_range_type const>::type> >
+          one_page_qubit_page_firsts(
+            ::ket::mpi::state<Complex, true, Allocator>& local_state,
+            ::ket::mpi::permutated<Qubit> const permutated_qubit)
+          {
+            using bit_integer_type = typename ::ket::meta::bit_integer_of<Qubit>::type;
+            using state_integer_type = typename ::ket::meta::state_integer_of<Qubit>::type;
+            auto const num_nonpage_local_qubits
+              = static_cast<bit_integer_type>(local_state.num_local_qubits() - local_state.num_page_qubits());
+            auto const permutated_qubit_mask
+              = ::ket::utility::integer_exp2<state_integer_type>(permutated_qubit - num_nonpage_local_qubits);
+            auto const lower_bits_mask = permutated_qubit_mask - state_integer_type{1u};
+            auto const upper_bits_mask = compl lower_bits_mask;
+
+            using page_iterator
+              = typename boost::range_iterator<typename ::ket::mpi::state<Complex, true, Allocator>::page_range_type const>::type;
+            auto result = std::vector<std::pair<page_iterator, page_iterator>>{};
+            auto const num_pages = local_state.num_pages();
+            auto const num_data_blocks = local_state.num_data_blocks();
+            result.reserve(num_data_blocks * (num_pages / 2u));
+            for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
+              for (auto page_index_wo_qubit = std::size_t{0u}; page_index_wo_qubit < num_pages / 2u; ++page_index_wo_qubit)
+              {
+                // x0x
+                auto const zero_page_index
+                  = ((page_index_wo_qubit bitand upper_bits_mask) << 1u)
+                    bitor (page_index_wo_qubit bitand lower_bits_mask);
+                // x1x
+                auto const one_page_index = zero_page_index bitor permutated_qubit_mask;
+
+                auto const zero_data_block_page_indices = std::make_pair(data_block_index, zero_page_index);
+                auto const one_data_block_page_indices = std::make_pair(data_block_index, one_page_index);
+                // function maps zeros to zeros
+                if (local_state.is_zero_page(zero_data_block_page_indices)
+                    and local_state.is_zero_page(one_data_block_page_indices))
+                  continue;
+                local_state.unmark_zero_page(zero_data_block_page_indices);
+                local_state.unmark_zero_page(one_data_block_page_indices);
+
+                auto const zero_page_range = local_state.page_range(zero_data_block_page_indices);
+                auto const one_page_range = local_state.page_range(one_data_block_page_indices);
+                assert(boost::size(zero_page_range) == boost::size(one_page_range));
+                assert(::ket::utility::integer_exp2<std::size_t>(num_nonpage_local_qubits) == boost::size(zero_page_range));
+
+                result.emplace_back(std::begin(zero_page_range), std::begin(one_page_range));
+              }
+
+            return result;
+          }
+
           template <
             std::size_t num_operated_nonpage_qubits,
             typename ParallelPolicy,
@@ -59,42 +119,86 @@ namespace ket
 
             using bit_integer_type = typename ::ket::meta::bit_integer_of<Qubit>::type;
             using state_integer_type = typename ::ket::meta::state_integer_of<Qubit>::type;
-            auto const num_nonpage_local_qubits
-              = static_cast<bit_integer_type>(local_state.num_local_qubits() - local_state.num_page_qubits());
-            auto const permutated_qubit_mask
-              = ::ket::utility::integer_exp2<state_integer_type>(permutated_qubit - num_nonpage_local_qubits);
-            auto const lower_bits_mask = permutated_qubit_mask - state_integer_type{1u};
-            auto const upper_bits_mask = compl lower_bits_mask;
+            auto const page_firsts = ::ket::mpi::gate::page::detail::one_page_qubit_page_firsts(local_state, permutated_qubit);
 
-            auto const num_pages = local_state.num_pages();
-            auto const num_data_blocks = local_state.num_data_blocks();
-            for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
-              for (auto page_index_wo_qubit = std::size_t{0u}; page_index_wo_qubit < num_pages / 2u; ++page_index_wo_qubit)
+            // (page pair, index_wo_nonpage_qubits) is flattened into one index
+            auto const num_index_bits
+              = static_cast<bit_integer_type>(
+                  local_state.num_local_qubits() - local_state.num_page_qubits() - num_operated_nonpage_qubits);
+            auto const index_mask = ::ket::utility::integer_exp2<state_integer_type>(num_index_bits) - state_integer_type{1u};
+
+            using ::ket::utility::loop_n;
+            loop_n(
+              parallel_policy,
+              static_cast<state_integer_type>(page_firsts.size()) << num_index_bits,
+              [&page_firsts, num_index_bits, index_mask, &function](state_integer_type const index, int const thread_index)
               {
-                // x0x
-                auto const zero_page_index
-                  = ((page_index_wo_qubit bitand upper_bits_mask) << 1u)
-                    bitor (page_index_wo_qubit bitand lower_bits_mask);
-                // x1x
-                auto const one_page_index = zero_page_index bitor permutated_qubit_mask;
+                auto const& firsts = page_firsts[index >> num_index_bits];
+                function(firsts.first, firsts.second, index bitand index_mask, thread_index);
+              });
 
-                auto const zero_page_range = local_state.page_range(std::make_pair(data_block_index, zero_page_index));
-                auto const one_page_range = local_state.page_range(std::make_pair(data_block_index, one_page_index));
-                assert(boost::size(zero_page_range) == boost::size(one_page_range));
-                assert(::ket::utility::integer_exp2<std::size_t>(::ket::utility::integer_log2<std::size_t>(boost::size(zero_page_range))) == boost::size(zero_page_range));
+            return local_state;
+          }
 
-                auto const zero_first = std::begin(zero_page_range);
-                auto const one_first = std::begin(one_page_range);
+          // reduction version of one_page_qubit_gate: function(zero_first, one_first, index, thread_index, accumulator)
+          template <
+            std::size_t num_operated_nonpage_qubits,
+            typename ParallelPolicy,
+            typename RandomAccessRange, typename Qubit,
+            typename Value, typename BinaryOperation, typename Function>
+          [[noreturn]] inline Value one_page_qubit_reduce(
+            ParallelPolicy const,
+            RandomAccessRange&, ::ket::mpi::permutated<Qubit> const,
+            Value const, BinaryOperation, Function&&)
+          { throw ::ket::mpi::gate::page::unsupported_page_gate_operation{"one_page_qubit_reduce"}; }
 
-                using ::ket::utility::loop_n;
-                loop_n(
+          template <
+            std::size_t num_operated_nonpage_qubits,
+            typename ParallelPolicy,
+            typename Complex, typename Allocator, typename Qubit,
+            typename Value, typename BinaryOperation, typename Function>
+          [[noreturn]] inline Value one_page_qubit_reduce(
+            ParallelPolicy const,
+            ::ket::mpi::state<Complex, false, Allocator>&, ::ket::mpi::permutated<Qubit> const,
+            Value const, BinaryOperation, Function&&)
+          { throw ::ket::mpi::gate::page::unsupported_page_gate_operation{"one_page_qubit_reduce"}; }
+
+          template <
+            std::size_t num_operated_nonpage_qubits,
+            typename ParallelPolicy,
+            typename Complex, typename Allocator, typename Qubit,
+            typename Value, typename BinaryOperation, typename Function>
+          inline Value one_page_qubit_reduce(
+            ParallelPolicy const parallel_policy,
+            ::ket::mpi::state<Complex, true, Allocator>& local_state,
+            ::ket::mpi::permutated<Qubit> const permutated_qubit,
+            Value const identity, BinaryOperation binary_operation, Function&& function)
+          {
+            assert(::ket::mpi::page::is_on_page(permutated_qubit, local_state));
+
+            using bit_integer_type = typename ::ket::meta::bit_integer_of<Qubit>::type;
+            using state_integer_type = typename ::ket::meta::state_integer_of<Qubit>::type;
+            auto const page_firsts = ::ket::mpi::gate::page::detail::one_page_qubit_page_firsts(local_state, permutated_qubit);
+
+            // (page pair, index_wo_nonpage_qubits) is flattened into one index. Partial results are combined in the
+            // order of thread indices, so the result is reproducible for the same number of threads
+            auto const num_index_bits
+              = static_cast<bit_integer_type>(
+                  local_state.num_local_qubits() - local_state.num_page_qubits() - num_operated_nonpage_qubits);
+            auto const index_mask = ::ket::utility::integer_exp2<state_integer_type>(num_index_bits) - state_integer_type{1u};
+
+            auto const result
+              = ::ket::utility::loop_n_reduce(
                   parallel_policy,
-                  boost::size(zero_page_range) >> num_operated_nonpage_qubits,
-                  [zero_first, one_first, &function](state_integer_type const index_wo_nonpage_qubits, int const thread_index)
-                  { function(zero_first, one_first, index_wo_nonpage_qubits, thread_index); });
-              }
+                  static_cast<state_integer_type>(page_firsts.size()) << num_index_bits, identity, binary_operation,
+                  [&page_firsts, num_index_bits, index_mask, &function](
+                    state_integer_type const index, int const thread_index, Value& accumulator)
+                  {
+                    auto const& firsts = page_firsts[index >> num_index_bits];
+                    function(firsts.first, firsts.second, index bitand index_mask, thread_index, accumulator);
+                  });
 
-            return local_state;
+            return result;
           }
         } // namespace detail
       } // namespace page
@@ -3,10 +3,14 @@
 
 # include <cstddef>
 # include <cassert>
+# include <array>
+# include <vector>
 # include <algorithm>
 # include <iterator>
+# include <utility>
 
 # include <boost/range/size.hpp>
+# include <boost/range/iterator.hpp>
 
 # include <ket/meta/bit_integer_of.hpp>
 # include <ket/meta/state_integer_of.hpp>
@@ -98,8 +102,14 @@ namespace ket
                 xor lower_bits_mask;
             auto const upper_bits_mask = compl (lower_bits_mask bitor middle_bits_mask);
 
+            // The page quadruples are collected first, and then (page quadruple, index_wo_nonpage_qubits) is flattened
+            // into one index of one parallel loop, so that the paged state pays one fork/join per gate
+            using page_iterator
+              = typename boost::range_iterator<typename ::ket::mpi::state<Complex, true, Allocator>::page_range_type const>::type;
+            auto page_firsts = std::vector<std::array<page_iterator, 4u>>{};
             auto const num_pages = local_state.num_pages();
             auto const num_data_blocks = local_state.num_data_blocks();
+            page_firsts.reserve(num_data_blocks * (num_pages / 4u));
             for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
               for (auto page_index_wo_qubits = std::size_t{0u};
                    page_index_wo_qubits < num_pages / 4u; ++page_index_wo_qubits)
@@ -116,23 +126,43 @@ namespace ket
                 // x1_2x1_1x
                 auto const page_index_11 = page_index_10 bitor permutated_qubit1_mask;
 
-                auto const page_range_00 = local_state.page_range(std::make_pair(data_block_index, page_index_00));
-                auto const first_00 = std::begin(page_range_00);
-                auto const page_range_01 = local_state.page_range(std::make_pair(data_block_index, page_index_01));
-                auto const first_01 = std::begin(page_range_01);
-                auto const page_range_10 = local_state.page_range(std::make_pair(data_block_index, page_index_10));
-                auto const first_10 = std::begin(page_range_10);
-                auto const page_range_11 = local_state.page_range(std::make_pair(data_block_index, page_index_11));
-                auto const first_11 = std::begin(page_range_11);
-
-                using ::ket::utility::loop_n;
-                loop_n(
-                  parallel_policy,
-                  boost::size(page_range_11) >> num_operated_nonpage_qubits,
-                  [first_00, first_01, first_10, first_11, &function](state_integer_type const index_wo_nonpage_qubits, int const thread_index)
-                  { function(first_00, first_01, first_10, first_11, index_wo_nonpage_qubits, thread_index); });
+                auto const data_block_page_indices_00 = std::make_pair(data_block_index, page_index_00);
+                auto const data_block_page_indices_01 = std::make_pair(data_block_index, page_index_01);
+                auto const data_block_page_indices_10 = std::make_pair(data_block_index, page_index_10);
+                auto const data_block_page_indices_11 = std::make_pair(data_block_index, page_index_11);
+                // function maps zeros to zeros
+                if (local_state.is_zero_page(data_block_page_indices_00)
+                    and local_state.is_zero_page(data_block_page_indices_01)
+                    and local_state.is_zero_page(data_block_page_indices_10)
+                    and local_state.is_zero_page(data_block_page_indices_11))
+                  continue;
+                local_state.unmark_zero_page(data_block_page_indices_00);
+                local_state.unmark_zero_page(data_block_page_indices_01);
+                local_state.unmark_zero_page(data_block_page_indices_10);
+                local_state.unmark_zero_page(data_block_page_indices_11);
+
+                page_firsts.push_back(
+                  std::array<page_iterator, 4u>{
+                    std::begin(local_state.page_range(data_block_page_indices_00)),
+                    std::begin(local_state.page_range(data_block_page_indices_01)),
+                    std::begin(local_state.page_range(data_block_page_indices_10)),
+                    std::begin(local_state.page_range(data_block_page_indices_11))});
               }
 
+            auto const num_index_bits
+              = static_cast<bit_integer_type>(num_nonpage_local_qubits - num_operated_nonpage_qubits);
+            auto const index_mask = ::ket::utility::integer_exp2<state_integer_type>(num_index_bits) - state_integer_type{1u};
+
+            using ::ket::utility::loop_n;
+            loop_n(
+              parallel_policy,
+              static_cast<state_integer_type>(page_firsts.size()) << num_index_bits,
+              [&page_firsts, num_index_bits, index_mask, &function](state_integer_type const index, int const thread_index)
+              {
+                auto const& firsts = page_firsts[index >> num_index_bits];
+                function(firsts[0u], firsts[1u], firsts[2u], firsts[3u], index bitand index_mask, thread_index);
+              });
+
             return local_state;
           }
         } // namespace detail
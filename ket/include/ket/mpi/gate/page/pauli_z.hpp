@@ -43,12 +43,12 @@ namespace ket
           using real_type = typename ::ket::utility::meta::real_of<typename boost::range_value<RandomAccessRange>::type>::type;
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::gate::page::detail::one_page_qubit_gate<1u>(
+          return ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
             parallel_policy, local_state, permutated_qubit,
             [](auto const, auto const one_first, StateInteger const index, int const)
             { *(one_first + index) *= real_type{-1}; });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::gate::page::detail::one_page_qubit_gate<1u>(
+          return ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
             parallel_policy, local_state, permutated_qubit,
             ::ket::mpi::gate::page::pauli_z_detail::pauli_z<real_type>{});
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
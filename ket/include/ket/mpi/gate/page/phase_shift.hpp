@@ -4,8 +4,10 @@
 # include <boost/config.hpp>
 
 # include <cmath>
+# include <iterator>
 
 # include <boost/math/constants/constants.hpp>
+# include <boost/range/value_type.hpp>
 
 # include <ket/qubit.hpp>
 # include <ket/utility/exp_i.hpp>
@@ -91,7 +93,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
               using boost::math::constants::one_div_root_two;
@@ -134,7 +136,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               *zero_iter -= phase_coefficient2 * *one_iter;
               *zero_iter *= one_div_root_two<Real>();
@@ -170,7 +172,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
               using boost::math::constants::one_div_root_two;
@@ -213,7 +215,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               *zero_iter += phase_coefficient1 * *one_iter;
               *zero_iter *= one_div_root_two<Real>();
@@ -257,7 +259,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               *zero_iter *= cosine_;
               *zero_iter -= sine_phase_coefficient3_ * *one_iter;
@@ -313,7 +315,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               *zero_iter *= cosine;
               *zero_iter -= sine_phase_coefficient3 * *one_iter;
@@ -359,7 +361,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               *zero_iter *= cosine_;
               *zero_iter += sine_phase_coefficient2_ * *one_iter;
@@ -415,7 +417,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               *zero_iter *= cosine;
               *zero_iter += sine_phase_coefficient2 * *one_iter;
@@ -59,23 +59,23 @@ namespace ket
 # ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
           struct zero_one_probabilities
           {
-            long double& zero_probability_;
-            long double& one_probability_;
-
-            zero_one_probabilities(
-              long double& zero_probability, long double& one_probability)
-              : zero_probability_{zero_probability},
-                one_probability_{one_probability}
-            { }
-
             template <typename Iterator, typename StateInteger>
-            void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const) const
+            void operator()(
+              Iterator const zero_first, Iterator const one_first, StateInteger const index, int const,
+              std::pair<long double, long double>& partial_probabilities) const
             {
               using std::norm;
-              zero_probability_ += static_cast<long double>(norm(*(zero_first + index)));
-              one_probability_ += static_cast<long double>(norm(*(one_first + index)));
+              partial_probabilities.first += static_cast<long double>(norm(*(zero_first + index)));
+              partial_probabilities.second += static_cast<long double>(norm(*(one_first + index)));
             }
           }; // struct zero_one_probabilities
+
+          struct add_probabilities
+          {
+            std::pair<long double, long double> operator()(
+              std::pair<long double, long double> const& lhs, std::pair<long double, long double> const& rhs) const
+            { return std::make_pair(lhs.first + rhs.first, lhs.second + rhs.second); }
+          }; // struct add_probabilities
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
         } // namespace projective_measurement_detail
 
@@ -91,29 +91,31 @@ namespace ket
           ::ket::mpi::state<Complex, true, Allocator>& local_state,
           ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> > const permutated_qubit)
         {
-          auto zero_probability = 0.0l;
-          auto one_probability = 0.0l;
-
+          using probabilities_type = std::pair<long double, long double>;
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            [&zero_probability, &one_probability](
-              auto const zero_first, auto const one_first, StateInteger const index, int const)
-            {
-              using std::norm;
-              zero_probability += static_cast<long double>(norm(*(zero_first + index)));
-              one_probability += static_cast<long double>(norm(*(one_first + index)));
-            });
+          auto const probabilities
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, probabilities_type{0.0l, 0.0l},
+                [](probabilities_type const& lhs, probabilities_type const& rhs)
+                { return probabilities_type{lhs.first + rhs.first, lhs.second + rhs.second}; },
+                [](auto const zero_first, auto const one_first, StateInteger const index, int const,
+                   probabilities_type& partial_probabilities)
+                {
+                  using std::norm;
+                  partial_probabilities.first += static_cast<long double>(norm(*(zero_first + index)));
+                  partial_probabilities.second += static_cast<long double>(norm(*(one_first + index)));
+                });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            ::ket::mpi::gate::page::projective_measurement_detail::zero_one_probabilities{
-              zero_probability, one_probability});
+          auto const probabilities
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, probabilities_type{0.0l, 0.0l},
+                ::ket::mpi::gate::page::projective_measurement_detail::add_probabilities{},
+                ::ket::mpi::gate::page::projective_measurement_detail::zero_one_probabilities{});
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
 
           using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
           return std::make_pair(
-            static_cast<real_type>(zero_probability), static_cast<real_type>(one_probability));
+            static_cast<real_type>(probabilities.first), static_cast<real_type>(probabilities.second));
         }
 
         // change_state_after_measuring_zero
@@ -4,6 +4,7 @@
 # include <boost/config.hpp>
 
 # include <cassert>
+# include <functional>
 
 # include <boost/math/constants/constants.hpp>
 
@@ -44,29 +45,18 @@ namespace ket
         namespace set_detail
         {
 # ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          template <typename Complex, typename Real>
+          template <typename Complex>
           struct set1
           {
-            Real& one_probability_;
-
-            explicit set1(Real& one_probability)
-              : one_probability_{one_probability}
-            { }
-
-            template <typename Iterator, typename StateInteger>
-            void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const) const
+            template <typename Iterator, typename StateInteger, typename Real>
+            void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const, Real& partial_one_probability) const
             {
               *(zero_first + index) = Complex{0};
 
               using std::norm;
-              one_probability_ += norm(*(one_first + index));
+              partial_one_probability += norm(*(one_first + index));
             }
-          }; // struct set1<Complex, Real>
-
-          template <typename Complex, typename Real>
-          inline ::ket::mpi::gate::page::set_detail::set1<Complex, Real>
-          make_set1(Real& one_probability)
-          { return ::ket::mpi::gate::page::set_detail::set1<Complex, Real>{one_probability}; }
+          }; // struct set1<Complex>
 
           template <typename Real>
           struct set2
@@ -98,22 +88,23 @@ namespace ket
           ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> > const permutated_qubit)
         {
           using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
-          auto one_probability = real_type{0};
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            [&one_probability](auto const zero_first, auto const one_first, StateInteger const index, int const)
-            {
-              *(zero_first + index) = Complex{0};
-
-              using std::norm;
-              one_probability += norm(*(one_first + index));
-            });
+          auto const one_probability
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, real_type{0}, std::plus<real_type>{},
+                [](auto const zero_first, auto const one_first, StateInteger const index, int const, real_type& partial_one_probability)
+                {
+                  *(zero_first + index) = Complex{0};
+
+                  using std::norm;
+                  partial_one_probability += norm(*(one_first + index));
+                });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-            parallel_policy, local_state, permutated_qubit,
-            ::ket::mpi::gate::page::set_detail::make_set1<Complex>(one_probability));
+          auto const one_probability
+            = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+                parallel_policy, local_state, permutated_qubit, real_type{0}, std::plus<real_type>{},
+                ::ket::mpi::gate::page::set_detail::set1<Complex>{});
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
 
           using std::pow;
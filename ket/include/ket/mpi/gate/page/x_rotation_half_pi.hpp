@@ -3,6 +3,8 @@
 
 # include <boost/config.hpp>
 
+# include <iterator>
+
 # include <boost/math/constants/constants.hpp>
 # include <boost/range/value_type.hpp>
 
@@ -32,7 +34,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter += ::ket::utility::imaginary_unit<Complex>() * *one_iter;
@@ -62,7 +64,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter += ::ket::utility::imaginary_unit<complex_type>() * *one_iter;
@@ -88,7 +90,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter -= ::ket::utility::imaginary_unit<Complex>() * *one_iter;
@@ -118,7 +120,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter -= ::ket::utility::imaginary_unit<complex_type>() * *one_iter;
@@ -3,6 +3,8 @@
 
 # include <boost/config.hpp>
 
+# include <iterator>
+
 # include <boost/math/constants/constants.hpp>
 # include <boost/range/value_type.hpp>
 
@@ -31,7 +33,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter += *one_iter;
@@ -60,7 +62,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter += *one_iter;
@@ -86,7 +88,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename std::iterator_traits<Iterator>::value_type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter -= *one_iter;
@@ -115,7 +117,7 @@ namespace ket
             {
               auto const zero_iter = zero_first + index;
               auto const one_iter = one_first + index;
-              auto const zero_iter_value = *zero_iter;
+              typename boost::range_value<RandomAccessRange>::type const zero_iter_value = *zero_iter;
 
               using boost::math::constants::one_div_root_two;
               *zero_iter -= *one_iter;
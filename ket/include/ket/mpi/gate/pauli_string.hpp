@@ -0,0 +1,400 @@
+#ifndef KET_MPI_GATE_PAULI_STRING_HPP
+# define KET_MPI_GATE_PAULI_STRING_HPP
+
+# include <cstddef>
+# include <array>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+# include <type_traits>
+
+# include <boost/range/size.hpp>
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/datatype_base.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/rank.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/gate/pauli_string.hpp>
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/parity.hpp>
+# include <ket/mpi/permutated.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/for_each_swapped_chunk.hpp>
+# include <ket/mpi/utility/remap_qubits.hpp>
+# include <ket/mpi/utility/logger.hpp>
+# include <ket/mpi/page/unmark_zero_pages.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace gate
+    {
+      // pauli_string: applies X^x_mask Z^z_mask up to a global phase, where the masks are of *unpermutated* qubits.
+      //   The signs are computed from the permutated qubit values, so only the bits of x_mask need communication
+      namespace pauli_string_detail
+      {
+        // the values of i and i ^ permutated_x_mask are on this process. If permutated_x_mask has bits of qubits
+        // between local ranges, e.g. page qubits, the pairs of ranges are found by the second sweep of the ranges
+        template <typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename StateInteger>
+        inline void local_pauli_string(
+          MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+          LocalState& local_state, StateInteger const permutated_x_mask, StateInteger const permutated_z_mask,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          auto const present_rank = communicator.rank(environment);
+          auto range_first_index = StateInteger{0u};
+          auto has_swapped_ranges = false;
+          ::ket::mpi::utility::for_each_local_range(
+            mpi_policy, local_state, communicator, environment,
+            [&mpi_policy, parallel_policy, &local_state, permutated_x_mask, permutated_z_mask,
+             &communicator, &environment, present_rank, &range_first_index, &has_swapped_ranges](
+              auto const first, auto const last)
+            {
+              auto const range_size = static_cast<StateInteger>(last - first);
+              auto const in_range_x_mask = permutated_x_mask bitand (range_size - StateInteger{1u});
+              auto const partner_range_first_index = range_first_index xor (permutated_x_mask xor in_range_x_mask);
+              using ::ket::mpi::utility::rank_index_to_qubit_value;
+              auto const first_value = rank_index_to_qubit_value(mpi_policy, local_state, present_rank, range_first_index);
+
+              if (partner_range_first_index == range_first_index)
+                ::ket::gate::pauli_string_detail::pauli_string_within(
+                  parallel_policy, first, range_size, first_value, in_range_x_mask, permutated_z_mask);
+              // both of the ranges are replaced when the lower one is visited
+              else if (partner_range_first_index > range_first_index)
+              {
+                auto const partner_first_value
+                  = rank_index_to_qubit_value(mpi_policy, local_state, present_rank, partner_range_first_index);
+                has_swapped_ranges = true;
+                auto other_range_first_index = StateInteger{0u};
+                ::ket::mpi::utility::for_each_local_range(
+                  mpi_policy, local_state, communicator, environment,
+                  [parallel_policy, first, range_size, first_value, partner_first_value,
+                   in_range_x_mask, permutated_z_mask, partner_range_first_index, &other_range_first_index](
+                    auto const partner_first, auto const partner_last)
+                  {
+                    if (other_range_first_index == partner_range_first_index)
+                      ::ket::gate::pauli_string_detail::swap_with_signs(
+                        parallel_policy, first, partner_first, range_size,
+                        [](StateInteger const index) { return index; },
+                        in_range_x_mask, first_value, partner_first_value, permutated_z_mask);
+                    other_range_first_index += static_cast<StateInteger>(partner_last - partner_first);
+                  });
+              }
+
+              range_first_index += range_size;
+            });
+
+          // a range of zeros may have got values of another range
+          if (has_swapped_ranges)
+            ::ket::mpi::page::unmark_zero_pages(local_state);
+        }
+
+        // Without unit qubits, the values of i ^ permutated_x_mask for the local indices i are on the partner process
+        // whose rank differs in the global bits of permutated_x_mask. All the values are exchanged by
+        // for_each_swapped_chunk(sent_first_index, num_values, min_chunk_size, target_rank, function) (see
+        // ::ket::mpi::utility::for_each_swapped_chunk) in chunks which are aligned to the highest local bit of
+        // permutated_x_mask
+        template <typename ParallelPolicy, typename LocalState, typename StateInteger, typename ForEachSwappedChunk>
+        inline void global_pauli_string(
+          ::ket::mpi::utility::policy::general_mpi const mpi_policy, ParallelPolicy const parallel_policy,
+          LocalState& local_state, StateInteger const permutated_x_mask, StateInteger const permutated_z_mask,
+          ForEachSwappedChunk&& for_each_swapped_chunk,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          auto const local_size = static_cast<StateInteger>(boost::size(local_state));
+          auto const num_local_qubits = ::ket::utility::integer_log2<StateInteger>(local_size);
+          auto const local_x_mask = permutated_x_mask bitand (local_size - StateInteger{1u});
+          auto const present_rank = communicator.rank(environment);
+          auto const partner_rank
+            = present_rank.mpi_rank() xor static_cast<int>(permutated_x_mask >> num_local_qubits);
+
+          auto const min_chunk_size
+            = local_x_mask == StateInteger{0u}
+              ? StateInteger{1u}
+              : ::ket::utility::integer_exp2<StateInteger>(
+                  ::ket::utility::integer_log2<StateInteger>(local_x_mask) + StateInteger{1u});
+
+          for_each_swapped_chunk(
+            std::size_t{0u}, static_cast<std::size_t>(local_size), static_cast<std::size_t>(min_chunk_size),
+            yampi::rank{partner_rank},
+            [mpi_policy, parallel_policy, &local_state, permutated_x_mask, local_x_mask, permutated_z_mask,
+             present_rank, &communicator, &environment](
+              std::size_t const chunk_first_index, std::size_t const chunk_last_index, auto const receive_buffer_first)
+            {
+              ::ket::mpi::utility::for_each_local_subrange(
+                mpi_policy, local_state, chunk_first_index, chunk_last_index, communicator, environment,
+                [mpi_policy, parallel_policy, &local_state, permutated_x_mask, local_x_mask, permutated_z_mask,
+                 present_rank, receive_buffer_first, chunk_first_index](
+                  auto const first, auto const last, std::size_t const offset)
+                {
+                  using ::ket::mpi::utility::rank_index_to_qubit_value;
+                  auto const first_value
+                    = rank_index_to_qubit_value(
+                        mpi_policy, local_state, present_rank,
+                        static_cast<StateInteger>(chunk_first_index + offset));
+                  using ::ket::utility::loop_n;
+                  loop_n(
+                    parallel_policy, static_cast<StateInteger>(last - first),
+                    [first, first_value, permutated_x_mask, local_x_mask, permutated_z_mask,
+                     receive_buffer_first, offset](StateInteger const index, int const)
+                    {
+                      auto const& partner_value
+                        = *(receive_buffer_first + ((static_cast<StateInteger>(offset) + index) xor local_x_mask));
+                      *(first + index)
+                        = ::ket::utility::parity(((first_value + index) xor permutated_x_mask) bitand permutated_z_mask)
+                          ? -partner_value : partner_value;
+                    });
+                });
+            });
+
+          ::ket::mpi::page::unmark_zero_pages(local_state);
+        }
+
+        // The X's on local qubits and all the Z's are applied first. Since the X's commute with each other, the rest
+        // are applied after at most num_local_qubits of their qubits are made local by
+        // interchange(nonlocal_qubit, evicted_qubit), which is repeated until no X's remain
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+          typename StateInteger, typename BitInteger, typename Allocator,
+          typename ForEachSwappedChunk, typename Interchange>
+        inline void pauli_string(
+          MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+          LocalState& local_state, StateInteger const x_mask, StateInteger const z_mask,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+          ForEachSwappedChunk&&, Interchange&& interchange,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          auto const num_local_qubits
+            = static_cast<BitInteger>(
+                ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+          auto const local_mask = ::ket::utility::integer_exp2<StateInteger>(num_local_qubits) - StateInteger{1u};
+
+          auto remaining_x_mask = x_mask;
+          auto remaining_z_mask = z_mask;
+          while (true)
+          {
+            auto const permutated_x_mask = ::ket::mpi::permutate_bits(permutation, remaining_x_mask);
+            auto const local_x_mask
+              = ::ket::mpi::inverse_permutate_bits(permutation, permutated_x_mask bitand local_mask);
+            ::ket::mpi::gate::pauli_string_detail::local_pauli_string(
+              mpi_policy, parallel_policy, local_state,
+              permutated_x_mask bitand local_mask, ::ket::mpi::permutate_bits(permutation, remaining_z_mask),
+              communicator, environment);
+
+            remaining_x_mask ^= local_x_mask;
+            remaining_z_mask = StateInteger{0u};
+            if (remaining_x_mask == StateInteger{0u})
+              return;
+
+            // the lowest num_local_qubits bits of remaining_x_mask, which are all nonlocal
+            auto next_x_mask = remaining_x_mask;
+            for (auto num_bits = BitInteger{0u}; num_bits < num_local_qubits; ++num_bits)
+              next_x_mask &= next_x_mask - StateInteger{1u};
+            next_x_mask = remaining_x_mask xor next_x_mask;
+
+            ::ket::mpi::utility::make_mask_qubits_local(
+              mpi_policy, local_state, next_x_mask, permutation, interchange, communicator, environment);
+          }
+        }
+
+        template <
+          typename ParallelPolicy, typename LocalState,
+          typename StateInteger, typename BitInteger, typename Allocator,
+          typename ForEachSwappedChunk, typename Interchange>
+        inline void pauli_string(
+          ::ket::mpi::utility::policy::general_mpi const mpi_policy, ParallelPolicy const parallel_policy,
+          LocalState& local_state, StateInteger const x_mask, StateInteger const z_mask,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+          ForEachSwappedChunk&& for_each_swapped_chunk, Interchange&&,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          auto const permutated_x_mask = ::ket::mpi::permutate_bits(permutation, x_mask);
+          auto const permutated_z_mask = ::ket::mpi::permutate_bits(permutation, z_mask);
+
+          if (permutated_x_mask < static_cast<StateInteger>(boost::size(local_state)))
+            ::ket::mpi::gate::pauli_string_detail::local_pauli_string(
+              mpi_policy, parallel_policy, local_state, permutated_x_mask, permutated_z_mask,
+              communicator, environment);
+          else
+            ::ket::mpi::gate::pauli_string_detail::global_pauli_string(
+              mpi_policy, parallel_policy, local_state, permutated_x_mask, permutated_z_mask,
+              std::forward<ForEachSwappedChunk>(for_each_swapped_chunk), communicator, environment);
+        }
+      } // namespace pauli_string_detail
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline typename std::enable_if<
+        ::ket::mpi::utility::policy::meta::is_mpi_policy<MpiPolicy>::value, RandomAccessRange&>::type
+      pauli_string(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{"Pauli string", environment};
+
+        ::ket::mpi::gate::pauli_string_detail::pauli_string(
+          mpi_policy, parallel_policy, local_state, x_mask, z_mask, permutation,
+          [&mpi_policy, &local_state, &buffer, &communicator, &environment](
+            std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+            yampi::rank const target_rank, auto&& function)
+          {
+            ::ket::mpi::utility::for_each_swapped_chunk(
+              mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, target_rank,
+              communicator, environment, std::forward<decltype(function)>(function));
+          },
+          [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &communicator, &environment](
+            ::ket::qubit<StateInteger, BitInteger> const nonlocal_qubit,
+            ::ket::qubit<StateInteger, BitInteger> const evicted_qubit)
+          {
+            ::ket::mpi::utility::remap_qubits(
+              mpi_policy, parallel_policy, local_state,
+              std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{nonlocal_qubit},
+              std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{evicted_qubit},
+              permutation, buffer, communicator, environment);
+          },
+          communicator, environment);
+
+        return local_state;
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline typename std::enable_if<
+        ::ket::mpi::utility::policy::meta::is_mpi_policy<MpiPolicy>::value, RandomAccessRange&>::type
+      pauli_string(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{"Pauli string", environment};
+
+        ::ket::mpi::gate::pauli_string_detail::pauli_string(
+          mpi_policy, parallel_policy, local_state, x_mask, z_mask, permutation,
+          [&mpi_policy, &local_state, &buffer, &datatype, &communicator, &environment](
+            std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+            yampi::rank const target_rank, auto&& function)
+          {
+            ::ket::mpi::utility::for_each_swapped_chunk(
+              mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, datatype,
+              target_rank, communicator, environment, std::forward<decltype(function)>(function));
+          },
+          [&mpi_policy, parallel_policy, &local_state, &permutation, &buffer, &datatype,
+           &communicator, &environment](
+            ::ket::qubit<StateInteger, BitInteger> const nonlocal_qubit,
+            ::ket::qubit<StateInteger, BitInteger> const evicted_qubit)
+          {
+            ::ket::mpi::utility::remap_qubits(
+              mpi_policy, parallel_policy, local_state,
+              std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{nonlocal_qubit},
+              std::array< ::ket::qubit<StateInteger, BitInteger>, 1u >{evicted_qubit},
+              permutation, buffer, datatype, communicator, environment);
+          },
+          communicator, environment);
+
+        return local_state;
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline typename std::enable_if<
+        ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange&>::type
+      pauli_string(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::pauli_string(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, x_mask, z_mask, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline typename std::enable_if<
+        ::ket::utility::policy::meta::is_loop_n_policy<ParallelPolicy>::value, RandomAccessRange&>::type
+      pauli_string(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::pauli_string(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, x_mask, z_mask, permutation, buffer, datatype, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline typename std::enable_if<
+        (not ::ket::mpi::utility::policy::meta::is_mpi_policy<RandomAccessRange>::value)
+          and (not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value),
+        RandomAccessRange&>::type
+      pauli_string(
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::pauli_string(
+          ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
+          local_state, x_mask, z_mask, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline typename std::enable_if<
+        (not ::ket::mpi::utility::policy::meta::is_mpi_policy<RandomAccessRange>::value)
+          and (not ::ket::utility::policy::meta::is_loop_n_policy<RandomAccessRange>::value),
+        RandomAccessRange&>::type
+      pauli_string(
+        RandomAccessRange& local_state, StateInteger const x_mask, StateInteger const z_mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::pauli_string(
+          ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
+          local_state, x_mask, z_mask, permutation, buffer, datatype, communicator, environment);
+      }
+    } // namespace gate
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_GATE_PAULI_STRING_HPP
@@ -126,7 +126,7 @@ namespace ket
               parallel_policy, local_state, permutated_target_qubit, permutated_control_qubit2, permutated_control_qubit1);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, permutated_target_qubit, permutated_control_qubit1, permutated_control_qubit2](
               auto const first, auto const last)
@@ -137,7 +137,7 @@ namespace ket
                 permutated_control_qubit1.qubit(), permutated_control_qubit2.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::toffoli_detail::make_call_toffoli(
               parallel_policy,
@@ -380,7 +380,7 @@ namespace ket
               parallel_policy, local_state, permutated_target_qubit, permutated_control_qubit2, permutated_control_qubit1);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             [parallel_policy, permutated_target_qubit,
              permutated_control_qubit1, permutated_control_qubit2](
@@ -392,7 +392,7 @@ namespace ket
                 permutated_control_qubit1.qubit(), permutated_control_qubit2.qubit());
             });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-          return ::ket::mpi::utility::for_each_local_range(
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
             mpi_policy, local_state, communicator, environment,
             ::ket::mpi::gate::toffoli_detail::make_call_adj_toffoli(
               parallel_policy,
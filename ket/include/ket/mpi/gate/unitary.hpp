@@ -0,0 +1,385 @@
+#ifndef KET_MPI_GATE_UNITARY_HPP
+# define KET_MPI_GATE_UNITARY_HPP
+
+# include <boost/config.hpp>
+
+# include <cstddef>
+# include <vector>
+# include <array>
+# include <iterator>
+
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/datatype_base.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/gate/unitary.hpp>
+# include <ket/utility/contains.hpp>
+# include <ket/mpi/permutated.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/state.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/logger.hpp>
+# include <ket/mpi/utility/detail/swap_permutated_local_qubits.hpp>
+# include <ket/mpi/page/is_on_page.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace gate
+    {
+      namespace unitary_detail
+      {
+# ifdef BOOST_NO_CXX14_GENERIC_LAMBDAS
+        template <typename ParallelPolicy, typename Matrix, typename Qubits>
+        struct call_unitary
+        {
+          ParallelPolicy parallel_policy_;
+          Matrix const& matrix_;
+          Qubits const& permutated_qubits_;
+
+          call_unitary(
+            ParallelPolicy const parallel_policy,
+            Matrix const& matrix, Qubits const& permutated_qubits)
+            : parallel_policy_{parallel_policy},
+              matrix_{matrix},
+              permutated_qubits_{permutated_qubits}
+          { }
+
+          template <typename RandomAccessIterator>
+          void operator()(
+            RandomAccessIterator const first, RandomAccessIterator const last) const
+          { ::ket::gate::unitary(parallel_policy_, first, last, matrix_, permutated_qubits_); }
+        }; // struct call_unitary<ParallelPolicy, Matrix, Qubits>
+
+        template <typename ParallelPolicy, typename Matrix, typename Qubits>
+        inline call_unitary<ParallelPolicy, Matrix, Qubits>
+        make_call_unitary(
+          ParallelPolicy const parallel_policy,
+          Matrix const& matrix, Qubits const& permutated_qubits)
+        { return {parallel_policy, matrix, permutated_qubits}; }
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+
+        // There are no page kernels for dense matrices, so qubits on pages are swapped
+        // with the lowest nonpage qubits which are not operated
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange,
+          typename StateInteger, typename BitInteger, std::size_t num_qubits,
+          typename Allocator>
+        inline void move_qubits_off_pages(
+          MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+          RandomAccessRange& local_state,
+          std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          using permutated_qubit_type = ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> >;
+          auto permutated_other_qubit = permutated_qubit_type{BitInteger{0u}};
+
+          for (auto const qubit: qubits)
+          {
+            auto const permutated_qubit = permutation[qubit];
+            if (not ::ket::mpi::page::is_on_page(permutated_qubit, local_state))
+              continue;
+
+            using ::ket::mpi::inverse;
+            while (::ket::mpi::page::is_on_page(permutated_other_qubit, local_state)
+                   or ::ket::utility::contains(
+                        std::begin(qubits), std::end(qubits), inverse(permutation)[permutated_other_qubit]))
+              ++permutated_other_qubit;
+
+            ::ket::mpi::utility::detail::swap_permutated_local_qubits(
+              mpi_policy, parallel_policy, local_state, permutated_qubit, permutated_other_qubit,
+              static_cast<StateInteger>(::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment)),
+              static_cast<StateInteger>(::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment)),
+              communicator, environment);
+            using ::ket::mpi::permutate;
+            permutate(permutation, qubit, inverse(permutation)[permutated_other_qubit]);
+          }
+        }
+
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+          typename StateInteger, typename BitInteger, std::size_t num_qubits, typename Allocator>
+        inline RandomAccessRange& unitary(
+          MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+          RandomAccessRange& local_state, Matrix const& matrix,
+          std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          ::ket::mpi::gate::unitary_detail::move_qubits_off_pages(
+            mpi_policy, parallel_policy, local_state, qubits, permutation, communicator, environment);
+
+          using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+          auto permutated_qubits = std::array<qubit_type, num_qubits>{};
+          for (auto index = std::size_t{0u}; index < num_qubits; ++index)
+            permutated_qubits[index] = permutation[qubits[index]].qubit();
+
+# ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
+            mpi_policy, local_state, communicator, environment,
+            [parallel_policy, &matrix, &permutated_qubits](auto const first, auto const last)
+            { ::ket::gate::unitary(parallel_policy, first, last, matrix, permutated_qubits); });
+# else // BOOST_NO_CXX14_GENERIC_LAMBDAS
+          return ::ket::mpi::utility::for_each_nonzero_local_range(
+            mpi_policy, local_state, communicator, environment,
+            ::ket::mpi::gate::unitary_detail::make_call_unitary(
+              parallel_policy, matrix, permutated_qubits));
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
+        }
+      } // namespace unitary_detail
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& unitary(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Unitary<"}, num_qubits, '>'), environment};
+
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy,
+          local_state, qubits, permutation, buffer, communicator, environment);
+
+        return ::ket::mpi::gate::unitary_detail::unitary(
+          mpi_policy, parallel_policy, local_state, matrix, qubits, permutation, communicator, environment);
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& unitary(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Unitary<"}, num_qubits, '>'), environment};
+
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy,
+          local_state, qubits, permutation, buffer, datatype, communicator, environment);
+
+        return ::ket::mpi::gate::unitary_detail::unitary(
+          mpi_policy, parallel_policy, local_state, matrix, qubits, permutation, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& unitary(
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, matrix, qubits, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& unitary(
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, matrix, qubits, permutation, buffer, datatype, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, matrix, qubits, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, matrix, qubits, permutation, buffer, datatype, communicator, environment);
+      }
+
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& adj_unitary(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Adj(Unitary)<"}, num_qubits, '>'), environment};
+
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy,
+          local_state, qubits, permutation, buffer, communicator, environment);
+
+        return ::ket::mpi::gate::unitary_detail::unitary(
+          mpi_policy, parallel_policy, local_state, ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits, permutation, communicator, environment);
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& adj_unitary(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::log_with_time_guard<char> print{::ket::mpi::utility::generate_logger_string(std::string{"Adj(Unitary)<"}, num_qubits, '>'), environment};
+
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy,
+          local_state, qubits, permutation, buffer, datatype, communicator, environment);
+
+        return ::ket::mpi::gate::unitary_detail::unitary(
+          mpi_policy, parallel_policy, local_state, ::ket::gate::unitary_detail::conjugate_transpose(matrix), qubits, permutation, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& adj_unitary(
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::adj_unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, matrix, qubits, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& adj_unitary(
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::adj_unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(),
+          ::ket::utility::policy::make_sequential(),
+          local_state, matrix, qubits, permutation, buffer, datatype, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline RandomAccessRange& adj_unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::adj_unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, matrix, qubits, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename ParallelPolicy, typename RandomAccessRange, typename Matrix,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline RandomAccessRange& adj_unitary(
+        ParallelPolicy const parallel_policy,
+        RandomAccessRange& local_state, Matrix const& matrix,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<RandomAccessRange>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        return ::ket::mpi::gate::adj_unitary(
+          ::ket::mpi::utility::policy::make_general_mpi(), parallel_policy,
+          local_state, matrix, qubits, permutation, buffer, datatype, communicator, environment);
+      }
+    } // namespace gate
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_GATE_UNITARY_HPP
@@ -1,22 +1,26 @@
 #ifndef KET_MPI_GENERATE_EVENTS_HPP
 # define KET_MPI_GENERATE_EVENTS_HPP
 
+# include <cstddef>
 # include <cmath>
+# include <complex>
 # include <vector>
+# include <string>
 # include <iterator>
+# include <algorithm>
+# include <numeric>
+# include <memory>
+# include <stdexcept>
 
 # include <boost/range/size.hpp>
 # include <boost/range/value_type.hpp>
 
+# include <mpi.h>
+
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 # include <yampi/communicator.hpp>
 # include <yampi/rank.hpp>
-# include <yampi/buffer.hpp>
-# include <yampi/gather.hpp>
-# include <yampi/broadcast.hpp>
-# include <yampi/message_envelope.hpp>
-# include <yampi/algorithm/transform.hpp>
 
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/positive_random_value_upto.hpp>
@@ -24,118 +28,259 @@
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
 # include <ket/mpi/utility/logger.hpp>
-# include <ket/mpi/utility/fill.hpp>
-# include <ket/mpi/utility/transform_inclusive_scan_self.hpp>
-# include <ket/mpi/utility/upper_bound.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
 
 
 namespace ket
 {
   namespace mpi
   {
-    // generate_events
+    // generate_events: the state is not modified.
+    //   The root rank draws all the random values at once and sorts them, and the values are scattered to the ranks
+    //   having them. Each rank finds the indices for its values by one pass over its local cumulative probabilities,
+    //   and the results are gathered to the root rank and broadcast. So the number of collectives does not depend on
+    //   num_events
+    namespace generate_events_detail
+    {
+      template <typename MpiPolicy, typename LocalState, typename Real>
+      inline Real local_total_probability(
+        MpiPolicy const& mpi_policy, LocalState const& local_state, Real const,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto result = Real{0};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [&result](auto const first, auto const last)
+          {
+            for (auto iter = first; iter != last; ++iter)
+            {
+              using std::norm;
+              result += static_cast<Real>(norm(*iter));
+            }
+          });
+        return result;
+      }
+
+      // local_indices[i] is the index of the first element whose local cumulative probability is greater than
+      // sorted_random_values[i], which are ascending
+      template <typename MpiPolicy, typename LocalState, typename Real, typename StateInteger>
+      inline void find_local_indices(
+        MpiPolicy const& mpi_policy, LocalState const& local_state,
+        std::vector<Real> const& sorted_random_values, std::vector<StateInteger>& local_indices,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const num_values = sorted_random_values.size();
+        local_indices.resize(num_values);
+        if (num_values == std::size_t{0u})
+          return;
+
+        auto value_index = std::size_t{0u};
+        auto index = StateInteger{0u};
+        auto cumulative_probability = Real{0};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [num_values, &sorted_random_values, &local_indices, &value_index, &index, &cumulative_probability](
+            auto const first, auto const last)
+          {
+            for (auto iter = first; iter != last and value_index < num_values; ++iter, ++index)
+            {
+              using std::norm;
+              cumulative_probability += static_cast<Real>(norm(*iter));
+              for (; value_index < num_values and sorted_random_values[value_index] < cumulative_probability; ++value_index)
+                local_indices[value_index] = index;
+            }
+          });
+
+        // values not less than the total probability only by rounding errors
+        auto const last_index = static_cast<StateInteger>(boost::size(local_state)) - StateInteger{1u};
+        std::fill(std::begin(local_indices) + value_index, std::end(local_indices), last_index);
+      }
+
+      template <
+        typename MpiPolicy, typename ResultAllocator,
+        typename LocalState, typename RandomNumberGenerator,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline void generate_events(
+        MpiPolicy const& mpi_policy,
+        std::vector<StateInteger, ResultAllocator>& result,
+        LocalState const& local_state,
+        int const num_events,
+        RandomNumberGenerator& random_number_generator,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, Allocator> const& permutation,
+        MPI_Datatype const state_integer_mpi_datatype, int const num_mpi_data_per_state_integer,
+        MPI_Datatype const real_mpi_datatype, int const num_mpi_data_per_real,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        result.clear();
+        if (num_events <= 0)
+          return;
+
+        using complex_type = typename boost::range_value<LocalState>::type;
+        using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
+        auto const total_probability
+          = ::ket::mpi::generate_events_detail::local_total_probability(
+              mpi_policy, local_state, real_type{}, communicator, environment);
+
+        auto const present_rank = communicator.rank(environment);
+        constexpr auto root_rank = yampi::rank{0};
+        auto const is_root = present_rank == root_rank;
+        auto const num_ranks = static_cast<std::size_t>(communicator.size(environment));
+
+        auto const check
+          = [](int const error_code, char const* const function_name)
+            {
+              if (error_code != MPI_SUCCESS)
+                throw std::runtime_error{std::string{function_name} + " failed in ket::mpi::generate_events"};
+            };
+
+        auto total_probabilities = std::vector<real_type>{};
+        if (is_root)
+          total_probabilities.resize(num_ranks);
+
+        check(
+          MPI_Gather(
+            std::addressof(total_probability), num_mpi_data_per_real, real_mpi_datatype,
+            total_probabilities.data(), num_mpi_data_per_real, real_mpi_datatype,
+            root_rank.mpi_rank(), communicator.mpi_comm()),
+          "MPI_Gather");
+
+        // random values sorted in ascending order, and the indices of events for them
+        auto random_values = std::vector<real_type>{};
+        auto event_indices = std::vector<int>{};
+        auto counts = std::vector<int>{};
+        auto displacements = std::vector<int>{};
+        if (is_root)
+        {
+          ::ket::utility::ranges::inclusive_scan(total_probabilities, std::begin(total_probabilities));
+
+          auto unsorted_random_values = std::vector<real_type>(num_events);
+          for (auto& random_value: unsorted_random_values)
+            random_value
+              = ::ket::utility::positive_random_value_upto(total_probabilities.back(), random_number_generator);
+
+          event_indices.resize(num_events);
+          std::iota(std::begin(event_indices), std::end(event_indices), 0);
+          std::sort(
+            std::begin(event_indices), std::end(event_indices),
+            [&unsorted_random_values](int const lhs, int const rhs)
+            { return unsorted_random_values[lhs] < unsorted_random_values[rhs]; });
+
+          random_values.reserve(num_events);
+          for (auto const event_index: event_indices)
+            random_values.push_back(unsorted_random_values[event_index]);
+
+          // values are converted into local cumulative probabilities of the ranks having them
+          counts.resize(num_ranks);
+          displacements.resize(num_ranks);
+          auto value_first = std::begin(random_values);
+          for (auto rank_index = std::size_t{0u}; rank_index < num_ranks; ++rank_index)
+          {
+            auto const value_last
+              = rank_index + 1u == num_ranks
+                ? std::end(random_values)
+                : std::upper_bound(value_first, std::end(random_values), total_probabilities[rank_index]);
+            counts[rank_index] = static_cast<int>(value_last - value_first);
+            displacements[rank_index] = static_cast<int>(value_first - std::begin(random_values));
+
+            if (rank_index > std::size_t{0u})
+              std::for_each(
+                value_first, value_last,
+                [&total_probabilities, rank_index](real_type& random_value)
+                { random_value -= total_probabilities[rank_index - 1u]; });
+
+            value_first = value_last;
+          }
+        }
+
+        auto num_local_values = 0;
+        check(
+          MPI_Scatter(
+            counts.data(), 1, MPI_INT, std::addressof(num_local_values), 1, MPI_INT,
+            root_rank.mpi_rank(), communicator.mpi_comm()),
+          "MPI_Scatter");
+
+        auto local_random_values = std::vector<real_type>(num_local_values);
+        if (is_root)
+          for (auto rank_index = std::size_t{0u}; rank_index < num_ranks; ++rank_index)
+          {
+            counts[rank_index] *= num_mpi_data_per_real;
+            displacements[rank_index] *= num_mpi_data_per_real;
+          }
+        check(
+          MPI_Scatterv(
+            random_values.data(), counts.data(), displacements.data(), real_mpi_datatype,
+            local_random_values.data(), num_local_values * num_mpi_data_per_real, real_mpi_datatype,
+            root_rank.mpi_rank(), communicator.mpi_comm()),
+          "MPI_Scatterv");
+
+        auto local_results = std::vector<StateInteger>{};
+        ::ket::mpi::generate_events_detail::find_local_indices(
+          mpi_policy, local_state, local_random_values, local_results, communicator, environment);
+        for (auto& local_result: local_results)
+        {
+          using ::ket::mpi::utility::rank_index_to_qubit_value;
+          using ::ket::mpi::inverse_permutate_bits;
+          local_result
+            = inverse_permutate_bits(
+                permutation, rank_index_to_qubit_value(mpi_policy, local_state, present_rank, local_result));
+        }
+
+        auto sorted_results = std::vector<StateInteger>{};
+        if (is_root)
+        {
+          sorted_results.resize(num_events);
+          for (auto rank_index = std::size_t{0u}; rank_index < num_ranks; ++rank_index)
+          {
+            counts[rank_index] = counts[rank_index] / num_mpi_data_per_real * num_mpi_data_per_state_integer;
+            displacements[rank_index] = displacements[rank_index] / num_mpi_data_per_real * num_mpi_data_per_state_integer;
+          }
+        }
+        check(
+          MPI_Gatherv(
+            local_results.data(), num_local_values * num_mpi_data_per_state_integer, state_integer_mpi_datatype,
+            sorted_results.data(), counts.data(), displacements.data(), state_integer_mpi_datatype,
+            root_rank.mpi_rank(), communicator.mpi_comm()),
+          "MPI_Gatherv");
+
+        result.resize(num_events);
+        if (is_root)
+          for (auto index = std::size_t{0u}; index < sorted_results.size(); ++index)
+            result[event_indices[index]] = sorted_results[index];
+
+        check(
+          MPI_Bcast(
+            result.data(), num_events * num_mpi_data_per_state_integer, state_integer_mpi_datatype,
+            root_rank.mpi_rank(), communicator.mpi_comm()),
+          "MPI_Bcast");
+      }
+    } // namespace generate_events_detail
+
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename ResultAllocator,
       typename LocalState, typename RandomNumberGenerator,
       typename StateInteger, typename BitInteger, typename Allocator>
     inline void generate_events(
-      MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+      MpiPolicy const& mpi_policy, ParallelPolicy const,
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator& random_number_generator,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
       ket::mpi::utility::log_with_time_guard<char> print{"Generate Events", environment};
 
-      result.clear();
-      result.reserve(num_events);
-
       using complex_type = typename boost::range_value<LocalState>::type;
-      using std::real;
-      auto const total_probability
-        = real(::ket::mpi::utility::transform_inclusive_scan_self(
-            parallel_policy, local_state,
-            [](complex_type const& lhs, complex_type const& rhs)
-            { using std::real; return static_cast<complex_type>(real(lhs) + real(rhs)); },
-            [](complex_type const& value)
-            { using std::norm; return static_cast<complex_type>(norm(value)); },
-            environment));
-
-      auto const present_rank = communicator.rank(environment);
-      constexpr auto root_rank = yampi::rank{0};
-
       using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      auto total_probabilities = std::vector<real_type>{};
-      if (present_rank == root_rank)
-        total_probabilities.resize(communicator.size(environment));
-
-      yampi::gather(root_rank, communicator).call(
-        yampi::make_buffer(total_probability),
-        std::begin(total_probabilities), environment);
-
-      if (present_rank == root_rank)
-        ::ket::utility::ranges::inclusive_scan(
-          total_probabilities, std::begin(total_probabilities));
-
-      for (auto event_index = 0; event_index < num_events; ++event_index)
-      {
-        auto random_value = real_type{};
-        auto result_rank = yampi::rank{};
-        if (present_rank == root_rank)
-        {
-          random_value
-            = ::ket::utility::positive_random_value_upto(
-                total_probabilities.back(), random_number_generator);
-          result_rank
-            = static_cast<yampi::rank>(static_cast<StateInteger>(
-                std::upper_bound(
-                  std::begin(total_probabilities),
-                  std::end(total_probabilities), random_value)
-                - std::begin(total_probabilities)));
-        }
-
-        auto result_mpi_rank = result_rank.mpi_rank();
-        yampi::broadcast(root_rank, communicator).call(
-          yampi::make_buffer(result_mpi_rank), environment);
-        result_rank = static_cast<yampi::rank>(result_mpi_rank);
-
-        yampi::algorithm::transform(
-          yampi::ignore_status(),
-          yampi::make_buffer(random_value),
-          yampi::make_buffer(random_value),
-          [&total_probabilities, result_rank](real_type const random_value)
-          { return random_value - total_probabilities[result_rank.mpi_rank() - 1]; },
-          ::yampi::message_envelope(root_rank, result_rank, communicator),
-          environment);
-
-        auto permutated_result = StateInteger{};
-        if (present_rank == result_rank)
-        {
-          auto const local_result
-            = static_cast<StateInteger>(
-                ::ket::mpi::utility::upper_bound(
-                  local_state, static_cast<complex_type>(random_value),
-                  [](complex_type const& lhs, complex_type const& rhs)
-                  { using std::real; return real(lhs) < real(rhs); },
-                  environment));
-
-          using ::ket::mpi::utility::rank_index_to_qubit_value;
-          permutated_result
-            = rank_index_to_qubit_value(
-                mpi_policy, local_state, result_rank, local_result);
-        }
-
-        yampi::broadcast(result_rank, communicator).call(
-          yampi::make_buffer(permutated_result), environment);
-
-        using ::ket::mpi::inverse_permutate_bits;
-        result.push_back(inverse_permutate_bits(permutation, permutated_result));
-      }
+      ::ket::mpi::generate_events_detail::generate_events(
+        mpi_policy, result, local_state, num_events, random_number_generator, permutation,
+        MPI_BYTE, static_cast<int>(sizeof(StateInteger)), MPI_BYTE, static_cast<int>(sizeof(real_type)),
+        communicator, environment);
     }
 
     template <
@@ -145,13 +290,13 @@ namespace ket
       typename StateInteger, typename BitInteger, typename Allocator,
       typename DerivedDatatype1, typename DerivedDatatype2>
     inline void generate_events(
-      MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+      MpiPolicy const& mpi_policy, ParallelPolicy const,
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator& random_number_generator,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::datatype_base<DerivedDatatype1> const& state_integer_datatype,
       yampi::datatype_base<DerivedDatatype2> const& real_datatype,
       yampi::communicator const& communicator,
@@ -159,92 +304,10 @@ namespace ket
     {
       ket::mpi::utility::log_with_time_guard<char> print{"Generate Events", environment};
 
-      result.clear();
-      result.reserve(num_events);
-
-      using complex_type = typename boost::range_value<LocalState>::type;
-      using std::real;
-      auto const total_probability
-        = real(::ket::mpi::utility::transform_inclusive_scan_self(
-            parallel_policy, local_state,
-            [](complex_type const& lhs, complex_type const& rhs)
-            { using std::real; return static_cast<complex_type>(real(lhs) + real(rhs)); },
-            [](complex_type const& value)
-            { using std::norm; return static_cast<complex_type>(norm(value)); },
-            environment));
-
-      auto const present_rank = communicator.rank(environment);
-      constexpr auto root_rank = yampi::rank{0};
-
-      using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
-      auto total_probabilities = std::vector<real_type>{};
-      if (present_rank == root_rank)
-        total_probabilities.resize(communicator.size(environment));
-
-      yampi::gather(root_rank, communicator).call(
-        yampi::make_buffer(total_probability, real_datatype),
-        std::begin(total_probabilities),
-        environment);
-
-      if (present_rank == root_rank)
-        ::ket::utility::ranges::inclusive_scan(
-          total_probabilities, std::begin(total_probabilities));
-
-      for (auto event_index = 0; event_index < num_events; ++event_index)
-      {
-        auto random_value = real_type{};
-        auto result_rank = yampi::rank{};
-        if (present_rank == root_rank)
-        {
-          random_value
-            = ::ket::utility::positive_random_value_upto(
-                total_probabilities.back(), random_number_generator);
-          result_rank
-            = static_cast<yampi::rank>(static_cast<StateInteger>(
-                std::upper_bound(
-                  std::begin(total_probabilities),
-                  std::end(total_probabilities), random_value)
-                - std::begin(total_probabilities)));
-        }
-
-        auto result_mpi_rank = result_rank.mpi_rank();
-        yampi::broadcast(root_rank, communicator).call(
-          yampi::make_buffer(result_mpi_rank),
-          environment);
-        result_rank = static_cast<yampi::rank>(result_mpi_rank);
-
-        yampi::algorithm::transform(
-          yampi::ignore_status(),
-          yampi::make_buffer(random_value, real_datatype),
-          yampi::make_buffer(random_value, real_datatype),
-          [&total_probabilities, result_rank](real_type const random_value)
-          { return random_value - total_probabilities[result_rank.mpi_rank() - 1]; },
-          ::yampi::message_envelope(root_rank, result_rank, communicator),
-          environment);
-
-        StateInteger permutated_result;
-        if (present_rank == result_rank)
-        {
-          StateInteger const local_result
-            = static_cast<StateInteger>(
-                ::ket::mpi::utility::upper_bound(
-                  local_state, static_cast<complex_type>(random_value),
-                  [](complex_type const& lhs, complex_type const& rhs)
-                  { using std::real; return real(lhs) < real(rhs); },
-                  environment));
-
-          using ::ket::mpi::utility::rank_index_to_qubit_value;
-          permutated_result
-            = rank_index_to_qubit_value(
-                mpi_policy, local_state, result_rank, local_result);
-        }
-
-        yampi::broadcast(result_rank, communicator).call(
-          yampi::make_buffer(permutated_result, state_integer_datatype), environment);
-
-        using ::ket::mpi::inverse_permutate_bits;
-        result.push_back(inverse_permutate_bits(permutation, permutated_result));
-      }
+      ::ket::mpi::generate_events_detail::generate_events(
+        mpi_policy, result, local_state, num_events, random_number_generator, permutation,
+        state_integer_datatype.mpi_datatype(), 1, real_datatype.mpi_datatype(), 1,
+        communicator, environment);
     }
 
     template <
@@ -255,12 +318,12 @@ namespace ket
     inline void generate_events(
       MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator const&,
       typename RandomNumberGenerator::result_type const seed,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
@@ -280,12 +343,12 @@ namespace ket
     inline void generate_events(
       MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator const&,
       typename RandomNumberGenerator::result_type const seed,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::datatype_base<DerivedDatatype1> const& state_integer_datatype,
       yampi::datatype_base<DerivedDatatype2> const& real_datatype,
       yampi::communicator const& communicator,
@@ -304,11 +367,11 @@ namespace ket
       typename StateInteger, typename BitInteger, typename Allocator>
     inline void generate_events(
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator& random_number_generator,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
@@ -326,11 +389,11 @@ namespace ket
       typename DerivedDatatype1, typename DerivedDatatype2>
     inline void generate_events(
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator& random_number_generator,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::datatype_base<DerivedDatatype1> const& state_integer_datatype,
       yampi::datatype_base<DerivedDatatype2> const& real_datatype,
       yampi::communicator const& communicator,
@@ -349,12 +412,12 @@ namespace ket
       typename StateInteger, typename BitInteger, typename Allocator>
     inline void generate_events(
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator const&,
       typename RandomNumberGenerator::result_type const seed,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::communicator const& communicator,
       yampi::environment const& environment)
     {
@@ -371,12 +434,12 @@ namespace ket
       typename DerivedDatatype1, typename DerivedDatatype2>
     inline void generate_events(
       std::vector<StateInteger, ResultAllocator>& result,
-      LocalState& local_state,
+      LocalState const& local_state,
       int const num_events,
       RandomNumberGenerator const&,
       typename RandomNumberGenerator::result_type const seed,
       ::ket::mpi::qubit_permutation<
-        StateInteger, BitInteger, Allocator>& permutation,
+        StateInteger, BitInteger, Allocator> const& permutation,
       yampi::datatype_base<DerivedDatatype1> const& state_integer_datatype,
       yampi::datatype_base<DerivedDatatype2> const& real_datatype,
       yampi::communicator const& communicator,
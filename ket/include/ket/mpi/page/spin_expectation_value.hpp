@@ -1,10 +1,7 @@
 #ifndef KET_MPI_PAGE_SPIN_EXPECTATION_VALUE_HPP
 # define KET_MPI_PAGE_SPIN_EXPECTATION_VALUE_HPP
 
-# include <vector>
 # include <array>
-# include <numeric>
-# include <iterator>
 
 # include <boost/math/constants/constants.hpp>
 # include <boost/range/value_type.hpp>
@@ -54,14 +51,8 @@ namespace ket
         template <typename HdSpin>
         struct spin_expectation_value
         {
-          std::vector<HdSpin>& spins_in_threads_;
-
-          explicit spin_expectation_value(std::vector<HdSpin>& spins_in_threads)
-            : spins_in_threads_{spins_in_threads}
-          { }
-
           template <typename Iterator, typename StateInteger>
-          void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const thread_index) const
+          void operator()(Iterator const zero_first, Iterator const one_first, StateInteger const index, int const, HdSpin& partial_spin) const
           {
             using std::conj;
             auto const conj_zero_value = conj(*(zero_first + index));
@@ -69,19 +60,26 @@ namespace ket
             auto const conj_zero_times_one = conj_zero_value * one_value;
 
             using std::real;
-            spins_in_threads_[thread_index][0u] += static_cast<long double>(real(conj_zero_times_one));
+            partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
             using std::imag;
-            spins_in_threads_[thread_index][1u] += static_cast<long double>(imag(conj_zero_times_one));
+            partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
             using std::norm;
-            spins_in_threads_[thread_index][2u]
+            partial_spin[2u]
               += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
           }
-        }; // struct spin_expectation_value<Complex, Real>
+        }; // struct spin_expectation_value<HdSpin>
 
         template <typename HdSpin>
-        inline ::ket::mpi::page::spin_expectation_value_detail::spin_expectation_value<HdSpin>
-        make_spin_expectation_value(std::vector<HdSpin>& spins_in_threads)
-        { return ::ket::mpi::page::spin_expectation_value_detail::spin_expectation_value<HdSpin>{spins_in_threads}; }
+        struct add_spins
+        {
+          HdSpin operator()(HdSpin accumulated_spin, HdSpin const& spin) const
+          {
+            accumulated_spin[0u] += spin[0u];
+            accumulated_spin[1u] += spin[1u];
+            accumulated_spin[2u] += spin[2u];
+            return accumulated_spin;
+          }
+        }; // struct add_spins<HdSpin>
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
       } // namespace spin_expectation_value_detail
 
@@ -97,43 +95,40 @@ namespace ket
       {
         using hd_spin_type = std::array<long double, 3u>;
         constexpr auto zero_spin = hd_spin_type{ };
-        auto spins_in_threads
-          = std::vector<hd_spin_type>(::ket::utility::num_threads(parallel_policy), zero_spin);
 
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-        ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-          parallel_policy, local_state, permutated_qubit,
-          [&spins_in_threads](auto const zero_first, auto const one_first, StateInteger const index, int const thread_index)
-          {
-            using std::conj;
-            auto const conj_zero_value = conj(*(zero_first + index));
-            auto const one_value = *(one_first + index);
-            auto const conj_zero_times_one = conj_zero_value * one_value;
-
-            using std::real;
-            spins_in_threads[thread_index][0u] += static_cast<long double>(real(conj_zero_times_one));
-            using std::imag;
-            spins_in_threads[thread_index][1u] += static_cast<long double>(imag(conj_zero_times_one));
-            using std::norm;
-            spins_in_threads[thread_index][2u]
-              += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
-          });
-# else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-        ::ket::mpi::gate::page::detail::one_page_qubit_gate<0u>(
-          parallel_policy, local_state, permutated_qubit,
-          ::ket::mpi::page::spin_expectation_value_detail::make_spin_expectation_value<hd_spin_type>(spins_in_threads));
-# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
-
         auto const hd_spin
-          = std::accumulate(
-              std::begin(spins_in_threads), std::end(spins_in_threads), zero_spin,
+          = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+              parallel_policy, local_state, permutated_qubit, zero_spin,
               [](hd_spin_type accumulated_spin, hd_spin_type const& spin)
               {
                 accumulated_spin[0u] += spin[0u];
                 accumulated_spin[1u] += spin[1u];
                 accumulated_spin[2u] += spin[2u];
                 return accumulated_spin;
+              },
+              [](auto const zero_first, auto const one_first, StateInteger const index, int const, hd_spin_type& partial_spin)
+              {
+                using std::conj;
+                auto const conj_zero_value = conj(*(zero_first + index));
+                auto const one_value = *(one_first + index);
+                auto const conj_zero_times_one = conj_zero_value * one_value;
+
+                using std::real;
+                partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
+                using std::imag;
+                partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
+                using std::norm;
+                partial_spin[2u]
+                  += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
               });
+# else // BOOST_NO_CXX14_GENERIC_LAMBDAS
+        auto const hd_spin
+          = ::ket::mpi::gate::page::detail::one_page_qubit_reduce<0u>(
+              parallel_policy, local_state, permutated_qubit, zero_spin,
+              ::ket::mpi::page::spin_expectation_value_detail::add_spins<hd_spin_type>{},
+              ::ket::mpi::page::spin_expectation_value_detail::spin_expectation_value<hd_spin_type>{});
+# endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
 
         using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
         using spin_type = std::array<real_type, 3u>;
@@ -0,0 +1,32 @@
+#ifndef KET_MPI_PAGE_UNMARK_ZERO_PAGES_HPP
+# define KET_MPI_PAGE_UNMARK_ZERO_PAGES_HPP
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace page
+    {
+      namespace dispatch
+      {
+        template <typename LocalState_>
+        struct unmark_zero_pages
+        {
+          template <typename LocalState>
+          static void call(LocalState&)
+          { }
+        }; // struct unmark_zero_pages<LocalState_>
+      } // namespace dispatch
+
+      // unmark_zero_pages(local_state): forgets which pages of local_state are known to have only zeros.
+      //   It should be called after values are moved between local ranges without ket::mpi::state's own operations
+      template <typename LocalState>
+      inline void unmark_zero_pages(LocalState& local_state)
+      { ::ket::mpi::page::dispatch::unmark_zero_pages<LocalState>::call(local_state); }
+    } // namespace page
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_PAGE_UNMARK_ZERO_PAGES_HPP
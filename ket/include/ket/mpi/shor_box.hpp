@@ -2,7 +2,12 @@
 # define KET_MPI_SHOR_BOX_HPP
 
 # include <cassert>
+# include <cmath>
+# include <cstddef>
 # include <iterator>
+# include <vector>
+# include <algorithm>
+# include <utility>
 # include <type_traits>
 
 # include <boost/range/size.hpp>
@@ -21,7 +26,10 @@
 # include <ket/meta/bit_integer_of.hpp>
 # include <ket/utility/is_unique_if_sorted.hpp>
 # include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/real_of.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
 # include <ket/mpi/utility/fill.hpp>
@@ -32,6 +40,86 @@ namespace ket
 {
   namespace mpi
   {
+    // shor_box: the exponents are split into segments of consecutive exponents, and each segment starts from
+    //   base^(its first exponent) mod divisor (see ket::shor_box). The data block, thus the rank, of an amplitude
+    //   is selected by its qubits at the permutated bits of data blocks. If no modular exponentiation qubit is there,
+    //   the exponents of the segments whose exponent qubits select other ranks are skipped. Otherwise every rank
+    //   walks all the exponents, and writes only the amplitudes of its own
+    namespace shor_box_detail
+    {
+      // local_segment_firsts: returns the first exponents of the segments to be walked and the number of all the
+      //   segments
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename Qubits,
+        typename StateInteger, typename BitInteger, typename Allocator>
+      inline std::pair<std::vector<StateInteger>, std::size_t> local_segment_firsts(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState const& local_state, BitInteger const num_exponent_qubits,
+        Qubits const& exponent_qubits, Qubits const& modular_exponentiation_qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const data_block_size
+          = static_cast<StateInteger>(
+              ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment));
+        auto const least_data_block_permutated_bit = ::ket::utility::integer_log2<BitInteger>(data_block_size);
+        using permutated_qubit_type = ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> >;
+        auto const is_data_block_qubit
+          = [&permutation, least_data_block_permutated_bit](::ket::qubit<StateInteger, BitInteger> const qubit)
+            { return permutation[qubit] >= permutated_qubit_type{least_data_block_permutated_bit}; };
+
+        // The exponent qubits[i] holds the (n - 1 - i)-th bit of the exponent
+        auto data_block_exponent_mask = StateInteger{0u};
+        auto const exponent_qubits_first = std::begin(exponent_qubits);
+        for (auto index = BitInteger{0u}; index < num_exponent_qubits; ++index)
+          if (is_data_block_qubit(exponent_qubits_first[index]))
+            data_block_exponent_mask
+              |= StateInteger{1u} << (num_exponent_qubits - BitInteger{1u} - index);
+
+        auto const is_rank_filterable
+          = std::none_of(
+              std::begin(modular_exponentiation_qubits), std::end(modular_exponentiation_qubits), is_data_block_qubit);
+
+        // Exponents in a segment have the same bits of data_block_exponent_mask if the segments are aligned
+        // blocks of at most 2^b exponents, where b is the lowest bit of data_block_exponent_mask
+        auto min_num_segment_bits = num_exponent_qubits;
+        if (is_rank_filterable)
+          while (min_num_segment_bits > BitInteger{0u}
+                 and ((data_block_exponent_mask >> (num_exponent_qubits - min_num_segment_bits)) bitand StateInteger{1u})
+                     == StateInteger{0u})
+            --min_num_segment_bits;
+        auto const num_segment_bits
+          = std::max(
+              min_num_segment_bits,
+              ::ket::shor_box_detail::num_segment_bits(
+                ::ket::utility::num_threads(parallel_policy), num_exponent_qubits));
+        auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
+        auto const num_segments = ::ket::utility::integer_exp2<StateInteger>(num_segment_bits);
+        auto const segment_size
+          = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits - num_segment_bits);
+
+        auto const present_rank = communicator.rank(environment);
+        auto result = std::vector<StateInteger>{};
+        for (auto first_exponent = StateInteger{0u}; first_exponent < num_exponents; first_exponent += segment_size)
+        {
+          if (is_rank_filterable)
+          {
+            auto const qubit_value
+              = ::ket::shor_box_detail::make_filtered_integer(
+                  ::ket::shor_box_detail::reverse_bits(first_exponent, num_exponent_qubits), exponent_qubits);
+            using ::ket::mpi::permutate_bits;
+            if (::ket::mpi::utility::qubit_value_to_rank_index(
+                  mpi_policy, permutate_bits(permutation, qubit_value), data_block_size).first != present_rank)
+              continue;
+          }
+
+          result.push_back(first_exponent);
+        }
+
+        return std::make_pair(std::move(result), static_cast<std::size_t>(num_segments));
+      }
+    } // namespace shor_box_detail
+
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename RandomAccessRange, typename StateInteger, typename Qubits,
@@ -70,33 +158,48 @@ namespace ket
 
       auto const num_exponent_qubits = static_cast<BitInteger>(boost::size(exponent_qubits));
       auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-      auto modular_exponentiation_value = StateInteger{1u};
 
       using std::pow;
       auto const constant_coefficient
         = static_cast<complex_type>(static_cast<real_type>(pow(static_cast<real_type>(num_exponents), -0.5)));
 
+      auto const segment_firsts
+        = ::ket::mpi::shor_box_detail::local_segment_firsts(
+            mpi_policy, parallel_policy, local_state, num_exponent_qubits,
+            exponent_qubits, modular_exponentiation_qubits, permutation, communicator, environment);
+      auto const segment_size = num_exponents / static_cast<StateInteger>(segment_firsts.second);
+
+      // Worker threads of loop_n must not call MPI functions
       auto const present_rank = communicator.rank(environment);
+      auto const data_block_size
+        = static_cast<StateInteger>(
+            ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment));
       auto const first = std::begin(local_state);
-      for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
-      {
-        auto const qubit_value
-          = ::ket::shor_box_detail::calculate_index(
-              ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
-              modular_exponentiation_value, modular_exponentiation_qubits);
-
-        using ::ket::mpi::permutate_bits;
-        auto const rank_index
-          = ::ket::mpi::utility::qubit_value_to_rank_index(
-              mpi_policy, local_state, permutate_bits(permutation, qubit_value),
-              communicator, environment);
-
-        if (rank_index.first == present_rank)
-          *(first + rank_index.second) = constant_coefficient;
-
-        modular_exponentiation_value *= base;
-        modular_exponentiation_value %= divisor;
-      }
+      using ::ket::utility::loop_n;
+      loop_n(
+        parallel_policy, static_cast<StateInteger>(segment_firsts.first.size()),
+        [&mpi_policy, base, divisor, num_exponent_qubits,
+         &exponent_qubits, &modular_exponentiation_qubits, &permutation,
+         constant_coefficient, &segment_firsts, segment_size, present_rank, data_block_size, first](
+          StateInteger const segment_index, int const)
+        {
+          auto const first_exponent = segment_firsts.first[segment_index];
+          ::ket::shor_box_detail::shor_box_segment(
+            first_exponent, first_exponent + segment_size,
+            base, divisor, num_exponent_qubits, exponent_qubits, modular_exponentiation_qubits,
+            constant_coefficient,
+            [&mpi_policy, &permutation, present_rank, data_block_size, first](
+              StateInteger const qubit_value, complex_type const& coefficient)
+            {
+              using ::ket::mpi::permutate_bits;
+              auto const rank_index
+                = ::ket::mpi::utility::qubit_value_to_rank_index(
+                    mpi_policy, permutate_bits(permutation, qubit_value), data_block_size);
+
+              if (rank_index.first == present_rank)
+                *(first + rank_index.second) = coefficient;
+            });
+        });
 
       return local_state;
     }
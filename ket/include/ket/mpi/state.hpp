@@ -36,9 +36,12 @@
 # include <ket/control.hpp>
 # include <ket/utility/integer_exp2.hpp>
 # include <ket/utility/loop_n.hpp>
+# include <ket/utility/numa.hpp>
+# include <ket/utility/planar_complex_vector.hpp>
 # include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/page/is_on_page.hpp>
+# include <ket/mpi/page/unmark_zero_pages.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
 # include <ket/mpi/utility/for_each_local_range.hpp>
 # include <ket/mpi/utility/transform_inclusive_scan.hpp>
@@ -47,6 +50,7 @@
 # include <ket/mpi/utility/detail/swap_permutated_local_qubits.hpp>
 # include <ket/mpi/utility/detail/for_each_in_diagonal_loop.hpp>
 # include <ket/mpi/utility/detail/swap_local_data.hpp>
+# include <ket/mpi/utility/detail/interchange_qubits.hpp>
 
 # if __cplusplus >= 201703L
 #   define KET_is_nothrow_swappable std::is_nothrow_swappable
@@ -66,7 +70,8 @@ namespace ket
         : public boost::iterators::iterator_facade<
             state_iterator<State>,
             typename State::value_type,
-            std::random_access_iterator_tag>
+            std::random_access_iterator_tag,
+            typename State::reference>
       {
         State* state_ptr_;
         int index_;
@@ -83,8 +88,12 @@ namespace ket
         { }
 
 
-        typename State::value_type& dereference() const
-        { return const_cast<typename State::value_type&>((*state_ptr_)[index_]); }
+        // not through State::operator[], which forgets zero pages. Non-const State::begin() has forgotten them
+        typename State::reference dereference() const
+        {
+          return std::begin(state_ptr_->page_range(state_ptr_->get_data_block_page_indices(index_)))[
+            state_ptr_->get_nonpage_index(index_)];
+        }
 
         bool equal(state_iterator const& other) const
         { return state_ptr_ == other.state_ptr_ and index_ == other.index_; }
@@ -120,7 +129,9 @@ namespace ket
       using allocator_type = typename Allocator::template rebind<value_type>::other;
 
      private:
-      using data_type = std::vector<value_type, allocator_type>;
+      // std::vector<value_type, allocator_type>, or ket::utility::planar_complex_vector if Allocator is
+      // ket::utility::planar_allocator
+      using data_type = typename ::ket::utility::meta::complex_container_of<value_type, allocator_type>::type;
       data_type data_;
 
      public:
@@ -134,6 +145,10 @@ namespace ket
       std::size_t num_data_blocks_;
       std::vector<page_range_type> page_ranges_;
       page_range_type buffer_range_;
+      // is_zero_page_[page_range_index] is true if the page is known to have only zeros. Gates skip such pages, and
+      // interchange_qubits does not send them. may_have_zero_pages_ is false if all of is_zero_page_ are false
+      std::vector<bool> is_zero_page_;
+      bool may_have_zero_pages_;
 
      public:
       using size_type = typename data_type::size_type;
@@ -161,7 +176,9 @@ namespace ket
           num_pages_{other.num_pages_},
           num_data_blocks_{other.num_data_blocks_},
           page_ranges_{other.page_ranges_},
-          buffer_range_{other.buffer_range_}
+          buffer_range_{other.buffer_range_},
+          is_zero_page_{other.is_zero_page_},
+          may_have_zero_pages_{other.may_have_zero_pages_}
       { }
 
       state(state&& other, allocator_type const& allocator)
@@ -171,7 +188,9 @@ namespace ket
           num_pages_{std::move(other.num_pages_)},
           num_data_blocks_{std::move(other.num_data_blocks_)},
           page_ranges_{std::move(other.page_ranges_)},
-          buffer_range_{std::move(other.buffer_range_)}
+          buffer_range_{std::move(other.buffer_range_)},
+          is_zero_page_{std::move(other.is_zero_page_)},
+          may_have_zero_pages_{std::move(other.may_have_zero_pages_)}
       { }
 
       state(std::initializer_list<value_type> initializer_list, allocator_type const& allocator = allocator_type())
@@ -181,7 +200,9 @@ namespace ket
           num_pages_{std::size_t{2u}},
           num_data_blocks_{std::size_t{1u}},
           page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
-          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
       {
         assert(::ket::utility::integer_exp2<std::size_t>(num_local_qubits_) == initializer_list.size());
         assert(num_local_qubits_ > num_page_qubits_);
@@ -195,7 +216,9 @@ namespace ket
           num_pages_{std::size_t{1u} << num_page_qubits},
           num_data_blocks_{std::size_t{1u}},
           page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
-          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
       {
         assert(::ket::utility::integer_exp2<std::size_t>(num_local_qubits_) == initializer_list.size());
         assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_);
@@ -209,7 +232,9 @@ namespace ket
           num_pages_{std::size_t{1u} << num_page_qubits},
           num_data_blocks_{static_cast<std::size_t>(num_data_blocks)},
           page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
-          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
       {
         assert(::ket::utility::integer_exp2<std::size_t>(num_local_qubits_) * num_data_blocks_ == initializer_list.size());
         assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_);
@@ -225,7 +250,7 @@ namespace ket
         yampi::communicator const& communicator,
         yampi::environment const& environment)
         : data_{generate_initial_data(
-            ::ket::mpi::utility::policy::make_general_mpi(),
+            ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
             num_local_qubits, StateInteger{1u} << num_page_qubits,
             initial_integer, permutation, communicator, environment)},
           num_local_qubits_{static_cast<std::size_t>(num_local_qubits)},
@@ -233,7 +258,9 @@ namespace ket
           num_pages_{std::size_t{1u} << num_page_qubits},
           num_data_blocks_{std::size_t{1u}},
           page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
-          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
       { assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_); }
 
       template <typename MpiPolicy, typename BitInteger, typename StateInteger, typename PermutationAllocator>
@@ -246,13 +273,43 @@ namespace ket
         yampi::communicator const& communicator,
         yampi::environment const& environment)
         : data_{generate_initial_data(
-            mpi_policy, num_local_qubits, StateInteger{1u} << num_page_qubits, initial_integer, permutation, communicator, environment)},
+            mpi_policy, ::ket::utility::policy::make_sequential(),
+            num_local_qubits, StateInteger{1u} << num_page_qubits, initial_integer, permutation, communicator, environment)},
           num_local_qubits_{static_cast<std::size_t>(num_local_qubits)},
           num_page_qubits_{static_cast<std::size_t>(num_page_qubits)},
           num_pages_{std::size_t{1u} << num_page_qubits},
           num_data_blocks_{static_cast<std::size_t>(::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment))},
           page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
-          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)}
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
+      { assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_); }
+
+      // The amplitudes are first touched by the threads of parallel_policy in the same static partition as loop_n in
+      // gates. If allocator_type is ket::utility::uninitialized_allocator, each memory page is then placed on the NUMA
+      // node of the thread processing it
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename BitInteger, typename StateInteger, typename PermutationAllocator>
+      state(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        BitInteger const num_local_qubits, BitInteger const num_page_qubits,
+        StateInteger const initial_integer,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, PermutationAllocator> const& permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+        : data_{generate_initial_data(
+            mpi_policy, parallel_policy,
+            num_local_qubits, StateInteger{1u} << num_page_qubits, initial_integer, permutation, communicator, environment)},
+          num_local_qubits_{static_cast<std::size_t>(num_local_qubits)},
+          num_page_qubits_{static_cast<std::size_t>(num_page_qubits)},
+          num_pages_{std::size_t{1u} << num_page_qubits},
+          num_data_blocks_{static_cast<std::size_t>(::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment))},
+          page_ranges_{generate_initial_page_ranges(data_, num_pages_, num_data_blocks_)},
+          buffer_range_{generate_initial_buffer_range(data_, num_pages_, num_data_blocks_)},
+          is_zero_page_{generate_initial_zero_page_flags()},
+          may_have_zero_pages_{true}
       { assert(num_page_qubits_ >= BitInteger{1u} and num_local_qubits_ > num_page_qubits_); }
 
       template <typename PairOrTuple>
@@ -277,18 +334,22 @@ namespace ket
         std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices2)
       {
         assert(data_block_page_indices1 != data_block_page_indices2);
+        auto const page_range_index1 = page_range_index(data_block_page_indices1);
+        auto const page_range_index2 = page_range_index(data_block_page_indices2);
         using std::swap;
-        swap(
-          page_ranges_[page_range_index(data_block_page_indices1)],
-          page_ranges_[page_range_index(data_block_page_indices2)]);
+        swap(page_ranges_[page_range_index1], page_ranges_[page_range_index2]);
+        std::vector<bool>::swap(is_zero_page_[page_range_index1], is_zero_page_[page_range_index2]);
       }
 
+      // The values of the buffer are not tracked, so the page is no longer known to have only zeros
       template <typename DataBlockIndex, typename PageIndex>
       void swap_buffer_and_page(
         std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices)
       {
+        auto const the_page_range_index = page_range_index(data_block_page_indices);
         using std::swap;
-        swap(buffer_range_, page_ranges_[page_range_index(data_block_page_indices)]);
+        swap(buffer_range_, page_ranges_[the_page_range_index]);
+        is_zero_page_[the_page_range_index] = false;
       }
 
       template <typename DataBlockIndex, typename PageIndex, typename NonpageIndex>
@@ -309,16 +370,46 @@ namespace ket
           nonpage_index2 >= decltype(nonpage_index2){0u}
           and nonpage_index2 < ::ket::utility::integer_exp2<size_type>(num_local_qubits_ - num_page_qubits_));
 
+        auto const page_range_index1 = page_range_index(data_block_page_nonpage_indices1);
+        auto const page_range_index2 = page_range_index(data_block_page_nonpage_indices2);
         using std::swap;
         swap(
-          std::begin(page_ranges_[page_range_index(data_block_page_nonpage_indices1)])[nonpage_index1],
-          std::begin(page_ranges_[page_range_index(data_block_page_nonpage_indices2)])[nonpage_index2]);
+          std::begin(page_ranges_[page_range_index1])[nonpage_index1],
+          std::begin(page_ranges_[page_range_index2])[nonpage_index2]);
+        is_zero_page_[page_range_index1] = false;
+        is_zero_page_[page_range_index2] = false;
       }
 
+      // Values written through page_range() are not tracked. Code writing them should unmark the page unless it
+      // keeps a page of zeros zero, as gates do
       template <typename DataBlockIndex, typename PageIndex>
       page_range_type const& page_range(std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices) const
       { return page_ranges_[page_range_index(data_block_page_indices)]; }
 
+      template <typename DataBlockIndex, typename PageIndex>
+      bool is_zero_page(std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices) const
+      { return is_zero_page_[page_range_index(data_block_page_indices)]; }
+
+      template <typename DataBlockIndex, typename PageIndex>
+      void mark_zero_page(std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices)
+      {
+        is_zero_page_[page_range_index(data_block_page_indices)] = true;
+        may_have_zero_pages_ = true;
+      }
+
+      template <typename DataBlockIndex, typename PageIndex>
+      void unmark_zero_page(std::pair<DataBlockIndex, PageIndex> const& data_block_page_indices)
+      { is_zero_page_[page_range_index(data_block_page_indices)] = false; }
+
+      void unmark_zero_pages() noexcept
+      {
+        if (not may_have_zero_pages_)
+          return;
+
+        std::fill(std::begin(is_zero_page_), std::end(is_zero_page_), false);
+        may_have_zero_pages_ = false;
+      }
+
       page_range_type const& buffer_range() const
       { return buffer_range_; }
 
@@ -331,9 +422,10 @@ namespace ket
       { return num_local_qubits_ == other.num_local_qubits_ and num_data_blocks_ == other.num_data_blocks_ and std::equal(begin(), end(), other.begin()); }
       bool operator<(state const& other) const noexcept { return std::lexicographical_compare(begin(), end(), other.begin(), other.end()); }
 
-      // Element access
+      // Element access. Values written through non-const references are not tracked, so zero pages are forgotten
       reference at(size_type const index)
       {
+        unmark_zero_pages();
         return data_.at(
           (std::begin(page_ranges_[page_range_index(get_data_block_page_indices(index))]) - std::begin(data_))
           + get_nonpage_index(index));
@@ -349,6 +441,7 @@ namespace ket
       reference operator[](size_type const index)
       {
         assert(index < ::ket::utility::integer_exp2<size_type>(num_local_qubits_) * num_data_blocks_);
+        unmark_zero_pages();
         return std::begin(page_ranges_[page_range_index(get_data_block_page_indices(index))])[get_nonpage_index(index)];
       }
 
@@ -358,18 +451,20 @@ namespace ket
         return std::begin(page_ranges_[page_range_index(get_data_block_page_indices(index))])[get_nonpage_index(index)];
       }
 
-      reference front() { return *std::begin(page_ranges_[page_range_index(get_data_block_page_indices(0u))]); }
+      reference front() { unmark_zero_pages(); return *std::begin(page_ranges_[page_range_index(get_data_block_page_indices(0u))]); }
       const_reference front() const { return *std::begin(page_ranges_[page_range_index(get_data_block_page_indices(0u))]); }
 
-      reference back() { return *--std::end(page_ranges_[page_range_index(get_data_block_page_indices((1u << num_local_qubits_) - 1u))]); }
+      reference back() { unmark_zero_pages(); return *--std::end(page_ranges_[page_range_index(get_data_block_page_indices((1u << num_local_qubits_) - 1u))]); }
       const_reference back() const { return *--std::end(page_ranges_[page_range_index(get_data_block_page_indices((1u << num_local_qubits_) - 1u))]); }
 
-      // Iterators
-      iterator begin() noexcept { return iterator{*this, 0}; }
+      // Iterators. As with the element access, non-const begin() and end() forget all the zero pages even if only a
+      // few values are written. Tracking the written pages would make every dereference write a flag, which is shared
+      // by the threads of a parallel loop. Readers should use the const overloads, and gates use page_range()
+      iterator begin() noexcept { unmark_zero_pages(); return iterator{*this, 0}; }
       const_iterator begin() const noexcept { return const_iterator{*this, 0}; }
       const_iterator cbegin() const noexcept { return const_iterator{*this, 0}; }
       iterator end() noexcept
-      { return iterator{*this, static_cast<int>(1u << num_local_qubits_)}; }
+      { unmark_zero_pages(); return iterator{*this, static_cast<int>(1u << num_local_qubits_)}; }
       const_iterator end() const noexcept
       { return const_iterator{*this, static_cast<int>(1u << num_local_qubits_)}; }
       const_iterator cend() const noexcept
@@ -394,7 +489,8 @@ namespace ket
           KET_is_nothrow_swappable<data_type>::value
           and KET_is_nothrow_swappable<std::size_t>::value
           and KET_is_nothrow_swappable<std::vector<page_range_type>>::value
-          and KET_is_nothrow_swappable<page_range_type>::value )
+          and KET_is_nothrow_swappable<page_range_type>::value
+          and KET_is_nothrow_swappable<std::vector<bool>>::value )
       {
         using std::swap;
         swap(data_, other.data_);
@@ -405,6 +501,8 @@ namespace ket
         swap(num_data_blocks_, other.num_data_blocks_);
         swap(page_ranges_, other.page_ranges_);
         swap(buffer_range_, other.buffer_range_);
+        swap(is_zero_page_, other.is_zero_page_);
+        swap(may_have_zero_pages_, other.may_have_zero_pages_);
       }
 
      private:
@@ -427,10 +525,10 @@ namespace ket
       }
 
       template <
-        typename MpiPolicy, typename BitInteger, typename StateInteger,
+        typename MpiPolicy, typename ParallelPolicy, typename BitInteger, typename StateInteger,
         typename PermutationAllocator>
       data_type generate_initial_data(
-        MpiPolicy const& mpi_policy,
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
         BitInteger const num_local_qubits, StateInteger const num_pages,
         StateInteger const initial_integer,
         ::ket::mpi::qubit_permutation<
@@ -448,8 +546,12 @@ namespace ket
 
         assert(state_size % (num_pages * num_data_blocks) == 0);
 
-        result.reserve(result_size);
-        result.assign(state_size, value_type{0});
+        // resize does not touch the memory if allocator_type is ket::utility::uninitialized_allocator
+        result.resize(result_size);
+        ::ket::utility::interleave_pages(result);
+        ::ket::utility::fill(parallel_policy, std::begin(result), std::end(result), value_type{0});
+        // qubit_value_to_rank_index requires the size without the buffer. Shrinking does not reallocate the memory
+        result.resize(state_size);
 
         using ::ket::mpi::permutate_bits;
         auto const rank_index
@@ -460,7 +562,7 @@ namespace ket
         if (communicator.rank(environment) == rank_index.first)
           result[rank_index.second] = value_type{1};
 
-        result.resize(result_size);
+        result.resize(result_size, value_type{0});
         return result;
       }
 
@@ -491,6 +593,20 @@ namespace ket
           std::begin(data) + (num_pages * num_data_blocks + 1u) * page_size);
       }
 
+      std::vector<bool> generate_initial_zero_page_flags() const
+      {
+        auto result = std::vector<bool>(page_ranges_.size());
+        std::transform(
+          std::begin(page_ranges_), std::end(page_ranges_), std::begin(result),
+          [](page_range_type const& page_range)
+          {
+            return std::all_of(
+              std::begin(page_range), std::end(page_range),
+              [](value_type const value) { return value == value_type{0}; });
+          });
+        return result;
+      }
+
      public:
       std::pair<size_type, size_type> get_data_block_page_indices(size_type const index) const
       {
@@ -623,21 +739,27 @@ namespace ket
             = (StateInteger{1u} << (minmax_permutated_qubits.second - num_nonpage_local_qubits))
               bitor page_index0;
 
-          for (auto nonpage_value_wo_qubits = StateInteger{0u};
-               nonpage_value_wo_qubits < ::ket::utility::integer_exp2<StateInteger>(static_cast<StateInteger>(num_nonpage_local_qubits - 1u));
-               ++nonpage_value_wo_qubits)
+          for (auto data_block_index = StateInteger{0u};
+               data_block_index < local_state.num_data_blocks(); ++data_block_index)
           {
-            auto const nonpage_index0
-              = ((nonpage_value_wo_qubits bitand nonpage_upper_bits_mask) << 1u)
-                bitor (nonpage_value_wo_qubits bitand nonpage_lower_bits_mask);
-            auto const nonpage_index1
-              = nonpage_index0 bitor (StateInteger{1u} << minmax_permutated_qubits.first);
-
-            for (auto data_block_index = StateInteger{0u};
-                 data_block_index < local_state.num_data_blocks(); ++data_block_index)
+            if (local_state.is_zero_page(std::make_pair(data_block_index, page_index0))
+                and local_state.is_zero_page(std::make_pair(data_block_index, page_index1)))
+              continue;
+
+            for (auto nonpage_value_wo_qubits = StateInteger{0u};
+                 nonpage_value_wo_qubits < ::ket::utility::integer_exp2<StateInteger>(static_cast<StateInteger>(num_nonpage_local_qubits - 1u));
+                 ++nonpage_value_wo_qubits)
+            {
+              auto const nonpage_index0
+                = ((nonpage_value_wo_qubits bitand nonpage_upper_bits_mask) << 1u)
+                  bitor (nonpage_value_wo_qubits bitand nonpage_lower_bits_mask);
+              auto const nonpage_index1
+                = nonpage_index0 bitor (StateInteger{1u} << minmax_permutated_qubits.first);
+
               local_state.swap_values(
                 std::make_tuple(data_block_index, page_index0, nonpage_index1),
                 std::make_tuple(data_block_index, page_index1, nonpage_index0));
+            }
           }
         }
       }
@@ -732,7 +854,7 @@ namespace ket
           StateInteger const source_local_first_index,
           StateInteger const source_local_last_index,
           yampi::rank const target_rank,
-          yampi::communicator const& communicator, yampi::environment const& environment)
+          yampi::communicator const& communicator, yampi::environment const&)
         {
           using page_range_type
             = typename ::ket::mpi::state<Complex, has_page_qubits, Allocator>::page_range_type;
@@ -741,15 +863,12 @@ namespace ket
           do_call(
             local_state, data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
-            [target_rank, &communicator, &environment](
-              page_iterator const first, page_iterator const last,
-              page_iterator const buffer_first, page_iterator const buffer_last)
+            [target_rank, &communicator](
+              page_iterator const first, page_iterator const last, bool const is_zero,
+              page_iterator const receive_first)
             {
-              yampi::algorithm::swap(
-                yampi::ignore_status(),
-                yampi::make_buffer(first, last),
-                yampi::make_buffer(buffer_first, buffer_last),
-                target_rank, communicator, environment);
+              return ::ket::mpi::utility::detail::swap_unless_zero(
+                first, last, is_zero, receive_first, target_rank, communicator);
             });
         }
 
@@ -763,7 +882,7 @@ namespace ket
           StateInteger const source_local_first_index,
           StateInteger const source_local_last_index,
           yampi::datatype_base<DerivedDatatype> const& datatype, yampi::rank const target_rank,
-          yampi::communicator const& communicator, yampi::environment const& environment)
+          yampi::communicator const& communicator, yampi::environment const&)
         {
           using page_range_type
             = typename ::ket::mpi::state<Complex, has_page_qubits, Allocator>::page_range_type;
@@ -772,26 +891,26 @@ namespace ket
           do_call(
             local_state, data_block_index, data_block_size,
             source_local_first_index, source_local_last_index,
-            [&datatype, target_rank, &communicator, &environment](
-              page_iterator const first, page_iterator const last,
-              page_iterator const buffer_first, page_iterator const buffer_last)
+            [&datatype, target_rank, &communicator](
+              page_iterator const first, page_iterator const last, bool const is_zero,
+              page_iterator const receive_first)
             {
-              yampi::algorithm::swap(
-                yampi::ignore_status(),
-                yampi::make_buffer(first, last, datatype),
-                yampi::make_buffer(buffer_first, buffer_last, datatype),
-                target_rank, communicator, environment);
+              return ::ket::mpi::utility::detail::swap_unless_zero(
+                first, last, is_zero, receive_first, datatype, target_rank, communicator);
             });
         }
 
        private:
+        // swap_unless_zero(first, last, is_zero, receive_first) exchanges the ranges and returns false if the
+        // target range is a zero page. A zero page is sent as an empty message, so the zero page flags come with
+        // the data instead of by another exchange, though a pair of zero pages still costs an empty exchange
         template <
-          typename Allocator, typename Complex, typename StateInteger, typename Function>
+          typename Allocator, typename Complex, typename StateInteger, typename SwapUnlessZeroFunction>
         static void do_call(
           ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
           StateInteger const data_block_index, StateInteger const data_block_size,
           StateInteger const source_local_first_index, StateInteger const source_local_last_index,
-          Function&& yampi_swap)
+          SwapUnlessZeroFunction&& swap_unless_zero)
         {
           assert(data_block_index >= StateInteger{0u} and data_block_index < local_state.num_data_blocks());
           assert(data_block_size == ::ket::utility::integer_exp2<std::size_t>(local_state.num_local_qubits()));
@@ -812,7 +931,10 @@ namespace ket
 
           for (auto page_index = front_page_index; page_index <= back_page_index; ++page_index)
           {
-            auto const page_range = local_state.page_range(std::make_pair(data_block_index, page_index));
+            auto const data_block_page_indices = std::make_pair(data_block_index, page_index);
+            auto const is_zero_page = local_state.is_zero_page(data_block_page_indices);
+
+            auto const page_range = local_state.page_range(data_block_page_indices);
             auto const page_size = boost::size(page_range);
 
             auto const page_first = std::begin(page_range);
@@ -833,12 +955,32 @@ namespace ket
             auto const the_buffer_first = buffer_first + first_index;
             auto const the_buffer_last = buffer_first + last_index;
 
+            // A zero page receives the data in place. Its empty message is sent from the buffer, which does not
+            // overlap the receiving range
+            auto const is_target_nonzero_page
+              = is_zero_page
+                ? swap_unless_zero(the_buffer_first, the_buffer_last, true, the_first)
+                : swap_unless_zero(the_first, the_last, false, the_buffer_first);
+
+            if (is_zero_page)
+            {
+              if (is_target_nonzero_page)
+                local_state.unmark_zero_page(data_block_page_indices);
+              continue;
+            }
+
+            if (not is_target_nonzero_page)
+            {
+              std::fill(the_first, the_last, Complex{0});
+              if (first_index == StateInteger{0u} and last_index == static_cast<StateInteger>(page_size))
+                local_state.mark_zero_page(data_block_page_indices);
+              continue;
+            }
+
             std::copy(page_first, the_first, buffer_first);
             std::copy(the_last, page_last, the_buffer_last);
 
-            yampi_swap(the_first, the_last, the_buffer_first, the_buffer_last);
-
-            local_state.swap_buffer_and_page(std::make_pair(data_block_index, page_index));
+            local_state.swap_buffer_and_page(data_block_page_indices);
           }
         }
       }; // struct interchange_qubits<has_page_qubits>
@@ -883,6 +1025,34 @@ namespace ket
         }
       }; // struct for_each_local_range<has_page_qubits>
 
+      template <bool has_page_qubits>
+      struct for_each_nonzero_local_range
+      {
+        template <typename MpiPolicy, typename Complex, typename Allocator, typename Function>
+        static ::ket::mpi::state<Complex, has_page_qubits, Allocator>& call(
+          MpiPolicy const&,
+          ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
+          yampi::communicator const&, yampi::environment const&,
+          Function&& function)
+        {
+          // Gates should not be on page qubits
+          auto const num_data_blocks = local_state.num_data_blocks();
+          auto const num_pages = local_state.num_pages();
+          for (auto data_block_index = std::size_t{0u}; data_block_index < num_data_blocks; ++data_block_index)
+            for (auto page_index = std::size_t{0u}; page_index < num_pages; ++page_index)
+            {
+              auto const data_block_page_indices = std::make_pair(data_block_index, page_index);
+              if (local_state.is_zero_page(data_block_page_indices))
+                continue;
+
+              function(
+                std::begin(local_state.page_range(data_block_page_indices)),
+                std::end(local_state.page_range(data_block_page_indices)));
+            }
+          return local_state;
+        }
+      }; // struct for_each_nonzero_local_range<has_page_qubits>
+
       template <bool has_page_qubits>
       struct swap_local_data
       {
@@ -936,6 +1106,13 @@ namespace ket
               auto const page_range1 = local_state.page_range(data_block_page_indices1);
               auto const page_range2 = local_state.page_range(data_block_page_indices2);
 
+              if ((page_index1 == front_page_index1 and first1 != std::begin(page_range1))
+                  or (page_index1 == back_page_index1 and last1 != std::end(page_range1)))
+              {
+                local_state.unmark_zero_page(data_block_page_indices1);
+                local_state.unmark_zero_page(data_block_page_indices2);
+              }
+
               if (page_index1 == front_page_index1)
                 std::swap_ranges(std::begin(page_range1), first1, std::begin(page_range2));
 
@@ -957,8 +1134,13 @@ namespace ket
 
             while (true)
             {
-              auto const page_range1 = local_state.page_range(std::make_pair(data_block_index1, page_index1));
-              auto const page_range2 = local_state.page_range(std::make_pair(data_block_index2, page_index2));
+              auto const data_block_page_indices1 = std::make_pair(data_block_index1, page_index1);
+              auto const data_block_page_indices2 = std::make_pair(data_block_index2, page_index2);
+              local_state.unmark_zero_page(data_block_page_indices1);
+              local_state.unmark_zero_page(data_block_page_indices2);
+
+              auto const page_range1 = local_state.page_range(data_block_page_indices1);
+              auto const page_range2 = local_state.page_range(data_block_page_indices2);
 
               auto const the_last1 = page_index1 == back_page_index1 ? last1 : std::end(page_range1);
               auto const the_last2 = page_index2 == back_page_index2 ? last2 : std::end(page_range2);
@@ -1066,6 +1248,10 @@ namespace ket
           auto const num_pages = local_state.num_pages();
           for (auto page_index = std::size_t{0u}; page_index < num_pages; ++page_index)
           {
+            // function only multiplies values by coefficients
+            if (local_state.is_zero_page(std::make_pair(data_block_index, page_index)))
+              continue;
+
             auto const first = std::begin(local_state.page_range(std::make_pair(data_block_index, page_index)));
             using ::ket::utility::loop_n;
             loop_n(
@@ -1460,7 +1646,7 @@ namespace ket
           ::ket::utility::barrier(parallel_policy, executor);
 
           ::ket::utility::single_execute(
-            parallel_policy, executor,
+            parallel_policy, executor, thread_index,
             [&partial_sums, binary_operation]
             {
               std::partial_sum(
@@ -2010,7 +2196,7 @@ namespace ket
           ::ket::utility::barrier(parallel_policy, executor);
 
           ::ket::utility::single_execute(
-            parallel_policy, executor,
+            parallel_policy, executor, thread_index,
             [&partial_sums, binary_operation]
             {
               std::partial_sum(
@@ -2152,7 +2338,9 @@ namespace ket
       using allocator_type = typename Allocator::template rebind<value_type>::other;
 
      private:
-      using data_type = std::vector<value_type, allocator_type>;
+      // std::vector<value_type, allocator_type>, or ket::utility::planar_complex_vector if Allocator is
+      // ket::utility::planar_allocator
+      using data_type = typename ::ket::utility::meta::complex_container_of<value_type, allocator_type>::type;
       data_type data_;
 
       std::size_t num_local_qubits_;
@@ -2211,7 +2399,7 @@ namespace ket
         yampi::communicator const& communicator,
         yampi::environment const& environment)
         : data_{generate_initial_data(
-            ::ket::mpi::utility::policy::make_general_mpi(),
+            ::ket::mpi::utility::policy::make_general_mpi(), ::ket::utility::policy::make_sequential(),
             num_local_qubits, initial_integer, permutation, communicator, environment)},
           num_local_qubits_{num_local_qubits},
           num_data_blocks_{1u}
@@ -2226,7 +2414,27 @@ namespace ket
         yampi::communicator const& communicator,
         yampi::environment const& environment)
         : data_{generate_initial_data(
-            mpi_policy, num_local_qubits, initial_integer, permutation, communicator, environment)},
+            mpi_policy, ::ket::utility::policy::make_sequential(),
+            num_local_qubits, initial_integer, permutation, communicator, environment)},
+          num_local_qubits_{num_local_qubits},
+          num_data_blocks_{::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment)}
+      { }
+
+      // The amplitudes are first touched by the threads of parallel_policy in the same static partition as loop_n in
+      // gates (see the paged state)
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename BitInteger, typename StateInteger, typename PermutationAllocator>
+      state(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        BitInteger const num_local_qubits, StateInteger const initial_integer,
+        ::ket::mpi::qubit_permutation<
+          StateInteger, BitInteger, PermutationAllocator> const&
+          permutation,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+        : data_{generate_initial_data(
+            mpi_policy, parallel_policy, num_local_qubits, initial_integer, permutation, communicator, environment)},
           num_local_qubits_{num_local_qubits},
           num_data_blocks_{::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment)}
       { }
@@ -2282,20 +2490,25 @@ namespace ket
       data_type const& data() const { return data_; }
 
      private:
-      template <typename MpiPolicy, typename BitInteger, typename StateInteger, typename PermutationAllocator>
+      template <
+        typename MpiPolicy, typename ParallelPolicy,
+        typename BitInteger, typename StateInteger, typename PermutationAllocator>
       data_type generate_initial_data(
-        MpiPolicy const& mpi_policy, BitInteger const num_local_qubits, StateInteger const initial_integer,
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        BitInteger const num_local_qubits, StateInteger const initial_integer,
         ::ket::mpi::qubit_permutation<
           StateInteger, BitInteger, PermutationAllocator> const&
           permutation,
         yampi::communicator const& communicator,
         yampi::environment const& environment) const
       {
-        auto result
-          = data_type(
-              ::ket::utility::integer_exp2<std::size_t>(num_local_qubits)
-                * ::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment),
-              value_type{0});
+        // resize does not touch the memory if allocator_type is ket::utility::uninitialized_allocator
+        auto result = data_type{};
+        result.resize(
+          ::ket::utility::integer_exp2<std::size_t>(num_local_qubits)
+            * ::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment));
+        ::ket::utility::interleave_pages(result);
+        ::ket::utility::fill(parallel_policy, std::begin(result), std::end(result), value_type{0});
 
         using ::ket::mpi::permutate_bits;
         auto const rank_index
@@ -2448,6 +2661,27 @@ namespace ket
         }
       }; // struct for_each_local_range<false>
 
+      template <>
+      struct for_each_nonzero_local_range<false>
+      {
+        template <
+          typename MpiPolicy,
+          typename Complex, typename Allocator,
+          typename Function>
+        static ::ket::mpi::state<Complex, false, Allocator>& call(
+          MpiPolicy const& mpi_policy,
+          ::ket::mpi::state<Complex, false, Allocator>& local_state,
+          yampi::communicator const& communicator, yampi::environment const& environment,
+          Function&& function)
+        {
+          ::ket::mpi::utility::for_each_local_range(
+            mpi_policy, local_state.data(),
+            communicator, environment, std::forward<Function>(function));
+
+          return local_state;
+        }
+      }; // struct for_each_nonzero_local_range<false>
+
       template <>
       struct swap_local_data<false>
       {
@@ -2614,6 +2848,16 @@ namespace ket
         ::ket::mpi::permutated< ::ket::control< ::ket::qubit<StateInteger, BitInteger> > > const permutated_control_qubit,
         ::ket::mpi::state<Complex, true, Allocator> const& local_state)
       { return ::ket::mpi::is_page_qubit(permutated_control_qubit, local_state); }
+
+      namespace dispatch
+      {
+        template <typename Complex, typename Allocator>
+        struct unmark_zero_pages< ::ket::mpi::state<Complex, true, Allocator> >
+        {
+          static void call(::ket::mpi::state<Complex, true, Allocator>& local_state)
+          { local_state.unmark_zero_pages(); }
+        }; // struct unmark_zero_pages< ::ket::mpi::state<Complex, true, Allocator> >
+      } // namespace dispatch
     } // namespace page
 
     namespace utility
@@ -2716,6 +2960,26 @@ namespace ket
           }
         }; // struct for_each_local_range< ::ket::mpi::state<Complex, has_page_qubits, Allocator> >
 
+        template <typename LocalState_>
+        struct for_each_nonzero_local_range;
+
+        template <typename Complex, bool has_page_qubits, typename Allocator>
+        struct for_each_nonzero_local_range< ::ket::mpi::state<Complex, has_page_qubits, Allocator> >
+        {
+          template <typename MpiPolicy, typename Function>
+          static ::ket::mpi::state<Complex, has_page_qubits, Allocator>& call(
+            MpiPolicy const& mpi_policy,
+            ::ket::mpi::state<Complex, has_page_qubits, Allocator>& local_state,
+            yampi::communicator const& communicator, yampi::environment const& environment,
+            Function&& function)
+          {
+            using for_each_nonzero_local_range_type
+              = ::ket::mpi::state_detail::for_each_nonzero_local_range<has_page_qubits>;
+            return for_each_nonzero_local_range_type::call(
+              mpi_policy, local_state, communicator, environment, std::forward<Function>(function));
+          }
+        }; // struct for_each_nonzero_local_range< ::ket::mpi::state<Complex, has_page_qubits, Allocator> >
+
         template <typename LocalState_>
         struct swap_local_data;
 
@@ -2827,6 +3091,9 @@ namespace ket
             BinaryOperation binary_operation, UnaryOperation unary_operation,
             yampi::environment const& environment)
           {
+            // partial sums are not zero even in zero pages
+            ::ket::mpi::page::unmark_zero_pages(local_state);
+
             using transform_inclusive_scan_self_type
               = ::ket::mpi::state_detail::transform_inclusive_scan_self<has_page_qubits>;
             return transform_inclusive_scan_self_type::call(
@@ -2843,6 +3110,9 @@ namespace ket
             BinaryOperation binary_operation, UnaryOperation unary_operation,
             Complex const initial_value, yampi::environment const& environment)
           {
+            // partial sums are not zero even in zero pages
+            ::ket::mpi::page::unmark_zero_pages(local_state);
+
             using transform_inclusive_scan_self_type
               = ::ket::mpi::state_detail::transform_inclusive_scan_self<has_page_qubits>;
             return transform_inclusive_scan_self_type::call(
@@ -3,10 +3,15 @@
 
 # include <cassert>
 # include <cstddef>
+# include <cmath>
 # include <iterator>
 # include <type_traits>
 # include <vector>
+# include <array>
+# include <algorithm>
+# include <utility>
 
+# include <boost/math/constants/constants.hpp>
 # include <boost/range/size.hpp>
 # include <boost/range/value_type.hpp>
 
@@ -15,14 +20,16 @@
 # include <yampi/communicator.hpp>
 
 # include <ket/qubit.hpp>
-# include <ket/control.hpp>
 # include <ket/utility/generate_phase_coefficients.hpp>
+# include <ket/utility/exp_i.hpp>
 # include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/real_of.hpp>
+# include <ket/mpi/permutated.hpp>
 # include <ket/mpi/qubit_permutation.hpp>
 # include <ket/mpi/gate/hadamard.hpp>
-# include <ket/mpi/gate/controlled_phase_shift.hpp>
+# include <ket/mpi/gate/diagonal.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/remap_qubits.hpp>
 # include <ket/mpi/utility/logger.hpp>
 # include <ket/utility/integer_exp2.hpp>
 # ifndef NDEBUG
@@ -34,6 +41,130 @@ namespace ket
 {
   namespace mpi
   {
+    // swapped_fourier_transform: the target qubit of each Hadamard gate has to be local, but the controlled phase
+    //   shifts on the same target qubit form one diagonal gate, which needs no communication (see
+    //   ket::mpi::gate::diagonal). When the next target qubit is global, it is made local together with the following
+    //   global target qubits by ket::mpi::utility::remap_nonlocal_qubits, which exchanges all of them at once. The
+    //   evicted qubits are the local qubits which are not targets anymore, or the local target qubits transformed last.
+    //   For example, if n qubits are transformed and the lower n/2 of them are local, the state is exchanged twice
+    //   instead of n/2 times
+    namespace swapped_fourier_transform_detail
+    {
+      constexpr std::size_t num_twiddle_table_bits = 10u;
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename ForwardIterator,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline void make_first_target_local(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, ForwardIterator const first, ForwardIterator const last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        if (permutation[*first] < ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> >{num_local_qubits})
+          return;
+
+        ::ket::mpi::utility::remap_nonlocal_qubits(
+          mpi_policy, parallel_policy, local_state, first, last, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename ForwardIterator,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline void make_first_target_local(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, ForwardIterator const first, ForwardIterator const last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+        if (permutation[*first] < ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> >{num_local_qubits})
+          return;
+
+        ::ket::mpi::utility::remap_nonlocal_qubits(
+          mpi_policy, parallel_policy, local_state, first, last, permutation, buffer, datatype,
+          communicator, environment);
+      }
+
+      // twiddle_coefficient_function: the product of the controlled phase shifts on qubits_first[target_bit] whose
+      //   control qubits are qubits_first[0], ..., qubits_first[target_bit - 1], that is, exp(+-2 pi i v / 2^(n+1))
+      //   if the target qubit is 1, where n is target_bit and v is the value of the control qubits.
+      //   It is the product of ceil(n / num_twiddle_table_bits) table lookups
+      template <typename Complex, typename StateInteger, typename BitInteger>
+      class twiddle_coefficient_function
+      {
+        StateInteger target_mask_;
+        std::vector<BitInteger> permutated_control_bits_;
+        std::vector<Complex> tables_;
+
+       public:
+        template <typename RandomAccessIterator, typename Allocator>
+        twiddle_coefficient_function(
+          RandomAccessIterator const qubits_first, std::size_t const target_bit,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+          bool const is_adjoint)
+          : target_mask_{StateInteger{1u} << static_cast<BitInteger>(permutation[qubits_first[target_bit]].qubit())},
+            permutated_control_bits_(target_bit),
+            tables_{}
+        {
+          for (auto control_bit = std::size_t{0u}; control_bit < target_bit; ++control_bit)
+            permutated_control_bits_[control_bit]
+              = static_cast<BitInteger>(permutation[qubits_first[control_bit]].qubit());
+
+          using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
+          using boost::math::constants::two_pi;
+          auto const phase_unit = is_adjoint ? -two_pi<real_type>() : two_pi<real_type>();
+          for (auto first_bit = std::size_t{0u}; first_bit < target_bit; first_bit += num_twiddle_table_bits)
+          {
+            auto const num_bits = std::min(num_twiddle_table_bits, target_bit - first_bit);
+            for (auto value = std::size_t{0u}; value < (std::size_t{1u} << num_bits); ++value)
+              tables_.push_back(
+                ::ket::utility::exp_i<Complex>(
+                  phase_unit
+                  * std::ldexp(
+                      static_cast<real_type>(value),
+                      static_cast<int>(first_bit) - static_cast<int>(target_bit) - 1)));
+          }
+        }
+
+        Complex operator()(StateInteger const value) const
+        {
+          using real_type = typename ::ket::utility::meta::real_of<Complex>::type;
+          auto result = Complex{real_type{1}};
+          if ((value bitand target_mask_) == StateInteger{0u})
+            return result;
+
+          auto const num_control_bits = permutated_control_bits_.size();
+          auto table_first = std::size_t{0u};
+          for (auto first_bit = std::size_t{0u}; first_bit < num_control_bits; first_bit += num_twiddle_table_bits)
+          {
+            auto const last_bit = std::min(first_bit + num_twiddle_table_bits, num_control_bits);
+            auto index = std::size_t{0u};
+            for (auto bit = first_bit; bit < last_bit; ++bit)
+              index
+                |= static_cast<std::size_t>((value >> permutated_control_bits_[bit]) bitand StateInteger{1u})
+                   << (bit - first_bit);
+
+            result *= tables_[table_first + index];
+            table_first += std::size_t{1u} << (last_bit - first_bit);
+          }
+
+          return result;
+        }
+      }; // class twiddle_coefficient_function<Complex, StateInteger, BitInteger>
+    } // namespace swapped_fourier_transform_detail
+
     template <
       typename MpiPolicy, typename ParallelPolicy,
       typename RandomAccessRange, typename Qubits, typename PhaseCoefficientsAllocator,
@@ -68,28 +199,34 @@ namespace ket
 
       auto const qubits_first = std::begin(qubits);
 
+      // targets: the target qubits in the order of the transform
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      auto targets = std::vector<qubit_type>(qubits_first, qubits_first + num_qubits);
+      std::reverse(std::begin(targets), std::end(targets));
+
+      using complex_type = typename boost::range_value<RandomAccessRange>::type;
       for (auto index = decltype(num_qubits){0u}; index < num_qubits; ++index)
       {
         auto target_bit = num_qubits - index - decltype(num_qubits){1u};
 
+        ::ket::mpi::swapped_fourier_transform_detail::make_first_target_local(
+          mpi_policy, parallel_policy, local_state, std::begin(targets) + index, std::end(targets), permutation,
+          buffer, communicator, environment);
+
         using ::ket::mpi::gate::hadamard;
         hadamard(
           mpi_policy, parallel_policy,
           local_state, qubits_first[target_bit], permutation,
           buffer, communicator, environment);
 
-        for (auto phase_exponent = decltype(num_qubits){2u};
-             phase_exponent <= num_qubits - index; ++phase_exponent)
-        {
-          auto const control_bit = target_bit - (phase_exponent - decltype(phase_exponent){1u});
-
-          using ::ket::mpi::gate::controlled_phase_shift_coeff;
-          controlled_phase_shift_coeff(
-            mpi_policy, parallel_policy,
-            local_state, phase_coefficients[phase_exponent],
-            qubits_first[target_bit], ::ket::make_control(qubits_first[control_bit]),
-            permutation, buffer, communicator, environment);
-        }
+        if (target_bit == decltype(target_bit){0u})
+          continue;
+
+        ::ket::mpi::gate::diagonal(
+          mpi_policy, parallel_policy, local_state,
+          ::ket::mpi::swapped_fourier_transform_detail::twiddle_coefficient_function<
+            complex_type, StateInteger, BitInteger>{qubits_first, target_bit, permutation, false},
+          communicator, environment);
       }
 
       return local_state;
@@ -131,28 +268,34 @@ namespace ket
 
       auto const qubits_first = std::begin(qubits);
 
+      // targets: the target qubits in the order of the transform
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      auto targets = std::vector<qubit_type>(qubits_first, qubits_first + num_qubits);
+      std::reverse(std::begin(targets), std::end(targets));
+
+      using complex_type = typename boost::range_value<RandomAccessRange>::type;
       for (auto index = decltype(num_qubits){0u}; index < num_qubits; ++index)
       {
         auto target_bit = num_qubits - index - decltype(num_qubits){1u};
 
+        ::ket::mpi::swapped_fourier_transform_detail::make_first_target_local(
+          mpi_policy, parallel_policy, local_state, std::begin(targets) + index, std::end(targets), permutation,
+          buffer, datatype, communicator, environment);
+
         using ::ket::mpi::gate::hadamard;
         hadamard(
           mpi_policy, parallel_policy,
           local_state, qubits_first[target_bit], permutation,
           buffer, datatype, communicator, environment);
 
-        for (auto phase_exponent = decltype(num_qubits){2u};
-             phase_exponent <= num_qubits - index; ++phase_exponent)
-        {
-          auto const control_bit = target_bit - (phase_exponent - decltype(phase_exponent){1u});
-
-          using ::ket::mpi::gate::controlled_phase_shift_coeff;
-          controlled_phase_shift_coeff(
-            mpi_policy, parallel_policy,
-            local_state, phase_coefficients[phase_exponent],
-            qubits_first[target_bit], ::ket::make_control(qubits_first[control_bit]),
-            permutation, buffer, datatype, communicator, environment);
-        }
+        if (target_bit == decltype(target_bit){0u})
+          continue;
+
+        ::ket::mpi::gate::diagonal(
+          mpi_policy, parallel_policy, local_state,
+          ::ket::mpi::swapped_fourier_transform_detail::twiddle_coefficient_function<
+            complex_type, StateInteger, BitInteger>{qubits_first, target_bit, permutation, false},
+          communicator, environment);
       }
 
       return local_state;
@@ -473,20 +616,23 @@ namespace ket
 
       auto const qubits_first = std::begin(qubits);
 
+      // targets: the target qubits in the order of the transform
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      auto const targets = std::vector<qubit_type>(qubits_first, qubits_first + num_qubits);
+
+      using complex_type = typename boost::range_value<RandomAccessRange>::type;
       for (auto target_bit = decltype(num_qubits){0u}; target_bit < num_qubits; ++target_bit)
       {
-        for (auto index = decltype(target_bit){0u}; index < target_bit; ++index)
-        {
-          auto const phase_exponent = decltype(target_bit){1u} + target_bit - index;
-          auto const control_bit = target_bit - (phase_exponent - decltype(phase_exponent){1u});
-
-          using ::ket::mpi::gate::adj_controlled_phase_shift_coeff;
-          adj_controlled_phase_shift_coeff(
-            mpi_policy, parallel_policy,
-            local_state, phase_coefficients[phase_exponent], qubits_first[target_bit],
-            ::ket::make_control(qubits_first[control_bit]),
-            permutation, buffer, communicator, environment);
-        }
+        ::ket::mpi::swapped_fourier_transform_detail::make_first_target_local(
+          mpi_policy, parallel_policy, local_state, std::begin(targets) + target_bit, std::end(targets), permutation,
+          buffer, communicator, environment);
+
+        if (target_bit > decltype(target_bit){0u})
+          ::ket::mpi::gate::diagonal(
+            mpi_policy, parallel_policy, local_state,
+            ::ket::mpi::swapped_fourier_transform_detail::twiddle_coefficient_function<
+              complex_type, StateInteger, BitInteger>{qubits_first, target_bit, permutation, true},
+            communicator, environment);
 
         using ::ket::mpi::gate::adj_hadamard;
         adj_hadamard(
@@ -534,20 +680,23 @@ namespace ket
 
       auto const qubits_first = std::begin(qubits);
 
+      // targets: the target qubits in the order of the transform
+      using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+      auto const targets = std::vector<qubit_type>(qubits_first, qubits_first + num_qubits);
+
+      using complex_type = typename boost::range_value<RandomAccessRange>::type;
       for (auto target_bit = decltype(num_qubits){0u}; target_bit < num_qubits; ++target_bit)
       {
-        for (auto index = decltype(target_bit){0u}; index < target_bit; ++index)
-        {
-          auto const phase_exponent = decltype(target_bit){1u} + target_bit - index;
-          auto const control_bit = target_bit - (phase_exponent - decltype(phase_exponent){1u});
-
-          using ::ket::mpi::gate::adj_controlled_phase_shift_coeff;
-          adj_controlled_phase_shift_coeff(
-            mpi_policy, parallel_policy,
-            local_state, phase_coefficients[phase_exponent], qubits_first[target_bit],
-            ::ket::make_control(qubits_first[control_bit]),
-            permutation, buffer, datatype, communicator, environment);
-        }
+        ::ket::mpi::swapped_fourier_transform_detail::make_first_target_local(
+          mpi_policy, parallel_policy, local_state, std::begin(targets) + target_bit, std::end(targets), permutation,
+          buffer, datatype, communicator, environment);
+
+        if (target_bit > decltype(target_bit){0u})
+          ::ket::mpi::gate::diagonal(
+            mpi_policy, parallel_policy, local_state,
+            ::ket::mpi::swapped_fourier_transform_detail::twiddle_coefficient_function<
+              complex_type, StateInteger, BitInteger>{qubits_first, target_bit, permutation, true},
+            communicator, environment);
 
         using ::ket::mpi::gate::adj_hadamard;
         adj_hadamard(
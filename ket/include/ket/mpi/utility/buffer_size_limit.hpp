@@ -0,0 +1,26 @@
+#ifndef KET_MPI_UTILITY_BUFFER_SIZE_LIMIT_HPP
+# define KET_MPI_UTILITY_BUFFER_SIZE_LIMIT_HPP
+
+# include <cstddef>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace utility
+    {
+      // maximal number of values of the buffer which is used as extra memory by an exchange of amplitudes between
+      // processes, or 0 if it is not bounded. It is kept apart from the buffers, so resizing a buffer never changes it.
+      // Only the thread calling MPI functions reads it
+      inline std::size_t& buffer_size_limit()
+      {
+        static auto result = std::size_t{0u};
+        return result;
+      }
+    } // namespace utility
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_UTILITY_BUFFER_SIZE_LIMIT_HPP
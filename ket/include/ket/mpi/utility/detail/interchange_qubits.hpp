@@ -2,13 +2,23 @@
 # define KET_MPI_UTILITY_DETAIL_INTERCHANGE_QUBITS_HPP
 
 # include <cassert>
+# include <cstddef>
+# include <cstdint>
+# include <complex>
+# include <array>
+# include <memory>
+# include <limits>
+# include <stdexcept>
 # include <vector>
 # include <iterator>
+# include <algorithm>
 # include <utility>
 # include <type_traits>
 
 # include <boost/range/value_type.hpp>
 
+# include <mpi.h>
+
 # include <yampi/environment.hpp>
 # include <yampi/datatype_base.hpp>
 # include <yampi/communicator.hpp>
@@ -17,6 +27,10 @@
 # include <yampi/status.hpp>
 # include <yampi/algorithm/swap.hpp>
 
+# include <ket/utility/planar_complex_vector.hpp>
+# include <ket/mpi/utility/num_sent_bytes.hpp>
+# include <ket/mpi/utility/buffer_size_limit.hpp>
+
 
 namespace ket
 {
@@ -24,6 +38,267 @@ namespace ket
   {
     namespace utility
     {
+      namespace detail
+      {
+        // yampi_swap(first, last, buffer_first, buffer_last, [datatype,] target_rank, communicator, environment):
+        //   sends [first, last) to target_rank and receives data of target_rank into [buffer_first, buffer_last)
+        template <typename ContiguousIterator, typename BufferIterator>
+        inline void yampi_swap(
+          ContiguousIterator const first, ContiguousIterator const last,
+          BufferIterator const buffer_first, BufferIterator const buffer_last,
+          yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          ::ket::mpi::utility::num_sent_bytes() += static_cast<std::uint64_t>(last - first) * sizeof(*first);
+          yampi::algorithm::swap(
+            yampi::ignore_status(),
+            yampi::make_buffer(first, last),
+            yampi::make_buffer(buffer_first, buffer_last),
+            target_rank, communicator, environment);
+        }
+
+        template <typename ContiguousIterator, typename BufferIterator, typename DerivedDatatype>
+        inline void yampi_swap(
+          ContiguousIterator const first, ContiguousIterator const last,
+          BufferIterator const buffer_first, BufferIterator const buffer_last,
+          yampi::datatype_base<DerivedDatatype> const& datatype, yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          ::ket::mpi::utility::num_sent_bytes() += static_cast<std::uint64_t>(last - first) * sizeof(*first);
+          yampi::algorithm::swap(
+            yampi::ignore_status(),
+            yampi::make_buffer(first, last, datatype),
+            yampi::make_buffer(buffer_first, buffer_last, datatype),
+            target_rank, communicator, environment);
+        }
+
+        // planar data are sent as two contiguous blocks, real parts and imaginary parts
+        template <typename Real>
+        inline void yampi_swap(
+          ::ket::utility::planar_complex_iterator<Real> const first,
+          ::ket::utility::planar_complex_iterator<Real> const last,
+          ::ket::utility::planar_complex_iterator<Real> const buffer_first,
+          ::ket::utility::planar_complex_iterator<Real> const buffer_last,
+          yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          assert(last - first == buffer_last - buffer_first);
+          auto const count = last - first;
+          ::ket::mpi::utility::num_sent_bytes() += static_cast<std::uint64_t>(count) * 2u * sizeof(Real);
+
+          yampi::algorithm::swap(
+            yampi::ignore_status(),
+            yampi::make_buffer(first.real_part_ptr(), first.real_part_ptr() + count),
+            yampi::make_buffer(buffer_first.real_part_ptr(), buffer_first.real_part_ptr() + count),
+            target_rank, communicator, environment);
+          yampi::algorithm::swap(
+            yampi::ignore_status(),
+            yampi::make_buffer(first.imag_part_ptr(), first.imag_part_ptr() + count),
+            yampi::make_buffer(buffer_first.imag_part_ptr(), buffer_first.imag_part_ptr() + count),
+            target_rank, communicator, environment);
+        }
+
+        // datatype describes complex numbers, so it is not used for planar data
+        template <typename Real, typename DerivedDatatype>
+        inline void yampi_swap(
+          ::ket::utility::planar_complex_iterator<Real> const first,
+          ::ket::utility::planar_complex_iterator<Real> const last,
+          ::ket::utility::planar_complex_iterator<Real> const buffer_first,
+          ::ket::utility::planar_complex_iterator<Real> const buffer_last,
+          yampi::datatype_base<DerivedDatatype> const&, yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          ::ket::mpi::utility::detail::yampi_swap(
+            first, last, buffer_first, buffer_last, target_rank, communicator, environment);
+        }
+
+        // byte_datatype: a contiguous MPI datatype of size bytes, which describes one value of the size
+        class byte_datatype
+        {
+          MPI_Datatype mpi_datatype_;
+
+         public:
+          explicit byte_datatype(std::size_t const size)
+            : mpi_datatype_{}
+          {
+            if (MPI_Type_contiguous(static_cast<int>(size), MPI_BYTE, std::addressof(mpi_datatype_)) != MPI_SUCCESS)
+              throw std::runtime_error{"MPI_Type_contiguous failed in ket::mpi::utility::detail::byte_datatype"};
+            if (MPI_Type_commit(std::addressof(mpi_datatype_)) != MPI_SUCCESS)
+            {
+              MPI_Type_free(std::addressof(mpi_datatype_));
+              throw std::runtime_error{"MPI_Type_commit failed in ket::mpi::utility::detail::byte_datatype"};
+            }
+          }
+
+          ~byte_datatype() noexcept { MPI_Type_free(std::addressof(mpi_datatype_)); }
+          byte_datatype(byte_datatype const&) = delete;
+          byte_datatype& operator=(byte_datatype const&) = delete;
+
+          MPI_Datatype mpi_datatype() const noexcept { return mpi_datatype_; }
+        }; // class byte_datatype
+
+        // swap_unless_zero(first, count, is_zero, receive_first, mpi_datatype, target_rank, communicator): sends
+        //   [first, first + count) to target_rank, or an empty message if is_zero, and receives the message of
+        //   target_rank into [receive_first, receive_first + count). The result is false if the received message is
+        //   empty, so whether the ranges of the two processes are zero is told by the data themselves.
+        //   mpi_datatype describes one value, and receive_first should not be in [first, first + count)
+        template <typename Value>
+        inline bool swap_unless_zero(
+          Value const* const first, std::size_t const count, bool const is_zero, Value* const receive_first,
+          MPI_Datatype const mpi_datatype, yampi::rank const target_rank, yampi::communicator const& communicator)
+        {
+          assert(count <= static_cast<std::size_t>(std::numeric_limits<int>::max()));
+          if (not is_zero)
+            ::ket::mpi::utility::num_sent_bytes() += static_cast<std::uint64_t>(count) * sizeof(Value);
+
+          auto status = MPI_Status{};
+          if (MPI_Sendrecv(
+                first, is_zero ? 0 : static_cast<int>(count), mpi_datatype, target_rank.mpi_rank(), 0,
+                receive_first, static_cast<int>(count), mpi_datatype, target_rank.mpi_rank(), 0,
+                communicator.mpi_comm(), std::addressof(status))
+              != MPI_SUCCESS)
+            throw std::runtime_error{"MPI_Sendrecv failed in ket::mpi::utility::detail::swap_unless_zero"};
+
+          auto received_count = 0;
+          if (MPI_Get_count(std::addressof(status), mpi_datatype, std::addressof(received_count)) != MPI_SUCCESS)
+            throw std::runtime_error{"MPI_Get_count failed in ket::mpi::utility::detail::swap_unless_zero"};
+          return received_count != 0;
+        }
+
+        // swap_unless_zero(first, last, is_zero, receive_first, [datatype,] target_rank, communicator): the same as
+        //   above for the range [first, last)
+        template <typename ContiguousIterator>
+        inline bool swap_unless_zero(
+          ContiguousIterator const first, ContiguousIterator const last, bool const is_zero,
+          ContiguousIterator const receive_first,
+          yampi::rank const target_rank, yampi::communicator const& communicator)
+        {
+          ::ket::mpi::utility::detail::byte_datatype const datatype{sizeof(*first)};
+          return ::ket::mpi::utility::detail::swap_unless_zero(
+            std::addressof(*first), static_cast<std::size_t>(last - first), is_zero, std::addressof(*receive_first),
+            datatype.mpi_datatype(), target_rank, communicator);
+        }
+
+        template <typename ContiguousIterator, typename DerivedDatatype>
+        inline bool swap_unless_zero(
+          ContiguousIterator const first, ContiguousIterator const last, bool const is_zero,
+          ContiguousIterator const receive_first,
+          yampi::datatype_base<DerivedDatatype> const& datatype, yampi::rank const target_rank,
+          yampi::communicator const& communicator)
+        {
+          return ::ket::mpi::utility::detail::swap_unless_zero(
+            std::addressof(*first), static_cast<std::size_t>(last - first), is_zero, std::addressof(*receive_first),
+            datatype.mpi_datatype(), target_rank, communicator);
+        }
+
+        // planar data are sent as two contiguous blocks, real parts and imaginary parts
+        template <typename Real>
+        inline bool swap_unless_zero(
+          ::ket::utility::planar_complex_iterator<Real> const first,
+          ::ket::utility::planar_complex_iterator<Real> const last, bool const is_zero,
+          ::ket::utility::planar_complex_iterator<Real> const receive_first,
+          yampi::rank const target_rank, yampi::communicator const& communicator)
+        {
+          auto const count = static_cast<std::size_t>(last - first);
+          ::ket::mpi::utility::detail::byte_datatype const datatype{sizeof(Real)};
+          auto const is_received
+            = ::ket::mpi::utility::detail::swap_unless_zero(
+                first.real_part_ptr(), count, is_zero, receive_first.real_part_ptr(),
+                datatype.mpi_datatype(), target_rank, communicator);
+          ::ket::mpi::utility::detail::swap_unless_zero(
+            first.imag_part_ptr(), count, is_zero, receive_first.imag_part_ptr(),
+            datatype.mpi_datatype(), target_rank, communicator);
+          return is_received;
+        }
+
+        // datatype describes complex numbers, so it is not used for planar data
+        template <typename Real, typename DerivedDatatype>
+        inline bool swap_unless_zero(
+          ::ket::utility::planar_complex_iterator<Real> const first,
+          ::ket::utility::planar_complex_iterator<Real> const last, bool const is_zero,
+          ::ket::utility::planar_complex_iterator<Real> const receive_first,
+          yampi::datatype_base<DerivedDatatype> const&, yampi::rank const target_rank,
+          yampi::communicator const& communicator)
+        {
+          return ::ket::mpi::utility::detail::swap_unless_zero(
+            first, last, is_zero, receive_first, target_rank, communicator);
+        }
+
+        // interchange_in_chunks(first, count, buffer_first, chunk_size, mpi_datatype, num_mpi_data_per_value, ...):
+        //   exchanges [first, first + count) with target_rank chunk_size values at a time by nonblocking send/recv.
+        //   Chunks are received alternately into [buffer_first, buffer_first + chunk_size) and
+        //   [buffer_first + chunk_size, buffer_first + 2 * chunk_size), so the copy-back of a chunk overlaps the transfer
+        //   of the next one. If chunk_size >= count, the buffer needs only count values
+        template <typename Value>
+        inline void interchange_in_chunks(
+          Value* const first, std::size_t const count,
+          Value* const buffer_first, std::size_t chunk_size,
+          MPI_Datatype const mpi_datatype, int const num_mpi_data_per_value,
+          yampi::rank const target_rank,
+          yampi::communicator const& communicator, yampi::environment const&)
+        {
+          if (count == std::size_t{0u})
+            return;
+
+          ::ket::mpi::utility::num_sent_bytes() += static_cast<std::uint64_t>(count) * sizeof(Value);
+          assert(chunk_size > std::size_t{0u});
+          // halving keeps two chunks inside the buffer even if a single chunk was planned
+          auto const max_chunk_size
+            = static_cast<std::size_t>(std::numeric_limits<int>::max() / num_mpi_data_per_value);
+          if (chunk_size > max_chunk_size)
+            chunk_size = std::min(max_chunk_size, chunk_size / 2u);
+
+          auto const num_chunks = (count + chunk_size - std::size_t{1u}) / chunk_size;
+          auto requests = std::array<std::array<MPI_Request, 2u>, 2u>{};
+
+          auto const start_chunk
+            = [first, count, buffer_first, chunk_size, mpi_datatype, num_mpi_data_per_value, target_rank, &communicator, &requests](
+                std::size_t const chunk_index)
+              {
+                auto const chunk_first_index = chunk_index * chunk_size;
+                auto const mpi_count
+                  = static_cast<int>(std::min(chunk_size, count - chunk_first_index)) * num_mpi_data_per_value;
+                auto& chunk_requests = requests[chunk_index % 2u];
+
+                if (MPI_Irecv(
+                      buffer_first + (chunk_index % 2u) * chunk_size, mpi_count, mpi_datatype,
+                      target_rank.mpi_rank(), 0, communicator.mpi_comm(), std::addressof(chunk_requests[0u]))
+                    != MPI_SUCCESS)
+                  throw std::runtime_error{"MPI_Irecv failed in ket::mpi::utility::detail::interchange_in_chunks"};
+                if (MPI_Isend(
+                      first + chunk_first_index, mpi_count, mpi_datatype,
+                      target_rank.mpi_rank(), 0, communicator.mpi_comm(), std::addressof(chunk_requests[1u]))
+                    != MPI_SUCCESS)
+                  throw std::runtime_error{"MPI_Isend failed in ket::mpi::utility::detail::interchange_in_chunks"};
+              };
+
+          start_chunk(std::size_t{0u});
+          for (auto chunk_index = std::size_t{0u}; chunk_index < num_chunks; ++chunk_index)
+          {
+            if (chunk_index + 1u < num_chunks)
+              start_chunk(chunk_index + 1u);
+
+            if (MPI_Waitall(2, requests[chunk_index % 2u].data(), MPI_STATUSES_IGNORE) != MPI_SUCCESS)
+              throw std::runtime_error{"MPI_Waitall failed in ket::mpi::utility::detail::interchange_in_chunks"};
+
+            auto const chunk_first_index = chunk_index * chunk_size;
+            auto const chunk_buffer_first = buffer_first + (chunk_index % 2u) * chunk_size;
+            std::copy(
+              chunk_buffer_first, chunk_buffer_first + std::min(chunk_size, count - chunk_first_index),
+              first + chunk_first_index);
+          }
+        }
+
+        // interchange_buffer_size(count, size_limit): the number of values of the buffer used by an interchange of count
+        //   values, which is at most size_limit unless size_limit is 0 or 1
+        inline std::size_t interchange_buffer_size(std::size_t const count, std::size_t const size_limit)
+        { return size_limit == std::size_t{0u} or size_limit >= count ? count : std::max(size_limit, std::size_t{2u}); }
+
+        // A range longer than buffer_size values is exchanged buffer_size / 2 values at a time
+        inline std::size_t interchange_chunk_size(std::size_t const buffer_size, std::size_t const count)
+        { return buffer_size >= count ? count : buffer_size / 2u; }
+      } // namespace detail
+
       namespace dispatch
       {
         template <typename LocalState_>
@@ -42,15 +317,11 @@ namespace ket
             assert(source_local_last_index >= source_local_first_index);
 
             auto const first = std::begin(local_state) + data_block_index * data_block_size + source_local_first_index;
-            auto const last = std::begin(local_state) + data_block_index * data_block_size + source_local_last_index;
+            auto const count = static_cast<std::size_t>(source_local_last_index - source_local_first_index);
 
-            buffer.resize(source_local_last_index - source_local_first_index);
-            yampi::algorithm::swap(
-              yampi::ignore_status(),
-              yampi::make_buffer(first, last),
-              yampi::make_buffer(std::begin(buffer), std::end(buffer)),
+            do_call(
+              first, count, buffer, MPI_BYTE, static_cast<int>(sizeof(*first)),
               target_rank, communicator, environment);
-            std::copy(std::begin(buffer), std::end(buffer), first);
           }
 
           template <typename LocalState, typename Allocator, typename StateInteger, typename DerivedDatatype>
@@ -66,17 +337,92 @@ namespace ket
             assert(source_local_last_index >= source_local_first_index);
 
             auto const first = std::begin(local_state) + data_block_index * data_block_size + source_local_first_index;
-            auto const last = std::begin(local_state) + data_block_index * data_block_size + source_local_last_index;
+            auto const count = static_cast<std::size_t>(source_local_last_index - source_local_first_index);
 
-            buffer.resize(source_local_last_index - source_local_first_index);
-            yampi::algorithm::swap(
-              yampi::ignore_status(),
-              yampi::make_buffer(first, last, datatype),
-              yampi::make_buffer(std::begin(buffer), std::end(buffer), datatype),
+            do_call(
+              first, count, buffer, datatype.mpi_datatype(), 1,
               target_rank, communicator, environment);
-            std::copy(std::begin(buffer), std::end(buffer), first);
+          }
+
+         private:
+          template <typename ContiguousIterator, typename Value, typename Allocator>
+          static void do_call(
+            ContiguousIterator const first, std::size_t const count,
+            std::vector<Value, Allocator>& buffer,
+            MPI_Datatype const mpi_datatype, int const num_mpi_data_per_value,
+            yampi::rank const target_rank,
+            yampi::communicator const& communicator, yampi::environment const& environment)
+          {
+            auto const size_limit = ::ket::mpi::utility::buffer_size_limit();
+            auto const buffer_size = ::ket::mpi::utility::detail::interchange_buffer_size(count, size_limit);
+            if (buffer.size() < buffer_size)
+              buffer.resize(buffer_size);
+
+            ::ket::mpi::utility::detail::interchange_in_chunks(
+              std::addressof(*first), count,
+              buffer.data(), ::ket::mpi::utility::detail::interchange_chunk_size(buffer_size, count),
+              mpi_datatype, num_mpi_data_per_value, target_rank, communicator, environment);
+
+            if (size_limit == std::size_t{0u})
+              buffer.clear();
           }
         }; // struct interchange_qubits<LocalState_>
+
+        // real parts and imaginary parts are exchanged one after the other through buffer, which is regarded as
+        // an array of 2 * buffer.size() Real's. The limit of the buffer size is also doubled in Real's
+        template <typename Real, typename PlanarAllocator>
+        struct interchange_qubits< ::ket::utility::planar_complex_vector<Real, PlanarAllocator> >
+        {
+          template <typename Allocator, typename StateInteger>
+          static void call(
+            ::ket::utility::planar_complex_vector<Real, PlanarAllocator>& local_state,
+            std::vector<std::complex<Real>, Allocator>& buffer,
+            StateInteger const data_block_index, StateInteger const data_block_size,
+            StateInteger const source_local_first_index,
+            StateInteger const source_local_last_index,
+            yampi::rank const target_rank,
+            yampi::communicator const& communicator, yampi::environment const& environment)
+          {
+            assert(source_local_last_index >= source_local_first_index);
+
+            auto const first = std::begin(local_state) + data_block_index * data_block_size + source_local_first_index;
+            auto const count = static_cast<std::size_t>(source_local_last_index - source_local_first_index);
+
+            auto const size_limit = ::ket::mpi::utility::buffer_size_limit();
+            auto const num_buffer_reals = ::ket::mpi::utility::detail::interchange_buffer_size(count, 2u * size_limit);
+            if (2u * buffer.size() < num_buffer_reals)
+              buffer.resize((num_buffer_reals + 1u) / 2u);
+            auto const buffer_first = reinterpret_cast<Real*>(buffer.data());
+            auto const chunk_size = ::ket::mpi::utility::detail::interchange_chunk_size(num_buffer_reals, count);
+
+            ::ket::mpi::utility::detail::interchange_in_chunks(
+              first.real_part_ptr(), count, buffer_first, chunk_size,
+              MPI_BYTE, static_cast<int>(sizeof(Real)), target_rank, communicator, environment);
+            ::ket::mpi::utility::detail::interchange_in_chunks(
+              first.imag_part_ptr(), count, buffer_first, chunk_size,
+              MPI_BYTE, static_cast<int>(sizeof(Real)), target_rank, communicator, environment);
+
+            if (size_limit == std::size_t{0u})
+              buffer.clear();
+          }
+
+          // datatype describes complex numbers, so it is not used for planar data
+          template <typename Allocator, typename StateInteger, typename DerivedDatatype>
+          static void call(
+            ::ket::utility::planar_complex_vector<Real, PlanarAllocator>& local_state,
+            std::vector<std::complex<Real>, Allocator>& buffer,
+            StateInteger const data_block_index, StateInteger const data_block_size,
+            StateInteger const source_local_first_index,
+            StateInteger const source_local_last_index,
+            yampi::datatype_base<DerivedDatatype> const&, yampi::rank const target_rank,
+            yampi::communicator const& communicator, yampi::environment const& environment)
+          {
+            call(
+              local_state, buffer, data_block_index, data_block_size,
+              source_local_first_index, source_local_last_index,
+              target_rank, communicator, environment);
+          }
+        }; // struct interchange_qubits< ::ket::utility::planar_complex_vector<Real, PlanarAllocator> >
       } // namespace dispatch
 
       namespace detail
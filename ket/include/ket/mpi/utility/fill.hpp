@@ -9,6 +9,7 @@
 # include <ket/utility/loop_n.hpp>
 # include <ket/mpi/utility/general_mpi.hpp>
 # include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/page/unmark_zero_pages.hpp>
 
 
 namespace ket
@@ -53,13 +54,17 @@ namespace ket
         yampi::communicator const& communicator,
         yampi::environment const& environment)
       {
+        // pages known to have only zeros are skipped if value is zero
+        if (value != Value{0})
+          ::ket::mpi::page::unmark_zero_pages(local_state);
+
 # ifndef BOOST_NO_CXX14_GENERIC_LAMBDAS
-        return ::ket::mpi::utility::for_each_local_range(
+        return ::ket::mpi::utility::for_each_nonzero_local_range(
           mpi_policy, local_state, communicator, environment,
           [parallel_policy, &value](auto const first, auto const last)
           { ::ket::utility::fill(parallel_policy, first, last, value); });
 # else // BOOST_NO_CXX14_GENERIC_LAMBDAS
-        return ::ket::mpi::utility::for_each_local_range(
+        return ::ket::mpi::utility::for_each_nonzero_local_range(
           mpi_policy, local_state, communicator, environment,
           ::ket::mpi::utility::fill_detail::make_fill(parallel_policy, value));
 # endif // BOOST_NO_CXX14_GENERIC_LAMBDAS
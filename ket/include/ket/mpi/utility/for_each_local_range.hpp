@@ -3,6 +3,7 @@
 
 # include <cstddef>
 # include <iterator>
+# include <algorithm>
 # include <utility>
 
 # include <boost/range/size.hpp>
@@ -62,6 +63,20 @@ namespace ket
             return local_state;
           }
         }; // struct for_each_local_range<LocalState_>
+
+        template <typename LocalState_>
+        struct for_each_nonzero_local_range
+        {
+          template <typename MpiPolicy, typename LocalState, typename Function>
+          static LocalState& call(
+            MpiPolicy const& mpi_policy, LocalState& local_state,
+            yampi::communicator const& communicator, yampi::environment const& environment,
+            Function&& function)
+          {
+            return ::ket::mpi::utility::dispatch::for_each_local_range<LocalState_>::call(
+              mpi_policy, local_state, communicator, environment, std::forward<Function>(function));
+          }
+        }; // struct for_each_nonzero_local_range<LocalState_>
       } // namespace dispatch
 
       template <typename MpiPolicy, typename LocalState, typename Function>
@@ -83,6 +98,46 @@ namespace ket
         return ::ket::mpi::utility::dispatch::for_each_local_range<LocalState>::call(
           mpi_policy, local_state, communicator, environment, std::forward<Function>(function));
       }
+
+      // for_each_nonzero_local_range(mpi_policy, local_state, communicator, environment, function):
+      //   same as for_each_local_range except that local ranges known to have only zeros may be skipped,
+      //   so function must leave a range of zeros as it is
+      template <typename MpiPolicy, typename LocalState, typename Function>
+      inline LocalState& for_each_nonzero_local_range(
+        MpiPolicy const& mpi_policy, LocalState& local_state,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Function&& function)
+      {
+        return ::ket::mpi::utility::dispatch::for_each_nonzero_local_range<LocalState>::call(
+          mpi_policy, local_state, communicator, environment, std::forward<Function>(function));
+      }
+
+      // for_each_local_subrange(mpi_policy, local_state, first_index, last_index, ..., function):
+      //   calls function(first, last, offset) for the parts of the local ranges in [first_index, last_index) of the
+      //   local indices, where offset is the local index of first minus first_index
+      template <typename MpiPolicy, typename LocalState, typename Function>
+      inline void for_each_local_subrange(
+        MpiPolicy const& mpi_policy, LocalState& local_state,
+        std::size_t const first_index, std::size_t const last_index,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Function&& function)
+      {
+        auto range_first_index = std::size_t{0u};
+        ::ket::mpi::utility::for_each_local_range(
+          mpi_policy, local_state, communicator, environment,
+          [first_index, last_index, &range_first_index, &function](auto const first, auto const last)
+          {
+            auto const range_last_index = range_first_index + static_cast<std::size_t>(last - first);
+            auto const subrange_first_index = std::max(first_index, range_first_index);
+            auto const subrange_last_index = std::min(last_index, range_last_index);
+            if (subrange_first_index < subrange_last_index)
+              function(
+                first + (subrange_first_index - range_first_index),
+                first + (subrange_last_index - range_first_index),
+                subrange_first_index - first_index);
+            range_first_index = range_last_index;
+          });
+      }
     } // namespace utility
   } // namespace mpi
 } // namespace ket
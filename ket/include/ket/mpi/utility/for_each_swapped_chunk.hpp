@@ -0,0 +1,148 @@
+#ifndef KET_MPI_UTILITY_FOR_EACH_SWAPPED_CHUNK_HPP
+# define KET_MPI_UTILITY_FOR_EACH_SWAPPED_CHUNK_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/datatype_base.hpp>
+# include <yampi/communicator.hpp>
+# include <yampi/buffer.hpp>
+# include <yampi/rank.hpp>
+# include <yampi/status.hpp>
+# include <yampi/algorithm/swap.hpp>
+
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/integer_log2.hpp>
+# include <ket/mpi/utility/for_each_local_range.hpp>
+# include <ket/mpi/utility/buffer_size_limit.hpp>
+# include <ket/mpi/utility/num_sent_bytes.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace utility
+    {
+      namespace detail
+      {
+        // swapped_chunk_size(num_values, min_chunk_size): num_values if the buffer size is not limited, otherwise the
+        //   largest power of 2 not exceeding half of the limit, which is clamped to [min_chunk_size, num_values]
+        inline std::size_t swapped_chunk_size(std::size_t const num_values, std::size_t const min_chunk_size)
+        {
+          auto const size_limit = ::ket::mpi::utility::buffer_size_limit();
+          if (size_limit == std::size_t{0u})
+            return num_values;
+
+          auto const max_chunk_size
+            = ::ket::utility::integer_exp2<std::size_t>(
+                ::ket::utility::integer_log2<std::size_t>(std::max(size_limit / 2u, std::size_t{1u})));
+          return std::max(std::min(max_chunk_size, num_values), min_chunk_size);
+        }
+
+        template <typename MpiPolicy, typename LocalState, typename Allocator, typename Swap, typename Function>
+        inline void for_each_swapped_chunk(
+          MpiPolicy const& mpi_policy, LocalState& local_state,
+          std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+          std::vector<typename boost::range_value<LocalState>::type, Allocator>& buffer,
+          yampi::communicator const& communicator, yampi::environment const& environment,
+          Swap&& swap, Function&& function)
+        {
+          if (num_values == std::size_t{0u})
+            return;
+
+          auto const chunk_size = ::ket::mpi::utility::detail::swapped_chunk_size(num_values, min_chunk_size);
+          auto temporary_buffer
+            = std::vector<typename boost::range_value<LocalState>::type, Allocator>(buffer.get_allocator());
+          if (buffer.size() < 2u * chunk_size)
+            temporary_buffer.resize(2u * chunk_size);
+          auto const send_buffer_first
+            = temporary_buffer.empty() ? std::begin(buffer) : std::begin(temporary_buffer);
+          auto const receive_buffer_first = send_buffer_first + chunk_size;
+
+          for (auto chunk_first_index = std::size_t{0u}; chunk_first_index < num_values; chunk_first_index += chunk_size)
+          {
+            auto const chunk_last_index = std::min(chunk_first_index + chunk_size, num_values);
+            ::ket::mpi::utility::for_each_local_subrange(
+              mpi_policy, local_state, sent_first_index + chunk_first_index, sent_first_index + chunk_last_index,
+              communicator, environment,
+              [send_buffer_first](auto const first, auto const last, std::size_t const offset)
+              { std::copy(first, last, send_buffer_first + offset); });
+
+            auto const count = chunk_last_index - chunk_first_index;
+            ::ket::mpi::utility::num_sent_bytes()
+              += static_cast<std::uint64_t>(count) * sizeof(typename boost::range_value<LocalState>::type);
+            swap(send_buffer_first, send_buffer_first + count, receive_buffer_first, receive_buffer_first + count);
+
+            function(chunk_first_index, chunk_last_index, receive_buffer_first);
+          }
+        }
+      } // namespace detail
+
+      // for_each_swapped_chunk(
+      //   mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, [datatype,] target_rank,
+      //   communicator, environment, function):
+      //   exchanges the values of [sent_first_index, sent_first_index + num_values) of the local indices with
+      //   target_rank chunk by chunk, and calls function(chunk_first_index, chunk_last_index, received_first) for each
+      //   chunk, where the chunk indices are relative to sent_first_index and the values of target_rank are in
+      //   [received_first, received_first + (chunk_last_index - chunk_first_index)). The chunk size is a power of 2
+      //   bounded by buffer_size_limit() unless it is less than min_chunk_size, which should be a power of 2. buffer is
+      //   used if it is large enough, otherwise a temporary buffer is, so the size of buffer is never changed
+      template <typename MpiPolicy, typename LocalState, typename Allocator, typename Function>
+      inline void for_each_swapped_chunk(
+        MpiPolicy const& mpi_policy, LocalState& local_state,
+        std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+        std::vector<typename boost::range_value<LocalState>::type, Allocator>& buffer,
+        yampi::rank const target_rank,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Function&& function)
+      {
+        ::ket::mpi::utility::detail::for_each_swapped_chunk(
+          mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, communicator, environment,
+          [target_rank, &communicator, &environment](
+            auto const first, auto const last, auto const buffer_first, auto const buffer_last)
+          {
+            yampi::algorithm::swap(
+              yampi::ignore_status(),
+              yampi::make_buffer(first, last),
+              yampi::make_buffer(buffer_first, buffer_last),
+              target_rank, communicator, environment);
+          },
+          std::forward<Function>(function));
+      }
+
+      template <typename MpiPolicy, typename LocalState, typename Allocator, typename DerivedDatatype, typename Function>
+      inline void for_each_swapped_chunk(
+        MpiPolicy const& mpi_policy, LocalState& local_state,
+        std::size_t const sent_first_index, std::size_t const num_values, std::size_t const min_chunk_size,
+        std::vector<typename boost::range_value<LocalState>::type, Allocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype, yampi::rank const target_rank,
+        yampi::communicator const& communicator, yampi::environment const& environment,
+        Function&& function)
+      {
+        ::ket::mpi::utility::detail::for_each_swapped_chunk(
+          mpi_policy, local_state, sent_first_index, num_values, min_chunk_size, buffer, communicator, environment,
+          [&datatype, target_rank, &communicator, &environment](
+            auto const first, auto const last, auto const buffer_first, auto const buffer_last)
+          {
+            yampi::algorithm::swap(
+              yampi::ignore_status(),
+              yampi::make_buffer(first, last, datatype),
+              yampi::make_buffer(buffer_first, buffer_last, datatype),
+              target_rank, communicator, environment);
+          },
+          std::forward<Function>(function));
+      }
+    } // namespace utility
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_UTILITY_FOR_EACH_SWAPPED_CHUNK_HPP
@@ -564,6 +564,16 @@ namespace ket
               static_cast<yampi::rank>(qubit_value / boost::size(local_state)),
               qubit_value % boost::size(local_state));
           }
+
+          template <typename StateInteger>
+          static std::pair<yampi::rank, StateInteger> call(
+            ::ket::mpi::utility::policy::general_mpi const,
+            StateInteger const qubit_value, StateInteger const data_block_size)
+          {
+            return std::make_pair(
+              static_cast<yampi::rank>(qubit_value / data_block_size),
+              qubit_value % data_block_size);
+          }
         }; // struct qubit_value_to_rank_index< ::ket::mpi::utility::policy::general_mpi >
       } // namespace dispatch
 
@@ -925,6 +935,16 @@ namespace ket
           mpi_policy, local_state, qubit_value, communicator, environment);
       }
 
+      // This version calls no MPI functions. data_block_size should be that of this process
+      template <typename StateInteger>
+      inline std::pair<yampi::rank, StateInteger> qubit_value_to_rank_index(
+        ::ket::mpi::utility::policy::general_mpi const mpi_policy,
+        StateInteger const qubit_value, StateInteger const data_block_size)
+      {
+        return ::ket::mpi::utility::dispatch::qubit_value_to_rank_index< ::ket::mpi::utility::policy::general_mpi >::call(
+          mpi_policy, qubit_value, data_block_size);
+      }
+
 # ifdef KET_USE_DIAGONAL_LOOP
       template <
         typename ParallelPolicy, typename LocalState,
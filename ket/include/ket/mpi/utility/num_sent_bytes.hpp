@@ -0,0 +1,27 @@
+#ifndef KET_MPI_UTILITY_NUM_SENT_BYTES_HPP
+# define KET_MPI_UTILITY_NUM_SENT_BYTES_HPP
+
+# include <cstdint>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace utility
+    {
+      // total number of bytes of amplitudes which this process has sent to other processes in interchanging qubits
+      // or in exchanging values with partner processes (see for_each_swapped_chunk).
+      // The difference of the values before and after an operation is the amount of its communication.
+      // Only the thread calling MPI functions updates it
+      inline std::uint64_t& num_sent_bytes()
+      {
+        static auto result = std::uint64_t{0u};
+        return result;
+      }
+    } // namespace utility
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_UTILITY_NUM_SENT_BYTES_HPP
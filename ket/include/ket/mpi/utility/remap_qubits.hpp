@@ -0,0 +1,356 @@
+#ifndef KET_MPI_UTILITY_REMAP_QUBITS_HPP
+# define KET_MPI_UTILITY_REMAP_QUBITS_HPP
+
+# include <cstddef>
+# include <cassert>
+# include <vector>
+# include <array>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+# include <stdexcept>
+
+# include <boost/range/value_type.hpp>
+
+# include <yampi/environment.hpp>
+# include <yampi/datatype_base.hpp>
+# include <yampi/communicator.hpp>
+
+# include <ket/qubit.hpp>
+# include <ket/utility/integer_exp2.hpp>
+# include <ket/mpi/permutated.hpp>
+# include <ket/mpi/qubit_permutation.hpp>
+# include <ket/mpi/utility/general_mpi.hpp>
+# include <ket/mpi/utility/unit_mpi.hpp>
+# include <ket/mpi/utility/detail/swap_permutated_local_qubits.hpp>
+
+
+namespace ket
+{
+  namespace mpi
+  {
+    namespace utility
+    {
+      // remap_qubits: makes nonlocal_qubits[i] local by exchanging it with evicted_qubits[i], which must be local.
+      //   maybe_interchange_qubits exchanges nonlocal qubits with the "local swap qubits", i.e. the highest local
+      //   qubits, so evicted_qubits are moved there by local swaps first. All the qubits are exchanged at once
+      namespace remap_qubits_detail
+      {
+        template <
+          typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+          typename StateInteger, typename BitInteger, std::size_t num_qubits, typename Allocator>
+        inline void move_to_local_swap_qubits(
+          MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+          LocalState& local_state,
+          std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& evicted_qubits,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+          yampi::communicator const& communicator, yampi::environment const& environment)
+        {
+          auto const num_local_qubits
+            = static_cast<BitInteger>(
+                ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+          auto const num_data_blocks
+            = static_cast<StateInteger>(
+                ::ket::mpi::utility::policy::num_data_blocks(mpi_policy, communicator, environment));
+          auto const data_block_size
+            = static_cast<StateInteger>(
+                ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment));
+
+          using permutated_qubit_type = ::ket::mpi::permutated< ::ket::qubit<StateInteger, BitInteger> >;
+          for (auto index = std::size_t{0u}; index < num_qubits; ++index)
+          {
+            auto const permutated_local_swap_qubit
+              = permutated_qubit_type{num_local_qubits - BitInteger{1u} - static_cast<BitInteger>(index)};
+            auto const permutated_evicted_qubit = permutation[evicted_qubits[index]];
+            assert(permutated_evicted_qubit < permutated_qubit_type{num_local_qubits});
+
+            if (permutated_evicted_qubit == permutated_local_swap_qubit)
+              continue;
+
+            ::ket::mpi::utility::detail::swap_permutated_local_qubits(
+              mpi_policy, parallel_policy, local_state,
+              permutated_local_swap_qubit, permutated_evicted_qubit,
+              num_data_blocks, data_block_size, communicator, environment);
+            using ::ket::mpi::inverse;
+            using ::ket::mpi::permutate;
+            permutate(permutation, evicted_qubits[index], inverse(permutation)[permutated_local_swap_qubit]);
+          }
+        }
+      } // namespace remap_qubits_detail
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator>
+      inline void remap_qubits(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& nonlocal_qubits,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& evicted_qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::remap_qubits_detail::move_to_local_swap_qubits(
+          mpi_policy, parallel_policy, local_state, evicted_qubits, permutation, communicator, environment);
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, nonlocal_qubits, permutation, buffer, communicator, environment);
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+        typename StateInteger, typename BitInteger, std::size_t num_qubits,
+        typename Allocator, typename BufferAllocator, typename DerivedDatatype>
+      inline void remap_qubits(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& nonlocal_qubits,
+        std::array< ::ket::qubit<StateInteger, BitInteger>, num_qubits > const& evicted_qubits,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        ::ket::mpi::utility::remap_qubits_detail::move_to_local_swap_qubits(
+          mpi_policy, parallel_policy, local_state, evicted_qubits, permutation, communicator, environment);
+        ::ket::mpi::utility::maybe_interchange_qubits(
+          mpi_policy, parallel_policy, local_state, nonlocal_qubits, permutation, buffer, datatype, communicator, environment);
+      }
+
+      namespace remap_qubits_detail
+      {
+        constexpr std::size_t max_num_remapped_qubits = 6u;
+
+        // select_remapped_qubits: [first, last) are the qubits to be made local in the order of their use
+        template <typename ForwardIterator, typename StateInteger, typename BitInteger, typename Allocator>
+        inline void select_remapped_qubits(
+          ForwardIterator const first, ForwardIterator const last,
+          ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+          BitInteger const num_local_qubits,
+          std::vector< ::ket::qubit<StateInteger, BitInteger> >& nonlocal_qubits,
+          std::vector< ::ket::qubit<StateInteger, BitInteger> >& evicted_qubits)
+        {
+          using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+          using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
+
+          nonlocal_qubits.clear();
+          for (auto iter = first; iter != last and nonlocal_qubits.size() < max_num_remapped_qubits; ++iter)
+            if (permutation[*iter] >= permutated_qubit_type{num_local_qubits})
+              nonlocal_qubits.push_back(*iter);
+
+          auto const num_members = static_cast<std::size_t>(std::distance(first, last));
+          auto const order_of
+            = [first, last](qubit_type const qubit)
+              { return static_cast<std::size_t>(std::distance(first, std::find(first, last, qubit))); };
+
+          // The local qubits out of [first, last) are evicted from the highest one, which needs no local swap
+          evicted_qubits.clear();
+          using order_qubit_pair = std::pair<std::size_t, qubit_type>;
+          auto local_members = std::vector<order_qubit_pair>{};
+          for (auto permutated_bit = num_local_qubits;
+               permutated_bit-- > BitInteger{0u} and evicted_qubits.size() < nonlocal_qubits.size(); )
+          {
+            using ::ket::mpi::inverse;
+            auto const qubit = inverse(permutation)[permutated_qubit_type{permutated_bit}];
+            auto const order = order_of(qubit);
+            if (order == num_members)
+              evicted_qubits.push_back(qubit);
+            else
+              local_members.emplace_back(order, qubit);
+          }
+
+          // A local qubit of [first, last) is evicted only if it is used after the nonlocal qubit replacing it
+          std::sort(
+            std::begin(local_members), std::end(local_members),
+            [](order_qubit_pair const& lhs, order_qubit_pair const& rhs) { return lhs.first > rhs.first; });
+          for (auto const& local_member: local_members)
+          {
+            if (evicted_qubits.size() == nonlocal_qubits.size()
+                or local_member.first < order_of(nonlocal_qubits[evicted_qubits.size()]))
+              break;
+
+            evicted_qubits.push_back(local_member.second);
+          }
+
+          nonlocal_qubits.resize(evicted_qubits.size());
+        }
+
+        // dispatch_remap_qubits<max_num_remapped_qubits>::call calls remap_qubits for runtime-sized qubits
+        template <std::size_t num_qubits>
+        struct dispatch_remap_qubits
+        {
+          template <
+            typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+            typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+          static void call(
+            MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+            LocalState& local_state,
+            std::vector< ::ket::qubit<StateInteger, BitInteger> > const& nonlocal_qubits,
+            std::vector< ::ket::qubit<StateInteger, BitInteger> > const& evicted_qubits,
+            ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+            std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+            yampi::communicator const& communicator,
+            yampi::environment const& environment)
+          {
+            if (nonlocal_qubits.size() < num_qubits)
+              return ::ket::mpi::utility::remap_qubits_detail::dispatch_remap_qubits<num_qubits - 1u>::call(
+                mpi_policy, parallel_policy, local_state, nonlocal_qubits, evicted_qubits, permutation,
+                buffer, communicator, environment);
+
+            using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+            auto nonlocal_qubit_array = std::array<qubit_type, num_qubits>{};
+            auto evicted_qubit_array = std::array<qubit_type, num_qubits>{};
+            std::copy(std::begin(nonlocal_qubits), std::end(nonlocal_qubits), std::begin(nonlocal_qubit_array));
+            std::copy(std::begin(evicted_qubits), std::end(evicted_qubits), std::begin(evicted_qubit_array));
+
+            ::ket::mpi::utility::remap_qubits(
+              mpi_policy, parallel_policy, local_state, nonlocal_qubit_array, evicted_qubit_array, permutation,
+              buffer, communicator, environment);
+          }
+
+          template <
+            typename MpiPolicy, typename ParallelPolicy, typename LocalState,
+            typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+            typename DerivedDatatype>
+          static void call(
+            MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+            LocalState& local_state,
+            std::vector< ::ket::qubit<StateInteger, BitInteger> > const& nonlocal_qubits,
+            std::vector< ::ket::qubit<StateInteger, BitInteger> > const& evicted_qubits,
+            ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+            std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+            yampi::datatype_base<DerivedDatatype> const& datatype,
+            yampi::communicator const& communicator,
+            yampi::environment const& environment)
+          {
+            if (nonlocal_qubits.size() < num_qubits)
+              return ::ket::mpi::utility::remap_qubits_detail::dispatch_remap_qubits<num_qubits - 1u>::call(
+                mpi_policy, parallel_policy, local_state, nonlocal_qubits, evicted_qubits, permutation,
+                buffer, datatype, communicator, environment);
+
+            using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+            auto nonlocal_qubit_array = std::array<qubit_type, num_qubits>{};
+            auto evicted_qubit_array = std::array<qubit_type, num_qubits>{};
+            std::copy(std::begin(nonlocal_qubits), std::end(nonlocal_qubits), std::begin(nonlocal_qubit_array));
+            std::copy(std::begin(evicted_qubits), std::end(evicted_qubits), std::begin(evicted_qubit_array));
+
+            ::ket::mpi::utility::remap_qubits(
+              mpi_policy, parallel_policy, local_state, nonlocal_qubit_array, evicted_qubit_array, permutation,
+              buffer, datatype, communicator, environment);
+          }
+        }; // struct dispatch_remap_qubits<num_qubits>
+
+        template <>
+        struct dispatch_remap_qubits<0u>
+        {
+          template <typename... Arguments>
+          static void call(Arguments&&...) { }
+        }; // struct dispatch_remap_qubits<0u>
+      } // namespace remap_qubits_detail
+
+      // remap_nonlocal_qubits: makes at most 6 nonlocal qubits of [first, last) local by one remap_qubits, in the
+      //   order of [first, last). The evicted qubits are the local qubits out of [first, last) from the highest one,
+      //   and then the local qubits of [first, last) used after the nonlocal qubits replacing them.
+      //   Returns the number of the qubits made local
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename ForwardIterator,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator>
+      inline std::size_t remap_nonlocal_qubits(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, ForwardIterator const first, ForwardIterator const last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+
+        auto nonlocal_qubits = std::vector< ::ket::qubit<StateInteger, BitInteger> >{};
+        auto evicted_qubits = std::vector< ::ket::qubit<StateInteger, BitInteger> >{};
+        ::ket::mpi::utility::remap_qubits_detail::select_remapped_qubits(
+          first, last, permutation, num_local_qubits, nonlocal_qubits, evicted_qubits);
+        ::ket::mpi::utility::remap_qubits_detail::dispatch_remap_qubits<
+          ::ket::mpi::utility::remap_qubits_detail::max_num_remapped_qubits>::call(
+            mpi_policy, parallel_policy, local_state, nonlocal_qubits, evicted_qubits, permutation,
+            buffer, communicator, environment);
+        return nonlocal_qubits.size();
+      }
+
+      template <
+        typename MpiPolicy, typename ParallelPolicy, typename LocalState, typename ForwardIterator,
+        typename StateInteger, typename BitInteger, typename Allocator, typename BufferAllocator,
+        typename DerivedDatatype>
+      inline std::size_t remap_nonlocal_qubits(
+        MpiPolicy const& mpi_policy, ParallelPolicy const parallel_policy,
+        LocalState& local_state, ForwardIterator const first, ForwardIterator const last,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator>& permutation,
+        std::vector<typename boost::range_value<LocalState>::type, BufferAllocator>& buffer,
+        yampi::datatype_base<DerivedDatatype> const& datatype,
+        yampi::communicator const& communicator,
+        yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+
+        auto nonlocal_qubits = std::vector< ::ket::qubit<StateInteger, BitInteger> >{};
+        auto evicted_qubits = std::vector< ::ket::qubit<StateInteger, BitInteger> >{};
+        ::ket::mpi::utility::remap_qubits_detail::select_remapped_qubits(
+          first, last, permutation, num_local_qubits, nonlocal_qubits, evicted_qubits);
+        ::ket::mpi::utility::remap_qubits_detail::dispatch_remap_qubits<
+          ::ket::mpi::utility::remap_qubits_detail::max_num_remapped_qubits>::call(
+            mpi_policy, parallel_policy, local_state, nonlocal_qubits, evicted_qubits, permutation,
+            buffer, datatype, communicator, environment);
+        return nonlocal_qubits.size();
+      }
+
+      // make_mask_qubits_local: the nonlocal qubits whose bits of mask are 1 are made local by
+      //   interchange(nonlocal_qubit, evicted_qubit), where the evicted qubits are local qubits out of mask from the
+      //   highest one
+      template <
+        typename MpiPolicy, typename LocalState, typename StateInteger, typename BitInteger, typename Allocator,
+        typename Interchange>
+      inline void make_mask_qubits_local(
+        MpiPolicy const& mpi_policy, LocalState const& local_state, StateInteger const mask,
+        ::ket::mpi::qubit_permutation<StateInteger, BitInteger, Allocator> const& permutation,
+        Interchange&& interchange,
+        yampi::communicator const& communicator, yampi::environment const& environment)
+      {
+        auto const num_local_qubits
+          = static_cast<BitInteger>(
+              ::ket::mpi::utility::policy::num_local_qubits(mpi_policy, local_state, communicator, environment));
+
+        using qubit_type = ::ket::qubit<StateInteger, BitInteger>;
+        using permutated_qubit_type = ::ket::mpi::permutated<qubit_type>;
+        auto evicted_permutated_bit = num_local_qubits;
+        for (auto bit = BitInteger{0u}; (mask >> bit) != StateInteger{0u}; ++bit)
+        {
+          auto const qubit = qubit_type{bit};
+          if (((mask >> bit) bitand StateInteger{1u}) == StateInteger{0u}
+              or permutation[qubit] < permutated_qubit_type{num_local_qubits})
+            continue;
+
+          auto evicted_qubit = qubit;
+          do
+          {
+            if (evicted_permutated_bit == BitInteger{0u})
+              throw std::runtime_error{"too many nonlocal qubits in ket::mpi::utility::make_mask_qubits_local"};
+
+            using ::ket::mpi::inverse;
+            evicted_qubit = inverse(permutation)[permutated_qubit_type{--evicted_permutated_bit}];
+          }
+          while ((mask bitand ::ket::utility::integer_exp2<StateInteger>(evicted_qubit)) != StateInteger{0u});
+
+          interchange(qubit, evicted_qubit);
+        }
+      }
+    } // namespace utility
+  } // namespace mpi
+} // namespace ket
+
+
+#endif // KET_MPI_UTILITY_REMAP_QUBITS_HPP
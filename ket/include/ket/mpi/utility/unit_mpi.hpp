@@ -1041,9 +1041,16 @@ namespace ket
             LocalState const& local_state, StateInteger const qubit_value,
             yampi::communicator const& communicator, yampi::environment const& environment)
           {
-            // 2^L
-            auto const data_block_size
-              = ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment);
+            return call(
+              mpi_policy, qubit_value,
+              ::ket::mpi::utility::policy::data_block_size(mpi_policy, local_state, communicator, environment));
+          }
+
+          // data_block_size: 2^L
+          static std::pair<yampi::rank, StateInteger> call(
+            ::ket::mpi::utility::policy::unit_mpi<StateInteger, BitInteger, NumProcesses> const& mpi_policy,
+            StateInteger const qubit_value, StateInteger const data_block_size)
+          {
             // g
             auto const global_qubit_value
               = qubit_value / (::ket::mpi::utility::policy::num_unit_qubit_values(mpi_policy) * data_block_size);
@@ -1463,6 +1470,17 @@ namespace ket
             mpi_policy, local_state, qubit_value, communicator, environment);
       }
 
+      // This version calls no MPI functions. data_block_size should be that of this process
+      template <typename StateInteger, typename BitInteger, typename NumProcesses>
+      inline std::pair<yampi::rank, StateInteger> qubit_value_to_rank_index(
+        ::ket::mpi::utility::policy::unit_mpi<StateInteger, BitInteger, NumProcesses> const& mpi_policy,
+        StateInteger const qubit_value, StateInteger const data_block_size)
+      {
+        return ::ket::mpi::utility::dispatch::qubit_value_to_rank_index<
+          ::ket::mpi::utility::policy::unit_mpi<StateInteger, BitInteger, NumProcesses> >::call(
+            mpi_policy, qubit_value, data_block_size);
+      }
+
 # ifdef KET_USE_DIAGONAL_LOOP
       template <
         typename StateInteger, typename BitInteger, typename NumProcesses,
@@ -0,0 +1,52 @@
+#ifndef KET_PAULI_TERM_HPP
+# define KET_PAULI_TERM_HPP
+
+# include <cstdint>
+
+# include <ket/qubit.hpp>
+# include <ket/utility/integer_exp2.hpp>
+
+
+namespace ket
+{
+  // coefficient * P_{n-1} ... P_1 P_0, where P_i is X if the bit i of x_mask is 1 and that of z_mask is 0,
+  // Z if the converse, Y if both are 1, and I otherwise
+  template <typename Real, typename StateInteger = std::uint64_t>
+  struct pauli_term
+  {
+    using real_type = Real;
+    using state_integer_type = StateInteger;
+
+    Real coefficient;
+    StateInteger x_mask;
+    StateInteger z_mask;
+  }; // struct pauli_term<Real, StateInteger>
+
+  template <typename Real, typename StateInteger, typename BitInteger>
+  inline ::ket::pauli_term<Real, StateInteger>& add_pauli_x(
+    ::ket::pauli_term<Real, StateInteger>& term, ::ket::qubit<StateInteger, BitInteger> const qubit)
+  {
+    term.x_mask |= ::ket::utility::integer_exp2<StateInteger>(qubit);
+    return term;
+  }
+
+  template <typename Real, typename StateInteger, typename BitInteger>
+  inline ::ket::pauli_term<Real, StateInteger>& add_pauli_y(
+    ::ket::pauli_term<Real, StateInteger>& term, ::ket::qubit<StateInteger, BitInteger> const qubit)
+  {
+    term.x_mask |= ::ket::utility::integer_exp2<StateInteger>(qubit);
+    term.z_mask |= ::ket::utility::integer_exp2<StateInteger>(qubit);
+    return term;
+  }
+
+  template <typename Real, typename StateInteger, typename BitInteger>
+  inline ::ket::pauli_term<Real, StateInteger>& add_pauli_z(
+    ::ket::pauli_term<Real, StateInteger>& term, ::ket::qubit<StateInteger, BitInteger> const qubit)
+  {
+    term.z_mask |= ::ket::utility::integer_exp2<StateInteger>(qubit);
+    return term;
+  }
+} // namespace ket
+
+
+#endif // KET_PAULI_TERM_HPP
@@ -2,7 +2,6 @@
 # define KET_SHOR_BOX_HPP
 
 # include <cmath>
-//# include <vector>
 # include <iterator>
 # include <type_traits>
 
@@ -13,6 +12,7 @@
 # include <ket/meta/state_integer_of.hpp>
 # include <ket/meta/bit_integer_of.hpp>
 # include <ket/utility/integer_exp2.hpp>
+# include <ket/utility/loop_n.hpp>
 # include <ket/utility/meta/real_of.hpp>
 
 
@@ -54,6 +54,60 @@ namespace ket
         ::ket::shor_box_detail::make_filtered_integer(exponent, exponent_qubits)
         bitor ::ket::shor_box_detail::make_filtered_integer(modular_exponentiation_value, modular_exponentiation_qubits);
     }
+
+    // modular_exponentiation: base^exponent mod divisor by binary exponentiation. It gives the first value of each
+    //   segment of exponents, so that the segments are processed independently
+    template <typename StateInteger>
+    inline StateInteger modular_exponentiation(
+      StateInteger const base, StateInteger exponent, StateInteger const divisor)
+    {
+      auto result = StateInteger{1u};
+      for (auto power = base % divisor; exponent != StateInteger{0u}; exponent >>= 1u)
+      {
+        if ((exponent bitand StateInteger{1u}) != StateInteger{0u})
+          result = (result * power) % divisor;
+
+        power = (power * power) % divisor;
+      }
+
+      return result;
+    }
+
+    // num_segment_bits: exponents are split into 2^num_segment_bits segments, at least one per thread
+    template <typename BitInteger>
+    inline BitInteger num_segment_bits(unsigned int const num_threads, BitInteger const num_exponent_qubits)
+    {
+      auto result = BitInteger{0u};
+      while ((1u << result) < num_threads and result < num_exponent_qubits)
+        ++result;
+
+      return result;
+    }
+
+    // shor_box_segment: writes the amplitudes of the exponents in [first_exponent, last_exponent).
+    //   write(index, coefficient) stores coefficient to the amplitude of |index>
+    template <typename StateInteger, typename BitInteger, typename Qubits, typename Complex, typename Write>
+    inline void shor_box_segment(
+      StateInteger const first_exponent, StateInteger const last_exponent,
+      StateInteger const base, StateInteger const divisor,
+      BitInteger const num_exponent_qubits,
+      Qubits const& exponent_qubits, Qubits const& modular_exponentiation_qubits,
+      Complex const& coefficient, Write&& write)
+    {
+      auto modular_exponentiation_value
+        = ::ket::shor_box_detail::modular_exponentiation(base, first_exponent, divisor);
+      for (auto exponent = first_exponent; exponent < last_exponent; ++exponent)
+      {
+        write(
+          ::ket::shor_box_detail::calculate_index(
+            ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
+            modular_exponentiation_value, modular_exponentiation_qubits),
+          coefficient);
+
+        modular_exponentiation_value *= base;
+        modular_exponentiation_value %= divisor;
+      }
+    }
   } // namespace shor_box_detail
 
 
@@ -80,87 +134,29 @@ namespace ket
     ::ket::utility::fill(
       parallel_policy, first, last, complex_type{real_type{0}});
 
-    auto const num_exponent_qubits = bit_integer_type{boost::size(exponent_qubits)};
+    auto const num_exponent_qubits = static_cast<bit_integer_type>(boost::size(exponent_qubits));
     auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
 
     using std::pow;
     auto const constant_coefficient = complex_type{real_type{pow(num_exponents, -0.5)}};
 
-    for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
-    {
-      auto const index
-        = ::ket::shor_box_detail::calculate_index(
-            ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits), exponent_qubits,
-            modular_exponentiation_value, modular_exponentiation_qubits);
-
-      *(first + index) = constant_coefficient;
-
-      modular_exponentiation_value *= base;
-      modular_exponentiation_value %= divisor;
-    }
-
-
-    /*
-    // preliminary implement of parallel shor box
-    auto const num_exponent_qubits = boost::size(exponent_qubits);
-    auto const num_modular_exponentiation_qubits = boost::size(modular_exponentiation_qubits);
-
-    using qubit_type = typename boost::range_value<Qubits>::type;
-
-    static_assert(std::is_unsigned<StateInteger>::value, "StateInteger should be unsigned");
-    static_assert(
-      std::is_unsigned<typename ::ket::meta::bit_integer_of<qubit_type>::type>::value,
-      "BitInteger should be unsigned");
-
-    auto modular_squares = std::vector<StateInteger>{};
-    modular_squares.reserve(num_exponent_qubits);
-    modular_squares.push_back(base);
-    using ::ket::utility::loop_n;
-    loop_n(
-      ::ket::utility::policy::make_sequential(), num_exponent_qubits - decltype(num_exponent_qubits){1u},
-      [&modular_squares, divisor](decltype(num_exponent_qubits) const, int const)
-      { modular_squares.push_back((modular_squares.back() * modular_squares.back()) % divisor); });
-
-    auto modular_exponentiation_values = std::vector<StateInteger>{};
-    modular_exponentiation_values.reserve(::ket::utility::num_threads());
-
+    // Each exponent has its own amplitude, so the segments are written concurrently
+    auto const num_segment_bits
+      = ::ket::shor_box_detail::num_segment_bits(::ket::utility::num_threads(parallel_policy), num_exponent_qubits);
+    auto const segment_size = num_exponents >> num_segment_bits;
     using ::ket::utility::loop_n;
     loop_n(
-      parallel_policy, static_cast<StateInteger>(boost::size(state)),
-      [first](StateInteger const index, int const)
-      { *(first + index) = complex_type{real_type{0}}; });
-
-    using std::pow;
-    auto const constant_coefficient = complex_type{pow(num_exponents, -0.5)};
-    auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
-    auto const num_threads = ::ket::utility::num_threads();
-    loop_n(
-      parallel_policy, num_exponents,
-      [](StateInteger const exponent, int const thread_index)
+      parallel_policy, ::ket::utility::integer_exp2<StateInteger>(num_segment_bits),
+      [first, base, divisor, num_exponent_qubits, &exponent_qubits, &modular_exponentiation_qubits,
+       constant_coefficient, segment_size](
+        StateInteger const segment_index, int const)
       {
-        a
+        ::ket::shor_box_detail::shor_box_segment(
+          segment_index * segment_size, (segment_index + StateInteger{1u}) * segment_size,
+          base, divisor, num_exponent_qubits, exponent_qubits, modular_exponentiation_qubits,
+          constant_coefficient,
+          [first](StateInteger const index, complex_type const& coefficient) { *(first + index) = coefficient; });
       });
-
-
-    using std::pow;
-    auto const constant_coefficient = complex_type{pow(num_exponents, -0.5)};
-    auto const num_exponents = ::ket::utility::integer_exp2<StateInteger>(num_exponent_qubits);
-    auto modular_exponentiation_value = StateInteger{1u};
-    for (auto exponent = StateInteger{0u}; exponent < num_exponents; ++exponent)
-    {
-      auto const index
-        = ::ket::shor_box_detail::reverse_bits(exponent, num_exponent_qubits)
-          bitor (modular_exponentiation_value << num_exponent_qubits);
-
-      *(first + convert(index, exponent_qubits, modular_exponentiation_qubits))
-        = constant_coefficient;
-
-      modular_exponentiation_value *= base;
-      modular_exponentiation_value %= divisor;
-    }
-    */
   }
 
   template <typename RandomAccessIterator, typename StateInteger, typename Qubits>
@@ -2,9 +2,7 @@
 # define KET_SPIN_EXPECTATION_VALUE_HPP
 
 # include <cassert>
-# include <vector>
 # include <iterator>
-# include <numeric>
 # include <utility>
 # ifndef NDEBUG
 #   include <type_traits>
@@ -54,47 +52,40 @@ namespace ket
     using complex_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
     using hd_spin_type = std::array<long double, 3u>;
     auto constexpr zero_spin = hd_spin_type{ };
-    auto spins_in_threads
-      = std::vector<hd_spin_type>(::ket::utility::num_threads(parallel_policy), zero_spin);
-
-    using ::ket::utility::loop_n;
-    loop_n(
-      parallel_policy,
-      static_cast<StateInteger>(last - first)/2u,
-      [first, qubit_mask, lower_bits_mask, upper_bits_mask,
-       &spins_in_threads](
-        StateInteger const value_wo_qubit, int const thread_index)
-      {
-        // xxxxx0xxxxxx
-        auto const zero_index
-          = ((value_wo_qubit bitand upper_bits_mask) << 1u)
-            bitor (value_wo_qubit bitand lower_bits_mask);
-        // xxxxx1xxxxxx
-        auto const one_index = zero_index bitor qubit_mask;
-
-        using std::conj;
-        auto const conj_zero_value = conj(*(first+zero_index));
-        auto const one_value = *(first+one_index);
-        auto const conj_zero_times_one = conj_zero_value * one_value;
-
-        using std::real;
-        spins_in_threads[thread_index][0u] += static_cast<long double>(real(conj_zero_times_one));
-        using std::imag;
-        spins_in_threads[thread_index][1u] += static_cast<long double>(imag(conj_zero_times_one));
-        using std::norm;
-        spins_in_threads[thread_index][2u]
-          += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
-      });
-
-    hd_spin_type hd_spin
-      = std::accumulate(
-          std::begin(spins_in_threads), std::end(spins_in_threads), zero_spin,
+
+    auto const hd_spin
+      = ::ket::utility::loop_n_reduce(
+          parallel_policy,
+          static_cast<StateInteger>(last - first)/2u, zero_spin,
           [](hd_spin_type accumulated_spin, hd_spin_type const& spin)
           {
             accumulated_spin[0u] += spin[0u];
             accumulated_spin[1u] += spin[1u];
             accumulated_spin[2u] += spin[2u];
             return accumulated_spin;
+          },
+          [first, qubit_mask, lower_bits_mask, upper_bits_mask](
+            StateInteger const value_wo_qubit, int const, hd_spin_type& partial_spin)
+          {
+            // xxxxx0xxxxxx
+            auto const zero_index
+              = ((value_wo_qubit bitand upper_bits_mask) << 1u)
+                bitor (value_wo_qubit bitand lower_bits_mask);
+            // xxxxx1xxxxxx
+            auto const one_index = zero_index bitor qubit_mask;
+
+            using std::conj;
+            auto const conj_zero_value = conj(*(first+zero_index));
+            auto const one_value = *(first+one_index);
+            auto const conj_zero_times_one = conj_zero_value * one_value;
+
+            using std::real;
+            partial_spin[0u] += static_cast<long double>(real(conj_zero_times_one));
+            using std::imag;
+            partial_spin[1u] += static_cast<long double>(imag(conj_zero_times_one));
+            using std::norm;
+            partial_spin[2u]
+              += static_cast<long double>(norm(conj_zero_value)) - static_cast<long double>(norm(one_value));
           });
 
     using real_type = typename ::ket::utility::meta::real_of<complex_type>::type;
@@ -0,0 +1,56 @@
+#ifndef KET_UTILITY_FOR_EACH_BLOCK_HPP
+# define KET_UTILITY_FOR_EACH_BLOCK_HPP
+
+# include <cassert>
+# include <iterator>
+# include <algorithm>
+# include <utility>
+
+# include <ket/utility/loop_n.hpp>
+# include <ket/utility/integer_exp2.hpp>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // for_each_block(parallel_policy, first, last, num_block_qubits, function):
+    //   [first, last) is divided into blocks of 2^num_block_qubits elements (or one block if [first, last) is smaller),
+    //   and function(block_first, block_last) is called for each block. Blocks are distributed over threads,
+    //   so a sequence of gates whose qubits are all lower than num_block_qubits can be applied to one cache-resident
+    //   block after another with a sequential policy in function
+    template <
+      typename ParallelPolicy, typename RandomAccessIterator, typename BitInteger, typename Function>
+    inline void for_each_block(
+      ParallelPolicy const parallel_policy,
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      BitInteger const num_block_qubits, Function&& function)
+    {
+      using difference_type = typename std::iterator_traits<RandomAccessIterator>::difference_type;
+      auto const block_size
+        = std::min(::ket::utility::integer_exp2<difference_type>(num_block_qubits), last - first);
+      if (block_size == difference_type{0})
+        return;
+      assert((last - first) % block_size == difference_type{0});
+
+      using ::ket::utility::loop_n;
+      loop_n(
+        parallel_policy, (last - first) / block_size,
+        [first, block_size, &function](difference_type const block_index, int const)
+        { function(first + block_index * block_size, first + (block_index + difference_type{1}) * block_size); });
+    }
+
+    template <typename RandomAccessIterator, typename BitInteger, typename Function>
+    inline void for_each_block(
+      RandomAccessIterator const first, RandomAccessIterator const last,
+      BitInteger const num_block_qubits, Function&& function)
+    {
+      ::ket::utility::for_each_block(
+        ::ket::utility::policy::make_sequential(),
+        first, last, num_block_qubits, std::forward<Function>(function));
+    }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_FOR_EACH_BLOCK_HPP
@@ -1,6 +1,7 @@
 #ifndef KET_UTILITY_LOOP_N_HPP
 # define KET_UTILITY_LOOP_N_HPP
 
+# include <vector>
 # include <iterator>
 # include <algorithm>
 # include <numeric>
@@ -106,6 +107,70 @@ namespace ket
     }
 
 
+    // loop_n_reduce
+    namespace dispatch
+    {
+      template <typename ParallelPolicy, typename Integer>
+      struct loop_n_reduce
+      {
+        template <typename Value, typename Function>
+        static std::vector<Value> call(
+          ParallelPolicy const, Integer const n, Value const& identity, Function&& function);
+      }; // struct loop_n_reduce<ParallelPolicy, Integer>
+
+      template <typename Integer>
+      struct loop_n_reduce< ::ket::utility::policy::sequential, Integer >
+      {
+        template <typename Value, typename Function>
+        static std::vector<Value> call(
+          ::ket::utility::policy::sequential const,
+          Integer const n, Value const& identity, Function&& function)
+        {
+          auto accumulator = identity;
+          for (auto count = Integer{0}; count < n; ++count)
+            function(count, 0, accumulator);
+
+          return std::vector<Value>(1u, accumulator);
+        }
+      }; // struct loop_n_reduce< ::ket::utility::policy::sequential, Integer >
+    } // namespace dispatch
+
+    // function(count, thread_index, accumulator) updates the accumulator owned by the calling thread,
+    // which starts from identity. The accumulators are returned in the order of thread indices.
+    template <typename ParallelPolicy, typename Integer, typename Value, typename Function>
+    inline std::vector<Value> loop_n_reduce_by_thread(
+      ParallelPolicy const parallel_policy,
+      Integer const n, Value const& identity, Function&& function)
+    {
+      return ::ket::utility::dispatch::loop_n_reduce<ParallelPolicy, Integer>::call(
+        parallel_policy, n, identity, std::forward<Function>(function));
+    }
+
+    // The accumulators are combined in the order of thread indices, so the result does not depend on scheduling
+    template <
+      typename ParallelPolicy, typename Integer, typename Value,
+      typename BinaryOperation, typename Function>
+    inline Value loop_n_reduce(
+      ParallelPolicy const parallel_policy,
+      Integer const n, Value const identity, BinaryOperation binary_operation, Function&& function)
+    {
+      auto const accumulators
+        = ::ket::utility::loop_n_reduce_by_thread(
+            parallel_policy, n, identity, std::forward<Function>(function));
+      return std::accumulate(
+        std::begin(accumulators), std::end(accumulators), identity, binary_operation);
+    }
+
+    template <typename Integer, typename Value, typename BinaryOperation, typename Function>
+    inline Value loop_n_reduce(
+      Integer const n, Value const identity, BinaryOperation binary_operation, Function&& function)
+    {
+      return ::ket::utility::loop_n_reduce(
+        ::ket::utility::policy::make_sequential(),
+        n, identity, binary_operation, std::forward<Function>(function));
+    }
+
+
     // execute
     namespace dispatch
     {
@@ -173,7 +238,7 @@ namespace ket
       {
         template <typename Executor, typename Function>
         static void call(
-          ParallelPolicy const, Executor&, Function&& function);
+          ParallelPolicy const, Executor&, int const thread_index, Function&& function);
       }; // struct single_execute<ParallelPolicy>
 
       template <>
@@ -183,7 +248,7 @@ namespace ket
         static void call(
           ::ket::utility::policy::sequential const,
           ::ket::utility::dispatch::execute< ::ket::utility::policy::sequential >&,
-          Function&& function)
+          int const, Function&& function)
         { std::forward<Function>(function)(); }
       }; // struct single_execute< ::ket::utility::policy::sequential >
     } // namespace dispatch
@@ -238,20 +303,22 @@ namespace ket
     inline void barrier(ParallelPolicy const parallel_policy, Executor& executor)
     { ::ket::utility::dispatch::barrier<ParallelPolicy>::call(parallel_policy, executor); }
 
+    // single_execute: function is called only on one thread, and then all the threads wait for it.
+    //   thread_index is the one passed to the function given to execute
     template <typename Executor, typename Function>
     inline void single_execute(
-      Executor& executor, Function&& function)
+      Executor& executor, int const thread_index, Function&& function)
     {
       ::ket::utility::dispatch::single_execute< ::ket::utility::policy::sequential >::call(
-        ::ket::utility::policy::sequential(), executor, std::forward<Function>(function));
+        ::ket::utility::policy::sequential(), executor, thread_index, std::forward<Function>(function));
     }
 
     template <typename ParallelPolicy, typename Executor, typename Function>
     inline void single_execute(
-      ParallelPolicy const parallel_policy, Executor& executor, Function&& function)
+      ParallelPolicy const parallel_policy, Executor& executor, int const thread_index, Function&& function)
     {
       ::ket::utility::dispatch::single_execute<ParallelPolicy>::call(
-        parallel_policy, executor, std::forward<Function>(function));
+        parallel_policy, executor, thread_index, std::forward<Function>(function));
     }
 
 
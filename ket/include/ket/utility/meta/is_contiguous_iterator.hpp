@@ -0,0 +1,45 @@
+#ifndef KET_UTILITY_META_IS_CONTIGUOUS_ITERATOR_HPP
+# define KET_UTILITY_META_IS_CONTIGUOUS_ITERATOR_HPP
+
+# include <type_traits>
+# ifdef __GLIBCXX__
+#   include <bits/stl_iterator.h>
+# endif
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace meta
+    {
+      // is_contiguous_iterator<Iterator>::value is true if *(first + n) and *(&*first + n) are the same object.
+      // Only pointers and iterators of std::vector (and std::array) of known standard libraries are detected
+      template <typename Iterator>
+      struct is_contiguous_iterator
+        : std::false_type
+      { }; // struct is_contiguous_iterator<Iterator>
+
+      template <typename T>
+      struct is_contiguous_iterator<T*>
+        : std::true_type
+      { }; // struct is_contiguous_iterator<T*>
+
+# ifdef __GLIBCXX__
+      template <typename Pointer, typename Container>
+      struct is_contiguous_iterator< ::__gnu_cxx::__normal_iterator<Pointer, Container> >
+        : std::is_pointer<Pointer>
+      { }; // struct is_contiguous_iterator< ::__gnu_cxx::__normal_iterator<Pointer, Container> >
+# endif // __GLIBCXX__
+# ifdef _LIBCPP_VERSION
+      template <typename Pointer>
+      struct is_contiguous_iterator< ::std::__wrap_iter<Pointer> >
+        : std::is_pointer<Pointer>
+      { }; // struct is_contiguous_iterator< ::std::__wrap_iter<Pointer> >
+# endif // _LIBCPP_VERSION
+    } // namespace meta
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_META_IS_CONTIGUOUS_ITERATOR_HPP
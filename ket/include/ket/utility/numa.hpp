@@ -0,0 +1,52 @@
+#ifndef KET_UTILITY_NUMA_HPP
+# define KET_UTILITY_NUMA_HPP
+
+# include <cstddef>
+# include <cstdint>
+# include <vector>
+# if defined(KET_USE_NUMA_INTERLEAVE) && defined(__linux__)
+#   include <numa.h>
+# endif // defined(KET_USE_NUMA_INTERLEAVE) && defined(__linux__)
+
+# include <ket/utility/planar_complex_vector.hpp>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // interleave_pages: if KET_USE_NUMA_INTERLEAVE is defined (and libnuma is linked), memory pages of the data which
+    //   are not touched yet are placed on all the NUMA nodes in round-robin order. Otherwise the pages are placed by
+    //   first touch, i.e. on the NUMA node of the thread writing them first
+    inline void interleave_pages(void* const pointer, std::size_t const num_bytes) noexcept
+    {
+# if defined(KET_USE_NUMA_INTERLEAVE) && defined(__linux__)
+      if (num_bytes == std::size_t{0u} or numa_available() < 0)
+        return;
+
+      // mbind requires the address aligned to the page size
+      auto const page_size = static_cast<std::uintptr_t>(numa_pagesize());
+      auto const first = reinterpret_cast<std::uintptr_t>(pointer) bitand compl (page_size - std::uintptr_t{1u});
+      auto const last = reinterpret_cast<std::uintptr_t>(pointer) + num_bytes;
+      numa_interleave_memory(reinterpret_cast<void*>(first), static_cast<std::size_t>(last - first), numa_all_nodes_ptr);
+# else // defined(KET_USE_NUMA_INTERLEAVE) && defined(__linux__)
+      static_cast<void>(pointer);
+      static_cast<void>(num_bytes);
+# endif // defined(KET_USE_NUMA_INTERLEAVE) && defined(__linux__)
+    }
+
+    template <typename Value, typename Allocator>
+    inline void interleave_pages(std::vector<Value, Allocator>& data) noexcept
+    { ::ket::utility::interleave_pages(data.data(), data.size() * sizeof(Value)); }
+
+    template <typename Real, typename Allocator>
+    inline void interleave_pages(::ket::utility::planar_complex_vector<Real, Allocator>& data) noexcept
+    {
+      ::ket::utility::interleave_pages(data.real_data(), data.size() * sizeof(Real));
+      ::ket::utility::interleave_pages(data.imag_data(), data.size() * sizeof(Real));
+    }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_NUMA_HPP
@@ -10,9 +10,9 @@
 # if defined(_OPENMP) && defined(KET_USE_OPENMP)
 #   include <stdexcept>
 # else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+#   include <algorithm>
+#   include <memory>
 #   include <thread>
-#   include <future>
-#   include <condition_variable>
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 # include <type_traits>
 
@@ -23,6 +23,11 @@
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 
 # include <ket/utility/loop_n.hpp>
+# if !(defined(_OPENMP) && defined(KET_USE_OPENMP))
+#   include <ket/utility/parallel/thread_pool.hpp>
+# else // !(defined(_OPENMP) && defined(KET_USE_OPENMP))
+#   include <ket/utility/parallel/thread_affinity.hpp>
+# endif // !(defined(_OPENMP) && defined(KET_USE_OPENMP))
 
 
 namespace ket
@@ -35,12 +40,15 @@ namespace ket
       class parallel
       {
         NumThreads num_threads_;
+# if !(defined(_OPENMP) && defined(KET_USE_OPENMP))
+        std::shared_ptr< ::ket::utility::thread_pool > thread_pool_;
+# endif // !(defined(_OPENMP) && defined(KET_USE_OPENMP))
 
        public:
 # if defined(_OPENMP) && defined(KET_USE_OPENMP)
         parallel() noexcept
           : num_threads_(static_cast<NumThreads>(omp_get_max_threads()))
-        { }
+        { pin_threads(); }
 
         explicit parallel(NumThreads const num_threads)
           : num_threads_(
@@ -49,51 +57,84 @@ namespace ket
               : num_threads > static_cast<NumThreads>(omp_get_max_threads())
                 ? static_cast<NumThreads>(omp_get_max_threads())
                 : num_threads)
-        { omp_set_num_threads(static_cast<int>(num_threads_)); }
+        {
+          omp_set_num_threads(static_cast<int>(num_threads_));
+          pin_threads();
+        }
 # else // defined(_OPENMP) && defined(KET_USE_OPENMP)
-        parallel() noexcept
-          : num_threads_(static_cast<NumThreads>(std::thread::hardware_concurrency()))
+        parallel()
+          : num_threads_(
+              std::thread::hardware_concurrency() == 0u
+              ? NumThreads{1}
+              : static_cast<NumThreads>(std::thread::hardware_concurrency())),
+            thread_pool_{make_thread_pool(num_threads_)}
         { }
 
-        explicit parallel(NumThreads const num_threads) noexcept
+        explicit parallel(NumThreads const num_threads)
           : num_threads_(
               num_threads <= NumThreads{0}
               ? NumThreads{1}
               : num_threads >= static_cast<NumThreads>(std::thread::hardware_concurrency())
-                ? static_cast<NumThreads>(std::thread::hardware_concurrency())
-                : num_threads)
+                ? std::max(NumThreads{1}, static_cast<NumThreads>(std::thread::hardware_concurrency()))
+                : num_threads),
+            thread_pool_{make_thread_pool(num_threads_)}
         { }
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
 
         NumThreads num_threads() const noexcept { return num_threads_; }
 
 # if defined(_OPENMP) && defined(KET_USE_OPENMP)
-        void num_threads(NumThreads const num_threads) const noexcept
+        void num_threads(NumThreads const num_threads) noexcept
         {
           if (num_threads <= 0 or num_threads > static_cast<NumThreads>(omp_get_max_threads()))
             return;
 
           num_threads_ = num_threads;
           omp_set_num_threads(static_cast<int>(num_threads_));
+          pin_threads();
+        }
+
+       private:
+        // threads of "omp parallel" are bound to CPUs like workers of ket::utility::thread_pool if
+        // KET_USE_THREAD_AFFINITY is defined
+        void pin_threads() const noexcept
+        {
+#   ifdef KET_USE_THREAD_AFFINITY
+#     pragma omp parallel num_threads(static_cast<int>(num_threads_))
+          ::ket::utility::pin_this_thread(static_cast<unsigned int>(omp_get_thread_num()));
+#   endif // KET_USE_THREAD_AFFINITY
         }
 # else // defined(_OPENMP) && defined(KET_USE_OPENMP)
-        void num_threads(NumThreads const num_threads) const noexcept
+        void num_threads(NumThreads const num_threads)
         {
           if (num_threads <= 0 or num_threads > static_cast<NumThreads>(std::thread::hardware_concurrency()))
             return;
 
           num_threads_ = num_threads;
+          thread_pool_ = make_thread_pool(num_threads_);
+        }
+
+        // copies of a policy share the same workers; nullptr if num_threads() == 1
+        ::ket::utility::thread_pool* thread_pool() const noexcept { return thread_pool_.get(); }
+
+       private:
+        static std::shared_ptr< ::ket::utility::thread_pool > make_thread_pool(NumThreads const num_threads)
+        {
+          if (num_threads <= NumThreads{1})
+            return std::shared_ptr< ::ket::utility::thread_pool >{};
+
+          return std::make_shared< ::ket::utility::thread_pool >(static_cast<unsigned int>(num_threads));
         }
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
       }; // class parallel<NumThreads>
 
       template <typename NumThreads>
-      inline constexpr ::ket::utility::policy::parallel<NumThreads> make_parallel() noexcept
+      inline ::ket::utility::policy::parallel<NumThreads> make_parallel()
       { return ::ket::utility::policy::parallel<NumThreads>{}; }
 
       template <typename NumThreads>
-      inline constexpr ::ket::utility::policy::parallel<NumThreads>
-      make_parallel(NumThreads const num_threads) noexcept
+      inline ::ket::utility::policy::parallel<NumThreads>
+      make_parallel(NumThreads const num_threads)
       { return ::ket::utility::policy::parallel<NumThreads>(num_threads); }
 
       namespace meta
@@ -147,6 +188,21 @@ namespace ket
           : std::runtime_error("nonstandard exception is thrown in OpenMP block")
         { }
       }; // class omp_nonstandard_exception
+# else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+      // [first, last) of counts assigned to thread_index, the same partition as "omp for" with static schedule
+      template <typename Integer, typename NumThreads>
+      inline std::pair<Integer, Integer> static_partition(
+        Integer const n, NumThreads const num_threads, NumThreads const thread_index) noexcept
+      {
+        auto const local_num_counts = static_cast<NumThreads>(n) / num_threads;
+        auto const remainder = static_cast<NumThreads>(n) % num_threads;
+        return std::make_pair(
+          static_cast<Integer>(
+            local_num_counts * thread_index + std::min(remainder, thread_index)),
+          static_cast<Integer>(
+            local_num_counts * (thread_index + NumThreads{1u})
+            + std::min(remainder, thread_index + NumThreads{1u})));
+      }
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
     } // namespace parallel_loop_n_detail
 
@@ -169,10 +225,11 @@ namespace ket
           using mutex_type = ::ket::utility::parallel_loop_n_detail::omp_mutex;
           mutex_type mutex;
 
-#   pragma omp parallel reduction(||:is_nonstandard_exception_thrown)
+#   pragma omp parallel num_threads(static_cast<int>(::ket::utility::num_threads(parallel_policy))) \
+      reduction(||:is_nonstandard_exception_thrown)
           {
             auto const thread_index = static_cast<int>(omp_get_thread_num());
-#   pragma omp for
+#   pragma omp for schedule(static)
             for (auto count = Integer{0}; count < n; ++count)
               try
               {
@@ -204,50 +261,137 @@ namespace ket
       {
         template <typename Function>
         static void call(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
           Integer const n, Function&& function)
         {
           assert(::ket::utility::num_threads(parallel_policy) > 0u);
 
+          auto const thread_pool = parallel_policy.thread_pool();
+          if (thread_pool == nullptr)
+          {
+            for (auto count = Integer{0}; count < n; ++count)
+              function(count, 0);
+            return;
+          }
+
           auto const num_threads
             = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
-          auto const num_futures = num_threads - NumThreads{1u};
-          auto futures = std::vector<std::future<void>>{};
-          futures.reserve(num_futures);
+          thread_pool->run(
+            [n, num_threads, &function](int const thread_index)
+            {
+              auto const first_last_counts
+                = ::ket::utility::parallel_loop_n_detail::static_partition(
+                    n, num_threads, static_cast<NumThreads>(thread_index));
+
+              for (auto count = first_last_counts.first; count < first_last_counts.second; ++count)
+                function(count, thread_index);
+            });
+        }
+      }; // struct loop_n< ::ket::utility::policy::parallel<NumThreads>, Integer >
+# endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
+    } // namespace dispatch
 
-          auto const local_num_counts = static_cast<NumThreads>(n) / num_threads;
-          auto const remainder = static_cast<NumThreads>(n) % num_threads;
-          auto first_count = Integer{0};
 
-          for (auto thread_index = NumThreads{0u}; thread_index < num_futures; ++thread_index)
+    // loop_n_reduce
+    namespace dispatch
+    {
+# if defined(_OPENMP) && defined(KET_USE_OPENMP)
+      template <typename NumThreads, typename Integer>
+      struct loop_n_reduce< ::ket::utility::policy::parallel<NumThreads>, Integer >
+      {
+        template <typename Value, typename Function>
+        static std::vector<Value> call(
+          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          Integer const n, Value const& identity, Function&& function)
+        {
+          assert(::ket::utility::num_threads(parallel_policy) > 0u);
+
+          auto result = std::vector<Value>(::ket::utility::num_threads(parallel_policy), identity);
+
+          auto maybe_error = boost::optional<std::exception>{};
+          auto is_nonstandard_exception_thrown = false;
+
+          using mutex_type = ::ket::utility::parallel_loop_n_detail::omp_mutex;
+          mutex_type mutex;
+
+#   pragma omp parallel num_threads(static_cast<int>(::ket::utility::num_threads(parallel_policy))) \
+      reduction(||:is_nonstandard_exception_thrown)
           {
-            auto const last_count
-              = static_cast<Integer>(
-                  local_num_counts * (thread_index + NumThreads{1u})
-                  + std::min(remainder, thread_index + NumThreads{1u}));
-
-            futures.push_back(std::async(
-              std::launch::async,
-              [&function, first_count, last_count, thread_index]
+            auto const thread_index = static_cast<int>(omp_get_thread_num());
+            // accumulators live on the stacks of their threads until the loop ends
+            auto accumulator = identity;
+#   pragma omp for schedule(static) nowait
+            for (auto count = Integer{0}; count < n; ++count)
+              try
+              {
+                function(count, thread_index, accumulator);
+              }
+              catch (std::exception& error)
+              {
+                std::lock_guard<mutex_type> lock{mutex};
+
+                if (!maybe_error)
+                  maybe_error = error;
+              }
+              catch (...)
               {
-                for (auto count = first_count; count < last_count; ++count)
-                  function(count, static_cast<int>(thread_index));
-              }));
+                is_nonstandard_exception_thrown = true;
+              }
 
-            first_count = last_count;
+            result[thread_index] = accumulator;
           }
 
-          auto const last_count
-            = static_cast<Integer>(
-                local_num_counts * num_threads + std::min(remainder, num_threads));
+          if (is_nonstandard_exception_thrown)
+            throw ::ket::utility::parallel_loop_n_detail::omp_nonstandard_exception{};
 
-          for (auto count = first_count; count < last_count; ++count)
-            std::forward<Function>(function)(count, static_cast<int>(num_futures));
+          if (maybe_error)
+            throw *maybe_error;
 
-          for (auto const& future: futures)
-            future.wait();
+          return result;
         }
-      }; // struct loop_n< ::ket::utility::policy::parallel<NumThreads>, Integer >
+      }; // struct loop_n_reduce< ::ket::utility::policy::parallel<NumThreads>, Integer >
+# else // defined(_OPENMP) && defined(KET_USE_OPENMP)
+      template <typename NumThreads, typename Integer>
+      struct loop_n_reduce< ::ket::utility::policy::parallel<NumThreads>, Integer >
+      {
+        template <typename Value, typename Function>
+        static std::vector<Value> call(
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
+          Integer const n, Value const& identity, Function&& function)
+        {
+          assert(::ket::utility::num_threads(parallel_policy) > 0u);
+
+          auto result = std::vector<Value>(::ket::utility::num_threads(parallel_policy), identity);
+
+          auto const thread_pool = parallel_policy.thread_pool();
+          if (thread_pool == nullptr)
+          {
+            for (auto count = Integer{0}; count < n; ++count)
+              function(count, 0, result.front());
+            return result;
+          }
+
+          auto const num_threads
+            = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
+          auto const result_first = std::begin(result);
+          thread_pool->run(
+            [n, num_threads, &identity, &function, result_first](int const thread_index)
+            {
+              auto const first_last_counts
+                = ::ket::utility::parallel_loop_n_detail::static_partition(
+                    n, num_threads, static_cast<NumThreads>(thread_index));
+
+              // accumulators live on the stacks of their threads until the loop ends
+              auto accumulator = identity;
+              for (auto count = first_last_counts.first; count < first_last_counts.second; ++count)
+                function(count, thread_index, accumulator);
+
+              result_first[thread_index] = accumulator;
+            });
+
+          return result;
+        }
+      }; // struct loop_n_reduce< ::ket::utility::policy::parallel<NumThreads>, Integer >
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
     } // namespace dispatch
 
@@ -273,7 +417,8 @@ namespace ket
           using mutex_type = ::ket::utility::parallel_loop_n_detail::omp_mutex;
           mutex_type mutex;
 
-#   pragma omp parallel reduction(||:is_nonstandard_exception_thrown)
+#   pragma omp parallel num_threads(static_cast<int>(::ket::utility::num_threads(parallel_policy))) \
+      reduction(||:is_nonstandard_exception_thrown)
           {
             try
             {
@@ -308,7 +453,7 @@ namespace ket
           ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
           Integer const n, int const thread_index, Function&& function)
         {
-#   pragma omp for
+#   pragma omp for schedule(static)
           for (auto count = Integer{0}; count < n; ++count)
             function(count, thread_index);
         }
@@ -330,7 +475,7 @@ namespace ket
       {
         template <typename Executor, typename Function>
         static void call(
-          ::ket::utility::policy::parallel<NumThreads> const, Executor&,
+          ::ket::utility::policy::parallel<NumThreads> const, Executor&, int const,
           Function&& function)
         {
 #   pragma omp single
@@ -343,47 +488,28 @@ namespace ket
       template <typename NumThreads>
       class execute< ::ket::utility::policy::parallel<NumThreads> >
       {
-        std::mutex mutex_;
-        std::condition_variable cond_;
-        std::vector<int> barrier_counters_;
-
-        typedef ::ket::utility::policy::parallel<NumThreads> parallel_policy_type;
-        friend class loop_n_in_execute<parallel_policy_type>;
-        friend class barrier<parallel_policy_type>;
-        friend class single_execute<parallel_policy_type>;
-
        public:
-        execute()
-          : mutex_{}, cond_{}, barrier_counters_{}
-        { barrier_counters_.reserve(64); }
-
         template <typename Function>
         void invoke(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
           Function&& function)
         {
           assert(::ket::utility::num_threads(parallel_policy) > 0u);
 
-          auto const num_threads
-            = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
-          barrier_counters_.push_back(num_threads);
-
-          auto const num_futures = num_threads - NumThreads{1u};
-          auto futures = std::vector<std::future<void>>{};
-          futures.reserve(num_futures);
-
-          for (auto thread_index = NumThreads{0u}; thread_index < num_futures; ++thread_index)
+          auto const thread_pool = parallel_policy.thread_pool();
+          if (thread_pool == nullptr)
           {
-            futures.push_back(std::async(
-              std::launch::async,
-              [&function, thread_index, this]
-              { function(static_cast<int>(thread_index), *this); }));
+            function(0, *this);
+            return;
           }
 
-          std::forward<Function>(function)(static_cast<int>(num_futures), *this);
+          // function may call barrier(), which needs all the threads running concurrently
+          assert(
+            thread_pool->num_threads() == 1u
+            or not ::ket::utility::thread_pool_detail::is_in_thread_pool());
 
-          for (auto const& future: futures)
-            future.wait();
+          thread_pool->run(
+            [&function, this](int const thread_index) { function(thread_index, *this); });
         }
       }; // class execute< ::ket::utility::policy::parallel<NumThreads> >
 
@@ -392,24 +518,16 @@ namespace ket
       {
         template <typename Integer, typename Function>
         static void call(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
           Integer const n, int const thread_index,
           Function&& function)
         {
-          auto const num_threads
-            = static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy));
-          auto const local_num_counts = static_cast<NumThreads>(n) / num_threads;
-          auto const remainder = static_cast<NumThreads>(n) % num_threads;
-          auto const first_count
-            = static_cast<Integer>(
-                local_num_counts * static_cast<NumThreads>(thread_index)
-                + std::min(remainder, static_cast<NumThreads>(thread_index)));
-          auto const last_count
-            = static_cast<Integer>(
-                local_num_counts * static_cast<NumThreads>(thread_index + 1)
-                + std::min(remainder, static_cast<NumThreads>(thread_index + 1)));
-
-          for (auto count = first_count; count < last_count; ++count)
+          auto const first_last_counts
+            = ::ket::utility::parallel_loop_n_detail::static_partition(
+                n, static_cast<NumThreads>(::ket::utility::num_threads(parallel_policy)),
+                static_cast<NumThreads>(thread_index));
+
+          for (auto count = first_last_counts.first; count < first_last_counts.second; ++count)
             function(count, thread_index);
         }
       }; // struct loop_n_in_execute< ::ket::utility::policy::parallel<NumThreads> >
@@ -418,26 +536,11 @@ namespace ket
       struct barrier< ::ket::utility::policy::parallel<NumThreads> >
       {
         static void call(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
-          ::ket::utility::dispatch::execute< ::ket::utility::policy::parallel<NumThreads> >& executor)
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
+          ::ket::utility::dispatch::execute< ::ket::utility::policy::parallel<NumThreads> >&)
         {
-          auto const index
-            = static_cast<std::size_t>(executor.barrier_counters_.size()) - std::size_t{1u};
-
-          if (executor.barrier_counters_[index] == 1)
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
-            executor.barrier_counters_.push_back(
-              static_cast<int>(::ket::utility::num_threads(parallel_policy)));
-            --executor.barrier_counters_[index];
-            executor.cond_.notify_all();
-            return;
-          }
-
-          auto lock = std::unique_lock<std::mutex>{executor.mutex_};
-          --executor.barrier_counters_[index];
-          executor.cond_.wait(
-            lock, [&executor, index] { return executor.barrier_counters_[index] == 0; });
+          if (parallel_policy.thread_pool() != nullptr)
+            parallel_policy.thread_pool()->barrier();
         }
       }; // struct barrier< ::ket::utility::policy::parallel<NumThreads> >
 
@@ -446,34 +549,15 @@ namespace ket
       {
         template <typename Function>
         static void call(
-          ::ket::utility::policy::parallel<NumThreads> const parallel_policy,
+          ::ket::utility::policy::parallel<NumThreads> const& parallel_policy,
           ::ket::utility::dispatch::execute< ::ket::utility::policy::parallel<NumThreads> >& executor,
-          Function&& function)
+          int const thread_index, Function&& function)
         {
-          auto const index
-            = static_cast<std::size_t>(executor.barrier_counters_.size()) - std::size_t{1u};
-
-          if (executor.barrier_counters_[index]
-              == static_cast<int>(::ket::utility::num_threads(parallel_policy)))
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
+          if (thread_index == 0)
             function();
-          }
 
-          if (executor.barrier_counters_[index] == 1)
-          {
-            std::lock_guard<std::mutex> lock{executor.mutex_};
-            executor.barrier_counters_.push_back(
-              static_cast<int>(::ket::utility::num_threads(parallel_policy)));
-            --executor.barrier_counters_[index];
-            executor.cond_.notify_all();
-            return;
-          }
-
-          auto lock = std::unique_lock<std::mutex>{executor.mutex_};
-          --executor.barrier_counters_[index];
-          executor.cond_.wait(
-            lock, [&executor, index] { return executor.barrier_counters_[index] == 0; });
+          ::ket::utility::dispatch::barrier< ::ket::utility::policy::parallel<NumThreads> >::call(
+            parallel_policy, executor);
         }
       }; // struct single_execute< ::ket::utility::policy::parallel<NumThreads> >
 # endif // defined(_OPENMP) && defined(KET_USE_OPENMP)
@@ -582,6 +666,8 @@ namespace ket
           });
       }
 
+      // The first element of partial_sums[thread_index] is false if no count is assigned to the thread.
+      // Because counts are assigned from thread 0 onward, such threads always come last.
       template <
         typename ParallelPolicy,
         typename RangeSize, typename RandomAccessIterator, typename BinaryOperation,
@@ -589,13 +675,20 @@ namespace ket
       inline void post_inclusive_scan(
         ParallelPolicy const parallel_policy,
         RangeSize const range_size, RandomAccessIterator d_first, BinaryOperation binary_operation,
-        std::vector<Value, Allocator>& partial_sums)
+        std::vector<std::pair<bool, Value>, Allocator>& partial_sums)
       {
         auto partial_sums_first = std::begin(partial_sums);
 
+        using partial_sum_type = std::pair<bool, Value>;
         std::partial_sum(
-          partial_sums_first, std::end(partial_sums),
-          partial_sums_first, binary_operation);
+          partial_sums_first, std::end(partial_sums), partial_sums_first,
+          [binary_operation](partial_sum_type const& lhs, partial_sum_type const& rhs)
+          {
+            if (not lhs.first or not rhs.first)
+              return rhs.first ? rhs : lhs;
+
+            return partial_sum_type{true, binary_operation(lhs.second, rhs.second)};
+          });
 
         using ::ket::utility::loop_n;
         loop_n(
@@ -607,7 +700,7 @@ namespace ket
               return;
 
             d_first[n]
-              = binary_operation(partial_sums_first[thread_index - 1], d_first[n]);
+              = binary_operation(partial_sums_first[thread_index - 1].second, d_first[n]);
           });
       }
     } // namespace parallel_loop_n_detail
@@ -699,27 +792,23 @@ namespace ket
         {
           using value_type
             = typename std::iterator_traits<RandomAccessIterator1>::value_type;
-          auto partial_sums
-            = std::vector<value_type>(
-                ::ket::utility::num_threads(parallel_policy), value_type{0});
-
-          auto partial_sums_first = std::begin(partial_sums);
-
-          using ::ket::utility::loop_n;
           using difference_type
             = typename std::iterator_traits<RandomAccessIterator1>::difference_type;
-          loop_n(
-            parallel_policy, last - first,
-            [first, d_first, partial_sums_first](
-              difference_type const n, int const thread_index)
-            {
-              partial_sums_first[thread_index] += first[n];
-              d_first[n] = partial_sums_first[thread_index];
-            });
+          auto partial_sums
+            = ::ket::utility::loop_n_reduce_by_thread(
+                parallel_policy, last - first, value_type{0},
+                [first, d_first](
+                  difference_type const n, int const, value_type& partial_sum)
+                {
+                  partial_sum += first[n];
+                  d_first[n] = partial_sum;
+                });
 
+          auto partial_sums_first = std::begin(partial_sums);
           std::partial_sum(
             partial_sums_first, std::end(partial_sums), partial_sums_first);
 
+          using ::ket::utility::loop_n;
           loop_n(
             parallel_policy, last - first,
             [d_first, partial_sums_first](
@@ -804,36 +893,27 @@ namespace ket
           BinaryOperation binary_operation,
           std::random_access_iterator_tag const, std::random_access_iterator_tag const)
         {
-          auto is_calleds
-            = std::vector<int>(
-                ::ket::utility::num_threads(parallel_policy), static_cast<int>(false));
           using value_type
             = typename std::iterator_traits<RandomAccessIterator1>::value_type;
-          auto partial_sums
-            = std::vector<value_type>(::ket::utility::num_threads(parallel_policy));
-
-          auto is_calleds_first = std::begin(is_calleds);
-          auto partial_sums_first = std::begin(partial_sums);
-
-          using ::ket::utility::loop_n;
+          using partial_sum_type = std::pair<bool, value_type>;
           using difference_type
             = typename std::iterator_traits<RandomAccessIterator1>::difference_type;
-          loop_n(
-            parallel_policy, last - first,
-            [first, d_first, binary_operation, is_calleds_first, partial_sums_first](
-              difference_type const n, int const thread_index)
-            {
-              if (not is_calleds_first[thread_index])
-              {
-                partial_sums_first[thread_index] = first[n];
-                is_calleds_first[thread_index] = static_cast<int>(true);
-              }
-              else
-                partial_sums_first[thread_index]
-                  = binary_operation(partial_sums_first[thread_index], first[n]);
-
-              d_first[n] = partial_sums_first[thread_index];
-            });
+          auto partial_sums
+            = ::ket::utility::loop_n_reduce_by_thread(
+                parallel_policy, last - first, partial_sum_type{false, value_type{}},
+                [first, d_first, binary_operation](
+                  difference_type const n, int const, partial_sum_type& partial_sum)
+                {
+                  if (partial_sum.first)
+                    partial_sum.second = binary_operation(partial_sum.second, first[n]);
+                  else
+                  {
+                    partial_sum.second = first[n];
+                    partial_sum.first = true;
+                  }
+
+                  d_first[n] = partial_sum.second;
+                });
 
           ::ket::utility::parallel_loop_n_detail::post_inclusive_scan(
             parallel_policy, last - first, d_first, binary_operation, partial_sums);
@@ -914,38 +994,29 @@ namespace ket
           BinaryOperation binary_operation, Value const initial_value,
           std::random_access_iterator_tag const, std::random_access_iterator_tag const)
         {
-          auto is_calleds
-            = std::vector<int>(
-                ::ket::utility::num_threads(parallel_policy), static_cast<int>(false));
           using value_type = typename std::iterator_traits<RandomAccessIterator1>::value_type;
-          auto partial_sums
-            = std::vector<value_type>(::ket::utility::num_threads(parallel_policy));
-
-          auto is_calleds_first = std::begin(is_calleds);
-          auto partial_sums_first = std::begin(partial_sums);
-
-          using ::ket::utility::loop_n;
+          using partial_sum_type = std::pair<bool, value_type>;
           using difference_type
             = typename std::iterator_traits<RandomAccessIterator1>::difference_type;
-          loop_n(
-            parallel_policy, last - first,
-            [first, d_first, binary_operation, initial_value, is_calleds_first, partial_sums_first](
-              difference_type const n, int const thread_index)
-            {
-              if (not is_calleds_first[thread_index])
-              {
-                partial_sums_first[thread_index]
-                  = thread_index == 0
-                    ? binary_operation(initial_value, first[n])
-                    : first[n];
-                is_calleds_first[thread_index] = static_cast<int>(true);
-              }
-              else
-                partial_sums_first[thread_index]
-                  = binary_operation(partial_sums_first[thread_index], first[n]);
-
-              d_first[n] = partial_sums_first[thread_index];
-            });
+          auto partial_sums
+            = ::ket::utility::loop_n_reduce_by_thread(
+                parallel_policy, last - first, partial_sum_type{false, value_type{}},
+                [first, d_first, binary_operation, initial_value](
+                  difference_type const n, int const thread_index, partial_sum_type& partial_sum)
+                {
+                  if (partial_sum.first)
+                    partial_sum.second = binary_operation(partial_sum.second, first[n]);
+                  else
+                  {
+                    if (thread_index == 0)
+                      partial_sum.second = binary_operation(initial_value, first[n]);
+                    else
+                      partial_sum.second = first[n];
+                    partial_sum.first = true;
+                  }
+
+                  d_first[n] = partial_sum.second;
+                });
 
           ::ket::utility::parallel_loop_n_detail::post_inclusive_scan(
             parallel_policy, last - first, d_first, binary_operation, partial_sums);
@@ -1034,37 +1105,26 @@ namespace ket
           BinaryOperation binary_operation, UnaryOperation unary_operation,
           std::random_access_iterator_tag const, std::random_access_iterator_tag const)
         {
-          auto is_calleds
-            = std::vector<int>(
-                ::ket::utility::num_threads(parallel_policy), static_cast<int>(false));
           using value_type = typename std::iterator_traits<RandomAccessIterator1>::value_type;
-          auto partial_sums
-            = std::vector<value_type>(::ket::utility::num_threads(parallel_policy));
-
-          auto is_calleds_first = std::begin(is_calleds);
-          auto partial_sums_first = std::begin(partial_sums);
-
-          using ::ket::utility::loop_n;
+          using partial_sum_type = std::pair<bool, value_type>;
           using difference_type
             = typename std::iterator_traits<RandomAccessIterator1>::difference_type;
-          loop_n(
-            parallel_policy, last - first,
-            [first, d_first, binary_operation, unary_operation,
-             is_calleds_first, partial_sums_first](
-              difference_type const n, int const thread_index)
-            {
-              if (not is_calleds_first[thread_index])
-              {
-                partial_sums_first[thread_index] = unary_operation(first[n]);
-                is_calleds_first[thread_index] = static_cast<int>(true);
-              }
-              else
-                partial_sums_first[thread_index]
-                  = binary_operation(
-                      partial_sums_first[thread_index], unary_operation(first[n]));
-
-              d_first[n] = partial_sums_first[thread_index];
-            });
+          auto partial_sums
+            = ::ket::utility::loop_n_reduce_by_thread(
+                parallel_policy, last - first, partial_sum_type{false, value_type{}},
+                [first, d_first, binary_operation, unary_operation](
+                  difference_type const n, int const, partial_sum_type& partial_sum)
+                {
+                  if (partial_sum.first)
+                    partial_sum.second = binary_operation(partial_sum.second, unary_operation(first[n]));
+                  else
+                  {
+                    partial_sum.second = unary_operation(first[n]);
+                    partial_sum.first = true;
+                  }
+
+                  d_first[n] = partial_sum.second;
+                });
 
           ::ket::utility::parallel_loop_n_detail::post_inclusive_scan(
             parallel_policy, last - first, d_first, binary_operation, partial_sums);
@@ -1150,41 +1210,29 @@ namespace ket
           Value const initial_value,
           std::random_access_iterator_tag const, std::random_access_iterator_tag const)
         {
-          auto is_calleds
-            = std::vector<int>(
-                ::ket::utility::num_threads(parallel_policy), static_cast<int>(false));
           using value_type = typename std::iterator_traits<RandomAccessIterator1>::value_type;
-          auto partial_sums
-            = std::vector<value_type>(::ket::utility::num_threads(parallel_policy));
-
-          auto is_calleds_first = std::begin(is_calleds);
-          auto partial_sums_first = std::begin(partial_sums);
-
-          using ::ket::utility::loop_n;
+          using partial_sum_type = std::pair<bool, value_type>;
           using difference_type
             = typename std::iterator_traits<RandomAccessIterator1>::difference_type;
-          loop_n(
-            parallel_policy, last - first,
-            [first, d_first, binary_operation, unary_operation,
-             initial_value, is_calleds_first, partial_sums_first](
-              difference_type const n, int const thread_index)
-            {
-              if (not is_calleds_first[thread_index])
-              {
-                partial_sums_first[thread_index]
-                  = thread_index == 0
-                    ? binary_operation(
-                        initial_value, unary_operation(first[n]))
-                    : unary_operation(first[n]);
-                is_calleds_first[thread_index] = static_cast<int>(true);
-              }
-              else
-                partial_sums_first[thread_index]
-                  = binary_operation(
-                      partial_sums_first[thread_index], unary_operation(first[n]));
-
-              d_first[n] = partial_sums_first[thread_index];
-            });
+          auto partial_sums
+            = ::ket::utility::loop_n_reduce_by_thread(
+                parallel_policy, last - first, partial_sum_type{false, value_type{}},
+                [first, d_first, binary_operation, unary_operation, initial_value](
+                  difference_type const n, int const thread_index, partial_sum_type& partial_sum)
+                {
+                  if (partial_sum.first)
+                    partial_sum.second = binary_operation(partial_sum.second, unary_operation(first[n]));
+                  else
+                  {
+                    if (thread_index == 0)
+                      partial_sum.second = binary_operation(initial_value, unary_operation(first[n]));
+                    else
+                      partial_sum.second = unary_operation(first[n]);
+                    partial_sum.first = true;
+                  }
+
+                  d_first[n] = partial_sum.second;
+                });
 
           ::ket::utility::parallel_loop_n_detail::post_inclusive_scan(
             parallel_policy, last - first, d_first, binary_operation, partial_sums);
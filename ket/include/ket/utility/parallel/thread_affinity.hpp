@@ -0,0 +1,76 @@
+#ifndef KET_UTILITY_PARALLEL_THREAD_AFFINITY_HPP
+# define KET_UTILITY_PARALLEL_THREAD_AFFINITY_HPP
+
+# include <thread>
+# if defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+#   include <pthread.h>
+#   include <sched.h>
+# endif // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+
+
+namespace ket
+{
+  namespace utility
+  {
+# if defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+    namespace thread_affinity_detail
+    {
+      // the CPUs this process may run on (e.g. as given by mpiexec). They are read once before any thread is pinned
+      // because the affinity of a pinned thread is inherited by threads created by it
+      inline cpu_set_t const& process_cpu_set() noexcept
+      {
+        static auto const result
+          = []
+            {
+              auto cpu_set = cpu_set_t{};
+              CPU_ZERO(&cpu_set);
+              if (sched_getaffinity(0, sizeof(cpu_set_t), &cpu_set) != 0)
+                CPU_ZERO(&cpu_set);
+              return cpu_set;
+            }();
+        return result;
+      }
+    } // namespace thread_affinity_detail
+# endif // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+
+    // pin_thread: if KET_USE_THREAD_AFFINITY is defined, the thread is bound to the (thread_index % n)-th CPU of the n
+    //   CPUs this process may run on, in ascending order. Then the thread running each static partition of loop_n
+    //   stays on the NUMA node where the partition was first touched
+    inline void pin_thread(std::thread::native_handle_type const thread, unsigned int const thread_index) noexcept
+    {
+# if defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+      auto const& process_cpu_set = ::ket::utility::thread_affinity_detail::process_cpu_set();
+      auto const num_cpus = static_cast<unsigned int>(CPU_COUNT(&process_cpu_set));
+      if (num_cpus == 0u)
+        return;
+
+      auto const cpu_index = thread_index % num_cpus;
+      auto count = 0u;
+      for (auto cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &process_cpu_set) and count++ == cpu_index)
+        {
+          auto cpu_set = cpu_set_t{};
+          CPU_ZERO(&cpu_set);
+          CPU_SET(cpu, &cpu_set);
+          pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set);
+          return;
+        }
+# else // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+      static_cast<void>(thread);
+      static_cast<void>(thread_index);
+# endif // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+    }
+
+    inline void pin_this_thread(unsigned int const thread_index) noexcept
+    {
+# if defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+      ::ket::utility::pin_thread(pthread_self(), thread_index);
+# else // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+      static_cast<void>(thread_index);
+# endif // defined(KET_USE_THREAD_AFFINITY) && defined(__linux__)
+    }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PARALLEL_THREAD_AFFINITY_HPP
@@ -0,0 +1,253 @@
+#ifndef KET_UTILITY_PARALLEL_THREAD_POOL_HPP
+# define KET_UTILITY_PARALLEL_THREAD_POOL_HPP
+
+# include <cassert>
+# include <cstddef>
+# include <vector>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <atomic>
+# include <exception>
+# include <memory>
+# include <utility>
+# include <type_traits>
+
+# include <ket/utility/parallel/thread_affinity.hpp>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace thread_pool_detail
+    {
+      inline bool& is_in_thread_pool() noexcept
+      {
+        static thread_local bool result = false;
+        return result;
+      }
+
+      inline void relax() noexcept
+      {
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause();
+# endif
+      }
+
+      class in_thread_pool_guard
+      {
+        bool& is_in_thread_pool_;
+
+       public:
+        in_thread_pool_guard() noexcept
+          : is_in_thread_pool_{::ket::utility::thread_pool_detail::is_in_thread_pool()}
+        { is_in_thread_pool_ = true; }
+
+        ~in_thread_pool_guard() noexcept { is_in_thread_pool_ = false; }
+
+        in_thread_pool_guard(in_thread_pool_guard const&) = delete;
+        in_thread_pool_guard& operator=(in_thread_pool_guard const&) = delete;
+        in_thread_pool_guard(in_thread_pool_guard&&) = delete;
+        in_thread_pool_guard& operator=(in_thread_pool_guard&&) = delete;
+      }; // class in_thread_pool_guard
+    } // namespace thread_pool_detail
+
+
+    // Workers are created once and park between tasks: they spin for a while on the
+    // generation counter (so that back-to-back gate kernels do not pay for a wake-up)
+    // and only then block on the condition variable. The calling thread always takes
+    // part as the last thread, i.e. its thread index is num_threads() - 1.
+    class thread_pool
+    {
+      using task_function_type = void (*)(void*, int);
+
+      static constexpr unsigned int num_spins = 1u << 10u;
+      static constexpr unsigned int num_yields = 1u << 10u;
+
+      unsigned int num_threads_;
+      std::vector<std::thread> workers_;
+
+      std::mutex run_mutex_;
+
+      std::mutex mutex_;
+      std::condition_variable cond_;
+      std::atomic<unsigned int> num_sleeping_workers_;
+
+      task_function_type task_function_;
+      void* task_argument_;
+      std::atomic<std::size_t> generation_;
+      std::atomic<unsigned int> num_running_workers_;
+      std::atomic<bool> is_terminated_;
+
+      std::atomic<unsigned int> num_barrier_waiting_threads_;
+      std::atomic<std::size_t> barrier_generation_;
+
+      std::mutex error_mutex_;
+      std::exception_ptr error_;
+
+     public:
+      explicit thread_pool(unsigned int const num_threads)
+        : num_threads_{num_threads == 0u ? 1u : num_threads},
+          workers_{}, run_mutex_{}, mutex_{}, cond_{}, num_sleeping_workers_{0u},
+          task_function_{nullptr}, task_argument_{nullptr},
+          generation_{0u}, num_running_workers_{0u}, is_terminated_{false},
+          num_barrier_waiting_threads_{0u}, barrier_generation_{0u},
+          error_mutex_{}, error_{}
+      {
+        workers_.reserve(num_threads_ - 1u);
+        for (auto thread_index = 0u; thread_index < num_threads_ - 1u; ++thread_index)
+        {
+          workers_.emplace_back([this, thread_index] { work(static_cast<int>(thread_index)); });
+          ::ket::utility::pin_thread(workers_.back().native_handle(), thread_index);
+        }
+        // the calling thread runs the last partition of loop_n
+        ::ket::utility::pin_this_thread(num_threads_ - 1u);
+      }
+
+      ~thread_pool() noexcept
+      {
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          is_terminated_.store(true);
+          generation_.fetch_add(1u);
+        }
+        cond_.notify_all();
+
+        for (auto& worker: workers_)
+          worker.join();
+      }
+
+      thread_pool(thread_pool const&) = delete;
+      thread_pool& operator=(thread_pool const&) = delete;
+      thread_pool(thread_pool&&) = delete;
+      thread_pool& operator=(thread_pool&&) = delete;
+
+      unsigned int num_threads() const noexcept { return num_threads_; }
+
+      // function(thread_index) is called once on every thread of the pool
+      template <typename Function>
+      void run(Function&& function)
+      {
+        // without workers there is only the calling thread, and barrier() returns immediately
+        if (workers_.empty())
+        {
+          function(0);
+          return;
+        }
+
+        // nested calls (from a task already running on a pool) are executed serially on the calling thread.
+        // Then function must not call barrier() because the other thread indices are not running concurrently
+        if (::ket::utility::thread_pool_detail::is_in_thread_pool())
+        {
+          for (auto thread_index = 0u; thread_index < num_threads_; ++thread_index)
+            function(static_cast<int>(thread_index));
+          return;
+        }
+
+        std::lock_guard<std::mutex> run_lock{run_mutex_};
+        ::ket::utility::thread_pool_detail::in_thread_pool_guard guard{};
+
+        using function_type = typename std::remove_reference<Function>::type;
+        task_function_
+          = [](void* argument, int const thread_index)
+            { (*static_cast<function_type*>(argument))(thread_index); };
+        task_argument_ = static_cast<void*>(std::addressof(function));
+        error_ = std::exception_ptr{};
+
+        num_running_workers_.store(static_cast<unsigned int>(workers_.size()));
+        generation_.fetch_add(1u);
+        if (num_sleeping_workers_.load() > 0u)
+        {
+          { std::lock_guard<std::mutex> lock{mutex_}; }
+          cond_.notify_all();
+        }
+
+        try
+        {
+          function(static_cast<int>(num_threads_ - 1u));
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock{error_mutex_};
+          if (not error_)
+            error_ = std::current_exception();
+        }
+
+        for (auto count = 0u; num_running_workers_.load(std::memory_order_acquire) > 0u; ++count)
+          if (count < num_spins)
+            ::ket::utility::thread_pool_detail::relax();
+          else
+            std::this_thread::yield();
+
+        if (error_)
+          std::rethrow_exception(error_);
+      }
+
+      // called by every thread of the pool inside run()
+      void barrier() noexcept
+      {
+        if (num_threads_ == 1u)
+          return;
+
+        auto const barrier_generation = barrier_generation_.load(std::memory_order_acquire);
+        if (num_barrier_waiting_threads_.fetch_add(1u, std::memory_order_acq_rel) == num_threads_ - 1u)
+        {
+          num_barrier_waiting_threads_.store(0u, std::memory_order_relaxed);
+          barrier_generation_.fetch_add(1u, std::memory_order_release);
+          return;
+        }
+
+        for (auto count = 0u; barrier_generation_.load(std::memory_order_acquire) == barrier_generation; ++count)
+          if (count < num_spins)
+            ::ket::utility::thread_pool_detail::relax();
+          else
+            std::this_thread::yield();
+      }
+
+     private:
+      void work(int const thread_index)
+      {
+        ::ket::utility::thread_pool_detail::in_thread_pool_guard guard{};
+        auto generation = std::size_t{0u};
+
+        while (true)
+        {
+          for (auto count = 0u; generation_.load(std::memory_order_acquire) == generation and count < num_spins + num_yields; ++count)
+            if (count < num_spins)
+              ::ket::utility::thread_pool_detail::relax();
+            else
+              std::this_thread::yield();
+
+          if (generation_.load(std::memory_order_acquire) == generation)
+          {
+            std::unique_lock<std::mutex> lock{mutex_};
+            num_sleeping_workers_.fetch_add(1u);
+            cond_.wait(lock, [this, generation] { return generation_.load() != generation; });
+            num_sleeping_workers_.fetch_sub(1u);
+          }
+
+          generation = generation_.load(std::memory_order_acquire);
+          if (is_terminated_.load())
+            return;
+
+          try
+          {
+            task_function_(task_argument_, thread_index);
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock{error_mutex_};
+            if (not error_)
+              error_ = std::current_exception();
+          }
+
+          num_running_workers_.fetch_sub(1u, std::memory_order_release);
+        }
+      }
+    }; // class thread_pool
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PARALLEL_THREAD_POOL_HPP
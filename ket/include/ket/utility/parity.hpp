@@ -0,0 +1,25 @@
+#ifndef KET_UTILITY_PARITY_HPP
+# define KET_UTILITY_PARITY_HPP
+
+# include <limits>
+# include <type_traits>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // parity(value): true if the number of 1's in value is odd
+    template <typename UnsignedInteger>
+    inline bool parity(UnsignedInteger value) noexcept
+    {
+      static_assert(std::is_unsigned<UnsignedInteger>::value, "UnsignedInteger should be unsigned");
+      for (auto shift = std::numeric_limits<UnsignedInteger>::digits / 2; shift > 0; shift /= 2)
+        value ^= value >> shift;
+      return (value bitand UnsignedInteger{1u}) != UnsignedInteger{0u};
+    }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PARITY_HPP
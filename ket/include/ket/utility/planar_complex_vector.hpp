@@ -0,0 +1,443 @@
+#ifndef KET_UTILITY_PLANAR_COMPLEX_VECTOR_HPP
+# define KET_UTILITY_PLANAR_COMPLEX_VECTOR_HPP
+
+# include <cstddef>
+# include <cassert>
+# include <complex>
+# include <vector>
+# include <iterator>
+# include <algorithm>
+# include <memory>
+# include <utility>
+# include <stdexcept>
+# include <type_traits>
+# include <initializer_list>
+
+# include <boost/iterator/iterator_facade.hpp>
+
+# include <ket/utility/meta/real_of.hpp>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // planar_complex_reference<Real>: proxy of a complex number whose real and imaginary parts are stored in
+    // different arrays. Real may be const-qualified. Note that "auto x = *iterator;" copies the proxy, not the value;
+    // use value_type (or value()) to keep an old value
+    template <typename Real>
+    class planar_complex_reference
+    {
+      Real* real_part_ptr_;
+      Real* imag_part_ptr_;
+
+     public:
+      using real_type = typename std::remove_const<Real>::type;
+      using value_type = std::complex<real_type>;
+
+      planar_complex_reference(Real& real_part, Real& imag_part) noexcept
+        : real_part_ptr_{std::addressof(real_part)}, imag_part_ptr_{std::addressof(imag_part)}
+      { }
+
+      planar_complex_reference(planar_complex_reference const&) = default;
+
+      template <typename Real_, typename = typename std::enable_if<std::is_same<Real const, Real_ const>::value and std::is_const<Real>::value>::type>
+      planar_complex_reference(planar_complex_reference<Real_> const& other) noexcept
+        : real_part_ptr_{std::addressof(other.real_part())}, imag_part_ptr_{std::addressof(other.imag_part())}
+      { }
+
+      planar_complex_reference const& operator=(planar_complex_reference const& other) const
+      { return *this = other.value(); }
+
+      template <typename Real_>
+      planar_complex_reference const& operator=(planar_complex_reference<Real_> const& other) const
+      { return *this = other.value(); }
+
+      planar_complex_reference const& operator=(value_type const& value) const
+      {
+        *real_part_ptr_ = value.real();
+        *imag_part_ptr_ = value.imag();
+        return *this;
+      }
+
+      planar_complex_reference const& operator=(real_type const value) const
+      { return *this = value_type{value}; }
+
+      operator value_type() const { return value(); }
+      value_type value() const { return {*real_part_ptr_, *imag_part_ptr_}; }
+
+      Real& real_part() const noexcept { return *real_part_ptr_; }
+      Real& imag_part() const noexcept { return *imag_part_ptr_; }
+      real_type real() const { return *real_part_ptr_; }
+      real_type imag() const { return *imag_part_ptr_; }
+
+      planar_complex_reference const& operator+=(value_type const& value) const { return *this = this->value() + value; }
+      planar_complex_reference const& operator-=(value_type const& value) const { return *this = this->value() - value; }
+      planar_complex_reference const& operator*=(value_type const& value) const { return *this = this->value() * value; }
+      planar_complex_reference const& operator/=(value_type const& value) const { return *this = this->value() / value; }
+      planar_complex_reference const& operator*=(real_type const value) const
+      {
+        *real_part_ptr_ *= value;
+        *imag_part_ptr_ *= value;
+        return *this;
+      }
+      planar_complex_reference const& operator/=(real_type const value) const
+      {
+        *real_part_ptr_ /= value;
+        *imag_part_ptr_ /= value;
+        return *this;
+      }
+
+      friend value_type operator+(planar_complex_reference const& value) { return value.value(); }
+      friend value_type operator-(planar_complex_reference const& value) { return -value.value(); }
+
+      friend value_type operator+(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return lhs.value() + rhs.value(); }
+      friend value_type operator+(planar_complex_reference const& lhs, value_type const& rhs) { return lhs.value() + rhs; }
+      friend value_type operator+(value_type const& lhs, planar_complex_reference const& rhs) { return lhs + rhs.value(); }
+      friend value_type operator+(planar_complex_reference const& lhs, real_type const rhs) { return lhs.value() + rhs; }
+      friend value_type operator+(real_type const lhs, planar_complex_reference const& rhs) { return lhs + rhs.value(); }
+
+      friend value_type operator-(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return lhs.value() - rhs.value(); }
+      friend value_type operator-(planar_complex_reference const& lhs, value_type const& rhs) { return lhs.value() - rhs; }
+      friend value_type operator-(value_type const& lhs, planar_complex_reference const& rhs) { return lhs - rhs.value(); }
+      friend value_type operator-(planar_complex_reference const& lhs, real_type const rhs) { return lhs.value() - rhs; }
+      friend value_type operator-(real_type const lhs, planar_complex_reference const& rhs) { return lhs - rhs.value(); }
+
+      friend value_type operator*(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return lhs.value() * rhs.value(); }
+      friend value_type operator*(planar_complex_reference const& lhs, value_type const& rhs) { return lhs.value() * rhs; }
+      friend value_type operator*(value_type const& lhs, planar_complex_reference const& rhs) { return lhs * rhs.value(); }
+      friend value_type operator*(planar_complex_reference const& lhs, real_type const rhs) { return lhs.value() * rhs; }
+      friend value_type operator*(real_type const lhs, planar_complex_reference const& rhs) { return lhs * rhs.value(); }
+
+      friend value_type operator/(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return lhs.value() / rhs.value(); }
+      friend value_type operator/(planar_complex_reference const& lhs, value_type const& rhs) { return lhs.value() / rhs; }
+      friend value_type operator/(value_type const& lhs, planar_complex_reference const& rhs) { return lhs / rhs.value(); }
+      friend value_type operator/(planar_complex_reference const& lhs, real_type const rhs) { return lhs.value() / rhs; }
+
+      friend bool operator==(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return lhs.value() == rhs.value(); }
+      friend bool operator==(planar_complex_reference const& lhs, value_type const& rhs) { return lhs.value() == rhs; }
+      friend bool operator==(value_type const& lhs, planar_complex_reference const& rhs) { return lhs == rhs.value(); }
+      friend bool operator!=(planar_complex_reference const& lhs, planar_complex_reference const& rhs) { return not (lhs == rhs); }
+      friend bool operator!=(planar_complex_reference const& lhs, value_type const& rhs) { return not (lhs == rhs); }
+      friend bool operator!=(value_type const& lhs, planar_complex_reference const& rhs) { return not (lhs == rhs); }
+
+      friend real_type real(planar_complex_reference const& value) { return value.real(); }
+      friend real_type imag(planar_complex_reference const& value) { return value.imag(); }
+      friend real_type norm(planar_complex_reference const& value) { return value.real() * value.real() + value.imag() * value.imag(); }
+      friend real_type abs(planar_complex_reference const& value) { return std::abs(value.value()); }
+      friend real_type arg(planar_complex_reference const& value) { return std::arg(value.value()); }
+      friend value_type conj(planar_complex_reference const& value) { return {value.real(), -value.imag()}; }
+
+      friend void swap(planar_complex_reference const& lhs, planar_complex_reference const& rhs)
+      {
+        using std::swap;
+        swap(*lhs.real_part_ptr_, *rhs.real_part_ptr_);
+        swap(*lhs.imag_part_ptr_, *rhs.imag_part_ptr_);
+      }
+    }; // class planar_complex_reference<Real>
+
+    // planar_complex_iterator<Real>: random access iterator over two arrays of real and imaginary parts.
+    // Real may be const-qualified
+    template <typename Real>
+    class planar_complex_iterator
+      : public boost::iterators::iterator_facade<
+          planar_complex_iterator<Real>,
+          std::complex<typename std::remove_const<Real>::type>,
+          std::random_access_iterator_tag,
+          ::ket::utility::planar_complex_reference<Real>,
+          std::ptrdiff_t>
+    {
+      Real* real_part_ptr_;
+      Real* imag_part_ptr_;
+
+      friend class boost::iterators::iterator_core_access;
+
+     public:
+      constexpr planar_complex_iterator() noexcept
+        : real_part_ptr_{nullptr}, imag_part_ptr_{nullptr}
+      { }
+
+      constexpr planar_complex_iterator(Real* const real_part_ptr, Real* const imag_part_ptr) noexcept
+        : real_part_ptr_{real_part_ptr}, imag_part_ptr_{imag_part_ptr}
+      { }
+
+      template <typename Real_, typename = typename std::enable_if<std::is_same<Real const, Real_ const>::value and std::is_const<Real>::value>::type>
+      constexpr planar_complex_iterator(planar_complex_iterator<Real_> const& other) noexcept
+        : real_part_ptr_{other.real_part_ptr()}, imag_part_ptr_{other.imag_part_ptr()}
+      { }
+
+      // real_part_ptr() and imag_part_ptr() point to contiguous arrays, so kernels can use planar arithmetic on them
+      constexpr Real* real_part_ptr() const noexcept { return real_part_ptr_; }
+      constexpr Real* imag_part_ptr() const noexcept { return imag_part_ptr_; }
+
+      // iterator_facade::operator[] returns its own proxy for proxy references, which cannot be swapped
+      ::ket::utility::planar_complex_reference<Real> operator[](std::ptrdiff_t const n) const
+      { return {real_part_ptr_[n], imag_part_ptr_[n]}; }
+
+      ::ket::utility::planar_complex_reference<Real> dereference() const
+      { return {*real_part_ptr_, *imag_part_ptr_}; }
+
+      template <typename Real_>
+      bool equal(planar_complex_iterator<Real_> const& other) const
+      { return real_part_ptr_ == other.real_part_ptr(); }
+
+      void increment() { ++real_part_ptr_; ++imag_part_ptr_; }
+      void decrement() { --real_part_ptr_; --imag_part_ptr_; }
+      void advance(std::ptrdiff_t const n) { real_part_ptr_ += n; imag_part_ptr_ += n; }
+
+      template <typename Real_>
+      std::ptrdiff_t distance_to(planar_complex_iterator<Real_> const& other) const
+      { return other.real_part_ptr() - real_part_ptr_; }
+
+      void swap(planar_complex_iterator& other) noexcept
+      {
+        using std::swap;
+        swap(real_part_ptr_, other.real_part_ptr_);
+        swap(imag_part_ptr_, other.imag_part_ptr_);
+      }
+    }; // class planar_complex_iterator<Real>
+
+    template <typename Real>
+    inline void swap(
+      ::ket::utility::planar_complex_iterator<Real>& lhs,
+      ::ket::utility::planar_complex_iterator<Real>& rhs) noexcept
+    { lhs.swap(rhs); }
+
+    // planar_complex_vector<Real, Allocator>: std::vector-like container of std::complex<Real>, which stores real and
+    // imaginary parts in separate arrays (structure of arrays). Its iterators are planar_complex_iterator's
+    template <typename Real, typename Allocator = std::allocator<Real>>
+    class planar_complex_vector
+    {
+      using parts_type = std::vector<Real, Allocator>;
+      parts_type real_parts_;
+      parts_type imag_parts_;
+
+     public:
+      using real_type = Real;
+      using value_type = std::complex<Real>;
+      using allocator_type = Allocator;
+      using size_type = typename parts_type::size_type;
+      using difference_type = typename parts_type::difference_type;
+      using reference = ::ket::utility::planar_complex_reference<Real>;
+      using const_reference = ::ket::utility::planar_complex_reference<Real const>;
+      // there are no pointers to elements, so pointer is the same as iterator like std::vector<bool>
+      using pointer = ::ket::utility::planar_complex_iterator<Real>;
+      using const_pointer = ::ket::utility::planar_complex_iterator<Real const>;
+      using iterator = ::ket::utility::planar_complex_iterator<Real>;
+      using const_iterator = ::ket::utility::planar_complex_iterator<Real const>;
+      using reverse_iterator = std::reverse_iterator<iterator>;
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      planar_complex_vector() = default;
+
+      explicit planar_complex_vector(allocator_type const& allocator)
+        : real_parts_{allocator}, imag_parts_{allocator}
+      { }
+
+      planar_complex_vector(size_type const count, value_type const& value, allocator_type const& allocator = allocator_type())
+        : real_parts_(count, value.real(), allocator), imag_parts_(count, value.imag(), allocator)
+      { }
+
+      explicit planar_complex_vector(size_type const count, allocator_type const& allocator = allocator_type())
+        : real_parts_(count, Real{0}, allocator), imag_parts_(count, Real{0}, allocator)
+      { }
+
+      planar_complex_vector(std::initializer_list<value_type> initializer_list, allocator_type const& allocator = allocator_type())
+        : real_parts_{allocator}, imag_parts_{allocator}
+      { assign(initializer_list); }
+
+      planar_complex_vector(planar_complex_vector const&) = default;
+      planar_complex_vector(planar_complex_vector&&) = default;
+      planar_complex_vector& operator=(planar_complex_vector const&) = default;
+      planar_complex_vector& operator=(planar_complex_vector&&) = default;
+
+      planar_complex_vector(planar_complex_vector const& other, allocator_type const& allocator)
+        : real_parts_{other.real_parts_, allocator}, imag_parts_{other.imag_parts_, allocator}
+      { }
+
+      planar_complex_vector(planar_complex_vector&& other, allocator_type const& allocator)
+        : real_parts_{std::move(other.real_parts_), allocator}, imag_parts_{std::move(other.imag_parts_), allocator}
+      { }
+
+      void assign(size_type const count, value_type const& value)
+      {
+        real_parts_.assign(count, value.real());
+        imag_parts_.assign(count, value.imag());
+      }
+
+      template <typename InputIterator>
+      void assign(InputIterator first, InputIterator const last)
+      {
+        real_parts_.clear();
+        imag_parts_.clear();
+        for (; first != last; ++first)
+          push_back(*first);
+      }
+
+      void assign(std::initializer_list<value_type> initializer_list)
+      {
+        real_parts_.resize(initializer_list.size());
+        imag_parts_.resize(initializer_list.size());
+        std::copy(std::begin(initializer_list), std::end(initializer_list), begin());
+      }
+
+      allocator_type get_allocator() const { return real_parts_.get_allocator(); }
+
+      // element access
+      reference at(size_type const index) { return {real_parts_.at(index), imag_parts_.at(index)}; }
+      const_reference at(size_type const index) const { return {real_parts_.at(index), imag_parts_.at(index)}; }
+      reference operator[](size_type const index) { return {real_parts_[index], imag_parts_[index]}; }
+      const_reference operator[](size_type const index) const { return {real_parts_[index], imag_parts_[index]}; }
+      reference front() { return {real_parts_.front(), imag_parts_.front()}; }
+      const_reference front() const { return {real_parts_.front(), imag_parts_.front()}; }
+      reference back() { return {real_parts_.back(), imag_parts_.back()}; }
+      const_reference back() const { return {real_parts_.back(), imag_parts_.back()}; }
+
+      Real* real_data() noexcept { return real_parts_.data(); }
+      Real const* real_data() const noexcept { return real_parts_.data(); }
+      Real* imag_data() noexcept { return imag_parts_.data(); }
+      Real const* imag_data() const noexcept { return imag_parts_.data(); }
+
+      // iterators
+      iterator begin() noexcept { return {real_parts_.data(), imag_parts_.data()}; }
+      const_iterator begin() const noexcept { return {real_parts_.data(), imag_parts_.data()}; }
+      const_iterator cbegin() const noexcept { return begin(); }
+      iterator end() noexcept { return begin() + static_cast<difference_type>(size()); }
+      const_iterator end() const noexcept { return begin() + static_cast<difference_type>(size()); }
+      const_iterator cend() const noexcept { return end(); }
+      reverse_iterator rbegin() noexcept { return reverse_iterator{end()}; }
+      const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator{end()}; }
+      const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+      reverse_iterator rend() noexcept { return reverse_iterator{begin()}; }
+      const_reverse_iterator rend() const noexcept { return const_reverse_iterator{begin()}; }
+      const_reverse_iterator crend() const noexcept { return rend(); }
+
+      // capacity
+      bool empty() const noexcept { return real_parts_.empty(); }
+      size_type size() const noexcept { return real_parts_.size(); }
+      size_type max_size() const noexcept { return real_parts_.max_size(); }
+      void reserve(size_type const new_capacity) { real_parts_.reserve(new_capacity); imag_parts_.reserve(new_capacity); }
+      size_type capacity() const noexcept { return real_parts_.capacity(); }
+      void shrink_to_fit() { real_parts_.shrink_to_fit(); imag_parts_.shrink_to_fit(); }
+
+      // modifiers
+      void clear() noexcept { real_parts_.clear(); imag_parts_.clear(); }
+
+      void push_back(value_type const& value)
+      {
+        real_parts_.push_back(value.real());
+        imag_parts_.push_back(value.imag());
+      }
+
+      void pop_back() { real_parts_.pop_back(); imag_parts_.pop_back(); }
+
+      void resize(size_type const count)
+      {
+        real_parts_.resize(count);
+        imag_parts_.resize(count);
+      }
+
+      void resize(size_type const count, value_type const& value)
+      {
+        real_parts_.resize(count, value.real());
+        imag_parts_.resize(count, value.imag());
+      }
+
+      void swap(planar_complex_vector& other) noexcept
+      {
+        using std::swap;
+        swap(real_parts_, other.real_parts_);
+        swap(imag_parts_, other.imag_parts_);
+      }
+    }; // class planar_complex_vector<Real, Allocator>
+
+    template <typename Real, typename Allocator>
+    inline bool operator==(
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& lhs,
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& rhs)
+    { return lhs.size() == rhs.size() and std::equal(lhs.begin(), lhs.end(), rhs.begin()); }
+
+    template <typename Real, typename Allocator>
+    inline bool operator!=(
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& lhs,
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& rhs)
+    { return not (lhs == rhs); }
+
+    template <typename Real, typename Allocator>
+    inline bool operator<(
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& lhs,
+      ::ket::utility::planar_complex_vector<Real, Allocator> const& rhs)
+    {
+      return std::lexicographical_compare(
+        lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+        [](std::complex<Real> const& lhs_value, std::complex<Real> const& rhs_value)
+        {
+          return lhs_value.real() < rhs_value.real()
+            or (lhs_value.real() == rhs_value.real() and lhs_value.imag() < rhs_value.imag());
+        });
+    }
+
+    template <typename Real, typename Allocator>
+    inline void swap(
+      ::ket::utility::planar_complex_vector<Real, Allocator>& lhs,
+      ::ket::utility::planar_complex_vector<Real, Allocator>& rhs) noexcept
+    { lhs.swap(rhs); }
+
+    // planar_allocator<Complex, RealAllocator>: storage policy for containers parameterized by an allocator of Complex
+    // such as ket::mpi::state. It is not an allocator by itself but tells them to store amplitudes in
+    // planar_complex_vector<real_type, RealAllocator>
+    template <typename Complex, typename RealAllocator = std::allocator<typename ::ket::utility::meta::real_of<Complex>::type>>
+    class planar_allocator
+    {
+      RealAllocator real_allocator_;
+
+     public:
+      using value_type = Complex;
+      using real_allocator_type = RealAllocator;
+
+      template <typename Complex_>
+      struct rebind
+      { using other = planar_allocator<Complex_, RealAllocator>; };
+
+      planar_allocator() = default;
+
+      planar_allocator(RealAllocator const& real_allocator)
+        : real_allocator_{real_allocator}
+      { }
+
+      template <typename Complex_>
+      planar_allocator(planar_allocator<Complex_, RealAllocator> const& other)
+        : real_allocator_{other.real_allocator()}
+      { }
+
+      RealAllocator const& real_allocator() const noexcept { return real_allocator_; }
+      operator RealAllocator() const { return real_allocator_; }
+    }; // class planar_allocator<Complex, RealAllocator>
+
+    namespace meta
+    {
+      // complex_container_of<Complex, Allocator>::type is std::vector<Complex, Allocator> unless Allocator is
+      // planar_allocator
+      template <typename Complex, typename Allocator>
+      struct complex_container_of
+      { using type = std::vector<Complex, Allocator>; };
+
+      template <typename Complex, typename RealAllocator>
+      struct complex_container_of<Complex, ::ket::utility::planar_allocator<Complex, RealAllocator>>
+      { using type = ::ket::utility::planar_complex_vector<typename ::ket::utility::meta::real_of<Complex>::type, RealAllocator>; };
+
+      template <typename Iterator>
+      struct is_planar_complex_iterator
+        : std::false_type
+      { }; // struct is_planar_complex_iterator<Iterator>
+
+      template <typename Real>
+      struct is_planar_complex_iterator< ::ket::utility::planar_complex_iterator<Real> >
+        : std::true_type
+      { }; // struct is_planar_complex_iterator< ::ket::utility::planar_complex_iterator<Real> >
+    } // namespace meta
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_PLANAR_COMPLEX_VECTOR_HPP
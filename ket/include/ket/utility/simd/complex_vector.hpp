@@ -0,0 +1,283 @@
+#ifndef KET_UTILITY_SIMD_COMPLEX_VECTOR_HPP
+# define KET_UTILITY_SIMD_COMPLEX_VECTOR_HPP
+
+# include <cstddef>
+# include <complex>
+# include <type_traits>
+
+# if defined(__AVX512F__) || defined(__AVX2__)
+#   include <immintrin.h>
+# endif
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace simd
+    {
+      // complex_vector<Real> packs complex_vector<Real>::size consecutive std::complex<Real>'s into one SIMD register.
+      // It is defined only if the target supports AVX-512F or AVX2, which is detected at compile time (e.g. -march=native).
+      //   load(pointer), store(pointer): unaligned load/store of size complex numbers
+      //   broadcast(value): all elements are value
+      //   x + y, x - y, x * real, x * y (elementwise complex multiplication), times_i(x) = i x
+      //   swap_partners(x, bit): exchanges elements whose indices differ only in bit (bit < log2(size))
+      //   select(x0, x1, bit): takes elements whose index has 0 (1) at bit from x0 (x1)
+      template <typename Real>
+      class complex_vector;
+
+      template <typename Real>
+      struct has_complex_vector
+        : std::false_type
+      { }; // struct has_complex_vector<Real>
+
+# if defined(__AVX512F__)
+      template <>
+      class complex_vector<double>
+      {
+        __m512d data_;
+
+       public:
+        using real_type = double;
+        using value_type = std::complex<double>;
+
+        static constexpr std::size_t size = 4u;
+        static constexpr unsigned int num_in_vector_bits = 2u;
+
+        complex_vector() = default;
+        explicit complex_vector(__m512d const data) noexcept : data_{data} { }
+
+        static complex_vector load(std::complex<double> const* pointer) noexcept
+        { return complex_vector{_mm512_loadu_pd(reinterpret_cast<double const*>(pointer))}; }
+        void store(std::complex<double>* pointer) const noexcept
+        { _mm512_storeu_pd(reinterpret_cast<double*>(pointer), data_); }
+
+        static complex_vector broadcast(std::complex<double> const& value) noexcept
+        { return complex_vector{_mm512_setr4_pd(value.real(), value.imag(), value.real(), value.imag())}; }
+
+        friend complex_vector operator+(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm512_add_pd(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator-(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm512_sub_pd(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator*(complex_vector const& lhs, double const rhs) noexcept
+        { return complex_vector{_mm512_mul_pd(lhs.data_, _mm512_set1_pd(rhs))}; }
+        // (a + ib)(c + id) = (ac - bd) + i(ad + bc)
+        friend complex_vector operator*(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        {
+          auto const rhs_real = _mm512_movedup_pd(rhs.data_);
+          auto const rhs_imag = _mm512_permute_pd(rhs.data_, 0xFF);
+          auto const swapped_lhs = _mm512_permute_pd(lhs.data_, 0x55);
+          return complex_vector{
+            _mm512_fmaddsub_pd(lhs.data_, rhs_real, _mm512_mul_pd(swapped_lhs, rhs_imag))};
+        }
+        // i(a + ib) = -b + ia
+        friend complex_vector times_i(complex_vector const& value) noexcept
+        {
+          auto const zero = _mm512_setzero_pd();
+          return complex_vector{_mm512_fmaddsub_pd(zero, zero, _mm512_permute_pd(value.data_, 0x55))};
+        }
+
+        friend complex_vector swap_partners(complex_vector const& value, unsigned int const bit) noexcept
+        {
+          return bit == 0u
+            ? complex_vector{_mm512_shuffle_f64x2(value.data_, value.data_, _MM_SHUFFLE(2, 3, 0, 1))}
+            : complex_vector{_mm512_shuffle_f64x2(value.data_, value.data_, _MM_SHUFFLE(1, 0, 3, 2))};
+        }
+        friend complex_vector select(complex_vector const& zero_value, complex_vector const& one_value, unsigned int const bit) noexcept
+        {
+          return complex_vector{
+            _mm512_mask_blend_pd(bit == 0u ? __mmask8{0xCC} : __mmask8{0xF0}, zero_value.data_, one_value.data_)};
+        }
+      }; // class complex_vector<double>
+
+      template <>
+      class complex_vector<float>
+      {
+        __m512 data_;
+
+       public:
+        using real_type = float;
+        using value_type = std::complex<float>;
+
+        static constexpr std::size_t size = 8u;
+        static constexpr unsigned int num_in_vector_bits = 3u;
+
+        complex_vector() = default;
+        explicit complex_vector(__m512 const data) noexcept : data_{data} { }
+
+        static complex_vector load(std::complex<float> const* pointer) noexcept
+        { return complex_vector{_mm512_loadu_ps(reinterpret_cast<float const*>(pointer))}; }
+        void store(std::complex<float>* pointer) const noexcept
+        { _mm512_storeu_ps(reinterpret_cast<float*>(pointer), data_); }
+
+        static complex_vector broadcast(std::complex<float> const& value) noexcept
+        { return complex_vector{_mm512_setr4_ps(value.real(), value.imag(), value.real(), value.imag())}; }
+
+        friend complex_vector operator+(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm512_add_ps(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator-(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm512_sub_ps(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator*(complex_vector const& lhs, float const rhs) noexcept
+        { return complex_vector{_mm512_mul_ps(lhs.data_, _mm512_set1_ps(rhs))}; }
+        friend complex_vector operator*(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        {
+          auto const rhs_real = _mm512_moveldup_ps(rhs.data_);
+          auto const rhs_imag = _mm512_movehdup_ps(rhs.data_);
+          auto const swapped_lhs = _mm512_permute_ps(lhs.data_, _MM_SHUFFLE(2, 3, 0, 1));
+          return complex_vector{
+            _mm512_fmaddsub_ps(lhs.data_, rhs_real, _mm512_mul_ps(swapped_lhs, rhs_imag))};
+        }
+        friend complex_vector times_i(complex_vector const& value) noexcept
+        {
+          auto const zero = _mm512_setzero_ps();
+          return complex_vector{_mm512_fmaddsub_ps(zero, zero, _mm512_permute_ps(value.data_, _MM_SHUFFLE(2, 3, 0, 1)))};
+        }
+
+        friend complex_vector swap_partners(complex_vector const& value, unsigned int const bit) noexcept
+        {
+          return bit == 0u
+            ? complex_vector{_mm512_permute_ps(value.data_, _MM_SHUFFLE(1, 0, 3, 2))}
+            : bit == 1u
+              ? complex_vector{_mm512_shuffle_f32x4(value.data_, value.data_, _MM_SHUFFLE(2, 3, 0, 1))}
+              : complex_vector{_mm512_shuffle_f32x4(value.data_, value.data_, _MM_SHUFFLE(1, 0, 3, 2))};
+        }
+        friend complex_vector select(complex_vector const& zero_value, complex_vector const& one_value, unsigned int const bit) noexcept
+        {
+          return complex_vector{
+            _mm512_mask_blend_ps(
+              bit == 0u ? __mmask16{0xCCCC} : bit == 1u ? __mmask16{0xF0F0} : __mmask16{0xFF00},
+              zero_value.data_, one_value.data_)};
+        }
+      }; // class complex_vector<float>
+
+      template <>
+      struct has_complex_vector<double>
+        : std::true_type
+      { }; // struct has_complex_vector<double>
+
+      template <>
+      struct has_complex_vector<float>
+        : std::true_type
+      { }; // struct has_complex_vector<float>
+# elif defined(__AVX2__)
+      template <>
+      class complex_vector<double>
+      {
+        __m256d data_;
+
+       public:
+        using real_type = double;
+        using value_type = std::complex<double>;
+
+        static constexpr std::size_t size = 2u;
+        static constexpr unsigned int num_in_vector_bits = 1u;
+
+        complex_vector() = default;
+        explicit complex_vector(__m256d const data) noexcept : data_{data} { }
+
+        static complex_vector load(std::complex<double> const* pointer) noexcept
+        { return complex_vector{_mm256_loadu_pd(reinterpret_cast<double const*>(pointer))}; }
+        void store(std::complex<double>* pointer) const noexcept
+        { _mm256_storeu_pd(reinterpret_cast<double*>(pointer), data_); }
+
+        static complex_vector broadcast(std::complex<double> const& value) noexcept
+        { return complex_vector{_mm256_setr_pd(value.real(), value.imag(), value.real(), value.imag())}; }
+
+        friend complex_vector operator+(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm256_add_pd(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator-(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm256_sub_pd(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator*(complex_vector const& lhs, double const rhs) noexcept
+        { return complex_vector{_mm256_mul_pd(lhs.data_, _mm256_set1_pd(rhs))}; }
+        friend complex_vector operator*(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        {
+          auto const rhs_real = _mm256_movedup_pd(rhs.data_);
+          auto const rhs_imag = _mm256_permute_pd(rhs.data_, 0xF);
+          auto const swapped_lhs = _mm256_permute_pd(lhs.data_, 0x5);
+          return complex_vector{
+            _mm256_addsub_pd(_mm256_mul_pd(lhs.data_, rhs_real), _mm256_mul_pd(swapped_lhs, rhs_imag))};
+        }
+        friend complex_vector times_i(complex_vector const& value) noexcept
+        { return complex_vector{_mm256_addsub_pd(_mm256_setzero_pd(), _mm256_permute_pd(value.data_, 0x5))}; }
+
+        friend complex_vector swap_partners(complex_vector const& value, unsigned int const) noexcept
+        { return complex_vector{_mm256_permute2f128_pd(value.data_, value.data_, 0x01)}; }
+        friend complex_vector select(complex_vector const& zero_value, complex_vector const& one_value, unsigned int const) noexcept
+        { return complex_vector{_mm256_blend_pd(zero_value.data_, one_value.data_, 0xC)}; }
+      }; // class complex_vector<double>
+
+      template <>
+      class complex_vector<float>
+      {
+        __m256 data_;
+
+       public:
+        using real_type = float;
+        using value_type = std::complex<float>;
+
+        static constexpr std::size_t size = 4u;
+        static constexpr unsigned int num_in_vector_bits = 2u;
+
+        complex_vector() = default;
+        explicit complex_vector(__m256 const data) noexcept : data_{data} { }
+
+        static complex_vector load(std::complex<float> const* pointer) noexcept
+        { return complex_vector{_mm256_loadu_ps(reinterpret_cast<float const*>(pointer))}; }
+        void store(std::complex<float>* pointer) const noexcept
+        { _mm256_storeu_ps(reinterpret_cast<float*>(pointer), data_); }
+
+        static complex_vector broadcast(std::complex<float> const& value) noexcept
+        {
+          return complex_vector{
+            _mm256_setr_ps(
+              value.real(), value.imag(), value.real(), value.imag(),
+              value.real(), value.imag(), value.real(), value.imag())};
+        }
+
+        friend complex_vector operator+(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm256_add_ps(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator-(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        { return complex_vector{_mm256_sub_ps(lhs.data_, rhs.data_)}; }
+        friend complex_vector operator*(complex_vector const& lhs, float const rhs) noexcept
+        { return complex_vector{_mm256_mul_ps(lhs.data_, _mm256_set1_ps(rhs))}; }
+        friend complex_vector operator*(complex_vector const& lhs, complex_vector const& rhs) noexcept
+        {
+          auto const rhs_real = _mm256_moveldup_ps(rhs.data_);
+          auto const rhs_imag = _mm256_movehdup_ps(rhs.data_);
+          auto const swapped_lhs = _mm256_permute_ps(lhs.data_, _MM_SHUFFLE(2, 3, 0, 1));
+          return complex_vector{
+            _mm256_addsub_ps(_mm256_mul_ps(lhs.data_, rhs_real), _mm256_mul_ps(swapped_lhs, rhs_imag))};
+        }
+        friend complex_vector times_i(complex_vector const& value) noexcept
+        { return complex_vector{_mm256_addsub_ps(_mm256_setzero_ps(), _mm256_permute_ps(value.data_, _MM_SHUFFLE(2, 3, 0, 1)))}; }
+
+        friend complex_vector swap_partners(complex_vector const& value, unsigned int const bit) noexcept
+        {
+          return bit == 0u
+            ? complex_vector{_mm256_permute_ps(value.data_, _MM_SHUFFLE(1, 0, 3, 2))}
+            : complex_vector{_mm256_permute2f128_ps(value.data_, value.data_, 0x01)};
+        }
+        friend complex_vector select(complex_vector const& zero_value, complex_vector const& one_value, unsigned int const bit) noexcept
+        {
+          return bit == 0u
+            ? complex_vector{_mm256_blend_ps(zero_value.data_, one_value.data_, 0xCC)}
+            : complex_vector{_mm256_blend_ps(zero_value.data_, one_value.data_, 0xF0)};
+        }
+      }; // class complex_vector<float>
+
+      template <>
+      struct has_complex_vector<double>
+        : std::true_type
+      { }; // struct has_complex_vector<double>
+
+      template <>
+      struct has_complex_vector<float>
+        : std::true_type
+      { }; // struct has_complex_vector<float>
+# endif // defined(__AVX512F__) || defined(__AVX2__)
+    } // namespace simd
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_SIMD_COMPLEX_VECTOR_HPP
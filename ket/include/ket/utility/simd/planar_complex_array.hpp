@@ -0,0 +1,125 @@
+#ifndef KET_UTILITY_SIMD_PLANAR_COMPLEX_ARRAY_HPP
+# define KET_UTILITY_SIMD_PLANAR_COMPLEX_ARRAY_HPP
+
+# include <cstddef>
+# include <complex>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    namespace simd
+    {
+      // planar_complex_array<Real, size> holds size complex numbers as an array of real parts and an array of imaginary
+      // parts. It has the same interface as complex_vector except for load/store, which take two pointers to planar
+      // data, and has no shuffles. All operations are elementwise loops over real arrays without any permutation, so
+      // compilers vectorize them for any instruction set
+      template <typename Real, std::size_t size_>
+      class planar_complex_array
+      {
+        Real real_parts_[size_];
+        Real imag_parts_[size_];
+
+       public:
+        using real_type = Real;
+        using value_type = std::complex<Real>;
+
+        static constexpr std::size_t size = size_;
+
+        static planar_complex_array load(Real const* real_pointer, Real const* imag_pointer) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = real_pointer[index];
+            result.imag_parts_[index] = imag_pointer[index];
+          }
+          return result;
+        }
+
+        void store(Real* real_pointer, Real* imag_pointer) const noexcept
+        {
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            real_pointer[index] = real_parts_[index];
+            imag_pointer[index] = imag_parts_[index];
+          }
+        }
+
+        static planar_complex_array broadcast(std::complex<Real> const& value) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = value.real();
+            result.imag_parts_[index] = value.imag();
+          }
+          return result;
+        }
+
+        friend planar_complex_array operator+(planar_complex_array const& lhs, planar_complex_array const& rhs) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = lhs.real_parts_[index] + rhs.real_parts_[index];
+            result.imag_parts_[index] = lhs.imag_parts_[index] + rhs.imag_parts_[index];
+          }
+          return result;
+        }
+
+        friend planar_complex_array operator-(planar_complex_array const& lhs, planar_complex_array const& rhs) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = lhs.real_parts_[index] - rhs.real_parts_[index];
+            result.imag_parts_[index] = lhs.imag_parts_[index] - rhs.imag_parts_[index];
+          }
+          return result;
+        }
+
+        friend planar_complex_array operator*(planar_complex_array const& lhs, Real const rhs) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = lhs.real_parts_[index] * rhs;
+            result.imag_parts_[index] = lhs.imag_parts_[index] * rhs;
+          }
+          return result;
+        }
+
+        // (a + ib)(c + id) = (ac - bd) + i(ad + bc)
+        friend planar_complex_array operator*(planar_complex_array const& lhs, planar_complex_array const& rhs) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index]
+              = lhs.real_parts_[index] * rhs.real_parts_[index] - lhs.imag_parts_[index] * rhs.imag_parts_[index];
+            result.imag_parts_[index]
+              = lhs.real_parts_[index] * rhs.imag_parts_[index] + lhs.imag_parts_[index] * rhs.real_parts_[index];
+          }
+          return result;
+        }
+
+        // i(a + ib) = -b + ia
+        friend planar_complex_array times_i(planar_complex_array const& value) noexcept
+        {
+          auto result = planar_complex_array{};
+          for (auto index = std::size_t{0u}; index < size; ++index)
+          {
+            result.real_parts_[index] = -value.imag_parts_[index];
+            result.imag_parts_[index] = value.real_parts_[index];
+          }
+          return result;
+        }
+      }; // class planar_complex_array<Real, size_>
+    } // namespace simd
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_SIMD_PLANAR_COMPLEX_ARRAY_HPP
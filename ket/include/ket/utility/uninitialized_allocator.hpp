@@ -0,0 +1,84 @@
+#ifndef KET_UTILITY_UNINITIALIZED_ALLOCATOR_HPP
+# define KET_UTILITY_UNINITIALIZED_ALLOCATOR_HPP
+
+# include <memory>
+# include <new>
+# include <utility>
+# include <type_traits>
+
+
+namespace ket
+{
+  namespace utility
+  {
+    // uninitialized_allocator<Allocator>: Allocator whose construct(pointer) without arguments leaves trivially
+    // copyable and trivially destructible values such as std::complex<double> uninitialized. Containers resized by
+    // resize(count) do not touch their memory, so that each memory page is placed on the NUMA node of the thread
+    // writing it first (see ket::mpi::state)
+    template <typename Allocator>
+    class uninitialized_allocator
+      : public Allocator
+    {
+      using traits_type = std::allocator_traits<Allocator>;
+
+     public:
+      using value_type = typename traits_type::value_type;
+
+      template <typename Value>
+      struct rebind
+      { using other = uninitialized_allocator<typename traits_type::template rebind_alloc<Value>>; };
+
+      uninitialized_allocator() = default;
+
+      uninitialized_allocator(Allocator const& allocator) noexcept(std::is_nothrow_copy_constructible<Allocator>::value)
+        : Allocator(allocator)
+      { }
+
+      template <typename Allocator_>
+      uninitialized_allocator(uninitialized_allocator<Allocator_> const& other)
+        : Allocator(static_cast<Allocator_ const&>(other))
+      { }
+
+      template <typename Value>
+      void construct(Value* pointer)
+      {
+        default_construct(
+          pointer,
+          std::integral_constant<
+            bool, std::is_trivially_copyable<Value>::value and std::is_trivially_destructible<Value>::value>{});
+      }
+
+      template <typename Value, typename... Arguments>
+      void construct(Value* pointer, Arguments&&... arguments)
+      {
+        using rebound_traits_type = typename traits_type::template rebind_traits<Value>;
+        auto allocator = typename traits_type::template rebind_alloc<Value>(static_cast<Allocator const&>(*this));
+        rebound_traits_type::construct(allocator, pointer, std::forward<Arguments>(arguments)...);
+      }
+
+     private:
+      template <typename Value>
+      void default_construct(Value*, std::true_type const) noexcept
+      { }
+
+      template <typename Value>
+      void default_construct(Value* pointer, std::false_type const)
+      { ::new(static_cast<void*>(pointer)) Value(); }
+    }; // class uninitialized_allocator<Allocator>
+
+    template <typename Allocator1, typename Allocator2>
+    inline bool operator==(
+      ::ket::utility::uninitialized_allocator<Allocator1> const& lhs,
+      ::ket::utility::uninitialized_allocator<Allocator2> const& rhs)
+    { return static_cast<Allocator1 const&>(lhs) == static_cast<Allocator2 const&>(rhs); }
+
+    template <typename Allocator1, typename Allocator2>
+    inline bool operator!=(
+      ::ket::utility::uninitialized_allocator<Allocator1> const& lhs,
+      ::ket::utility::uninitialized_allocator<Allocator2> const& rhs)
+    { return not (lhs == rhs); }
+  } // namespace utility
+} // namespace ket
+
+
+#endif // KET_UTILITY_UNINITIALIZED_ALLOCATOR_HPP